@@ -396,6 +396,16 @@ ShiftRight(Environment* env, UDFContext* context, UDFValue* ret) {
 		AddUDF(theEnv, "binary->int", "l", 1, 1, "sy", CLIPS_translateBinary, "CLIPS_translateBinary", nullptr);
 		AddUDF(theEnv, "hex->int", "l", 1, 1, "sy", CLIPS_translateHex, "CLIPS_translateHex", nullptr);
 		AddUDF(theEnv, "oct->int", "l", 1, 1, "sy", CLIPS_translateOctal, "CLIPS_translateOctal", nullptr);
+		// these are pure so calls with literal arguments are folded when parsed
+		for (auto name : { "bitmask->int", "decode-bits", "encode-bits",
+						   "circular-shift-right", "circular-shift-left",
+						   "ones-complement", "twos-complement", "multiply-add",
+						   "upper-half", "lower-half", "binary-not", "binary-and",
+						   "binary-or", "binary-xor", "binary-nand", "binary-nor",
+						   "left-shift", "right-shift", "binary->int", "hex->int",
+						   "oct->int" }) {
+			SetFunctionFoldable(theEnv, name, true);
+		}
 	}
 
     void buildFunctionString(std::ostream& stream, const std::string& action, const std::string& name) noexcept {
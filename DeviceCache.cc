@@ -0,0 +1,298 @@
+/**
+ * @file
+ * implementation of methods described in DeviceCache.h
+ * @copyright
+ * syn
+ * Copyright (c) 2013-2017, Joshua Scoggins and Contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ClipsExtensions.h"
+#include "DeviceCache.h"
+#include "functional.h"
+
+#include <map>
+#include <sstream>
+#include <vector>
+
+extern "C" {
+#include "clips.h"
+}
+
+namespace syn {
+namespace cache {
+	constexpr char invalidationPrefix[] = "invalidate ";
+	constexpr auto invalidationPrefixLength = sizeof(invalidationPrefix) - 1;
+	constexpr int64_t defaultLines = 4096;
+	/**
+	 * One word of a remote device; lines are direct mapped by address
+	 */
+	struct Line {
+		int64_t address = -1;
+		int64_t value = 0;
+	};
+
+	struct DeviceCache {
+		DeviceCache(int64_t lines, int64_t prefetch) : table(lines), mask(lines - 1), prefetch(prefetch) { }
+		Line& lineFor(int64_t address) noexcept { return table[address & mask]; }
+		void invalidate(int64_t address, int64_t count) noexcept {
+			if (count >= static_cast<int64_t>(table.size())) {
+				invalidateAll();
+				return;
+			}
+			for (auto i = address; i < address + count; ++i) {
+				auto& line = lineFor(i);
+				if (line.address == i) {
+					line.address = -1;
+				}
+			}
+		}
+		void invalidateAll() noexcept {
+			for (auto& line : table) {
+				line.address = -1;
+			}
+		}
+		std::vector<Line> table;
+		int64_t mask;
+		int64_t prefetch;
+		int64_t hits = 0;
+		int64_t misses = 0;
+		int64_t invalidations = 0;
+	};
+
+	// device socket path -> cached words of that device
+	std::map<std::string, DeviceCache> caches;
+	void (*drainPending)(Environment*) = nullptr;
+
+	DeviceCache* find(const std::string& device) noexcept {
+		auto it = caches.find(device);
+		return it == caches.end() ? nullptr : &it->second;
+	}
+
+	std::string invalidation(const std::string& device, int64_t address, int64_t count) {
+		std::stringstream ss;
+		ss << invalidationPrefix << device << " " << address << " " << count;
+		return ss.str();
+	}
+
+	bool applyInvalidation(const std::string& message) noexcept {
+		if (message.compare(0, invalidationPrefixLength, invalidationPrefix) != 0) {
+			return false;
+		}
+		std::istringstream input(message.substr(invalidationPrefixLength));
+		std::string device;
+		int64_t address = 0, count = 0;
+		if (!(input >> device >> address >> count)) {
+			// a malformed invalidation can only be handled conservatively
+			for (auto& entry : caches) {
+				entry.second.invalidateAll();
+				++entry.second.invalidations;
+			}
+			return true;
+		}
+		if (auto* target = find(device)) {
+			target->invalidate(address, count);
+			++target->invalidations;
+		}
+		return true;
+	}
+
+	void enableFunction(Environment* env, UDFContext* context, UDFValue* ret) {
+		UDFValue device, lines, prefetch;
+		int64_t lineCount = defaultLines, prefetchCount = 0;
+		if (!UDFFirstArgument(context, LEXEME_BITS, &device)) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		if (UDFHasNextArgument(context)) {
+			if (!UDFNextArgument(context, INTEGER_BIT, &lines)) {
+				setBoolean(env, ret, false);
+				return;
+			}
+			lineCount = lines.integerValue->contents;
+		}
+		if (UDFHasNextArgument(context)) {
+			if (!UDFNextArgument(context, INTEGER_BIT, &prefetch)) {
+				setBoolean(env, ret, false);
+				return;
+			}
+			prefetchCount = prefetch.integerValue->contents;
+		}
+		if (lineCount <= 0 || (lineCount & (lineCount - 1)) != 0) {
+			UDFInvalidArgumentMessage(context, "positive power of two line count");
+			setBoolean(env, ret, false);
+			return;
+		} else if (prefetchCount < 0) {
+			UDFInvalidArgumentMessage(context, "non-negative prefetch count");
+			setBoolean(env, ret, false);
+			return;
+		}
+		std::string name(getLexeme(device));
+		caches.erase(name);
+		caches.emplace(name, DeviceCache(lineCount, prefetchCount));
+		setBoolean(env, ret, true);
+	}
+
+	void disableFunction(Environment* env, UDFContext* context, UDFValue* ret) {
+		UDFValue device;
+		if (!UDFFirstArgument(context, LEXEME_BITS, &device)) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		setBoolean(env, ret, caches.erase(getLexeme(device)) != 0);
+	}
+
+	void prefetchFunction(Environment* env, UDFContext* context, UDFValue* ret) {
+		UDFValue device;
+		if (!UDFFirstArgument(context, LEXEME_BITS, &device)) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		auto* target = find(getLexeme(device));
+		setInteger(env, ret, target ? target->prefetch : 0);
+	}
+
+	void lookupFunction(Environment* env, UDFContext* context, UDFValue* ret) {
+		UDFValue device, address;
+		if (!UDFFirstArgument(context, LEXEME_BITS, &device)) {
+			setBoolean(env, ret, false);
+			return;
+		} else if (!UDFNextArgument(context, INTEGER_BIT, &address)) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		auto* target = find(getLexeme(device));
+		if (!target) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		if (drainPending) {
+			drainPending(env);
+		}
+		auto addr = address.integerValue->contents;
+		auto& line = target->lineFor(addr);
+		if (line.address == addr) {
+			++target->hits;
+			setInteger(env, ret, line.value);
+		} else {
+			++target->misses;
+			setBoolean(env, ret, false);
+		}
+	}
+
+	void storeFunction(Environment* env, UDFContext* context, UDFValue* ret) {
+		UDFValue device, address, value;
+		if (!UDFFirstArgument(context, LEXEME_BITS, &device)) {
+			setBoolean(env, ret, false);
+			return;
+		} else if (!UDFNextArgument(context, INTEGER_BIT, &address)) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		auto* target = find(getLexeme(device));
+		if (!target) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		// consecutive words starting at the given address; anything which
+		// is not an integer (a failed read) ends the run
+		auto addr = address.integerValue->contents;
+		while (UDFHasNextArgument(context)) {
+			if (!UDFNextArgument(context, ANY_TYPE_BITS, &value)) {
+				setBoolean(env, ret, false);
+				return;
+			}
+			if (value.header->type != INTEGER_TYPE) {
+				target->invalidate(addr, 1);
+				setBoolean(env, ret, false);
+				return;
+			}
+			auto& line = target->lineFor(addr);
+			line.address = addr;
+			line.value = value.integerValue->contents;
+			++addr;
+		}
+		setBoolean(env, ret, true);
+	}
+
+	void invalidateFunction(Environment* env, UDFContext* context, UDFValue* ret) {
+		UDFValue device, address, count;
+		if (!UDFFirstArgument(context, LEXEME_BITS, &device)) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		auto* target = find(getLexeme(device));
+		if (!target) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		if (!UDFHasNextArgument(context)) {
+			target->invalidateAll();
+		} else if (!UDFNextArgument(context, INTEGER_BIT, &address)) {
+			setBoolean(env, ret, false);
+			return;
+		} else {
+			int64_t words = 1;
+			if (UDFHasNextArgument(context)) {
+				if (!UDFNextArgument(context, INTEGER_BIT, &count)) {
+					setBoolean(env, ret, false);
+					return;
+				}
+				words = count.integerValue->contents;
+			}
+			target->invalidate(address.integerValue->contents, words);
+		}
+		++target->invalidations;
+		setBoolean(env, ret, true);
+	}
+
+	void statisticsFunction(Environment* env, UDFContext* context, UDFValue* ret) {
+		UDFValue device;
+		if (!UDFFirstArgument(context, LEXEME_BITS, &device)) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		auto* target = find(getLexeme(device));
+		if (!target) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		maya::MultifieldBuilder mb(env);
+		mb.append(target->hits);
+		mb.append(target->misses);
+		mb.append(target->invalidations);
+		ret->multifieldValue = mb.create();
+	}
+} // end namespace cache
+
+	void installDeviceCache(Environment* env, void (*drain)(Environment*)) {
+		cache::drainPending = drain;
+		AddUDF(env, "device-cache-enable", "b", 1, 3, "sy;sy;l;l", cache::enableFunction, "cache::enableFunction", nullptr);
+		AddUDF(env, "device-cache-disable", "b", 1, 1, "sy", cache::disableFunction, "cache::disableFunction", nullptr);
+		AddUDF(env, "device-cache-prefetch", "l", 1, 1, "sy", cache::prefetchFunction, "cache::prefetchFunction", nullptr);
+		AddUDF(env, "device-cache-lookup", "lb", 2, 2, "sy;sy;l", cache::lookupFunction, "cache::lookupFunction", nullptr);
+		AddUDF(env, "device-cache-store", "b", 2, UNBOUNDED, "*;sy;l", cache::storeFunction, "cache::storeFunction", nullptr);
+		AddUDF(env, "device-cache-invalidate", "b", 1, 3, "sy;sy;l;l", cache::invalidateFunction, "cache::invalidateFunction", nullptr);
+		AddUDF(env, "device-cache-statistics", "mb", 1, 1, "sy", cache::statisticsFunction, "cache::statisticsFunction", nullptr);
+	}
+} // end namespace syn
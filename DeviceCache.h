@@ -0,0 +1,67 @@
+/**
+ * @file
+ * Client side cache for values read from remote memory and register devices.
+ * Each device gets a direct mapped table of words which is kept coherent
+ * through "invalidate" messages published by the owning device.
+ * @copyright
+ * syn
+ * Copyright (c) 2013-2017, Joshua Scoggins and Contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef SYN_DEVICE_CACHE_H__
+#define SYN_DEVICE_CACHE_H__
+#include <cstdint>
+#include <string>
+
+extern "C" {
+#include "clips.h"
+}
+
+namespace syn {
+	/**
+	 * Install the device-cache-* user functions into the target environment
+	 * @param env the environment to install into
+	 * @param drain called before every lookup so that invalidations which
+	 * have already arrived are applied before a hit is reported
+	 */
+	void installDeviceCache(Environment* env, void (*drain)(Environment*) = nullptr);
+
+namespace cache {
+	/**
+	 * Build the message a device publishes when the given words change
+	 * @param device the socket path of the device which owns the words
+	 * @param address the first word which changed
+	 * @param count the number of words which changed
+	 */
+	std::string invalidation(const std::string& device, int64_t address, int64_t count = 1);
+	/**
+	 * Apply the message to the cache if it is an invalidation
+	 * @param message a raw message received on the process socket
+	 * @return true if the message was an invalidation and has been consumed
+	 */
+	bool applyInvalidation(const std::string& message) noexcept;
+} // end namespace cache
+} // end namespace syn
+
+#endif // end SYN_DEVICE_CACHE_H__
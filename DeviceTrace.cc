@@ -0,0 +1,457 @@
+/**
+ * @file
+ * implementation of methods described in DeviceTrace.h
+ * @copyright
+ * syn
+ * Copyright (c) 2013-2017, Joshua Scoggins and Contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ClipsExtensions.h"
+#include "DeviceTrace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern "C" {
+#include "clips.h"
+}
+
+namespace syn {
+namespace trace {
+	/**
+	 * A single trace_event record; fixed size so that the buffer never
+	 * allocates while recording.
+	 */
+	struct Event {
+		char phase;
+		char name[64];
+		uint64_t ts;
+		uint64_t dur;
+		uint64_t trace;
+		uint64_t id;
+		uint64_t parent;
+	};
+
+	/**
+	 * Preallocated event buffer which is drained to disk when it fills or
+	 * when explicitly flushed. Recording and draining hold the same lock so
+	 * that an event recorded during a drain is neither overwritten nor lost.
+	 */
+	class EventBuffer {
+		public:
+			explicit EventBuffer(size_t capacity) : _capacity(capacity), _events(new Event[capacity]), _next(0), _dropped(0) { }
+			/**
+			 * @return true if the buffer is now full and should be drained
+			 */
+			bool record(const Event& e) noexcept {
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (_next >= _capacity) {
+					++_dropped;
+					return true;
+				}
+				_events[_next++] = e;
+				return _next == _capacity;
+			}
+			template<typename F>
+			size_t drain(F fn) {
+				std::lock_guard<std::mutex> lock(_mutex);
+				auto count = _next;
+				for (size_t i = 0; i < count; ++i) {
+					fn(_events[i]);
+				}
+				_next = 0;
+				return count;
+			}
+			size_t dropped() noexcept {
+				std::lock_guard<std::mutex> lock(_mutex);
+				return _dropped;
+			}
+		private:
+			std::mutex _mutex;
+			size_t _capacity;
+			std::unique_ptr<Event[]> _events;
+			size_t _next;
+			size_t _dropped;
+	};
+
+	constexpr size_t defaultCapacity = 65536;
+	constexpr auto headerPrefix = "@trace:";
+	constexpr char requestKind = 'q';
+	constexpr char responseKind = 'r';
+
+	bool _enabled = false;
+	bool _metadataWritten = false;
+	bool _exitHandlerInstalled = false;
+	std::string _path;
+	std::string _label;
+	std::unique_ptr<EventBuffer> _buffer;
+	std::atomic<uint32_t> _spanCounter(0);
+	Span _serving;
+	std::string _servingName;
+	bool _inRequest = false;
+	std::vector<std::tuple<Span, std::string>> _userSpans;
+
+	bool enabled() noexcept { return _enabled; }
+	uint64_t now() noexcept {
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+	void setProcessLabel(const std::string& label) noexcept { _label = label; }
+
+	uint64_t newSpanId() noexcept {
+		// the pid keeps span ids unique across every device on the machine
+		return (static_cast<uint64_t>(getpid()) << 32) | (++_spanCounter);
+	}
+	uint64_t newTraceId() noexcept {
+		static std::mt19937_64 gen(std::random_device{}() ^ (static_cast<uint64_t>(getpid()) << 16) ^ now());
+		uint64_t value = 0;
+		while (value == 0) {
+			value = gen();
+		}
+		return value;
+	}
+
+	void escape(std::ostream& out, const char* str) noexcept {
+		for (auto* c = str; *c != '\0'; ++c) {
+			switch (*c) {
+				case '"':
+				case '\\':
+					out << '\\' << *c;
+					break;
+				default:
+					if (static_cast<unsigned char>(*c) < 0x20) {
+						out << ' ';
+					} else {
+						out << *c;
+					}
+					break;
+			}
+		}
+	}
+
+	void writeEvent(std::ostream& out, const Event& e, long pid) noexcept {
+		out << "{\"name\":\"";
+		escape(out, e.name);
+		out << "\",\"cat\":\"device\",\"ph\":\"" << e.phase << "\",\"ts\":" << e.ts << ",\"pid\":" << pid << ",\"tid\":" << pid;
+		switch (e.phase) {
+			case 'X':
+				out << ",\"dur\":" << e.dur << std::hex << ",\"args\":{\"trace\":\"0x" << e.trace << "\",\"span\":\"0x" << e.id << "\",\"parent\":\"0x" << e.parent << "\"}" << std::dec;
+				break;
+			case 'f':
+				out << ",\"bp\":\"e\"";
+				// fall through
+			case 's':
+				out << std::hex << ",\"id\":\"0x" << e.id << "\"" << std::dec;
+				break;
+			default:
+				break;
+		}
+		out << "},\n";
+	}
+
+	/**
+	 * Append all buffered events to the trace file. Every device appends to
+	 * the file under an exclusive lock so that several processes can share a
+	 * single trace; the first writer emits the opening bracket (the closing
+	 * one is optional in the trace_event array format).
+	 * @return the number of events written
+	 */
+	size_t flush() noexcept {
+		if (!_buffer) {
+			return 0;
+		}
+		std::stringstream out;
+		long pid = getpid();
+		if (!_metadataWritten) {
+			out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"args\":{\"name\":\"";
+			escape(out, (_label.empty() ? std::to_string(pid) : _label).c_str());
+			out << "\"}},\n";
+			_metadataWritten = true;
+		}
+		auto count = _buffer->drain([&out, pid](const Event& e) { writeEvent(out, e, pid); });
+		auto fd = open(_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+		if (fd < 0) {
+			return 0;
+		}
+		flock(fd, LOCK_EX);
+		struct stat info;
+		std::string contents(out.str());
+		if (fstat(fd, &info) == 0 && info.st_size == 0) {
+			contents.insert(0, "[\n");
+		}
+		auto result = write(fd, contents.c_str(), contents.length());
+		flock(fd, LOCK_UN);
+		close(fd);
+		return result < 0 ? 0 : count;
+	}
+
+	void record(char phase, const std::string& name, uint64_t ts, uint64_t dur, const Span& span) noexcept {
+		Event e;
+		e.phase = phase;
+		strncpy(e.name, name.c_str(), sizeof(e.name) - 1);
+		e.name[sizeof(e.name) - 1] = '\0';
+		e.ts = ts;
+		e.dur = dur;
+		e.trace = span.trace;
+		e.id = span.id;
+		e.parent = span.parent;
+		if (_buffer->record(e)) {
+			flush();
+		}
+	}
+
+	Span currentParent() noexcept {
+		if (!_userSpans.empty()) {
+			return std::get<0>(_userSpans.back());
+		} else if (_inRequest) {
+			return _serving;
+		} else {
+			return Span();
+		}
+	}
+
+	Span makeChild() noexcept {
+		auto parent = currentParent();
+		Span span;
+		span.trace = parent.trace != 0 ? parent.trace : newTraceId();
+		span.id = newSpanId();
+		span.parent = parent.id;
+		span.begin = now();
+		return span;
+	}
+
+	Span beginOutbound() noexcept {
+		if (!_enabled) {
+			return Span();
+		}
+		return makeChild();
+	}
+
+	bool isRequest(const std::string& message) noexcept {
+		// a request names its reply socket as its last two words:
+		// "<command ...> callback <socket>"
+		std::istringstream input(message);
+		std::string word, previous, beforePrevious;
+		while (input >> word) {
+			beforePrevious = previous;
+			previous = word;
+		}
+		return beforePrevious == "callback";
+	}
+
+	std::string tag(const Span& span, const std::string& message) noexcept {
+		if (!_enabled) {
+			return message;
+		}
+		char header[64];
+		snprintf(header, sizeof(header), "%s%llx:%llx:%c ", headerPrefix, static_cast<unsigned long long>(span.trace), static_cast<unsigned long long>(span.id), isRequest(message) ? requestKind : responseKind);
+		return header + message;
+	}
+
+	void endOutbound(const Span& span, const std::string& destination) noexcept {
+		if (!_enabled) {
+			return;
+		}
+		record('X', "write " + destination, span.begin, now() - span.begin, span);
+		record('s', "message", span.begin, 0, span);
+	}
+
+	void finishInbound() noexcept {
+		if (_enabled && _inRequest) {
+			record('X', _servingName, _serving.begin, now() - _serving.begin, _serving);
+		}
+		_inRequest = false;
+	}
+
+	std::string untag(const std::string& message, uint64_t begin) noexcept {
+		Span sender;
+		std::string body(message);
+		auto request = false;
+		if (message.compare(0, strlen(headerPrefix), headerPrefix) == 0) {
+			unsigned long long t = 0, s = 0;
+			char kind = responseKind;
+			auto space = message.find(' ');
+			if (sscanf(message.c_str() + strlen(headerPrefix), "%llx:%llx:%c", &t, &s, &kind) >= 2) {
+				sender.trace = t;
+				sender.id = s;
+			}
+			body = (space == std::string::npos) ? std::string() : message.substr(space + 1);
+			request = (kind == requestKind);
+		} else {
+			// an untraced sender gives no kind, so go by the message layout
+			request = isRequest(body);
+		}
+		if (!_enabled) {
+			return body;
+		}
+		auto end = now();
+		Span read;
+		read.trace = sender.trace;
+		read.id = sender.id;
+		read.begin = begin;
+		record('X', "read", begin, end - begin, read);
+		if (sender.id != 0) {
+			record('f', "message", begin, 0, read);
+		}
+		// only requests open a new handling span, replies just terminate
+		// the flow started by the sender
+		if (request) {
+			_serving.trace = sender.trace != 0 ? sender.trace : newTraceId();
+			_serving.id = newSpanId();
+			_serving.parent = sender.id;
+			_serving.begin = end;
+			_servingName = "handle " + body.substr(0, body.find(' '));
+			_inRequest = true;
+		}
+		return body;
+	}
+
+	void flushOnExit() {
+		if (_enabled) {
+			finishInbound();
+			flush();
+		}
+	}
+
+	void enableTracing(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
+		UDFValue path, capacity;
+		if (!UDFFirstArgument(context, LEXEME_BITS, &path)) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		auto size = defaultCapacity;
+		if (UDFHasNextArgument(context)) {
+			if (!UDFNextArgument(context, INTEGER_BIT, &capacity)) {
+				setBoolean(env, ret, false);
+				return;
+			} else if (getInteger(capacity) <= 0) {
+				errorMessage(env, "TRACE", 1, "trace-enable: ", "capacity must be greater than zero!");
+				setBoolean(env, ret, false);
+				return;
+			}
+			size = getInteger(capacity);
+		}
+		if (_enabled) {
+			flush();
+		}
+		_path = getLexeme(path);
+		_buffer = std::make_unique<EventBuffer>(size);
+		_metadataWritten = false;
+		_enabled = true;
+		if (!_exitHandlerInstalled) {
+			atexit(flushOnExit);
+			_exitHandlerInstalled = true;
+		}
+		setBoolean(env, ret, true);
+	}
+
+	void disableTracing(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
+		if (!_enabled) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		finishInbound();
+		flush();
+		if (_buffer->dropped() > 0) {
+			std::stringstream msg;
+			msg << "trace buffer overflowed, " << _buffer->dropped() << " events were dropped\n";
+			clips::printRouter(env, STDWRN, msg.str());
+		}
+		_enabled = false;
+		_buffer.reset();
+		_userSpans.clear();
+		setBoolean(env, ret, true);
+	}
+
+	void flushTracing(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
+		setInteger(env, ret, _enabled ? flush() : 0);
+	}
+
+	void beginUserSpan(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
+		UDFValue name;
+		if (!UDFFirstArgument(context, LEXEME_BITS, &name)) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		if (!_enabled) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		_userSpans.emplace_back(makeChild(), getLexeme(name));
+		setBoolean(env, ret, true);
+	}
+
+	void endUserSpan(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
+		if (!_enabled || _userSpans.empty()) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		auto span = std::get<0>(_userSpans.back());
+		auto name = std::get<1>(_userSpans.back());
+		_userSpans.pop_back();
+		record('X', name, span.begin, now() - span.begin, span);
+		setBoolean(env, ret, true);
+	}
+	void tagMessage(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
+		UDFValue message;
+		if (!UDFFirstArgument(context, LEXEME_BITS, &message)) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		setString(env, ret, tag(beginOutbound(), getLexeme(message)).c_str());
+	}
+
+	void untagMessage(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
+		UDFValue message;
+		if (!UDFFirstArgument(context, LEXEME_BITS, &message)) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		// reading a message ends the request serviced since the last read
+		finishInbound();
+		setString(env, ret, untag(getLexeme(message), now()).c_str());
+	}
+} // end namespace trace
+
+	void installDeviceTracing(Environment* env) {
+		AddUDF(env, "trace-enable", "b", 1, 2, "sy;sy;l", trace::enableTracing, "trace::enableTracing", nullptr);
+		AddUDF(env, "trace-disable", "b", 0, 0, nullptr, trace::disableTracing, "trace::disableTracing", nullptr);
+		AddUDF(env, "trace-flush", "l", 0, 0, nullptr, trace::flushTracing, "trace::flushTracing", nullptr);
+		AddUDF(env, "trace-begin", "b", 1, 1, "sy", trace::beginUserSpan, "trace::beginUserSpan", nullptr);
+		AddUDF(env, "trace-end", "b", 0, 0, nullptr, trace::endUserSpan, "trace::endUserSpan", nullptr);
+		AddUDF(env, "trace-tag", "sb", 1, 1, "sy", trace::tagMessage, "trace::tagMessage", nullptr);
+		AddUDF(env, "trace-untag", "sb", 1, 1, "sy", trace::untagMessage, "trace::untagMessage", nullptr);
+	}
+} // end namespace syn
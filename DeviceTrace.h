@@ -0,0 +1,113 @@
+/**
+ * @file
+ * Cross device request tracing for the read-command/write-command socket
+ * protocol. Events are exported in the chrome trace_event JSON format; point
+ * every device at the same file with (trace-enable path) and load it into a
+ * trace viewer to get a timeline of the whole machine.
+ * @copyright
+ * syn
+ * Copyright (c) 2013-2017, Joshua Scoggins and Contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef SYN_DEVICE_TRACE_H__
+#define SYN_DEVICE_TRACE_H__
+#include <cstdint>
+#include <string>
+
+extern "C" {
+#include "clips.h"
+}
+
+namespace syn {
+	/**
+	 * Install the trace-* user functions into the target environment
+	 */
+	void installDeviceTracing(Environment* env);
+
+namespace trace {
+	/**
+	 * The identity of a single operation on the message path. Every span
+	 * belongs to a trace and optionally has a parent span which may live in
+	 * a different device process.
+	 */
+	struct Span {
+		uint64_t trace = 0;
+		uint64_t id = 0;
+		uint64_t parent = 0;
+		uint64_t begin = 0;
+	};
+
+	/**
+	 * @return true if events are currently being recorded in this process
+	 */
+	bool enabled() noexcept;
+	/**
+	 * @return the current time in microseconds since boot (shared between all
+	 * processes on the machine so that per device traces line up)
+	 */
+	uint64_t now() noexcept;
+	/**
+	 * Set the name used to label this process in the exported trace
+	 * @param label the name of the process (usually the socket path)
+	 */
+	void setProcessLabel(const std::string& label) noexcept;
+	/**
+	 * Start an outbound message; the new span becomes a child of the
+	 * request currently being serviced (if any).
+	 * @return the span describing the outbound message
+	 */
+	Span beginOutbound() noexcept;
+	/**
+	 * Prepend the trace header to the given message. The header also marks
+	 * the message as a request when it ends with "callback <socket>", so
+	 * the receiver doesn't have to inspect the body.
+	 * @param span the outbound span to propagate
+	 * @param message the message to tag
+	 * @return the message to put on the wire
+	 */
+	std::string tag(const Span& span, const std::string& message) noexcept;
+	/**
+	 * Record the completion of an outbound message
+	 * @param span the span returned from beginOutbound
+	 * @param destination the socket the message was written to
+	 */
+	void endOutbound(const Span& span, const std::string& destination) noexcept;
+	/**
+	 * Close the span of the request serviced since the last read
+	 */
+	void finishInbound() noexcept;
+	/**
+	 * Strip the trace header (if present) from a message which was just read.
+	 * When tracing is enabled the receive is recorded and, if the header marks
+	 * the message as a request, it becomes the parent of all messages written
+	 * until the next read.
+	 * @param message the raw message off of the wire
+	 * @param begin the time the connection was accepted
+	 * @return the message without the trace header
+	 */
+	std::string untag(const std::string& message, uint64_t begin) noexcept;
+} // end namespace trace
+} // end namespace syn
+
+#endif // end SYN_DEVICE_TRACE_H__
@@ -0,0 +1,91 @@
+/**
+ * @file
+ * implementation of methods described in FactBatch.h
+ * @copyright
+ * syn
+ * Copyright (c) 2013-2017, Joshua Scoggins and Contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "FactBatch.h"
+
+extern "C" {
+#include "clips.h"
+#include "factrhs.h"
+}
+
+namespace syn {
+	FactBatch::~FactBatch() {
+		discard();
+	}
+
+	void FactBatch::discard() noexcept {
+		for (auto fact : _asserts) {
+			ReturnFact(_env, fact);
+		}
+		for (auto fact : _retracts) {
+			ReleaseFact(fact);
+		}
+		_asserts.clear();
+		_retracts.clear();
+	}
+
+	void FactBatch::stage(Fact* fact) {
+		if (fact) {
+			_asserts.emplace_back(fact);
+		}
+	}
+
+	bool FactBatch::stage(const std::string& fact) {
+		auto result = StringToFact(_env, fact.c_str());
+		if (!result) {
+			return false;
+		}
+		_asserts.emplace_back(result);
+		return true;
+	}
+
+	void FactBatch::retract(Fact* fact) {
+		if (fact) {
+			RetainFact(fact);
+			_retracts.emplace_back(fact);
+		}
+	}
+
+	AssertError FactBatch::commit() {
+		if (!_retracts.empty()) {
+			RetractBatch(_env, _retracts.data(), _retracts.size());
+			for (auto fact : _retracts) {
+				ReleaseFact(fact);
+			}
+			_retracts.clear();
+		}
+		auto result = AE_NO_ERROR;
+		if (!_asserts.empty()) {
+			// AssertBatch takes ownership of every fact, asserted or not
+			result = AssertBatch(_env, _asserts.data(), _asserts.size());
+			_asserts.clear();
+		}
+		return result;
+	}
+} // end namespace syn
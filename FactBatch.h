@@ -0,0 +1,87 @@
+/**
+ * @file
+ * Bulk fact loading. Facts are staged in a batch and asserted or retracted
+ * together. Asserted facts are matched in batch order, so the activations
+ * are the same as for asserting them one at a time. Retracted facts are
+ * all removed from the fact-list before their matches are removed.
+ * @copyright
+ * syn
+ * Copyright (c) 2013-2017, Joshua Scoggins and Contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef SYN_FACT_BATCH_H__
+#define SYN_FACT_BATCH_H__
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "clips.h"
+}
+
+namespace syn {
+	/**
+	 * A group of facts to be asserted and retracted together. Nothing
+	 * reaches the fact-list until commit is called; facts which are still
+	 * staged when the batch is destroyed are discarded.
+	 */
+	class FactBatch {
+		public:
+			explicit FactBatch(Environment* env) noexcept : _env(env) { }
+			~FactBatch();
+			FactBatch(const FactBatch&) = delete;
+			FactBatch& operator=(const FactBatch&) = delete;
+			/**
+			 * Stage a fact built with a FactBuilder or StringToFact; the
+			 * batch takes ownership of the fact
+			 * @param fact the unasserted fact to stage
+			 */
+			void stage(Fact* fact);
+			/**
+			 * Stage a fact in assert-string form
+			 * @param fact the fact to parse
+			 * @return false if the fact could not be parsed
+			 */
+			bool stage(const std::string& fact);
+			/**
+			 * Retract the given fact when the batch is committed
+			 * @param fact the asserted fact to retract
+			 */
+			void retract(Fact* fact);
+			/**
+			 * Retract the staged facts and then assert the staged facts
+			 * @return the first error reported while asserting
+			 */
+			AssertError commit();
+			std::size_t staged() const noexcept { return _asserts.size(); }
+			std::size_t retracting() const noexcept { return _retracts.size(); }
+		private:
+			void discard() noexcept;
+		private:
+			Environment* _env;
+			std::vector<Fact*> _asserts;
+			std::vector<Fact*> _retracts;
+	};
+} // end namespace syn
+
+#endif // end SYN_FACT_BATCH_H__
@@ -0,0 +1,281 @@
+/**
+ * @file
+ * implementation of methods described in Reactor.h
+ * @copyright
+ * syn
+ * Copyright (c) 2013-2017, Joshua Scoggins and Contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "ClipsExtensions.h"
+#include "Reactor.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+extern "C" {
+#include "clips.h"
+}
+
+namespace syn {
+namespace reactor {
+	/**
+	 * A descriptor being watched along with the fact to assert when it
+	 * becomes readable.
+	 */
+	struct Source {
+		std::string fact;
+		bool owned = false;
+		bool timer = false;
+		// the fact asserted for the last readiness event; the descriptor is
+		// not polled again until it has been retracted
+		Fact* outstanding = nullptr;
+	};
+
+	struct State {
+		std::map<int, Source> sources;
+		// how many rule firings happen between non-blocking checks while
+		// the agenda is busy; zero means only check when the agenda is empty
+		int64_t interval = 64;
+		int64_t firings = 0;
+		std::vector<pollfd> pending;
+	};
+
+	std::map<Environment*, State> states;
+
+	State& getState(Environment* env) noexcept {
+		return states[env];
+	}
+
+	/**
+	 * Drop the outstanding fact of a source if it has been retracted
+	 * @return true if the descriptor should be polled
+	 */
+	bool armed(Source& src) noexcept {
+		if (src.outstanding && src.outstanding->garbage) {
+			ReleaseFact(src.outstanding);
+			src.outstanding = nullptr;
+		}
+		return src.outstanding == nullptr;
+	}
+
+	void release(Source& src, int fd) noexcept {
+		if (src.outstanding) {
+			ReleaseFact(src.outstanding);
+			src.outstanding = nullptr;
+		}
+		if (src.owned) {
+			close(fd);
+		}
+	}
+
+	/**
+	 * Poll every armed descriptor and assert the facts of the ready ones
+	 * @param timeout milliseconds to wait, -1 to wait forever
+	 * @return true if any fact was asserted
+	 */
+	bool check(Environment* env, State& st, int timeout) noexcept {
+		st.pending.clear();
+		for (auto& entry : st.sources) {
+			if (armed(entry.second)) {
+				st.pending.push_back({ entry.first, POLLIN, 0 });
+			}
+		}
+		if (st.pending.empty()) {
+			return false;
+		}
+		auto count = poll(st.pending.data(), st.pending.size(), timeout);
+		if (count < 0) {
+			// a signal (ctrl-c) interrupted us; return to the run loop so
+			// that it can notice the halt request
+			return errno == EINTR && timeout != 0 && !GetHaltExecution(env);
+		}
+		auto asserted = false;
+		for (auto const& p : st.pending) {
+			if (p.revents == 0) {
+				continue;
+			}
+			auto it = st.sources.find(p.fd);
+			if (p.revents & POLLNVAL) {
+				// closed out from under us, never going to become ready
+				st.sources.erase(it);
+				continue;
+			}
+			if (it->second.timer) {
+				uint64_t expirations = 0;
+				if (read(p.fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+					continue;
+				}
+			}
+			auto* fact = AssertString(env, it->second.fact.c_str());
+			if (fact) {
+				RetainFact(fact);
+				it->second.outstanding = fact;
+				asserted = true;
+			}
+		}
+		return asserted;
+	}
+
+	bool waitForReadiness(Environment* env, void* context) {
+		return check(env, *static_cast<State*>(context), -1);
+	}
+
+	void checkWhileBusy(Environment* env, Activation*, void* context) {
+		auto& st = *static_cast<State*>(context);
+		if (st.interval <= 0 || st.sources.empty()) {
+			return;
+		}
+		if (++st.firings >= st.interval) {
+			st.firings = 0;
+			check(env, st, 0);
+		}
+	}
+
+	void cleanup(Environment* env) {
+		auto it = states.find(env);
+		if (it == states.end()) {
+			return;
+		}
+		// the fact list is being torn down, only the descriptors matter
+		for (auto& entry : it->second.sources) {
+			if (entry.second.owned) {
+				close(entry.first);
+			}
+		}
+		states.erase(it);
+	}
+
+	void watchFunction(Environment* env, UDFContext* context, UDFValue* ret) {
+		UDFValue fd, fact;
+		if (!UDFFirstArgument(context, INTEGER_BIT, &fd)) {
+			setBoolean(env, ret, false);
+			return;
+		} else if (!UDFNextArgument(context, STRING_BIT, &fact)) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		setBoolean(env, ret, watchDescriptor(env, fd.integerValue->contents, fact.lexemeValue->contents));
+	}
+
+	void timerFunction(Environment* env, UDFContext* context, UDFValue* ret) {
+		UDFValue period, fact;
+		if (!UDFFirstArgument(context, INTEGER_BIT, &period)) {
+			setBoolean(env, ret, false);
+			return;
+		} else if (!UDFNextArgument(context, STRING_BIT, &fact)) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		auto ms = period.integerValue->contents;
+		if (ms <= 0) {
+			UDFInvalidArgumentMessage(context, "positive integer");
+			setBoolean(env, ret, false);
+			return;
+		}
+		auto fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+		if (fd < 0) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		itimerspec spec;
+		spec.it_interval.tv_sec = ms / 1000;
+		spec.it_interval.tv_nsec = (ms % 1000) * 1000000;
+		spec.it_value = spec.it_interval;
+		if (timerfd_settime(fd, 0, &spec, nullptr) < 0 ||
+				!watchDescriptor(env, fd, fact.lexemeValue->contents, true)) {
+			close(fd);
+			setBoolean(env, ret, false);
+			return;
+		}
+		getState(env).sources[fd].timer = true;
+		setInteger(env, ret, fd);
+	}
+
+	void unwatchFunction(Environment* env, UDFContext* context, UDFValue* ret) {
+		UDFValue fd;
+		if (!UDFFirstArgument(context, INTEGER_BIT, &fd)) {
+			setBoolean(env, ret, false);
+			return;
+		}
+		setBoolean(env, ret, unwatchDescriptor(env, fd.integerValue->contents));
+	}
+
+	void intervalFunction(Environment* env, UDFContext* context, UDFValue* ret) {
+		auto& st = getState(env);
+		if (UDFHasNextArgument(context)) {
+			UDFValue interval;
+			if (!UDFFirstArgument(context, INTEGER_BIT, &interval)) {
+				setBoolean(env, ret, false);
+				return;
+			}
+			st.interval = interval.integerValue->contents;
+			st.firings = 0;
+		}
+		setInteger(env, ret, st.interval);
+	}
+} // end namespace reactor
+
+	bool watchDescriptor(Environment* env, int fd, const std::string& fact, bool owned) noexcept {
+		auto& st = reactor::getState(env);
+		if (fd < 0 || st.sources.count(fd)) {
+			return false;
+		}
+		auto& src = st.sources[fd];
+		src.fact = fact;
+		src.owned = owned;
+		return true;
+	}
+
+	bool unwatchDescriptor(Environment* env, int fd) noexcept {
+		auto& st = reactor::getState(env);
+		auto it = st.sources.find(fd);
+		if (it == st.sources.end()) {
+			return false;
+		}
+		reactor::release(it->second, fd);
+		st.sources.erase(it);
+		return true;
+	}
+
+	bool watchingDescriptor(Environment* env, int fd) noexcept {
+		auto& st = reactor::getState(env);
+		return st.sources.count(fd) != 0;
+	}
+
+	void installReactor(Environment* env) {
+		auto& st = reactor::getState(env);
+		AddRunIdleFunction(env, "reactor", reactor::waitForReadiness, 0, &st);
+		AddAfterRuleFiresFunction(env, "reactor", reactor::checkWhileBusy, 0, &st);
+		AddEnvironmentCleanupFunction(env, "reactor", reactor::cleanup, 0);
+		AddUDF(env, "reactor-watch", "b", 2, 2, "l;l;s", reactor::watchFunction, "reactor::watchFunction", nullptr);
+		AddUDF(env, "reactor-timer", "lb", 2, 2, "l;l;s", reactor::timerFunction, "reactor::timerFunction", nullptr);
+		AddUDF(env, "reactor-unwatch", "b", 1, 1, "l", reactor::unwatchFunction, "reactor::unwatchFunction", nullptr);
+		AddUDF(env, "reactor-poll-interval", "lb", 0, 1, "l", reactor::intervalFunction, "reactor::intervalFunction", nullptr);
+	}
+} // end namespace syn
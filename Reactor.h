@@ -0,0 +1,73 @@
+/**
+ * @file
+ * Readiness driven rule execution. File descriptors (sockets, pipes,
+ * timerfds) are registered together with a fact; while (run) has nothing
+ * left on the agenda it sleeps in poll() and asserts the associated fact
+ * when a descriptor becomes readable.
+ * @copyright
+ * syn
+ * Copyright (c) 2013-2017, Joshua Scoggins and Contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef SYN_REACTOR_H__
+#define SYN_REACTOR_H__
+#include <string>
+
+extern "C" {
+#include "clips.h"
+}
+
+namespace syn {
+	/**
+	 * Install the reactor-* user functions and the run loop hooks into the
+	 * target environment
+	 */
+	void installReactor(Environment* env);
+	/**
+	 * Assert a fact whenever the given descriptor is readable. The
+	 * descriptor is not polled again until the asserted fact has been
+	 * retracted, so rules consume readiness by retracting the fact.
+	 * @param env the environment to assert the fact into
+	 * @param fd the descriptor to watch
+	 * @param fact the fact to assert in assert-string form
+	 * @param owned close the descriptor when it is no longer watched
+	 * @return false if the descriptor is already being watched
+	 */
+	bool watchDescriptor(Environment* env, int fd, const std::string& fact, bool owned = false) noexcept;
+	/**
+	 * Stop watching the given descriptor
+	 * @param env the environment the descriptor was registered with
+	 * @param fd the descriptor to stop watching
+	 * @return false if the descriptor was not being watched
+	 */
+	bool unwatchDescriptor(Environment* env, int fd) noexcept;
+	/**
+	 * @param env the environment to check
+	 * @param fd the descriptor to look for
+	 * @return true if the descriptor is currently being watched
+	 */
+	bool watchingDescriptor(Environment* env, int fd) noexcept;
+}
+
+#endif // end SYN_REACTOR_H__
@@ -25,7 +25,12 @@
 
 
 #include "ClipsExtensions.h"
+#include "DeviceCache.h"
+#include "DeviceTrace.h"
 #include "MemoryBlock.h"
+#include "Reactor.h"
+#include "functional.h"
+#include <poll.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/un.h>
@@ -37,7 +42,11 @@ extern "C" {
 #ifdef PLATFORM_LINUX
     #include "AlsaMIDIExtensions.h"
 #endif // end PLATFORM_LINUX
+#include <deque>
+#include <map>
+#include <set>
 #include <string>
+#include <utility>
 
 bool socketNameSet = false;
 std::string socketName;
@@ -45,6 +54,13 @@ std::string socketName;
 bool serverSetup = false;
 sockaddr_un server;
 int socketId;
+// command symbol -> function, deffunction, or generic which services it
+std::map<std::string, std::string> deviceCommands;
+// front ends which cache words of this device and want to hear about writes
+std::set<std::string> invalidationSubscribers;
+// messages picked up while draining invalidations, along with when they
+// were accepted
+std::deque<std::pair<std::string, uint64_t>> deferredMessages;
 
 void setServerSocket(Environment* env, UDFContext* context, UDFValue* ret) noexcept;
 void getServerSocket(Environment* env, UDFContext* context, UDFValue* ret) noexcept;
@@ -52,6 +68,13 @@ void setupConnection(Environment* env, UDFContext* context, UDFValue* ret) noexc
 void shutdownConnection(Environment* env, UDFContext* context, UDFValue* ret) noexcept;
 void readCommand(Environment* env, UDFContext* context, UDFValue* ret) noexcept;
 void writeCommand(Environment* env, UDFContext* context, UDFValue* ret) noexcept;
+void registerDeviceCommand(Environment* env, UDFContext* context, UDFValue* ret) noexcept;
+void readDeviceCommand(Environment* env, UDFContext* context, UDFValue* ret) noexcept;
+void watchConnection(Environment* env, UDFContext* context, UDFValue* ret) noexcept;
+void addInvalidationSubscriber(Environment* env, UDFContext* context, UDFValue* ret) noexcept;
+void removeInvalidationSubscriber(Environment* env, UDFContext* context, UDFValue* ret) noexcept;
+void publishInvalidation(Environment* env, UDFContext* context, UDFValue* ret) noexcept;
+void drainInvalidations(Environment* env) noexcept;
 
 void setupServerFunctions(Environment* env) noexcept {
 	socketNameSet = false;
@@ -64,6 +87,12 @@ void setupServerFunctions(Environment* env) noexcept {
 	AddUDF(env, "read-command", "syb", 0, 0, nullptr, readCommand, "readCommand", nullptr);
 	AddUDF(env, "write-command", "syb", 1, 2, "sy;sy;sy", writeCommand, "writeCommand", nullptr);
 	AddUDF(env, "shutdown-connection", "b", 0, 0, nullptr, shutdownConnection, "shutdownConnection", nullptr);
+	AddUDF(env, "register-device-command", "b", 2, 2, "sy;sy;y", registerDeviceCommand, "registerDeviceCommand", nullptr);
+	AddUDF(env, "read-device-command", "syb", 0, 0, nullptr, readDeviceCommand, "readDeviceCommand", nullptr);
+	AddUDF(env, "watch-connection", "b", 1, 1, "s", watchConnection, "watchConnection", nullptr);
+	AddUDF(env, "add-invalidation-subscriber", "b", 1, 1, "sy", addInvalidationSubscriber, "addInvalidationSubscriber", nullptr);
+	AddUDF(env, "remove-invalidation-subscriber", "b", 1, 1, "sy", removeInvalidationSubscriber, "removeInvalidationSubscriber", nullptr);
+	AddUDF(env, "publish-invalidation", "l", 1, 2, "l", publishInvalidation, "publishInvalidation", nullptr);
 	//TODO: add shutdown connection
 }
 int main(int argc, char* argv[]) {
@@ -72,6 +101,9 @@ int main(int argc, char* argv[]) {
 	// install features here
 	syn::installExtensions(mainEnv);
 	syn::installMemoryBlockTypes(mainEnv);
+	syn::installDeviceTracing(mainEnv);
+	syn::installReactor(mainEnv);
+	syn::installDeviceCache(mainEnv, drainInvalidations);
 #ifdef PLATFORM_LINUX
     syn::installAlsaMIDIExtensions(mainEnv);
 #endif // end PLATFORM_LINUX
@@ -91,6 +123,7 @@ void setServerSocket(Environment* env, UDFContext* context, UDFValue* ret) noexc
 		}
 		socketName = syn::getLexeme(name);
 		socketNameSet = true;
+		syn::trace::setProcessLabel(socketName);
 		syn::setBoolean(env, ret, true);
 	} else {
 		syn::setBoolean(env, ret, false);
@@ -131,6 +164,7 @@ void setupConnection(Environment* env, UDFContext* context, UDFValue* ret) noexc
 
 void shutdownConnection(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
 	if (serverSetup) {
+		syn::unwatchDescriptor(env, socketId);
 		close(socketId);
 		unlink(socketName.c_str());
 		serverSetup = false;
@@ -142,17 +176,13 @@ void shutdownConnection(Environment* env, UDFContext* context, UDFValue* ret) no
 	}
 }
 
-void readCommand(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
-	if (!serverSetup) {
-		syn::setBoolean(env, ret, false);
-		return;
-	}
+bool receiveMessage(Environment* env, std::string& message, uint64_t& accepted) noexcept {
 	std::stringstream collector;
 	auto msgsock = accept(socketId, 0, 0);
+	accepted = syn::trace::now();
 	if (msgsock == -1) {
 		clips::printRouter(env, STDERR, "error during accept!\n");
-		syn::setBoolean(env, ret, false);
-		return;
+		return false;
 	}
 	constexpr auto bufSize = 65535;
 	char buf[bufSize]; // 64k
@@ -163,7 +193,6 @@ void readCommand(Environment* env, UDFContext* context, UDFValue* ret) noexcept
 		rval = read(msgsock, buf, bufSize);
 		if (rval < 0) {
 			clips::printRouter(env, STDERR, "error reading stream message");
-			syn::setBoolean(env, ret, false);
 			failed = true;
 			break;
 		} else if (rval == 0) {
@@ -175,13 +204,95 @@ void readCommand(Environment* env, UDFContext* context, UDFValue* ret) noexcept
 	} while (rval > 0);
 	close(msgsock);
 	if (failed) {
+		return false;
+	}
+	message = collector.str();
+	return true;
+}
+
+bool readMessage(Environment* env, std::string& message) noexcept {
+	// the request handled since the previous read (if any) is now complete
+	syn::trace::finishInbound();
+	if (!deferredMessages.empty()) {
+		auto& front = deferredMessages.front();
+		message = syn::trace::untag(front.first, front.second);
+		deferredMessages.pop_front();
+		return true;
+	}
+	// cache invalidations can show up at any point, including while we wait
+	// for the reply to our own request
+	uint64_t accepted = 0;
+	while (receiveMessage(env, message, accepted)) {
+		if (!syn::cache::applyInvalidation(message)) {
+			message = syn::trace::untag(message, accepted);
+			return true;
+		}
+	}
+	return false;
+}
+
+void drainInvalidations(Environment* env) noexcept {
+	if (!serverSetup) {
+		return;
+	}
+	pollfd pending = { socketId, POLLIN, 0 };
+	std::string message;
+	uint64_t accepted = 0;
+	while (poll(&pending, 1, 0) > 0 && receiveMessage(env, message, accepted)) {
+		if (!syn::cache::applyInvalidation(message)) {
+			deferredMessages.emplace_back(message, accepted);
+		}
+	}
+}
+
+void readCommand(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
+	if (!serverSetup) {
 		syn::setBoolean(env, ret, false);
-	} else {
-		auto str = collector.str();
+		return;
+	}
+	std::string str;
+	if (readMessage(env, str)) {
 		syn::setString(env, ret, str);
+	} else {
+		syn::setBoolean(env, ret, false);
 	}
 }
 
+bool sendMessage(Environment* env, const std::string& dest, const std::string& cmd, bool reportErrors = true) noexcept {
+	auto sock = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (sock < 0) {
+		clips::printRouter(env, STDERR, "Could not open stream socket\n");
+		return false;
+	}
+	sockaddr_un outboundServer;
+	outboundServer.sun_family = AF_UNIX;
+	strcpy(outboundServer.sun_path, dest.c_str());
+	if (connect(sock, (sockaddr*)&outboundServer, sizeof(sockaddr_un)) < 0) {
+		close(sock);
+		if (reportErrors) {
+			clips::printRouter(env, STDERR, "Could not connect to stream socket!\n");
+		}
+		return false;
+	}
+
+	auto result = true;
+	if (write(sock, cmd.c_str(), cmd.length()) < 0) {
+		if (reportErrors) {
+			clips::printRouter(env, STDERR, "Could not write on stream socket!\n");
+		}
+		result = false;
+	}
+	close(sock);
+	return result;
+}
+
+bool writeMessage(Environment* env, const std::string& dest, const std::string& message) noexcept {
+	auto span = syn::trace::beginOutbound();
+	auto result = sendMessage(env, dest, syn::trace::tag(span, message));
+	syn::trace::endOutbound(span, dest);
+	return result;
+}
+
 void writeCommand(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
 	UDFValue destination, command;
 	if (!UDFFirstArgument(context, LEXEME_BITS, &destination)) {
@@ -191,30 +302,167 @@ void writeCommand(Environment* env, UDFContext* context, UDFValue* ret) noexcept
 		syn::setBoolean(env, ret, false);
 		return;
 	}
-	std::string dest(syn::getLexeme(destination));
-	std::string cmd(syn::getLexeme(command));
+	syn::setBoolean(env, ret, writeMessage(env, syn::getLexeme(destination), syn::getLexeme(command)));
+}
 
-	auto sock = socket(AF_UNIX, SOCK_STREAM, 0);
-	if (sock < 0) {
-		clips::printRouter(env, STDERR, "Could not open stream socket\n");
+void registerDeviceCommand(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
+	UDFValue input, function;
+	Expression theRef;
+	if (!UDFFirstArgument(context, LEXEME_BITS, &input)) {
+		syn::setBoolean(env, ret, false);
+		return;
+	} else if (!UDFNextArgument(context, SYMBOL_BIT, &function)) {
+		syn::setBoolean(env, ret, false);
+		return;
+	} else if (!GetFunctionReference(env, syn::getLexeme(function), &theRef)) {
+		syn::errorMessage(env, "SERVER", 1, "register-device-command: ", std::string("unknown function ") + syn::getLexeme(function));
 		syn::setBoolean(env, ret, false);
 		return;
 	}
-	sockaddr_un outboundServer;
-	outboundServer.sun_family = AF_UNIX;
-	strcpy(outboundServer.sun_path, dest.c_str());
-	if (connect(sock, (sockaddr*)&outboundServer, sizeof(sockaddr_un)) < 0) {
-		close(sock);
-		clips::printRouter(env, STDERR, "Could not connect to stream socket!\n");
+	deviceCommands[syn::getLexeme(input)] = syn::getLexeme(function);
+	syn::setBoolean(env, ret, true);
+}
+
+/**
+ * Service the request directly if its command was registered with
+ * register-device-command. Requests have the form
+ * "command args... callback path" and the reply is the imploded result of
+ * the registered function, identical to what the dispatch-command rule in
+ * SimpleServer.clp would produce.
+ * @return true if the request was handled
+ */
+bool dispatchDeviceCommand(Environment* env, const std::string& request) noexcept {
+	if (deviceCommands.empty()) {
+		return false;
+	}
+	auto command = request.substr(0, request.find(' '));
+	auto target = deviceCommands.find(command);
+	if (target == deviceCommands.end()) {
+		return false;
+	}
+	GCBlock gcb;
+	GCBlockStart(env, &gcb);
+	auto* fields = StringToMultifield(env, request.c_str());
+	auto length = fields->length;
+	if ((length < 3) ||
+		(fields->contents[length - 2].header->type != SYMBOL_TYPE) ||
+		(strcmp(fields->contents[length - 2].lexemeValue->contents, "callback") != 0) ||
+		((fields->contents[length - 1].header->type != SYMBOL_TYPE) &&
+		 (fields->contents[length - 1].header->type != STRING_TYPE))) {
+		GCBlockEnd(env, &gcb);
+		return false;
+	}
+	std::string callback(fields->contents[length - 1].lexemeValue->contents);
+	CLIPSValue result;
+	{
+		maya::FunctionCallBuilder call(env, length - 3);
+		for (size_t i = 1; i < (length - 2); ++i) {
+			call.append(&fields->contents[i]);
+		}
+		if (call.call(target->second, &result) != FCBE_NO_ERROR) {
+			syn::setBoolean(env, &result, false);
+			// the requester gets FALSE back, don't take the whole device down
+			SetEvaluationError(env, false);
+			SetHaltExecution(env, false);
+		}
+	}
+	maya::MultifieldBuilder reply(env);
+	reply.append(&result);
+	UDFValue imploded;
+	imploded.value = reply.create();
+	imploded.begin = 0;
+	imploded.range = imploded.multifieldValue->length;
+	writeMessage(env, callback, ImplodeMultifield(env, &imploded)->contents);
+	GCBlockEnd(env, &gcb);
+	return true;
+}
+
+void readDeviceCommand(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
+	if (!serverSetup) {
 		syn::setBoolean(env, ret, false);
 		return;
 	}
+	// keep servicing registered commands without returning to the rule
+	// engine, hand anything else back to the caller like read-command would
+	std::string str;
+	while (readMessage(env, str)) {
+		if (!dispatchDeviceCommand(env, str)) {
+			syn::setString(env, ret, str);
+			return;
+		} else if (syn::watchingDescriptor(env, socketId)) {
+			// the reactor owns waiting; only keep going while another
+			// client is already queued up so accept() never blocks
+			pollfd pending = { socketId, POLLIN, 0 };
+			if (poll(&pending, 1, 0) <= 0) {
+				syn::setBoolean(env, ret, true);
+				return;
+			}
+		}
+	}
+	syn::setBoolean(env, ret, false);
+}
 
-	if (write(sock, cmd.c_str(), cmd.length()) < 0) {
-		clips::printRouter(env, STDERR, "Could not write on stream socket!\n");
+void watchConnection(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
+	UDFValue fact;
+	if (!serverSetup) {
 		syn::setBoolean(env, ret, false);
-	} else {
-		syn::setBoolean(env, ret, true);
+		return;
+	} else if (!UDFFirstArgument(context, STRING_BIT, &fact)) {
+		syn::setBoolean(env, ret, false);
+		return;
 	}
-	close(sock);
+	syn::setBoolean(env, ret, syn::watchDescriptor(env, socketId, fact.lexemeValue->contents));
+}
+
+void addInvalidationSubscriber(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
+	UDFValue subscriber;
+	if (!UDFFirstArgument(context, LEXEME_BITS, &subscriber)) {
+		syn::setBoolean(env, ret, false);
+		return;
+	}
+	invalidationSubscribers.emplace(syn::getLexeme(subscriber));
+	syn::setBoolean(env, ret, true);
+}
+
+void removeInvalidationSubscriber(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
+	UDFValue subscriber;
+	if (!UDFFirstArgument(context, LEXEME_BITS, &subscriber)) {
+		syn::setBoolean(env, ret, false);
+		return;
+	}
+	syn::setBoolean(env, ret, invalidationSubscribers.erase(syn::getLexeme(subscriber)) != 0);
+}
+
+void publishInvalidation(Environment* env, UDFContext* context, UDFValue* ret) noexcept {
+	UDFValue address, count;
+	int64_t words = 1;
+	if (!UDFFirstArgument(context, INTEGER_BIT, &address)) {
+		syn::setInteger(env, ret, 0);
+		return;
+	}
+	if (UDFHasNextArgument(context)) {
+		if (!UDFNextArgument(context, INTEGER_BIT, &count)) {
+			syn::setInteger(env, ret, 0);
+			return;
+		}
+		words = count.integerValue->contents;
+	}
+	if (invalidationSubscribers.empty()) {
+		syn::setInteger(env, ret, 0);
+		return;
+	}
+	// sent before the reply to the request which caused the write, so the
+	// writer itself sees the invalidation first and the write-through wins.
+	// front ends which have gone away are dropped quietly
+	auto msg = syn::cache::invalidation(socketName, address.integerValue->contents, words);
+	int64_t sent = 0;
+	for (auto it = invalidationSubscribers.begin(); it != invalidationSubscribers.end(); ) {
+		if (sendMessage(env, *it, msg, false)) {
+			++sent;
+			++it;
+		} else {
+			it = invalidationSubscribers.erase(it);
+		}
+	}
+	syn::setInteger(env, ret, sent);
 }
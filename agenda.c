@@ -81,6 +81,7 @@
 #include "router.h"
 #include "rulebsc.h"
 #include "ruledef.h"
+#include "rulephs.h"
 #include "strngrtr.h"
 #include "sysdep.h"
 #include "watch.h"
@@ -145,6 +146,16 @@ void AddActivation(
    struct defruleModule *theModuleItem;
    struct salienceGroup *theGroup;
 
+   /*==================================================*/
+   /* A rule with a phase declaration is only placed   */
+   /* on the agenda while its phase is current. The    */
+   /* partial match is left without an activation and  */
+   /* will be refreshed when the phase is entered.     */
+   /*==================================================*/
+
+   if ((theRule->phase != NULL) && (! RulePhaseIsActive(theRule)))
+     { return; }
+
    /*=======================================*/
    /* Focus on the module if the activation */
    /* is from an auto-focus rule.           */
@@ -77,6 +77,17 @@ void BasicMathFunctionDefinitions(
    AddUDF(theEnv,"abs","ld",1,1,"ld",AbsFunction,"AbsFunction",NULL);
    AddUDF(theEnv,"min","ld",1,UNBOUNDED,"ld",MinFunction,"MinFunction",NULL);
    AddUDF(theEnv,"max","ld",1,UNBOUNDED,"ld",MaxFunction,"MaxFunction",NULL);
+
+   SetFunctionFoldable(theEnv,"+",true);
+   SetFunctionFoldable(theEnv,"*",true);
+   SetFunctionFoldable(theEnv,"-",true);
+   SetFunctionFoldable(theEnv,"/",true);
+   SetFunctionFoldable(theEnv,"div",true);
+   SetFunctionFoldable(theEnv,"integer",true);
+   SetFunctionFoldable(theEnv,"float",true);
+   SetFunctionFoldable(theEnv,"abs",true);
+   SetFunctionFoldable(theEnv,"min",true);
+   SetFunctionFoldable(theEnv,"max",true);
 #endif
   }
 
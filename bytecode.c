@@ -0,0 +1,1728 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  08/25/16            */
+   /*                                                     */
+   /*            PROCEDURAL CODE BYTECODE MODULE          */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Compiles the bodies of deffunctions and          */
+/*   message-handlers to a register based bytecode and       */
+/*   executes it.                                            */
+/*                                                           */
+/*   Compilation is optional (see set-bytecode-compilation)  */
+/*   and is done the first time a body is executed. The      */
+/*   result of each expression is placed in a register of a  */
+/*   frame allocated for each execution of the body, so      */
+/*   recursive calls don't share registers. progn, if,       */
+/*   while, loop-for-count, bind of a local variable, the    */
+/*   two argument forms of +, -, *, =, <>, <, <=, >, >=, eq  */
+/*   and neq, and references to parameters, local variables  */
+/*   and loop counters are compiled to their own             */
+/*   instructions. The result of a +, - or * nested in       */
+/*   another arithmetic or comparison is kept as a C number  */
+/*   rather than being converted to an integer or float      */
+/*   value. Other function calls are made directly from a    */
+/*   call instruction and any other expression is passed to  */
+/*   EvaluateExpression.                                     */
+/*                                                           */
+/*   The instructions follow the functions they replace      */
+/*   step for step, including the order in which arguments   */
+/*   are evaluated and type checked, the error values        */
+/*   returned, the checks of the halt, break and return      */
+/*   flags, and the garbage collection blocks of loops, so   */
+/*   a compiled body behaves exactly as the interpreted one. */
+/*   A body is never compiled while user function profiling  */
+/*   is on so that its calls are still counted.              */
+/*                                                           */
+/*************************************************************/
+
+/* =========================================
+   *****************************************
+               EXTERNAL DEFINITIONS
+   =========================================
+   ***************************************** */
+#include "setup.h"
+
+#if DEFFUNCTION_CONSTRUCT || OBJECT_SYSTEM
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "argacces.h"
+#include "bmathfun.h"
+#include "envrnmnt.h"
+#include "exprnops.h"
+#include "extnfunc.h"
+#include "memalloc.h"
+#include "multifld.h"
+#include "prccode.h"
+#include "prcdrfun.h"
+#include "prdctfun.h"
+#include "prntutil.h"
+#if PROFILING_FUNCTIONS
+#include "proflfun.h"
+#endif
+#include "router.h"
+#include "utility.h"
+
+#include "bytecode.h"
+
+#define BYTECODE_UNPATCHED UINT_MAX
+
+/* =========================================
+   *****************************************
+      INTERNALLY VISIBLE FUNCTION HEADERS
+   =========================================
+   ***************************************** */
+
+struct bytecodeCompiler
+  {
+   Environment *theEnv;
+   BYTECODE_INSTRUCTION *code;
+   unsigned int length;
+   unsigned int size;
+   unsigned short registerCount;
+   unsigned short loopDepth;
+   unsigned short loopCount;
+  };
+
+struct bytecodeLoop
+  {
+   GCBlock gcb;
+   LOOP_COUNTER_STACK *counter;
+   long long end;
+  };
+
+struct bytecodeNumber
+  {
+   bool integer;
+   long long ivalue;
+   double fvalue;
+  };
+
+   static unsigned int            EmitInstruction(struct bytecodeCompiler *,BytecodeOp,unsigned short,Expression *);
+   static void                    PatchJumps(struct bytecodeCompiler *,unsigned int);
+   static void                    CompileExpression(struct bytecodeCompiler *,Expression *,unsigned short);
+   static void                    CompileFunctionCall(struct bytecodeCompiler *,Expression *,unsigned short);
+   static void                    CompileProgn(struct bytecodeCompiler *,Expression *,unsigned short);
+   static void                    CompileIf(struct bytecodeCompiler *,Expression *,unsigned short);
+   static void                    CompileWhile(struct bytecodeCompiler *,Expression *,unsigned short);
+   static void                    CompileLoopForCount(struct bytecodeCompiler *,Expression *,unsigned short);
+   static void                    CompileBind(struct bytecodeCompiler *,Expression *,unsigned short);
+   static void                    CompileBinaryOperation(struct bytecodeCompiler *,Expression *,unsigned short,BytecodeOp,bool);
+   static void                    CompileNumericOperand(struct bytecodeCompiler *,Expression *,unsigned short,BYTECODE_OPERAND *);
+   static BytecodeOp              BinaryOperation(struct functionDefinition *);
+   static bool                    DirectOperand(Expression *,BYTECODE_OPERAND *);
+   static void                    RegisterOperand(BYTECODE_OPERAND *,Expression *,unsigned short);
+   static bool                    LiteralExpression(Expression *);
+   static unsigned short          BeginLoop(struct bytecodeCompiler *);
+   static long long               LoopCount(Environment *,unsigned short);
+   static UDFValue               *FetchValue(Environment *,UDFValue *,BYTECODE_OPERAND *,UDFValue *);
+   static bool                    FetchNumber(Environment *,UDFValue *,struct bytecodeNumber *,BYTECODE_OPERAND *,
+                                              Expression *,unsigned short,UDFValue *,struct bytecodeNumber *);
+   static bool                    CheckArgument(Environment *,UDFValue *,bool,unsigned,Expression *,unsigned short);
+   static void                    AssignCallErrorValue(Environment *,Expression *,UDFValue *);
+   static void                    Arithmetic(BytecodeOp,struct bytecodeNumber *,struct bytecodeNumber *,
+                                             struct bytecodeNumber *);
+   static bool                    CompareNumbers(BytecodeOp,struct bytecodeNumber *,struct bytecodeNumber *);
+   static bool                    CompareValues(UDFValue *,UDFValue *);
+   static void                    PopLoopCounter(Environment *,struct bytecodeLoop *);
+
+/* =========================================
+   *****************************************
+          EXTERNALLY VISIBLE FUNCTIONS
+   =========================================
+   ***************************************** */
+
+/***************************************************
+  NAME         : BytecodeCommandDefinitions
+  DESCRIPTION  : Registers the commands which
+                 control bytecode compilation
+  INPUTS       : None
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Commands registered
+  NOTES        : None
+ ***************************************************/
+void BytecodeCommandDefinitions(
+  Environment *theEnv)
+  {
+#if ! RUN_TIME
+   AddUDF(theEnv,"set-bytecode-compilation","b",1,1,NULL,SetBytecodeCompilationCommand,"SetBytecodeCompilationCommand",NULL);
+   AddUDF(theEnv,"get-bytecode-compilation","b",0,0,NULL,GetBytecodeCompilationCommand,"GetBytecodeCompilationCommand",NULL);
+#else
+#if MAC_XCD
+#pragma unused(theEnv)
+#endif
+#endif
+  }
+
+/***************************************************
+  NAME         : GetBytecodeCompilation
+  DESCRIPTION  : Determines if the bodies of
+                 deffunctions and message-handlers
+                 are compiled to bytecode
+  INPUTS       : None
+  RETURNS      : True if bodies are compiled,
+                 false otherwise
+  SIDE EFFECTS : None
+  NOTES        : None
+ ***************************************************/
+bool GetBytecodeCompilation(
+  Environment *theEnv)
+  {
+   return ProceduralPrimitiveData(theEnv)->BytecodeCompilation;
+  }
+
+/***************************************************
+  NAME         : SetBytecodeCompilation
+  DESCRIPTION  : Sets whether the bodies of
+                 deffunctions and message-handlers
+                 are compiled to bytecode
+  INPUTS       : The new value
+  RETURNS      : The old value
+  SIDE EFFECTS : Bodies executed from now on are
+                 compiled or interpreted
+  NOTES        : Bodies which have already been
+                 compiled keep their bytecode, but
+                 it is only used while compilation
+                 is enabled
+ ***************************************************/
+bool SetBytecodeCompilation(
+  Environment *theEnv,
+  bool value)
+  {
+   bool oldValue;
+
+   oldValue = ProceduralPrimitiveData(theEnv)->BytecodeCompilation;
+   ProceduralPrimitiveData(theEnv)->BytecodeCompilation = value;
+   return oldValue;
+  }
+
+/****************************************************************
+  NAME         : GetBytecodeCompilationCommand
+  DESCRIPTION  : H/L access to GetBytecodeCompilation
+  INPUTS       : None
+  RETURNS      : The current value
+  SIDE EFFECTS : None
+  NOTES        : H/L Syntax: (get-bytecode-compilation)
+ ****************************************************************/
+void GetBytecodeCompilationCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   returnValue->lexemeValue = CreateBoolean(theEnv,GetBytecodeCompilation(theEnv));
+  }
+
+/****************************************************************
+  NAME         : SetBytecodeCompilationCommand
+  DESCRIPTION  : H/L access to SetBytecodeCompilation
+  INPUTS       : None
+  RETURNS      : The old value
+  SIDE EFFECTS : Bytecode compilation set
+  NOTES        : H/L Syntax: (set-bytecode-compilation <value>)
+ ****************************************************************/
+void SetBytecodeCompilationCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+
+   if (! UDFFirstArgument(context,ANY_TYPE_BITS,&theArg))
+     { return; }
+
+   returnValue->lexemeValue = CreateBoolean(theEnv,SetBytecodeCompilation(theEnv,(theArg.value != FalseSymbol(theEnv))));
+  }
+
+/***************************************************
+  NAME         : CompileProcBytecode
+  DESCRIPTION  : Compiles the actions of a
+                 deffunction or message-handler
+  INPUTS       : The actions
+  RETURNS      : The bytecode
+  SIDE EFFECTS : Bytecode allocated
+  NOTES        : The bytecode refers to the action
+                 expressions, so it must be released
+                 before they are
+ ***************************************************/
+struct procBytecode *CompileProcBytecode(
+  Environment *theEnv,
+  Expression *actions)
+  {
+   struct bytecodeCompiler theCompiler;
+   struct procBytecode *theCode;
+
+   theCompiler.theEnv = theEnv;
+   theCompiler.code = NULL;
+   theCompiler.length = 0;
+   theCompiler.size = 0;
+   theCompiler.registerCount = 1;
+   theCompiler.loopDepth = 0;
+   theCompiler.loopCount = 0;
+
+   CompileExpression(&theCompiler,actions,0);
+
+   theCode = get_struct(theEnv,procBytecode);
+   theCode->length = theCompiler.length;
+   theCode->code = (BYTECODE_INSTRUCTION *) gm2(theEnv,sizeof(BYTECODE_INSTRUCTION) * theCompiler.length);
+   memcpy(theCode->code,theCompiler.code,sizeof(BYTECODE_INSTRUCTION) * theCompiler.length);
+   theCode->registerCount = theCompiler.registerCount;
+   theCode->loopCount = theCompiler.loopCount;
+   rm(theEnv,theCompiler.code,sizeof(BYTECODE_INSTRUCTION) * theCompiler.size);
+
+   return theCode;
+  }
+
+/***************************************************
+  NAME         : ReturnProcBytecode
+  DESCRIPTION  : Releases the bytecode of a
+                 deffunction or message-handler
+  INPUTS       : The bytecode (can be NULL)
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Bytecode deallocated
+  NOTES        : None
+ ***************************************************/
+void ReturnProcBytecode(
+  Environment *theEnv,
+  struct procBytecode *theCode)
+  {
+   if (theCode == NULL)
+     { return; }
+
+   rm(theEnv,theCode->code,sizeof(BYTECODE_INSTRUCTION) * theCode->length);
+   rtn_struct(theEnv,procBytecode,theCode);
+  }
+
+/***************************************************
+  NAME         : ExecuteProcBytecode
+  DESCRIPTION  : Executes the bytecode of a
+                 deffunction or message-handler
+  INPUTS       : 1) The bytecode
+                 2) A buffer to hold the result
+  RETURNS      : The evaluation error flag, as
+                 EvaluateExpression does
+  SIDE EFFECTS : The actions are executed
+  NOTES        : The parameters and local variables
+                 of the body must already be set up
+ ***************************************************/
+bool ExecuteProcBytecode(
+  Environment *theEnv,
+  struct procBytecode *theCode,
+  UDFValue *returnValue)
+  {
+   UDFValue frameRegisters[BYTECODE_FRAME_REGISTERS];
+   struct bytecodeNumber frameNumbers[BYTECODE_FRAME_REGISTERS];
+   struct bytecodeLoop frameLoops[BYTECODE_FRAME_LOOPS];
+   UDFValue *registers, *rv, *src, temp1, temp2;
+   struct bytecodeNumber *numbers, n1, n2;
+   struct bytecodeLoop *loops, *theLoop;
+   BYTECODE_INSTRUCTION *ip;
+   struct functionDefinition *fptr;
+   struct expr *oldArgument;
+   UDFContext theUDFContext;
+   unsigned int pc;
+
+   if (theCode->registerCount <= BYTECODE_FRAME_REGISTERS)
+     {
+      registers = frameRegisters;
+      numbers = frameNumbers;
+     }
+   else
+     {
+      registers = (UDFValue *) gm2(theEnv,sizeof(UDFValue) * theCode->registerCount);
+      numbers = (struct bytecodeNumber *) gm2(theEnv,sizeof(struct bytecodeNumber) * theCode->registerCount);
+     }
+
+   if (theCode->loopCount <= BYTECODE_FRAME_LOOPS)
+     { loops = frameLoops; }
+   else
+     { loops = (struct bytecodeLoop *) gm2(theEnv,sizeof(struct bytecodeLoop) * theCode->loopCount); }
+
+   pc = 0;
+   while (pc < theCode->length)
+     {
+      ip = &theCode->code[pc++];
+      rv = &registers[ip->dst];
+
+      switch (ip->op)
+        {
+         case BC_LOADK:
+           rv->value = ip->node->value;
+           rv->begin = 0;
+           rv->range = SIZE_MAX;
+           break;
+
+         case BC_LOAD_PARAM:
+           src = &ProceduralPrimitiveData(theEnv)->ProcParamArray[ip->a.index];
+           rv->value = src->value;
+           rv->begin = src->begin;
+           rv->range = src->range;
+           break;
+
+         case BC_LOAD_LOCAL:
+           src = &ProceduralPrimitiveData(theEnv)->LocalVarArray[ip->a.index];
+           if (src->supplementalInfo == TrueSymbol(theEnv))
+             {
+              rv->value = src->value;
+              rv->begin = src->begin;
+              rv->range = src->range;
+             }
+           else
+             { EvaluateExpression(theEnv,ip->node,rv); }
+           break;
+
+         case BC_LOAD_COUNT:
+           rv->integerValue = CreateInteger(theEnv,LoopCount(theEnv,ip->a.index));
+           rv->begin = 0;
+           rv->range = SIZE_MAX;
+           break;
+
+         case BC_CALL:
+#if PROFILING_FUNCTIONS
+           if (ProfileFunctionData(theEnv)->ProfileUserFunctions)
+             {
+              EvaluateExpression(theEnv,ip->node,rv);
+              break;
+             }
+#endif
+           fptr = ip->node->functionValue;
+           rv->voidValue = VoidConstant(theEnv);
+           rv->begin = 0;
+           rv->range = SIZE_MAX;
+
+           oldArgument = EvaluationData(theEnv)->CurrentExpression;
+           EvaluationData(theEnv)->CurrentExpression = ip->node;
+
+           theUDFContext.environment = theEnv;
+           theUDFContext.context = fptr->context;
+           theUDFContext.theFunction = fptr;
+           theUDFContext.lastArg = ip->node->argList;
+           theUDFContext.lastPosition = 1;
+           theUDFContext.returnValue = rv;
+           fptr->functionPointer(theEnv,&theUDFContext,rv);
+           if ((rv->header->type == MULTIFIELD_TYPE) &&
+               (rv->range == SIZE_MAX))
+             { rv->range = rv->multifieldValue->length; }
+
+           EvaluationData(theEnv)->CurrentExpression = oldArgument;
+           break;
+
+         case BC_EVAL:
+           EvaluateExpression(theEnv,ip->node,rv);
+           break;
+
+         case BC_BIND:
+           src = &ProceduralPrimitiveData(theEnv)->LocalVarArray[ip->a.index];
+           if (src->supplementalInfo == TrueSymbol(theEnv))
+             { ReleaseUDFV(theEnv,src); }
+           src->supplementalInfo = TrueSymbol(theEnv);
+           src->value = rv->value;
+           src->begin = rv->begin;
+           src->range = rv->range;
+           RetainUDFV(theEnv,src);
+           break;
+
+         case BC_UNBIND:
+           src = &ProceduralPrimitiveData(theEnv)->LocalVarArray[ip->a.index];
+           if (src->supplementalInfo == TrueSymbol(theEnv))
+             { ReleaseUDFV(theEnv,src); }
+           src->supplementalInfo = FalseSymbol(theEnv);
+           rv->value = FalseSymbol(theEnv);
+           rv->begin = 0;
+           rv->range = SIZE_MAX;
+           break;
+
+         case BC_ADD:
+         case BC_SUB:
+         case BC_MUL:
+           rv->begin = 0;
+           rv->range = SIZE_MAX;
+           if (FetchNumber(theEnv,registers,numbers,&ip->a,ip->node,1,rv,&n1) &&
+               FetchNumber(theEnv,registers,numbers,&ip->b,ip->node,2,rv,&n2))
+             {
+              if (ip->unboxed)
+                { Arithmetic(ip->op,&n1,&n2,&numbers[ip->dst]); }
+              else
+                {
+                 Arithmetic(ip->op,&n1,&n2,&n1);
+                 if (n1.integer)
+                   { rv->integerValue = CreateInteger(theEnv,n1.ivalue); }
+                 else
+                   { rv->floatValue = CreateFloat(theEnv,n1.fvalue); }
+                }
+             }
+           break;
+
+         case BC_NUM_EQ:
+         case BC_NUM_NE:
+         case BC_LT:
+         case BC_LE:
+         case BC_GT:
+         case BC_GE:
+           rv->begin = 0;
+           rv->range = SIZE_MAX;
+           if (FetchNumber(theEnv,registers,numbers,&ip->a,ip->node,1,rv,&n1) &&
+               FetchNumber(theEnv,registers,numbers,&ip->b,ip->node,2,rv,&n2))
+             { rv->lexemeValue = CreateBoolean(theEnv,CompareNumbers(ip->op,&n1,&n2)); }
+           break;
+
+         case BC_EQ:
+         case BC_NEQ:
+           src = FetchValue(theEnv,registers,&ip->a,&temp1);
+           if (CompareValues(src,FetchValue(theEnv,registers,&ip->b,&temp2)))
+             { rv->lexemeValue = CreateBoolean(theEnv,(ip->op == BC_EQ)); }
+           else
+             { rv->lexemeValue = CreateBoolean(theEnv,(ip->op == BC_NEQ)); }
+           rv->begin = 0;
+           rv->range = SIZE_MAX;
+           break;
+
+         case BC_CHECK_NUMBER:
+           rv->begin = 0;
+           rv->range = SIZE_MAX;
+           if (! FetchNumber(theEnv,registers,numbers,&ip->a,ip->node,ip->position,rv,&n1))
+             { pc = ip->target; }
+           break;
+
+         case BC_JUMP:
+           pc = ip->target;
+           break;
+
+         case BC_JUMP_FALSE:
+           if (rv->value == FalseSymbol(theEnv))
+             { pc = ip->target; }
+           break;
+
+         case BC_JUMP_HALT:
+           if (EvaluationData(theEnv)->HaltExecution)
+             { pc = ip->target; }
+           break;
+
+         case BC_JUMP_FLAGS:
+           if (ProcedureFunctionData(theEnv)->BreakFlag ||
+               ProcedureFunctionData(theEnv)->ReturnFlag)
+             { pc = ip->target; }
+           break;
+
+         case BC_HALT_FALSE:
+           if (EvaluationData(theEnv)->HaltExecution)
+             {
+              rv->value = FalseSymbol(theEnv);
+              rv->begin = 0;
+              rv->range = SIZE_MAX;
+             }
+           break;
+
+         case BC_IF_CONDITION:
+           if (((! ip->literal) && EvaluationData(theEnv)->EvaluationError) ||
+               ProcedureFunctionData(theEnv)->BreakFlag ||
+               ProcedureFunctionData(theEnv)->ReturnFlag)
+             {
+              rv->value = FalseSymbol(theEnv);
+              pc = ip->target;
+             }
+           break;
+
+         case BC_IF_RESULT:
+           if (EvaluationData(theEnv)->EvaluationError)
+             { AssignCallErrorValue(theEnv,ip->node,rv); }
+           break;
+
+         case BC_GC_START:
+           GCBlockStart(theEnv,&loops[ip->slot].gcb);
+           break;
+
+         case BC_WHILE_TEST:
+           if ((rv->value == FalseSymbol(theEnv)) ||
+               EvaluationData(theEnv)->HaltExecution)
+             { pc = ip->target; }
+           break;
+
+         case BC_CLEAN:
+           CleanCurrentGarbageFrame(theEnv,NULL);
+           CallPeriodicTasks(theEnv);
+           break;
+
+         case BC_LOOP_END:
+         case BC_LFC_END:
+           theLoop = &loops[ip->slot];
+           src = &registers[ip->a.index];
+           ProcedureFunctionData(theEnv)->BreakFlag = false;
+           rv->begin = 0;
+           rv->range = SIZE_MAX;
+           if (ProcedureFunctionData(theEnv)->ReturnFlag)
+             {
+              rv->value = src->value;
+              rv->begin = src->begin;
+              rv->range = src->range;
+             }
+           else
+             { rv->value = FalseSymbol(theEnv); }
+           if (ip->op == BC_LFC_END)
+             { PopLoopCounter(theEnv,theLoop); }
+           GCBlockEndUDF(theEnv,&theLoop->gcb,rv);
+           CallPeriodicTasks(theEnv);
+           break;
+
+         case BC_LFC_BEGIN:
+           theLoop = &loops[ip->slot];
+           theLoop->counter = get_struct(theEnv,loopCounterStack);
+           theLoop->counter->loopCounter = 0LL;
+           theLoop->counter->nxt = ProcedureFunctionData(theEnv)->LoopCounterStack;
+           ProcedureFunctionData(theEnv)->LoopCounterStack = theLoop->counter;
+           break;
+
+         case BC_LFC_START:
+         case BC_LFC_LIMIT:
+           theLoop = &loops[ip->slot];
+           src = &registers[ip->a.index];
+           if (! CheckArgument(theEnv,src,ip->a.literal,INTEGER_BIT,ip->node,ip->position))
+             {
+              rv->value = FalseSymbol(theEnv);
+              rv->begin = 0;
+              rv->range = SIZE_MAX;
+              PopLoopCounter(theEnv,theLoop);
+              pc = ip->target;
+             }
+           else if (ip->op == BC_LFC_START)
+             { theLoop->counter->loopCounter = src->integerValue->contents; }
+           else
+             {
+              theLoop->end = src->integerValue->contents;
+              GCBlockStart(theEnv,&theLoop->gcb);
+             }
+           break;
+
+         case BC_LFC_TEST:
+           theLoop = &loops[ip->slot];
+           if ((theLoop->counter->loopCounter > theLoop->end) ||
+               EvaluationData(theEnv)->HaltExecution)
+             { pc = ip->target; }
+           break;
+
+         case BC_LFC_NEXT:
+           loops[ip->slot].counter->loopCounter++;
+           break;
+        }
+     }
+
+   returnValue->value = registers[0].value;
+   returnValue->begin = registers[0].begin;
+   returnValue->range = registers[0].range;
+
+   if (registers != frameRegisters)
+     {
+      rm(theEnv,registers,sizeof(UDFValue) * theCode->registerCount);
+      rm(theEnv,numbers,sizeof(struct bytecodeNumber) * theCode->registerCount);
+     }
+   if (loops != frameLoops)
+     { rm(theEnv,loops,sizeof(struct bytecodeLoop) * theCode->loopCount); }
+
+   return EvaluationData(theEnv)->EvaluationError;
+  }
+
+/* =========================================
+   *****************************************
+          INTERNALLY VISIBLE FUNCTIONS
+   =========================================
+   ***************************************** */
+
+/***************************************************
+  NAME         : EmitInstruction
+  DESCRIPTION  : Appends an instruction to the
+                 code being compiled
+  INPUTS       : 1) The compiler
+                 2) The opcode
+                 3) The destination register
+                 4) The expression the instruction
+                    evaluates (can be NULL)
+  RETURNS      : The index of the instruction
+  SIDE EFFECTS : Code buffer grown as needed
+  NOTES        : Instructions are moved when the
+                 buffer grows, so they must be
+                 referred to by index
+ ***************************************************/
+static unsigned int EmitInstruction(
+  struct bytecodeCompiler *theCompiler,
+  BytecodeOp op,
+  unsigned short dst,
+  Expression *node)
+  {
+   BYTECODE_INSTRUCTION *theInstruction;
+   unsigned int newSize;
+
+   if (theCompiler->length == theCompiler->size)
+     {
+      newSize = (theCompiler->size == 0) ? 32 : (theCompiler->size * 2);
+      theCompiler->code = (BYTECODE_INSTRUCTION *)
+                          genrealloc(theCompiler->theEnv,theCompiler->code,
+                                     sizeof(BYTECODE_INSTRUCTION) * theCompiler->size,
+                                     sizeof(BYTECODE_INSTRUCTION) * newSize);
+      theCompiler->size = newSize;
+     }
+
+   theInstruction = &theCompiler->code[theCompiler->length];
+   memset(theInstruction,0,sizeof(BYTECODE_INSTRUCTION));
+   theInstruction->op = op;
+   theInstruction->dst = dst;
+   theInstruction->node = node;
+
+   if (dst >= theCompiler->registerCount)
+     { theCompiler->registerCount = (unsigned short) (dst + 1); }
+
+   return theCompiler->length++;
+  }
+
+/***************************************************
+  NAME         : PatchJumps
+  DESCRIPTION  : Points the unresolved jumps
+                 emitted since an instruction at
+                 the next instruction
+  INPUTS       : 1) The compiler
+                 2) The index of the first
+                    instruction to patch
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Jump targets set
+  NOTES        : Nested constructs resolve their
+                 own jumps before returning, so the
+                 only unresolved jumps left are those
+                 of the construct being compiled
+ ***************************************************/
+static void PatchJumps(
+  struct bytecodeCompiler *theCompiler,
+  unsigned int start)
+  {
+   unsigned int i;
+
+   for (i = start ; i < theCompiler->length ; i++)
+     {
+      if (theCompiler->code[i].target == BYTECODE_UNPATCHED)
+        { theCompiler->code[i].target = theCompiler->length; }
+     }
+  }
+
+/***************************************************
+  NAME         : CompileExpression
+  DESCRIPTION  : Compiles an expression so that
+                 its value is left in a register
+  INPUTS       : 1) The compiler
+                 2) The expression
+                 3) The destination register
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Instructions emitted
+  NOTES        : Registers above the destination
+                 are free for use as temporaries
+ ***************************************************/
+static void CompileExpression(
+  struct bytecodeCompiler *theCompiler,
+  Expression *theExpression,
+  unsigned short dst)
+  {
+   BYTECODE_OPERAND theOperand;
+   unsigned int pc;
+
+   if (DirectOperand(theExpression,&theOperand))
+     {
+      switch (theOperand.kind)
+        {
+         case BC_PARAMETER:
+           pc = EmitInstruction(theCompiler,BC_LOAD_PARAM,dst,theExpression);
+           break;
+
+         case BC_LOCAL:
+           pc = EmitInstruction(theCompiler,BC_LOAD_LOCAL,dst,theExpression);
+           break;
+
+         case BC_COUNTER:
+           pc = EmitInstruction(theCompiler,BC_LOAD_COUNT,dst,theExpression);
+           break;
+
+         default:
+           pc = EmitInstruction(theCompiler,BC_LOADK,dst,theExpression);
+           break;
+        }
+      theCompiler->code[pc].a = theOperand;
+      return;
+     }
+
+   if (theExpression->type == PROC_BIND)
+     { CompileBind(theCompiler,theExpression,dst); }
+   else if (theExpression->type == FCALL)
+     { CompileFunctionCall(theCompiler,theExpression,dst); }
+   else
+     { EmitInstruction(theCompiler,BC_EVAL,dst,theExpression); }
+  }
+
+/***************************************************
+  NAME         : CompileFunctionCall
+  DESCRIPTION  : Compiles a call to a system or
+                 user defined function
+  INPUTS       : 1) The compiler
+                 2) The call
+                 3) The destination register
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Instructions emitted
+  NOTES        : Calls which don't have their own
+                 instructions are made by BC_CALL
+ ***************************************************/
+static void CompileFunctionCall(
+  struct bytecodeCompiler *theCompiler,
+  Expression *theExpression,
+  unsigned short dst)
+  {
+   void (*fptr)(Environment *,UDFContext *,UDFValue *);
+   unsigned short argCount;
+   BytecodeOp op;
+
+   fptr = theExpression->functionValue->functionPointer;
+   argCount = CountArguments(theExpression->argList);
+
+   if ((fptr == PrognFunction) && (argCount > 0))
+     { CompileProgn(theCompiler,theExpression,dst); }
+   else if ((fptr == IfFunction) && ((argCount == 2) || (argCount == 3)))
+     { CompileIf(theCompiler,theExpression,dst); }
+   else if ((fptr == WhileFunction) && (argCount == 2))
+     { CompileWhile(theCompiler,theExpression,dst); }
+   else if ((fptr == LoopForCountFunction) && (argCount == 3))
+     { CompileLoopForCount(theCompiler,theExpression,dst); }
+   else if ((argCount == 2) &&
+            ((op = BinaryOperation(theExpression->functionValue)) != BC_CALL))
+     { CompileBinaryOperation(theCompiler,theExpression,dst,op,false); }
+   else
+     { EmitInstruction(theCompiler,BC_CALL,dst,theExpression); }
+  }
+
+/***************************************************
+  NAME         : CompileProgn
+  DESCRIPTION  : Compiles a progn call
+  INPUTS       : 1) The compiler
+                 2) The call
+                 3) The destination register
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Instructions emitted
+  NOTES        : Each action is skipped if
+                 execution has been halted, and
+                 the remaining actions are skipped
+                 after a break or return
+ ***************************************************/
+static void CompileProgn(
+  struct bytecodeCompiler *theCompiler,
+  Expression *theExpression,
+  unsigned short dst)
+  {
+   Expression *theAction;
+   unsigned int start, pc;
+
+   start = theCompiler->length;
+   for (theAction = theExpression->argList ; theAction != NULL ; theAction = theAction->nextArg)
+     {
+      pc = EmitInstruction(theCompiler,BC_JUMP_HALT,dst,NULL);
+      theCompiler->code[pc].target = BYTECODE_UNPATCHED;
+
+      CompileExpression(theCompiler,theAction,dst);
+
+      if (theAction->nextArg != NULL)
+        {
+         pc = EmitInstruction(theCompiler,BC_JUMP_FLAGS,dst,NULL);
+         theCompiler->code[pc].target = BYTECODE_UNPATCHED;
+        }
+     }
+
+   PatchJumps(theCompiler,start);
+   EmitInstruction(theCompiler,BC_HALT_FALSE,dst,NULL);
+  }
+
+/***************************************************
+  NAME         : CompileIf
+  DESCRIPTION  : Compiles an if call
+  INPUTS       : 1) The compiler
+                 2) The call
+                 3) The destination register
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Instructions emitted
+  NOTES        : The condition is evaluated into
+                 the destination register, so it
+                 holds FALSE when there is no else
+                 part and the condition is false
+ ***************************************************/
+static void CompileIf(
+  struct bytecodeCompiler *theCompiler,
+  Expression *theExpression,
+  unsigned short dst)
+  {
+   Expression *condition, *thenPart, *elsePart;
+   unsigned int start, pc, falseJump;
+
+   condition = theExpression->argList;
+   thenPart = condition->nextArg;
+   elsePart = thenPart->nextArg;
+
+   start = theCompiler->length;
+   CompileExpression(theCompiler,condition,dst);
+
+   pc = EmitInstruction(theCompiler,BC_IF_CONDITION,dst,theExpression);
+   theCompiler->code[pc].literal = LiteralExpression(condition);
+   theCompiler->code[pc].target = BYTECODE_UNPATCHED;
+
+   falseJump = EmitInstruction(theCompiler,BC_JUMP_FALSE,dst,NULL);
+   theCompiler->code[falseJump].target = BYTECODE_UNPATCHED;
+
+   CompileExpression(theCompiler,thenPart,dst);
+   if (! LiteralExpression(thenPart))
+     { EmitInstruction(theCompiler,BC_IF_RESULT,dst,theExpression); }
+
+   if (elsePart != NULL)
+     {
+      pc = EmitInstruction(theCompiler,BC_JUMP,dst,NULL);
+      theCompiler->code[pc].target = BYTECODE_UNPATCHED;
+
+      theCompiler->code[falseJump].target = theCompiler->length;
+      CompileExpression(theCompiler,elsePart,dst);
+      if (! LiteralExpression(elsePart))
+        { EmitInstruction(theCompiler,BC_IF_RESULT,dst,theExpression); }
+     }
+
+   PatchJumps(theCompiler,start);
+  }
+
+/***************************************************
+  NAME         : CompileWhile
+  DESCRIPTION  : Compiles a while call
+  INPUTS       : 1) The compiler
+                 2) The call
+                 3) The destination register
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Instructions emitted
+  NOTES        : The condition and the body share
+                 a register, which holds the value
+                 returned by a return in either
+ ***************************************************/
+static void CompileWhile(
+  struct bytecodeCompiler *theCompiler,
+  Expression *theExpression,
+  unsigned short dst)
+  {
+   Expression *condition, *body;
+   unsigned short slot, result;
+   unsigned int start, top, pc;
+
+   condition = theExpression->argList;
+   body = condition->nextArg;
+   slot = BeginLoop(theCompiler);
+   result = (unsigned short) (dst + 1);
+
+   start = theCompiler->length;
+   pc = EmitInstruction(theCompiler,BC_GC_START,dst,theExpression);
+   theCompiler->code[pc].slot = slot;
+
+   CompileExpression(theCompiler,condition,result);
+
+   top = theCompiler->length;
+   pc = EmitInstruction(theCompiler,BC_WHILE_TEST,result,NULL);
+   theCompiler->code[pc].target = BYTECODE_UNPATCHED;
+   pc = EmitInstruction(theCompiler,BC_JUMP_FLAGS,result,NULL);
+   theCompiler->code[pc].target = BYTECODE_UNPATCHED;
+
+   CompileExpression(theCompiler,body,result);
+
+   pc = EmitInstruction(theCompiler,BC_JUMP_FLAGS,result,NULL);
+   theCompiler->code[pc].target = BYTECODE_UNPATCHED;
+   EmitInstruction(theCompiler,BC_CLEAN,result,NULL);
+
+   CompileExpression(theCompiler,condition,result);
+
+   pc = EmitInstruction(theCompiler,BC_JUMP,result,NULL);
+   theCompiler->code[pc].target = top;
+
+   PatchJumps(theCompiler,start);
+   pc = EmitInstruction(theCompiler,BC_LOOP_END,dst,theExpression);
+   RegisterOperand(&theCompiler->code[pc].a,body,result);
+   theCompiler->code[pc].slot = slot;
+
+   theCompiler->loopDepth--;
+  }
+
+/***************************************************
+  NAME         : CompileLoopForCount
+  DESCRIPTION  : Compiles a loop-for-count call
+  INPUTS       : 1) The compiler
+                 2) The call
+                 3) The destination register
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Instructions emitted
+  NOTES        : As in LoopForCountFunction, the
+                 loop counter is pushed before the
+                 range is evaluated, and the end of
+                 the range is left in the register
+                 which receives the body's value
+ ***************************************************/
+static void CompileLoopForCount(
+  struct bytecodeCompiler *theCompiler,
+  Expression *theExpression,
+  unsigned short dst)
+  {
+   Expression *first, *last, *body;
+   unsigned short slot, result;
+   unsigned int startCheck, endCheck, start, top, pc;
+
+   first = theExpression->argList;
+   last = first->nextArg;
+   body = last->nextArg;
+   slot = BeginLoop(theCompiler);
+   result = (unsigned short) (dst + 1);
+
+   pc = EmitInstruction(theCompiler,BC_LFC_BEGIN,dst,theExpression);
+   theCompiler->code[pc].slot = slot;
+
+   CompileExpression(theCompiler,first,result);
+   startCheck = EmitInstruction(theCompiler,BC_LFC_START,dst,theExpression);
+   RegisterOperand(&theCompiler->code[startCheck].a,first,result);
+   theCompiler->code[startCheck].position = 1;
+   theCompiler->code[startCheck].slot = slot;
+
+   CompileExpression(theCompiler,last,result);
+   endCheck = EmitInstruction(theCompiler,BC_LFC_LIMIT,dst,theExpression);
+   RegisterOperand(&theCompiler->code[endCheck].a,last,result);
+   theCompiler->code[endCheck].position = 2;
+   theCompiler->code[endCheck].slot = slot;
+
+   start = top = theCompiler->length;
+   pc = EmitInstruction(theCompiler,BC_LFC_TEST,result,NULL);
+   theCompiler->code[pc].slot = slot;
+   theCompiler->code[pc].target = BYTECODE_UNPATCHED;
+   pc = EmitInstruction(theCompiler,BC_JUMP_FLAGS,result,NULL);
+   theCompiler->code[pc].target = BYTECODE_UNPATCHED;
+
+   CompileExpression(theCompiler,body,result);
+
+   pc = EmitInstruction(theCompiler,BC_JUMP_FLAGS,result,NULL);
+   theCompiler->code[pc].target = BYTECODE_UNPATCHED;
+   EmitInstruction(theCompiler,BC_CLEAN,result,NULL);
+   pc = EmitInstruction(theCompiler,BC_LFC_NEXT,result,NULL);
+   theCompiler->code[pc].slot = slot;
+
+   pc = EmitInstruction(theCompiler,BC_JUMP,result,NULL);
+   theCompiler->code[pc].target = top;
+
+   PatchJumps(theCompiler,start);
+   pc = EmitInstruction(theCompiler,BC_LFC_END,dst,theExpression);
+   RegisterOperand(&theCompiler->code[pc].a,body,result);
+   theCompiler->code[pc].slot = slot;
+
+   theCompiler->code[startCheck].target = theCompiler->length;
+   theCompiler->code[endCheck].target = theCompiler->length;
+
+   theCompiler->loopDepth--;
+  }
+
+/***************************************************
+  NAME         : CompileBind
+  DESCRIPTION  : Compiles the binding of a local
+                 variable
+  INPUTS       : 1) The compiler
+                 2) The PROC_BIND expression
+                 3) The destination register
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Instructions emitted
+  NOTES        : Binding a multifield value formed
+                 from several arguments is left to
+                 PutProcBind
+ ***************************************************/
+static void CompileBind(
+  struct bytecodeCompiler *theCompiler,
+  Expression *theExpression,
+  unsigned short dst)
+  {
+   unsigned int pc;
+   unsigned short index;
+
+   index = (unsigned short) (*((int *) theExpression->bitMapValue->contents) - 1);
+
+   if (theExpression->argList == NULL)
+     { pc = EmitInstruction(theCompiler,BC_UNBIND,dst,theExpression); }
+   else if (theExpression->argList->nextArg != NULL)
+     {
+      EmitInstruction(theCompiler,BC_EVAL,dst,theExpression);
+      return;
+     }
+   else
+     {
+      CompileExpression(theCompiler,theExpression->argList,dst);
+      pc = EmitInstruction(theCompiler,BC_BIND,dst,theExpression);
+     }
+
+   theCompiler->code[pc].a.kind = BC_LOCAL;
+   theCompiler->code[pc].a.index = index;
+  }
+
+/***************************************************
+  NAME         : CompileBinaryOperation
+  DESCRIPTION  : Compiles a two argument call to
+                 an arithmetic or comparison
+                 function
+  INPUTS       : 1) The compiler
+                 2) The call
+                 3) The destination register
+                 4) The opcode
+                 5) A flag indicating if the result
+                    of +, - or * is left unboxed in
+                    the number register rather than
+                    the value register
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Instructions emitted
+  NOTES        : Constants, parameters, local
+                 variables and loop counters are
+                 read by the instruction itself. A
+                 local variable is only read in place
+                 if the second argument is too, since
+                 the second argument could rebind
+                 it. If the second argument has to be
+                 evaluated first, a numeric first
+                 argument is type checked before it
+                 is, as the function would.
+ ***************************************************/
+static void CompileBinaryOperation(
+  struct bytecodeCompiler *theCompiler,
+  Expression *theExpression,
+  unsigned short dst,
+  BytecodeOp op,
+  bool unboxed)
+  {
+   Expression *first, *second;
+   BYTECODE_OPERAND a, b;
+   bool secondDirect, numeric;
+   unsigned int pc, check;
+
+   first = theExpression->argList;
+   second = first->nextArg;
+   numeric = ((op != BC_EQ) && (op != BC_NEQ));
+   check = BYTECODE_UNPATCHED;
+
+   secondDirect = DirectOperand(second,&b);
+
+   if ((! DirectOperand(first,&a)) ||
+       ((a.kind == BC_LOCAL) && (! secondDirect)))
+     {
+      if (numeric)
+        { CompileNumericOperand(theCompiler,first,(unsigned short) (dst + 1),&a); }
+      else
+        {
+         CompileExpression(theCompiler,first,(unsigned short) (dst + 1));
+         RegisterOperand(&a,first,(unsigned short) (dst + 1));
+        }
+     }
+
+   if (! secondDirect)
+     {
+      if (numeric)
+        {
+         check = EmitInstruction(theCompiler,BC_CHECK_NUMBER,dst,theExpression);
+         theCompiler->code[check].a = a;
+         theCompiler->code[check].position = 1;
+         a.checked = true;
+         CompileNumericOperand(theCompiler,second,(unsigned short) (dst + 2),&b);
+        }
+      else
+        {
+         CompileExpression(theCompiler,second,(unsigned short) (dst + 2));
+         RegisterOperand(&b,second,(unsigned short) (dst + 2));
+        }
+     }
+
+   pc = EmitInstruction(theCompiler,op,dst,theExpression);
+   theCompiler->code[pc].a = a;
+   theCompiler->code[pc].b = b;
+   theCompiler->code[pc].unboxed = unboxed;
+
+   if (check != BYTECODE_UNPATCHED)
+     { theCompiler->code[check].target = theCompiler->length; }
+  }
+
+/***************************************************
+  NAME         : CompileNumericOperand
+  DESCRIPTION  : Compiles an argument of an
+                 arithmetic or comparison function
+                 which isn't read in place
+  INPUTS       : 1) The compiler
+                 2) The argument
+                 3) The register for its value
+                 4) The operand to set up
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Instructions emitted
+  NOTES        : The result of a nested two
+                 argument +, - or * is only ever
+                 used as a number, so it isn't
+                 converted to an integer or float
+                 value
+ ***************************************************/
+static void CompileNumericOperand(
+  struct bytecodeCompiler *theCompiler,
+  Expression *theExpression,
+  unsigned short reg,
+  BYTECODE_OPERAND *theOperand)
+  {
+   BytecodeOp op;
+
+   RegisterOperand(theOperand,theExpression,reg);
+
+   if ((theExpression->type == FCALL) &&
+       (CountArguments(theExpression->argList) == 2))
+     {
+      op = BinaryOperation(theExpression->functionValue);
+      if ((op == BC_ADD) || (op == BC_SUB) || (op == BC_MUL))
+        {
+         CompileBinaryOperation(theCompiler,theExpression,reg,op,true);
+         theOperand->kind = BC_NUMBER;
+         return;
+        }
+     }
+
+   CompileExpression(theCompiler,theExpression,reg);
+  }
+
+/***************************************************
+  NAME         : BinaryOperation
+  DESCRIPTION  : Determines the opcode for a two
+                 argument call to a function
+  INPUTS       : The function
+  RETURNS      : The opcode, BC_CALL if the
+                 function has none
+  SIDE EFFECTS : None
+  NOTES        : None
+ ***************************************************/
+static BytecodeOp BinaryOperation(
+  struct functionDefinition *theFunction)
+  {
+   void (*fptr)(Environment *,UDFContext *,UDFValue *) = theFunction->functionPointer;
+
+   if (fptr == AdditionFunction) return BC_ADD;
+   if (fptr == SubtractionFunction) return BC_SUB;
+   if (fptr == MultiplicationFunction) return BC_MUL;
+   if (fptr == NumericEqualFunction) return BC_NUM_EQ;
+   if (fptr == NumericNotEqualFunction) return BC_NUM_NE;
+   if (fptr == LessThanFunction) return BC_LT;
+   if (fptr == LessThanOrEqualFunction) return BC_LE;
+   if (fptr == GreaterThanFunction) return BC_GT;
+   if (fptr == GreaterThanOrEqualFunction) return BC_GE;
+   if (fptr == EqFunction) return BC_EQ;
+   if (fptr == NeqFunction) return BC_NEQ;
+
+   return BC_CALL;
+  }
+
+/***************************************************
+  NAME         : DirectOperand
+  DESCRIPTION  : Determines if an expression can
+                 be read in place by an instruction
+  INPUTS       : 1) The expression
+                 2) The operand to set up
+  RETURNS      : True if the expression is a
+                 constant, a parameter, a local
+                 variable or a loop counter,
+                 false otherwise
+  SIDE EFFECTS : Operand set
+  NOTES        : None
+ ***************************************************/
+static bool DirectOperand(
+  Expression *theExpression,
+  BYTECODE_OPERAND *theOperand)
+  {
+   Expression *depth;
+
+   theOperand->kind = BC_CONSTANT;
+   theOperand->index = 0;
+   theOperand->literal = false;
+   theOperand->checked = false;
+   theOperand->node = theExpression;
+
+   switch (theExpression->type)
+     {
+      case STRING_TYPE:
+      case SYMBOL_TYPE:
+      case FLOAT_TYPE:
+      case INTEGER_TYPE:
+      case INSTANCE_NAME_TYPE:
+        theOperand->literal = true;
+        return true;
+
+      case PROC_PARAM:
+        theOperand->kind = BC_PARAMETER;
+        theOperand->index = (unsigned short) (*((int *) theExpression->bitMapValue->contents) - 1);
+        return true;
+
+      case PROC_GET_BIND:
+        theOperand->kind = BC_LOCAL;
+        theOperand->index = (unsigned short) (((PACKED_PROC_VAR *) theExpression->bitMapValue->contents)->first - 1);
+        return true;
+
+      case FCALL:
+        depth = theExpression->argList;
+        if ((theExpression->functionValue->functionPointer == GetLoopCount) &&
+            (depth != NULL) && (depth->nextArg == NULL) &&
+            (depth->type == INTEGER_TYPE) &&
+            (depth->integerValue->contents >= 0) &&
+            (depth->integerValue->contents <= USHRT_MAX))
+          {
+           theOperand->kind = BC_COUNTER;
+           theOperand->index = (unsigned short) depth->integerValue->contents;
+           return true;
+          }
+        break;
+     }
+
+   return false;
+  }
+
+/***************************************************
+  NAME         : RegisterOperand
+  DESCRIPTION  : Sets up an operand which refers
+                 to the value of an expression
+                 evaluated into a register
+  INPUTS       : 1) The operand
+                 2) The expression
+                 3) The register
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Operand set
+  NOTES        : None
+ ***************************************************/
+static void RegisterOperand(
+  BYTECODE_OPERAND *theOperand,
+  Expression *theExpression,
+  unsigned short reg)
+  {
+   theOperand->kind = BC_REGISTER;
+   theOperand->index = reg;
+   theOperand->literal = LiteralExpression(theExpression);
+   theOperand->checked = false;
+   theOperand->node = theExpression;
+  }
+
+/***************************************************
+  NAME         : LiteralExpression
+  DESCRIPTION  : Determines if an argument is one
+                 whose value UDFNextArgument uses
+                 without evaluating it
+  INPUTS       : The expression
+  RETURNS      : True if it is, false otherwise
+  SIDE EFFECTS : None
+  NOTES        : The evaluation error flag isn't
+                 checked for these arguments
+ ***************************************************/
+static bool LiteralExpression(
+  Expression *theExpression)
+  {
+   switch (theExpression->type)
+     {
+      case STRING_TYPE:
+      case SYMBOL_TYPE:
+      case FLOAT_TYPE:
+      case INTEGER_TYPE:
+      case INSTANCE_NAME_TYPE:
+        return true;
+     }
+
+   return false;
+  }
+
+/***************************************************
+  NAME         : BeginLoop
+  DESCRIPTION  : Allocates the loop slot of a loop
+                 being compiled
+  INPUTS       : The compiler
+  RETURNS      : The slot
+  SIDE EFFECTS : Loop depth incremented
+  NOTES        : Loops which aren't nested share
+                 slots
+ ***************************************************/
+static unsigned short BeginLoop(
+  struct bytecodeCompiler *theCompiler)
+  {
+   unsigned short slot;
+
+   slot = theCompiler->loopDepth++;
+   if (theCompiler->loopDepth > theCompiler->loopCount)
+     { theCompiler->loopCount = theCompiler->loopDepth; }
+
+   return slot;
+  }
+
+/***************************************************
+  NAME         : LoopCount
+  DESCRIPTION  : Returns the value of a loop
+                 counter, as GetLoopCount does
+  INPUTS       : The depth of the loop
+  RETURNS      : The counter
+  SIDE EFFECTS : None
+  NOTES        : None
+ ***************************************************/
+static long long LoopCount(
+  Environment *theEnv,
+  unsigned short depth)
+  {
+   LOOP_COUNTER_STACK *tmpCounter;
+
+   tmpCounter = ProcedureFunctionData(theEnv)->LoopCounterStack;
+   while (depth > 0)
+     {
+      tmpCounter = tmpCounter->nxt;
+      depth--;
+     }
+
+   return tmpCounter->loopCounter;
+  }
+
+/***************************************************
+  NAME         : FetchValue
+  DESCRIPTION  : Returns the value of an operand
+  INPUTS       : 1) The registers
+                 2) The operand
+                 3) A buffer for values which
+                    aren't stored anywhere
+  RETURNS      : The value
+  SIDE EFFECTS : An unbound local variable is
+                 evaluated by GetProcBind
+  NOTES        : Unboxed numbers are only read by
+                 FetchNumber
+ ***************************************************/
+static UDFValue *FetchValue(
+  Environment *theEnv,
+  UDFValue *registers,
+  BYTECODE_OPERAND *theOperand,
+  UDFValue *temp)
+  {
+   UDFValue *src;
+
+   switch (theOperand->kind)
+     {
+      case BC_REGISTER:
+        return &registers[theOperand->index];
+
+      case BC_PARAMETER:
+        return &ProceduralPrimitiveData(theEnv)->ProcParamArray[theOperand->index];
+
+      case BC_LOCAL:
+        src = &ProceduralPrimitiveData(theEnv)->LocalVarArray[theOperand->index];
+        if (src->supplementalInfo == TrueSymbol(theEnv))
+          { return src; }
+        EvaluateExpression(theEnv,theOperand->node,temp);
+        return temp;
+
+      case BC_CONSTANT:
+        temp->value = theOperand->node->value;
+        break;
+
+      case BC_COUNTER:
+        temp->integerValue = CreateInteger(theEnv,LoopCount(theEnv,theOperand->index));
+        break;
+
+      case BC_NUMBER:
+        SystemError(theEnv,"BYTECODE",1);
+        ExitRouter(theEnv,EXIT_FAILURE);
+        break;
+     }
+
+   temp->begin = 0;
+   temp->range = SIZE_MAX;
+   return temp;
+  }
+
+/***************************************************
+  NAME         : FetchNumber
+  DESCRIPTION  : Returns the value of a numeric
+                 operand, checking its type as
+                 UDFNextArgument does
+  INPUTS       : 1) The registers
+                 2) The number registers
+                 3) The operand
+                 4) The call the operand belongs to
+                 5) The position of the argument
+                 6) The call's result
+                 7) A buffer for the number
+  RETURNS      : True if the operand is a number,
+                 false otherwise
+  SIDE EFFECTS : On an error, the call's error
+                 value is assigned to its result
+  NOTES        : None
+ ***************************************************/
+static bool FetchNumber(
+  Environment *theEnv,
+  UDFValue *registers,
+  struct bytecodeNumber *numbers,
+  BYTECODE_OPERAND *theOperand,
+  Expression *call,
+  unsigned short position,
+  UDFValue *returnValue,
+  struct bytecodeNumber *theNumber)
+  {
+   UDFValue temp, *theValue;
+
+   if ((theOperand->kind == BC_COUNTER) || (theOperand->kind == BC_NUMBER))
+     {
+      if ((! theOperand->checked) && EvaluationData(theEnv)->EvaluationError)
+        {
+         AssignCallErrorValue(theEnv,call,returnValue);
+         return false;
+        }
+      if (theOperand->kind == BC_NUMBER)
+        { *theNumber = numbers[theOperand->index]; }
+      else
+        {
+         theNumber->integer = true;
+         theNumber->ivalue = LoopCount(theEnv,theOperand->index);
+         theNumber->fvalue = (double) theNumber->ivalue;
+        }
+      return true;
+     }
+
+   theValue = FetchValue(theEnv,registers,theOperand,&temp);
+   if ((! theOperand->checked) &&
+       (! CheckArgument(theEnv,theValue,theOperand->literal,NUMBER_BITS,call,position)))
+     {
+      AssignCallErrorValue(theEnv,call,returnValue);
+      return false;
+     }
+
+   if (theValue->header->type == INTEGER_TYPE)
+     {
+      theNumber->integer = true;
+      theNumber->ivalue = theValue->integerValue->contents;
+      theNumber->fvalue = (double) theNumber->ivalue;
+     }
+   else
+     {
+      theNumber->integer = false;
+      theNumber->fvalue = theValue->floatValue->contents;
+     }
+
+   return true;
+  }
+
+/***************************************************
+  NAME         : CheckArgument
+  DESCRIPTION  : Checks an evaluated argument as
+                 UDFNextArgument does
+  INPUTS       : 1) The value of the argument
+                 2) A flag indicating if the
+                    argument is a literal
+                 3) The expected type bits (only
+                    INTEGER_BIT and FLOAT_BIT are
+                    supported)
+                 4) The call the argument belongs to
+                 5) The position of the argument
+  RETURNS      : True if the argument is valid,
+                 false otherwise
+  SIDE EFFECTS : A type error is reported and
+                 execution is halted
+  NOTES        : None
+ ***************************************************/
+static bool CheckArgument(
+  Environment *theEnv,
+  UDFValue *theValue,
+  bool literal,
+  unsigned expectedType,
+  Expression *call,
+  unsigned short position)
+  {
+   unsigned short type = theValue->header->type;
+
+   if (((type == INTEGER_TYPE) && (expectedType & INTEGER_BIT)) ||
+       ((type == FLOAT_TYPE) && (expectedType & FLOAT_BIT)))
+     { return (literal || (! EvaluationData(theEnv)->EvaluationError)); }
+
+   ExpectedTypeError0(theEnv,call->functionValue->callFunctionName->contents,position);
+   PrintTypesString(theEnv,STDERR,expectedType,true);
+   SetHaltExecution(theEnv,true);
+   SetEvaluationError(theEnv,true);
+   return false;
+  }
+
+/***************************************************
+  NAME         : AssignCallErrorValue
+  DESCRIPTION  : Assigns the error value of a
+                 function to its result
+  INPUTS       : 1) The call
+                 2) The result
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Result set
+  NOTES        : None
+ ***************************************************/
+static void AssignCallErrorValue(
+  Environment *theEnv,
+  Expression *call,
+  UDFValue *returnValue)
+  {
+   UDFContext theUDFContext;
+
+   theUDFContext.environment = theEnv;
+   theUDFContext.context = call->functionValue->context;
+   theUDFContext.theFunction = call->functionValue;
+   theUDFContext.lastArg = NULL;
+   theUDFContext.lastPosition = 1;
+   theUDFContext.returnValue = returnValue;
+   AssignErrorValue(&theUDFContext);
+  }
+
+/***************************************************
+  NAME         : Arithmetic
+  DESCRIPTION  : Computes the result of +, - or *
+                 for two numbers
+  INPUTS       : 1) The opcode
+                 2) The first number
+                 3) The second number
+                 4) A buffer for the result (can
+                    be one of the numbers)
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Result set
+  NOTES        : The running totals are kept as
+                 AdditionFunction, SubtractionFunction
+                 and MultiplicationFunction keep them
+                 so that float results are identical.
+                 Integer overflow wraps around.
+ ***************************************************/
+static void Arithmetic(
+  BytecodeOp op,
+  struct bytecodeNumber *n1,
+  struct bytecodeNumber *n2,
+  struct bytecodeNumber *result)
+  {
+   unsigned long long u1, u2, ltotal;
+   double ftotal;
+
+   if (n1->integer && n2->integer)
+     {
+      u1 = (unsigned long long) n1->ivalue;
+      u2 = (unsigned long long) n2->ivalue;
+      if (op == BC_ADD)
+        { ltotal = u1 + u2; }
+      else if (op == BC_SUB)
+        { ltotal = u1 - u2; }
+      else
+        { ltotal = u1 * u2; }
+      result->integer = true;
+      result->ivalue = (long long) ltotal;
+      result->fvalue = (double) result->ivalue;
+      return;
+     }
+
+   if (op == BC_ADD)
+     {
+      if (n1->integer)
+        { ftotal = (double) n1->ivalue + n2->fvalue; }
+      else
+        {
+         ftotal = 0.0 + n1->fvalue;
+         ftotal += n2->fvalue;
+        }
+     }
+   else if (op == BC_SUB)
+     {
+      if (n1->integer)
+        { ftotal = (double) n1->ivalue - n2->fvalue; }
+      else
+        {
+         ftotal = n1->fvalue;
+         ftotal -= n2->fvalue;
+        }
+     }
+   else
+     {
+      if (n1->integer)
+        { ftotal = (double) n1->ivalue * n2->fvalue; }
+      else
+        {
+         ftotal = 1.0 * n1->fvalue;
+         ftotal *= n2->fvalue;
+        }
+     }
+
+   result->integer = false;
+   result->fvalue = ftotal;
+  }
+
+/***************************************************
+  NAME         : CompareNumbers
+  DESCRIPTION  : Compares two numbers as the
+                 numeric comparison functions do
+  INPUTS       : 1) The opcode
+                 2) The first number
+                 3) The second number
+  RETURNS      : The result of the comparison
+  SIDE EFFECTS : None
+  NOTES        : Each test is written the way its
+                 function tests for FALSE so that
+                 comparisons with NaN agree
+ ***************************************************/
+static bool CompareNumbers(
+  BytecodeOp op,
+  struct bytecodeNumber *n1,
+  struct bytecodeNumber *n2)
+  {
+   if (n1->integer && n2->integer)
+     {
+      switch (op)
+        {
+         case BC_NUM_EQ: return ! (n1->ivalue != n2->ivalue);
+         case BC_NUM_NE: return ! (n1->ivalue == n2->ivalue);
+         case BC_LT: return ! (n1->ivalue >= n2->ivalue);
+         case BC_LE: return ! (n1->ivalue > n2->ivalue);
+         case BC_GT: return ! (n1->ivalue <= n2->ivalue);
+         default: return ! (n1->ivalue < n2->ivalue);
+        }
+     }
+
+   switch (op)
+     {
+      case BC_NUM_EQ: return ! (n1->fvalue != n2->fvalue);
+      case BC_NUM_NE: return ! (n1->fvalue == n2->fvalue);
+      case BC_LT: return ! (n1->fvalue >= n2->fvalue);
+      case BC_LE: return ! (n1->fvalue > n2->fvalue);
+      case BC_GT: return ! (n1->fvalue <= n2->fvalue);
+      default: return ! (n1->fvalue < n2->fvalue);
+     }
+  }
+
+/***************************************************
+  NAME         : CompareValues
+  DESCRIPTION  : Compares two values as eq does
+  INPUTS       : The values
+  RETURNS      : True if they are the same,
+                 false otherwise
+  SIDE EFFECTS : None
+  NOTES        : None
+ ***************************************************/
+static bool CompareValues(
+  UDFValue *v1,
+  UDFValue *v2)
+  {
+   if (v1->header->type != v2->header->type)
+     { return false; }
+
+   if (v1->header->type == MULTIFIELD_TYPE)
+     { return MultifieldDOsEqual(v1,v2); }
+
+   return (v1->value == v2->value);
+  }
+
+/***************************************************
+  NAME         : PopLoopCounter
+  DESCRIPTION  : Removes the counter of a
+                 loop-for-count
+  INPUTS       : The loop slot
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Counter deallocated
+  NOTES        : None
+ ***************************************************/
+static void PopLoopCounter(
+  Environment *theEnv,
+  struct bytecodeLoop *theLoop)
+  {
+   ProcedureFunctionData(theEnv)->LoopCounterStack = theLoop->counter->nxt;
+   rtn_struct(theEnv,loopCounterStack,theLoop->counter);
+  }
+
+#endif /* DEFFUNCTION_CONSTRUCT || OBJECT_SYSTEM */
@@ -0,0 +1,124 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  08/25/16            */
+   /*                                                     */
+   /*         PROCEDURAL CODE BYTECODE HEADER FILE        */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Compiles the bodies of deffunctions and          */
+/*   message-handlers to a register based bytecode and       */
+/*   executes it.                                            */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_bytecode
+
+#pragma once
+
+#define _H_bytecode
+
+#include "evaluatn.h"
+#include "expressn.h"
+
+#define BYTECODE_FRAME_REGISTERS 16
+#define BYTECODE_FRAME_LOOPS 4
+
+typedef enum
+  {
+   BC_LOADK,
+   BC_LOAD_PARAM,
+   BC_LOAD_LOCAL,
+   BC_LOAD_COUNT,
+   BC_CALL,
+   BC_EVAL,
+   BC_BIND,
+   BC_UNBIND,
+   BC_ADD,
+   BC_SUB,
+   BC_MUL,
+   BC_NUM_EQ,
+   BC_NUM_NE,
+   BC_LT,
+   BC_LE,
+   BC_GT,
+   BC_GE,
+   BC_EQ,
+   BC_NEQ,
+   BC_CHECK_NUMBER,
+   BC_JUMP,
+   BC_JUMP_FALSE,
+   BC_JUMP_HALT,
+   BC_JUMP_FLAGS,
+   BC_HALT_FALSE,
+   BC_IF_CONDITION,
+   BC_IF_RESULT,
+   BC_GC_START,
+   BC_WHILE_TEST,
+   BC_CLEAN,
+   BC_LOOP_END,
+   BC_LFC_BEGIN,
+   BC_LFC_START,
+   BC_LFC_LIMIT,
+   BC_LFC_TEST,
+   BC_LFC_NEXT,
+   BC_LFC_END
+  } BytecodeOp;
+
+typedef enum
+  {
+   BC_REGISTER,
+   BC_PARAMETER,
+   BC_LOCAL,
+   BC_CONSTANT,
+   BC_COUNTER,
+   BC_NUMBER
+  } BytecodeOperandKind;
+
+/* ==============================================
+   An operand of an arithmetic or comparison
+   instruction which is read in place rather than
+   first being evaluated into a register
+   ============================================== */
+typedef struct bytecodeOperand
+  {
+   BytecodeOperandKind kind;
+   unsigned short index;
+   bool literal;
+   bool checked;
+   Expression *node;
+  } BYTECODE_OPERAND;
+
+typedef struct bytecodeInstruction
+  {
+   BytecodeOp op;
+   unsigned short dst;
+   unsigned short slot;
+   unsigned short position;
+   bool literal;
+   bool unboxed;
+   unsigned int target;
+   Expression *node;
+   BYTECODE_OPERAND a;
+   BYTECODE_OPERAND b;
+  } BYTECODE_INSTRUCTION;
+
+struct procBytecode
+  {
+   BYTECODE_INSTRUCTION *code;
+   unsigned int length;
+   unsigned short registerCount;
+   unsigned short loopCount;
+  };
+
+   void                           BytecodeCommandDefinitions(Environment *);
+   bool                           GetBytecodeCompilation(Environment *);
+   bool                           SetBytecodeCompilation(Environment *,bool);
+   void                           GetBytecodeCompilationCommand(Environment *,UDFContext *,UDFValue *);
+   void                           SetBytecodeCompilationCommand(Environment *,UDFContext *,UDFValue *);
+   struct procBytecode           *CompileProcBytecode(Environment *,Expression *);
+   bool                           ExecuteProcBytecode(Environment *,struct procBytecode *,UDFValue *);
+   void                           ReturnProcBytecode(Environment *,struct procBytecode *);
+
+#endif /* _H_bytecode */
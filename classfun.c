@@ -69,6 +69,7 @@
 #include "bload.h"
 #endif
 
+#include "bytecode.h"
 #include "classcom.h"
 #include "classini.h"
 #include "constant.h"
@@ -77,6 +78,9 @@
 #include "cstrcpsr.h"
 #include "envrnmnt.h"
 #include "evaluatn.h"
+#if DEFGENERIC_CONSTRUCT
+#include "genrcexe.h"
+#endif
 #include "inscom.h"
 #include "insfun.h"
 #include "insmngr.h"
@@ -747,6 +751,12 @@ void RemoveDefclass(
    DefmessageHandler *hnd;
    unsigned long i;
 
+   FlushHandlerChainCache(theEnv);
+   InvalidateSlotAccessCache(theEnv);
+#if DEFGENERIC_CONSTRUCT
+   InvalidateGenericDispatchCache(theEnv);
+#endif
+
    /* ====================================================
       Remove all of this class's superclasses' links to it
       ==================================================== */
@@ -793,6 +803,7 @@ void RemoveDefclass(
    for (i = 0 ; i < cls->handlerCount ; i++)
      {
       hnd = &cls->handlers[i];
+      ReturnProcBytecode(theEnv,hnd->bytecode);
       if (hnd->actions != NULL)
         ReturnPackedExpression(theEnv,hnd->actions);
       if (hnd->header.ppForm != NULL)
@@ -864,6 +875,7 @@ void DestroyDefclass(
    for (i = 0 ; i < cls->handlerCount ; i++)
      {
       hnd = &cls->handlers[i];
+      ReturnProcBytecode(theEnv,hnd->bytecode);
       if (hnd->actions != NULL)
         ReturnPackedExpression(theEnv,hnd->actions);
 
@@ -553,6 +553,13 @@ void Reset(
    GCBlockEnd(theEnv,&gcb);
    CallPeriodicTasks(theEnv);
 
+   /*==============================================*/
+   /* Give the slabs emptied by the removal of the */
+   /* old facts and partial matches back at once.  */
+   /*==============================================*/
+
+   ReleaseSlabs(theEnv);
+
    /*===================================*/
    /* A reset is no longer in progress. */
    /*===================================*/
@@ -81,6 +81,7 @@
 
 #if DEVELOPER
 
+   static void                    CountProbeDistances(struct atomTable *,unsigned long long *);
 #if DEFRULE_CONSTRUCT && OBJECT_SYSTEM
    static void                    PrintOPNLevel(Environment *,OBJECT_PATTERN_NODE *,char *,int);
 #endif
@@ -122,73 +123,28 @@ void PrimitiveTablesInfoCommand(
   UDFContext *context,
   UDFValue *returnValue)
   {
-   unsigned long i;
-   CLIPSLexeme **symbolArray, *symbolPtr;
-   CLIPSFloat **floatArray, *floatPtr;
-   CLIPSInteger **integerArray, *integerPtr;
-   CLIPSBitMap **bitMapArray, *bitMapPtr;
-   unsigned long long symbolCount = 0, integerCount = 0;
-   unsigned long long floatCount = 0, bitMapCount = 0;
-
-   /*====================================*/
-   /* Count entries in the symbol table. */
-   /*====================================*/
-
-   symbolArray = GetSymbolTable(theEnv);
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
-     {
-      for (symbolPtr = symbolArray[i]; symbolPtr != NULL; symbolPtr = symbolPtr->next)
-        { symbolCount++; }
-     }
-
-   /*====================================*/
-   /* Count entries in the integer table. */
-   /*====================================*/
-
-   integerArray = GetIntegerTable(theEnv);
-   for (i = 0; i < INTEGER_HASH_SIZE; i++)
-     {
-      for (integerPtr = integerArray[i]; integerPtr != NULL; integerPtr = integerPtr->next)
-        { integerCount++; }
-     }
-
-   /*====================================*/
-   /* Count entries in the float table. */
-   /*====================================*/
+   size_t position = 0;
+   unsigned long long integerCount = 0;
 
-   floatArray = GetFloatTable(theEnv);
-   for (i = 0; i < FLOAT_HASH_SIZE; i++)
-     {
-      for (floatPtr = floatArray[i]; floatPtr != NULL; floatPtr = floatPtr->next)
-        { floatCount++; }
-     }
+   /*==================================================*/
+   /* The atom tables keep a count of the entries, but */
+   /* small integers are kept outside of the table.    */
+   /*==================================================*/
 
-   /*====================================*/
-   /* Count entries in the bitmap table. */
-   /*====================================*/
-
-   bitMapArray = GetBitMapTable(theEnv);
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
-     {
-      for (bitMapPtr = bitMapArray[i]; bitMapPtr != NULL; bitMapPtr = bitMapPtr->next)
-        { bitMapCount++; }
-     }
-
-   /*========================*/
-   /* Print the information. */
-   /*========================*/
+   while (GetNextInteger(theEnv,&position) != NULL)
+     { integerCount++; }
 
    WriteString(theEnv,STDOUT,"Symbols: ");
-   PrintUnsignedInteger(theEnv,STDOUT,symbolCount);
+   PrintUnsignedInteger(theEnv,STDOUT,GetSymbolTable(theEnv)->count);
    WriteString(theEnv,STDOUT,"\n");
    WriteString(theEnv,STDOUT,"Integers: ");
    PrintUnsignedInteger(theEnv,STDOUT,integerCount);
    WriteString(theEnv,STDOUT,"\n");
    WriteString(theEnv,STDOUT,"Floats: ");
-   PrintUnsignedInteger(theEnv,STDOUT,floatCount);
+   PrintUnsignedInteger(theEnv,STDOUT,GetFloatTable(theEnv)->count);
    WriteString(theEnv,STDOUT,"\n");
    WriteString(theEnv,STDOUT,"BitMaps: ");
-   PrintUnsignedInteger(theEnv,STDOUT,bitMapCount);
+   PrintUnsignedInteger(theEnv,STDOUT,GetBitMapTable(theEnv)->count);
    WriteString(theEnv,STDOUT,"\n");
   }
 
@@ -196,7 +152,9 @@ void PrimitiveTablesInfoCommand(
 
 /*********************************************************/
 /* PrimitiveTablesUsageCommand: Prints information about */
-/*   the symbol, float, integer, and bitmap tables.      */
+/*   the symbol and float tables. For each table, the    */
+/*   number of entries found at each probe distance from */
+/*   their home slot is listed.                          */
 /*********************************************************/
 void PrimitiveTablesUsageCommand(
   Environment *theEnv,
@@ -205,64 +163,27 @@ void PrimitiveTablesUsageCommand(
   {
    unsigned long i;
    unsigned long long symbolCounts[COUNT_SIZE], floatCounts[COUNT_SIZE];
-   CLIPSLexeme **symbolArray, *symbolPtr;
-   CLIPSFloat **floatArray, *floatPtr;
-   unsigned long long symbolCount, totalSymbolCount = 0;
-   unsigned long long floatCount, totalFloatCount = 0;
-
-   for (i = 0; i < 21; i++)
-     {
-      symbolCounts[i] = 0;
-      floatCounts[i] = 0;
-     }
-
-   /*====================================*/
-   /* Count entries in the symbol table. */
-   /*====================================*/
-
-   symbolArray = GetSymbolTable(theEnv);
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
-     {
-      symbolCount = 0;
-      for (symbolPtr = symbolArray[i]; symbolPtr != NULL; symbolPtr = symbolPtr->next)
-        {
-         symbolCount++;
-         totalSymbolCount++;
-        }
-
-      if (symbolCount < (COUNT_SIZE - 1))
-        { symbolCounts[symbolCount]++; }
-      else
-        { symbolCounts[COUNT_SIZE - 1]++; }
-     }
+   struct atomTable *symbolTable, *floatTable;
 
-   /*===================================*/
-   /* Count entries in the float table. */
-   /*===================================*/
+   /*=======================================*/
+   /* Count probe distances in both tables. */
+   /*=======================================*/
 
-   floatArray = GetFloatTable(theEnv);
-   for (i = 0; i < FLOAT_HASH_SIZE; i++)
-     {
-      floatCount = 0;
-      for (floatPtr = floatArray[i]; floatPtr != NULL; floatPtr = floatPtr->next)
-        {
-         floatCount++;
-         totalFloatCount++;
-        }
+   symbolTable = GetSymbolTable(theEnv);
+   floatTable = GetFloatTable(theEnv);
 
-      if (floatCount < (COUNT_SIZE - 1))
-        { floatCounts[floatCount]++; }
-      else
-        { floatCounts[COUNT_SIZE - 1]++; }
-     }
+   CountProbeDistances(symbolTable,symbolCounts);
+   CountProbeDistances(floatTable,floatCounts);
 
    /*========================*/
    /* Print the information. */
    /*========================*/
 
    WriteString(theEnv,STDOUT,"Total Symbols: ");
-   PrintUnsignedInteger(theEnv,STDOUT,totalSymbolCount);
-   WriteString(theEnv,STDOUT,"\n");
+   PrintUnsignedInteger(theEnv,STDOUT,symbolTable->count);
+   WriteString(theEnv,STDOUT," (");
+   PrintUnsignedInteger(theEnv,STDOUT,symbolTable->size);
+   WriteString(theEnv,STDOUT," slots)\n");
    for (i = 0; i < COUNT_SIZE; i++)
      {
       PrintUnsignedInteger(theEnv,STDOUT,i);
@@ -272,8 +193,10 @@ void PrimitiveTablesUsageCommand(
      }
 
    WriteString(theEnv,STDOUT,"\nTotal Floats: ");
-   PrintUnsignedInteger(theEnv,STDOUT,totalFloatCount);
-   WriteString(theEnv,STDOUT,"\n");
+   PrintUnsignedInteger(theEnv,STDOUT,floatTable->count);
+   WriteString(theEnv,STDOUT," (");
+   PrintUnsignedInteger(theEnv,STDOUT,floatTable->size);
+   WriteString(theEnv,STDOUT," slots)\n");
    for (i = 0; i < COUNT_SIZE; i++)
      {
       PrintUnsignedInteger(theEnv,STDOUT,i);
@@ -284,6 +207,34 @@ void PrimitiveTablesUsageCommand(
 
   }
 
+/*****************************************************/
+/* CountProbeDistances: Tallies the entries of an    */
+/*   atom table by their distance from the slot at   */
+/*   which probing for them begins. Distances beyond */
+/*   the last count are tallied in the last count.   */
+/*****************************************************/
+static void CountProbeDistances(
+  struct atomTable *theTable,
+  unsigned long long *counts)
+  {
+   size_t i, distance;
+
+   for (i = 0; i < COUNT_SIZE; i++)
+     { counts[i] = 0; }
+
+   for (i = 0; i < theTable->size; i++)
+     {
+      if (theTable->slots[i].value == NULL) continue;
+
+      distance = (i - AtomTableHome(theTable,theTable->slots[i].hashValue)) & (theTable->size - 1);
+
+      if (distance < (COUNT_SIZE - 1))
+        { counts[distance]++; }
+      else
+        { counts[COUNT_SIZE - 1]++; }
+     }
+  }
+
 #if DEFRULE_CONSTRUCT && DEFTEMPLATE_CONSTRUCT
 
 /******************************************************/
@@ -42,6 +42,7 @@
 
 #include "bload.h"
 #include "bsave.h"
+#include "bytecode.h"
 #include "cstrcbin.h"
 #include "cstrccom.h"
 #include "envrnmnt.h"
@@ -72,6 +73,7 @@ typedef struct bsaveDeffunctionStruct
    unsigned short minNumberOfParameters;
    unsigned short maxNumberOfParameters;
    unsigned short numberOfLocalVars;
+   unsigned long version;
    unsigned long name;
    unsigned long code;
   } BSAVE_DEFFUNCTION;
@@ -136,8 +138,12 @@ static void DeallocateDeffunctionBloadData(
   Environment *theEnv)
   {
    size_t space;
-
 #if (BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE) && (! RUN_TIME)
+   unsigned long i;
+
+   for (i = 0 ; i < DeffunctionBinaryData(theEnv)->DeffunctionCount ; i++)
+     { ReturnProcBytecode(theEnv,DeffunctionBinaryData(theEnv)->DeffunctionArray[i].bytecode); }
+
    space = DeffunctionBinaryData(theEnv)->DeffunctionCount * sizeof(Deffunction);
    if (space != 0) genfree(theEnv,DeffunctionBinaryData(theEnv)->DeffunctionArray,space);
 
@@ -348,6 +354,7 @@ static void BsaveDeffunction(
    dummy_df.minNumberOfParameters = dptr->minNumberOfParameters;
    dummy_df.maxNumberOfParameters = dptr->maxNumberOfParameters;
    dummy_df.numberOfLocalVars = dptr->numberOfLocalVars;
+   dummy_df.version = dptr->version;
    if (dptr->code != NULL)
      {
       dummy_df.code = ExpressionData(theEnv)->ExpressionCount;
@@ -473,6 +480,7 @@ static void UpdateDeffunction(
                          sizeof(Deffunction),DeffunctionBinaryData(theEnv)->DeffunctionArray);
 
    dptr->code = ExpressionPointer(bdptr->code);
+   dptr->bytecode = NULL;
    dptr->busy = 0;
    dptr->executing = 0;
 #if DEBUGGING_FUNCTIONS
@@ -481,6 +489,7 @@ static void UpdateDeffunction(
    dptr->minNumberOfParameters = bdptr->minNumberOfParameters;
    dptr->maxNumberOfParameters = bdptr->maxNumberOfParameters;
    dptr->numberOfLocalVars = bdptr->numberOfLocalVars;
+   dptr->version = bdptr->version;
   }
 
 /***************************************************************
@@ -507,7 +516,10 @@ static void ClearDeffunctionBload(
    DeffunctionBinaryData(theEnv)->ModuleCount = 0L;
 
    for (i = 0 ; i < DeffunctionBinaryData(theEnv)->DeffunctionCount ; i++)
-     UnmarkConstructHeader(theEnv,&DeffunctionBinaryData(theEnv)->DeffunctionArray[i].header);
+     {
+      UnmarkConstructHeader(theEnv,&DeffunctionBinaryData(theEnv)->DeffunctionArray[i].header);
+      ReturnProcBytecode(theEnv,DeffunctionBinaryData(theEnv)->DeffunctionArray[i].bytecode);
+     }
    space = (sizeof(Deffunction) * DeffunctionBinaryData(theEnv)->DeffunctionCount);
    if (space == 0)
      return;
@@ -367,10 +367,11 @@ static void SingleDeffunctionToCode(
       ========================= */
    fprintf(theFile,",0,0,0,");
    ExpressionToCode(theEnv,theFile,theDeffunction->code);
-   fprintf(theFile,",%d,%d,%d",
+   fprintf(theFile,",%d,%d,%d,%luL,NULL",
            theDeffunction->minNumberOfParameters,
            theDeffunction->maxNumberOfParameters,
-           theDeffunction->numberOfLocalVars);
+           theDeffunction->numberOfLocalVars,
+           theDeffunction->version);
 
    fprintf(theFile,"}");
   }
@@ -152,9 +152,9 @@ void CallDeffunction(
                 ProfileFunctionData(theEnv)->ProfileConstructs);
 #endif
 
-   EvaluateProcActions(theEnv,dptr->header.whichModule->theModule,
-                       dptr->code,dptr->numberOfLocalVars,
-                       returnValue,UnboundDeffunctionErr);
+   EvaluateCompiledProcActions(theEnv,dptr->header.whichModule->theModule,
+                               dptr->code,&dptr->bytecode,dptr->numberOfLocalVars,
+                               returnValue,UnboundDeffunctionErr);
 
 #if PROFILING_FUNCTIONS
     EndProfile(theEnv,&profileFrame);
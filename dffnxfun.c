@@ -70,6 +70,8 @@
                EXTERNAL DEFINITIONS
    =========================================
    ***************************************** */
+#include <limits.h>
+
 #include "setup.h"
 
 #if DEFFUNCTION_CONSTRUCT
@@ -102,7 +104,12 @@
 #include "watch.h"
 #endif
 
+#if PROFILING_FUNCTIONS
+#include "proflfun.h"
+#endif
+
 #include "argacces.h"
+#include "bytecode.h"
 #include "cstrccom.h"
 #include "memalloc.h"
 #include "modulutl.h"
@@ -123,6 +130,7 @@
    static void                    DecrementDeffunctionBusyCount(Environment *,Deffunction *);
    static void                    IncrementDeffunctionBusyCount(Environment *,Deffunction *);
    static void                    DeallocateDeffunctionData(Environment *);
+   static void                    InlineDeffunctionFunction(Environment *,UDFContext *,UDFValue *);
 
 #if ! RUN_TIME
    static void                    DestroyDeffunctionAction(Environment *,ConstructHeader *,void *);
@@ -238,6 +246,9 @@ void SetupDeffunctions(
 
    AddUDF(theEnv,"get-deffunction-list","m",0,1,"y",GetDeffunctionListFunction,"GetDeffunctionListFunction",NULL);
    AddUDF(theEnv,"deffunction-module","y",1,1,"y",GetDeffunctionModuleCommand,"GetDeffunctionModuleCommand",NULL);
+   AddUDF(theEnv,"get-deffunction-inline-limit","l",0,0,NULL,GetDeffunctionInlineLimitCommand,"GetDeffunctionInlineLimitCommand",NULL);
+   AddUDF(theEnv,"set-deffunction-inline-limit","l",1,1,"l",SetDeffunctionInlineLimitCommand,"SetDeffunctionInlineLimitCommand",NULL);
+   AddUDF(theEnv,"(inline-deffunction)","*",3,3,NULL,InlineDeffunctionFunction,"InlineDeffunctionFunction",NULL);
 
 #if BLOAD_AND_BSAVE || BLOAD || BLOAD_ONLY
    SetupDeffunctionsBload(theEnv);
@@ -309,6 +320,7 @@ static void DestroyDeffunctionAction(
 
    if (theDeffunction == NULL) return;
 
+   ReturnProcBytecode(theEnv,theDeffunction->bytecode);
    ReturnPackedExpression(theEnv,theDeffunction->code);
 
    DestroyConstructHeader(theEnv,&theDeffunction->header);
@@ -503,6 +515,7 @@ void RemoveDeffunction(
      return;
    ReleaseLexeme(theEnv,GetDeffunctionNamePointer(theEnv,theDeffunction));
    ExpressionDeinstall(theEnv,theDeffunction->code);
+   ReturnProcBytecode(theEnv,theDeffunction->bytecode);
    ReturnPackedExpression(theEnv,theDeffunction->code);
    SetDeffunctionPPForm(theEnv,theDeffunction,NULL);
    ClearUserDataList(theEnv,theDeffunction->header.usrData);
@@ -543,6 +556,91 @@ void GetDeffunctionModuleCommand(
    returnValue->value = GetConstructModuleCommand(context,"deffunction-module",DeffunctionData(theEnv)->DeffunctionConstruct);
   }
 
+/*****************************************************
+  NAME         : GetDeffunctionInlineLimit
+  DESCRIPTION  : Returns the largest deffunction body
+                 (in expression nodes) which is
+                 substituted into its call sites
+  INPUTS       : None
+  RETURNS      : The limit, 0 if inlining is disabled
+  SIDE EFFECTS : None
+  NOTES        : None
+ *****************************************************/
+unsigned short GetDeffunctionInlineLimit(
+  Environment *theEnv)
+  {
+   return DeffunctionData(theEnv)->InlineLimit;
+  }
+
+/*****************************************************
+  NAME         : SetDeffunctionInlineLimit
+  DESCRIPTION  : Sets the largest deffunction body
+                 (in expression nodes) which is
+                 substituted into its call sites
+  INPUTS       : The new limit, 0 to disable inlining
+  RETURNS      : The old limit
+  SIDE EFFECTS : Calls parsed from now on are
+                 candidates for inlining
+  NOTES        : Calls which have already been parsed
+                 are not affected
+ *****************************************************/
+unsigned short SetDeffunctionInlineLimit(
+  Environment *theEnv,
+  unsigned short limit)
+  {
+   unsigned short oldLimit;
+
+   oldLimit = DeffunctionData(theEnv)->InlineLimit;
+   DeffunctionData(theEnv)->InlineLimit = limit;
+   return oldLimit;
+  }
+
+/****************************************************************
+  NAME         : GetDeffunctionInlineLimitCommand
+  DESCRIPTION  : H/L access to GetDeffunctionInlineLimit
+  INPUTS       : None
+  RETURNS      : The current limit
+  SIDE EFFECTS : None
+  NOTES        : H/L Syntax: (get-deffunction-inline-limit)
+ ****************************************************************/
+void GetDeffunctionInlineLimitCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   returnValue->integerValue = CreateInteger(theEnv,GetDeffunctionInlineLimit(theEnv));
+  }
+
+/****************************************************************
+  NAME         : SetDeffunctionInlineLimitCommand
+  DESCRIPTION  : H/L access to SetDeffunctionInlineLimit
+  INPUTS       : None
+  RETURNS      : The old limit
+  SIDE EFFECTS : Inline limit set
+  NOTES        : H/L Syntax: (set-deffunction-inline-limit <int>)
+ ****************************************************************/
+void SetDeffunctionInlineLimitCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+   long long limit;
+
+   if (! UDFFirstArgument(context,INTEGER_BIT,&theArg))
+     { return; }
+
+   limit = theArg.integerValue->contents;
+   if ((limit < 0) || (limit > USHRT_MAX))
+     {
+      UDFInvalidArgumentMessage(context,"integer from 0 to 65535");
+      returnValue->integerValue = CreateInteger(theEnv,GetDeffunctionInlineLimit(theEnv));
+      return;
+     }
+
+   returnValue->integerValue = CreateInteger(theEnv,SetDeffunctionInlineLimit(theEnv,(unsigned short) limit));
+  }
+
 #if DEBUGGING_FUNCTIONS
 
 /****************************************************
@@ -742,6 +840,51 @@ static bool EvaluateDeffunctionCall(
    return true;
   }
 
+/***************************************************
+  NAME         : InlineDeffunctionFunction
+  DESCRIPTION  : Evaluates a deffunction call whose
+                 body was substituted into the call
+                 site when it was parsed
+  INPUTS       : Caller's result buffer
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Inlined body evaluated, or the
+                 deffunction called normally if it
+                 has been redefined since the call
+                 was parsed (or is being watched or
+                 profiled)
+  NOTES        : H/L Syntax:
+                 ((inline-deffunction) <call>
+                                       <version>
+                                       <body>)
+ ***************************************************/
+static void InlineDeffunctionFunction(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   Expression *theCall, *theVersion;
+   Deffunction *theDeffunction;
+
+   theCall = GetFirstArgument();
+   theVersion = theCall->nextArg;
+   theDeffunction = (Deffunction *) theCall->value;
+
+   if ((theDeffunction->version != (unsigned long) theVersion->integerValue->contents)
+#if DEBUGGING_FUNCTIONS
+       || theDeffunction->trace
+#endif
+#if PROFILING_FUNCTIONS
+       || ProfileFunctionData(theEnv)->ProfileConstructs
+#endif
+      )
+     {
+      EvaluateExpression(theEnv,theCall,returnValue);
+      return;
+     }
+
+   EvaluateExpression(theEnv,theVersion->nextArg,returnValue);
+  }
+
 /***************************************************
   NAME         : DecrementDeffunctionBusyCount
   DESCRIPTION  : Lowers the busy count of a
@@ -917,6 +1060,8 @@ static bool RemoveAllDeffunctions(
          oldbusy = dptr->busy;
          ExpressionDeinstall(theEnv,dptr->code);
          dptr->busy = oldbusy;
+         ReturnProcBytecode(theEnv,dptr->bytecode);
+         dptr->bytecode = NULL;
          ReturnPackedExpression(theEnv,dptr->code);
          dptr->code = NULL;
         }
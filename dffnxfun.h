@@ -92,6 +92,8 @@ struct deffunction
    unsigned short minNumberOfParameters;
    unsigned short maxNumberOfParameters;
    unsigned short numberOfLocalVars;
+   unsigned long version;
+   struct procBytecode *bytecode;
   };
 
 #define DEFFUNCTION_DATA 23
@@ -106,6 +108,7 @@ struct deffunctionData
 #endif
    struct CodeGeneratorItem *DeffunctionCodeItem;
    Deffunction *ExecutingDeffunction;
+   unsigned short InlineLimit;
   };
 
 #define DeffunctionData(theEnv) ((struct deffunctionData *) GetEnvironmentData(theEnv,DEFFUNCTION_DATA))
@@ -127,6 +130,10 @@ struct deffunctionData
    bool                           Undeffunction(Deffunction *,Environment *);
    void                           GetDeffunctionListFunction(Environment *,UDFContext *,UDFValue *);
    void                           GetDeffunctionModuleCommand(Environment *,UDFContext *,UDFValue *);
+   unsigned short                 GetDeffunctionInlineLimit(Environment *);
+   unsigned short                 SetDeffunctionInlineLimit(Environment *,unsigned short);
+   void                           GetDeffunctionInlineLimitCommand(Environment *,UDFContext *,UDFValue *);
+   void                           SetDeffunctionInlineLimitCommand(Environment *,UDFContext *,UDFValue *);
    Deffunction                   *LookupDeffunctionByMdlOrScope(Environment *,const char *);
    Deffunction                   *LookupDeffunctionInScope(Environment *,const char *);
 #if (! BLOAD_ONLY) && (! RUN_TIME)
@@ -62,6 +62,8 @@
 
 #if DEFFUNCTION_CONSTRUCT && (! BLOAD_ONLY) && (! RUN_TIME)
 
+#include <string.h>
+
 #if BLOAD || BLOAD_AND_BSAVE
 #include "bload.h"
 #endif
@@ -74,6 +76,7 @@
 #include "genrccom.h"
 #endif
 
+#include "bytecode.h"
 #include "constant.h"
 #include "cstrccom.h"
 #include "cstrcpsr.h"
@@ -82,6 +85,7 @@
 #include "envrnmnt.h"
 #include "expressn.h"
 #include "exprnpsr.h"
+#include "extnfunc.h"
 #include "memalloc.h"
 #include "modulutl.h"
 #include "pprint.h"
@@ -98,6 +102,9 @@
 /***************************************/
 
    static bool                    ValidDeffunctionName(Environment *,const char *);
+   static bool                    InlineableBody(Environment *,Deffunction *,Expression *);
+   static bool                    InlineableArgument(Expression *);
+   static Expression             *CopyInlineBody(Environment *,Expression *,Expression *);
    static Deffunction            *AddDeffunction(Environment *,CLIPSLexeme *,Expression *,unsigned short,unsigned short,unsigned short,bool);
 
 /***************************************************************************
@@ -289,12 +296,198 @@ bool ParseDeffunction(
    return(deffunctionError);
   }
 
+/***************************************************************************
+  NAME         : InlineDeffunctionCall
+  DESCRIPTION  : Substitutes the body of a small deffunction into
+                 a call site as the call is parsed
+  INPUTS       : The parsed deffunction call
+  RETURNS      : The call itself if it cannot be inlined, otherwise
+                 an inlined call expression which contains it
+  SIDE EFFECTS : None
+  NOTES        : The inlined form is:
+                   ((inline-deffunction) <call> <version> <body>)
+                 where the parameter references in the copy of the
+                 body have been replaced by the call's arguments.
+                 The original call is kept so that it can be used
+                 once the deffunction is redefined.
+
+                 Only bodies with no local variables, no wildcard
+                 parameter and no return, break or internal
+                 functions (e.g. loop variables) are inlined, and
+                 only when every argument is a constant or a
+                 variable, so that the substitution cannot change
+                 the order or number of side effects.
+ ***************************************************************************/
+Expression *InlineDeffunctionCall(
+  Environment *theEnv,
+  Expression *theCall)
+  {
+   Deffunction *theDeffunction = (Deffunction *) theCall->value;
+   Expression *arg, *top;
+
+   if ((DeffunctionData(theEnv)->InlineLimit == 0) ||
+       (theDeffunction->code == NULL) ||
+       (theDeffunction->code->nextArg != NULL) ||
+       (theDeffunction->numberOfLocalVars != 0) ||
+       (theDeffunction->minNumberOfParameters != theDeffunction->maxNumberOfParameters) ||
+       (ExpressionSize(theDeffunction->code) > DeffunctionData(theEnv)->InlineLimit))
+     { return theCall; }
+
+   if (! InlineableBody(theEnv,theDeffunction,theDeffunction->code))
+     { return theCall; }
+
+   for (arg = theCall->argList ; arg != NULL ; arg = arg->nextArg)
+     {
+      if (! InlineableArgument(arg))
+        { return theCall; }
+     }
+
+   top = GenConstant(theEnv,FCALL,FindFunction(theEnv,"(inline-deffunction)"));
+   top->argList = theCall;
+   theCall->nextArg = GenConstant(theEnv,INTEGER_TYPE,CreateInteger(theEnv,(long long) theDeffunction->version));
+   theCall->nextArg->nextArg = CopyInlineBody(theEnv,theDeffunction->code,theCall->argList);
+   return top;
+  }
+
 /* =========================================
    *****************************************
           INTERNALLY VISIBLE FUNCTIONS
    =========================================
    ***************************************** */
 
+/***************************************************
+  NAME         : InlineableBody
+  DESCRIPTION  : Determines if a deffunction body
+                 can be evaluated in the context of
+                 its caller
+  INPUTS       : 1) The deffunction
+                 2) The body expression
+  RETURNS      : True if the body can be inlined,
+                 false otherwise
+  SIDE EFFECTS : None
+  NOTES        : Recursive
+ ***************************************************/
+static bool InlineableBody(
+  Environment *theEnv,
+  Deffunction *theDeffunction,
+  Expression *theBody)
+  {
+   const char *name;
+
+   for ( ; theBody != NULL ; theBody = theBody->nextArg)
+     {
+      switch (theBody->type)
+        {
+         case SYMBOL_TYPE:
+         case STRING_TYPE:
+         case INTEGER_TYPE:
+         case FLOAT_TYPE:
+         case INSTANCE_NAME_TYPE:
+         case PROC_PARAM:
+         case DEFGLOBAL_PTR:
+#if DEFGENERIC_CONSTRUCT
+         case GCALL:
+#endif
+           break;
+
+         case PCALL:
+           if (theBody->value == (void *) theDeffunction)
+             { return false; }
+           break;
+
+         case FCALL:
+           name = ExpressionFunctionCallName(theBody)->contents;
+           if ((name[0] == '(') ||
+               (strcmp(name,"return") == 0) ||
+               (strcmp(name,"break") == 0) ||
+               (strcmp(name,"bind") == 0))
+             { return false; }
+           break;
+
+         default:
+           return false;
+        }
+
+      if (! InlineableBody(theEnv,theDeffunction,theBody->argList))
+        { return false; }
+     }
+
+   return true;
+  }
+
+/***************************************************
+  NAME         : InlineableArgument
+  DESCRIPTION  : Determines if a call argument can
+                 be substituted for a parameter
+  INPUTS       : The argument expression
+  RETURNS      : True if the argument is a constant
+                 or a local or rule variable, false
+                 otherwise
+  SIDE EFFECTS : None
+  NOTES        : Global variables are excluded since
+                 the body could change the global
+                 before the parameter is referenced
+ ***************************************************/
+static bool InlineableArgument(
+  Expression *theArgument)
+  {
+   switch (theArgument->type)
+     {
+      case SYMBOL_TYPE:
+      case STRING_TYPE:
+      case INTEGER_TYPE:
+      case FLOAT_TYPE:
+      case INSTANCE_NAME_TYPE:
+      case SF_VARIABLE:
+        return true;
+
+      default:
+        return false;
+     }
+  }
+
+/***************************************************
+  NAME         : CopyInlineBody
+  DESCRIPTION  : Copies a deffunction body, replacing
+                 parameter references with the
+                 corresponding call arguments
+  INPUTS       : 1) The body expression
+                 2) The call arguments
+  RETURNS      : The copy
+  SIDE EFFECTS : Expressions allocated
+  NOTES        : Copies the body expression and its
+                 arguments, but not its siblings
+ ***************************************************/
+static Expression *CopyInlineBody(
+  Environment *theEnv,
+  Expression *theBody,
+  Expression *theArguments)
+  {
+   Expression *theCopy, *arg, *last = NULL, *copyArg;
+   int i;
+
+   if (theBody->type == PROC_PARAM)
+     {
+      arg = theArguments;
+      for (i = *((int *) theBody->bitMapValue->contents) ; i > 1 ; i--)
+        { arg = arg->nextArg; }
+      return GenConstant(theEnv,arg->type,arg->value);
+     }
+
+   theCopy = GenConstant(theEnv,theBody->type,theBody->value);
+   for (arg = theBody->argList ; arg != NULL ; arg = arg->nextArg)
+     {
+      copyArg = CopyInlineBody(theEnv,arg,theArguments);
+      if (last == NULL)
+        { theCopy->argList = copyArg; }
+      else
+        { last->nextArg = copyArg; }
+      last = copyArg;
+     }
+
+   return theCopy;
+  }
+
 /************************************************************
   NAME         : ValidDeffunctionName
   DESCRIPTION  : Determines if a new deffunction of the given
@@ -445,11 +638,13 @@ static Deffunction *AddDeffunction(
       InitializeConstructHeader(theEnv,"deffunction",DEFFUNCTION,&dfuncPtr->header,name);
       IncrementLexemeCount(name);
       dfuncPtr->code = NULL;
+      dfuncPtr->bytecode = NULL;
       dfuncPtr->minNumberOfParameters = min;
       dfuncPtr->maxNumberOfParameters = max;
       dfuncPtr->numberOfLocalVars = lvars;
       dfuncPtr->busy = 0;
       dfuncPtr->executing = 0;
+      dfuncPtr->version = 0;
      }
    else
      {
@@ -462,6 +657,8 @@ static Deffunction *AddDeffunction(
       oldbusy = dfuncPtr->busy;
       ExpressionDeinstall(theEnv,dfuncPtr->code);
       dfuncPtr->busy = oldbusy;
+      ReturnProcBytecode(theEnv,dfuncPtr->bytecode);
+      dfuncPtr->bytecode = NULL;
       ReturnPackedExpression(theEnv,dfuncPtr->code);
       dfuncPtr->code = NULL;
       SetDeffunctionPPForm(theEnv,dfuncPtr,NULL);
@@ -491,6 +688,13 @@ static Deffunction *AddDeffunction(
       ExpressionInstall(theEnv,actions);
       dfuncPtr->busy = oldbusy;
       dfuncPtr->code = actions;
+
+      /*=================================================*/
+      /* Calls which were inlined against the previous   */
+      /* definition will call this one instead.          */
+      /*=================================================*/
+
+      dfuncPtr->version++;
      }
 
    /*==================================*/
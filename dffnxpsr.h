@@ -44,8 +44,11 @@
 
 #define _H_dffnxpsr
 
+#include "expressn.h"
+
 #if DEFFUNCTION_CONSTRUCT && (! BLOAD_ONLY) && (! RUN_TIME)
 
+   Expression                    *InlineDeffunctionCall(Environment *,Expression *);
    bool                           ParseDeffunction(Environment *,const char *);
 
 #endif /* DEFFUNCTION_CONSTRUCT && (! BLOAD_ONLY) && (! RUN_TIME) */
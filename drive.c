@@ -61,12 +61,14 @@
 #include "engine.h"
 #include "envrnmnt.h"
 #include "incrrset.h"
+#include "joinrng.h"
 #include "lgcldpnd.h"
 #include "memalloc.h"
 #include "prntutil.h"
 #include "reteutil.h"
 #include "retract.h"
 #include "router.h"
+#include "utility.h"
 
 #include "drive.h"
 
@@ -126,10 +128,11 @@ void NetworkAssertRight(
   int operation)
   {
    struct partialMatch *lhsBinds, *nextBind;
-   bool exprResult, restore = false;
+   bool exprResult, restore = false, collect = false;
    struct partialMatch *oldLHSBinds = NULL;
    struct partialMatch *oldRHSBinds = NULL;
    struct joinNode *oldJoin = NULL;
+   GCBlock gcb;
 
    /*=========================================================*/
    /* If an incremental reset is being performed and the join */
@@ -172,6 +175,19 @@ void NetworkAssertRight(
       restore = true;
      }
 
+   /*======================================================*/
+   /* Values created by the join tests are collected while */
+   /* the beta memory is traversed rather than after the   */
+   /* entire join operation has completed.                 */
+   /*======================================================*/
+
+   if ((lhsBinds != NULL) &&
+       ((join->networkTest != NULL) || (join->secondaryNetworkTest != NULL)))
+     {
+      GCBlockStart(theEnv,&gcb);
+      collect = true;
+     }
+
    /*===================================================*/
    /* Compare each set of binds on the opposite side of */
    /* the join with the set of binds that entered this  */
@@ -292,6 +308,9 @@ void NetworkAssertRight(
            { PPDrive(theEnv,lhsBinds,rhsBinds,join,operation); }
         }
 
+      if (collect)
+        { GCBlockCollect(theEnv,&gcb); }
+
       /*====================================*/
       /* Move on to the next partial match. */
       /*====================================*/
@@ -299,6 +318,9 @@ void NetworkAssertRight(
       lhsBinds = nextBind;
      }
 
+   if (collect)
+     { GCBlockEndCollect(theEnv,&gcb); }
+
    /*=========================================*/
    /* Restore the old evaluation environment. */
    /*=========================================*/
@@ -330,6 +352,9 @@ void NetworkAssertLeft(
    struct partialMatch *oldLHSBinds = NULL;
    struct partialMatch *oldRHSBinds = NULL;
    struct joinNode *oldJoin = NULL;
+   struct rangeCandidates candidates;
+   bool useRange = false, collect = false;
+   GCBlock gcb;
 
    if ((operation == NETWORK_RETRACT) && PartialMatchWillBeDeleted(theEnv,lhsBinds))
      { return; }
@@ -418,6 +443,29 @@ void NetworkAssertLeft(
       restore = true;
      }
 
+   /*=====================================================*/
+   /* If the join has range terms, use the range index of */
+   /* the alpha memory to limit the entries examined.     */
+   /*=====================================================*/
+
+   if ((rhsBinds != NULL) && (join->rangeTest != NULL))
+     {
+      useRange = GetRangeCandidates(theEnv,join,lhsBinds,&candidates);
+      if (useRange)
+        { rhsBinds = NextRangeCandidate(&candidates); }
+     }
+
+   /*======================================================*/
+   /* Values created by the join tests are collected while */
+   /* the opposite memory is traversed.                    */
+   /*======================================================*/
+
+   if ((rhsBinds != NULL) && (join->networkTest != NULL))
+     {
+      GCBlockStart(theEnv,&gcb);
+      collect = true;
+     }
+
    /*===================================================*/
    /* Compare each set of binds on the opposite side of */
    /* the join with the set of binds that entered this  */
@@ -429,7 +477,7 @@ void NetworkAssertLeft(
      {
       if ((operation == NETWORK_RETRACT) && PartialMatchWillBeDeleted(theEnv,rhsBinds))
         {
-         rhsBinds = rhsBinds->nextInMemory;
+         rhsBinds = useRange ? NextRangeCandidate(&candidates) : rhsBinds->nextInMemory;
          continue;
         }
 
@@ -511,6 +559,10 @@ void NetworkAssertLeft(
            {
             AddBlockedLink(lhsBinds,rhsBinds);
             PPDrive(theEnv,lhsBinds,NULL,join,operation);
+            if (useRange)
+              { ReturnRangeCandidates(theEnv,&candidates); }
+            if (collect)
+              { GCBlockEndCollect(theEnv,&gcb); }
             EngineData(theEnv)->GlobalLHSBinds = oldLHSBinds;
             EngineData(theEnv)->GlobalRHSBinds = oldRHSBinds;
             EngineData(theEnv)->GlobalJoin = oldJoin;
@@ -535,13 +587,22 @@ void NetworkAssertLeft(
            }
         }
 
+      if (collect)
+        { GCBlockCollect(theEnv,&gcb); }
+
       /*====================================*/
       /* Move on to the next partial match. */
       /*====================================*/
 
-      rhsBinds = rhsBinds->nextInMemory;
+      rhsBinds = useRange ? NextRangeCandidate(&candidates) : rhsBinds->nextInMemory;
      }
 
+   if (useRange)
+     { ReturnRangeCandidates(theEnv,&candidates); }
+
+   if (collect)
+     { GCBlockEndCollect(theEnv,&gcb); }
+
    /*==================================================================*/
    /* If a join with an associated not CE or join from the right was   */
    /* entered from the LHS side of the join, and the join expression   */
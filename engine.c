@@ -85,6 +85,11 @@
 /*            Added GCBlockStart and GCBlockEnd functions    */
 /*            for garbage collection blocks.                 */
 /*                                                           */
+/*            Added run idle functions which are called      */
+/*            when the agenda is empty so that run can       */
+/*            wait for external events to supply             */
+/*            activations.                                   */
+/*                                                           */
 /*************************************************************/
 
 #include <stdio.h>
@@ -111,6 +116,7 @@
 #include "retract.h"
 #include "router.h"
 #include "ruledlt.h"
+#include "rulephs.h"
 #include "sysdep.h"
 #include "utility.h"
 #include "watch.h"
@@ -123,6 +129,7 @@
 
    static Defmodule              *RemoveFocus(Environment *,Defmodule *);
    static void                    DeallocateEngineData(Environment *);
+   static Activation             *WaitForActivation(Environment *);
 
 /*****************************************************************************/
 /* InitializeEngine: Initializes the activations and statistics watch items. */
@@ -149,6 +156,7 @@ static void DeallocateEngineData(
 
    DeallocateRuleFiredCallList(theEnv,EngineData(theEnv)->ListOfAfterRuleFiresFunctions);
    DeallocateRuleFiredCallList(theEnv,EngineData(theEnv)->ListOfBeforeRuleFiresFunctions);
+   DeallocateBoolCallList(theEnv,EngineData(theEnv)->ListOfRunIdleFunctions);
 
    tmpPtr = EngineData(theEnv)->CurrentFocus;
    while (tmpPtr != NULL)
@@ -264,6 +272,9 @@ long long Run(
    /*=====================================================*/
 
    theActivation = NextActivationToFire(theEnv);
+   if ((theActivation == NULL) && (runLimit != 0))
+     { theActivation = WaitForActivation(theEnv); }
+
    while ((theActivation != NULL) &&
           (runLimit != 0) &&
           (EvaluationData(theEnv)->HaltExecution == false) &&
@@ -528,6 +539,14 @@ long long Run(
 
       theActivation = (struct activation *) NextActivationToFire(theEnv);
 
+      /*=================================================*/
+      /* If the agenda is empty, give the idle functions */
+      /* a chance to supply more work before stopping.   */
+      /*=================================================*/
+
+      if ((theActivation == NULL) && (runLimit != 0))
+        { theActivation = WaitForActivation(theEnv); }
+
       /*==============================*/
       /* Check for a rule breakpoint. */
       /*==============================*/
@@ -717,14 +736,22 @@ Activation *NextActivationToFire(
    /*===========================================================*/
    /* Determine the top activation on the agenda of the current */
    /* focus. If the current focus has no activations on its     */
-   /* agenda, then pop the focus off the focus stack until      */
-   /* a focus that has an activation on its agenda is found.    */
+   /* agenda, then move it on to its next phase (if it has a    */
+   /* phase sequence) or pop the focus off the focus stack      */
+   /* until a focus that has an activation on its agenda is     */
+   /* found.                                                    */
    /*===========================================================*/
 
    theActivation = EngineData(theEnv)->CurrentFocus->theDefruleModule->agenda;
    while ((theActivation == NULL) && (EngineData(theEnv)->CurrentFocus != NULL))
      {
-      if (EngineData(theEnv)->CurrentFocus != NULL) PopFocus(theEnv);
+      if (AutoAdvancePhase(theEnv,EngineData(theEnv)->CurrentFocus->theDefruleModule))
+        {
+         theActivation = EngineData(theEnv)->CurrentFocus->theDefruleModule->agenda;
+         continue;
+        }
+
+      PopFocus(theEnv);
       if (EngineData(theEnv)->CurrentFocus != NULL) theActivation = EngineData(theEnv)->CurrentFocus->theDefruleModule->agenda;
      }
 
@@ -998,6 +1025,84 @@ bool AddBeforeRuleFiresFunction(
    return true;
   }
 
+/**************************************************/
+/* AddRunIdleFunction: Adds a function to the     */
+/*   ListOfRunIdleFunctions. These are called by  */
+/*   run when the agenda becomes empty and should */
+/*   return true if they may have added new       */
+/*   activations (for example by asserting facts  */
+/*   in response to an external event).           */
+/**************************************************/
+bool AddRunIdleFunction(
+  Environment *theEnv,
+  const char *name,
+  BoolCallFunction *functionPtr,
+  int priority,
+  void *context)
+  {
+   EngineData(theEnv)->ListOfRunIdleFunctions =
+      AddBoolFunctionToCallList(theEnv,name,priority,functionPtr,
+                                EngineData(theEnv)->ListOfRunIdleFunctions,context);
+   return true;
+  }
+
+/*********************************************/
+/* RemoveRunIdleFunction: Removes a function */
+/*   from the ListOfRunIdleFunctions.        */
+/*********************************************/
+bool RemoveRunIdleFunction(
+  Environment *theEnv,
+  const char *name)
+  {
+   bool found;
+
+   EngineData(theEnv)->ListOfRunIdleFunctions =
+      RemoveBoolFunctionFromCallList(theEnv,name,EngineData(theEnv)->ListOfRunIdleFunctions,&found);
+
+   return found;
+  }
+
+/****************************************************/
+/* WaitForActivation: Called by run when the agenda */
+/*   is empty. Invokes the run idle functions until */
+/*   one of them produces an activation or none of  */
+/*   them report that progress is possible.         */
+/****************************************************/
+static Activation *WaitForActivation(
+  Environment *theEnv)
+  {
+   BoolCallFunctionItem *idleFunction;
+   Activation *theActivation;
+   bool progress;
+
+   while ((EngineData(theEnv)->ListOfRunIdleFunctions != NULL) &&
+          (EvaluationData(theEnv)->HaltExecution == false) &&
+          (EngineData(theEnv)->HaltRules == false))
+     {
+      progress = false;
+
+      for (idleFunction = EngineData(theEnv)->ListOfRunIdleFunctions;
+           idleFunction != NULL;
+           idleFunction = idleFunction->next)
+        {
+         if ((*idleFunction->func)(theEnv,idleFunction->context))
+           { progress = true; }
+        }
+
+      if (! progress)
+        { return NULL; }
+
+      CleanCurrentGarbageFrame(theEnv,NULL);
+      CallPeriodicTasks(theEnv);
+
+      theActivation = NextActivationToFire(theEnv);
+      if (theActivation != NULL)
+        { return theActivation; }
+     }
+
+   return NULL;
+  }
+
 /****************************************************/
 /* RemoveAfterRuleFiresFunction: Removes a function */
 /*   from the ListOfAfterRuleFiresFunctions.        */
@@ -72,6 +72,13 @@
 /*                                                           */
 /*            UDF redesign.                                  */
 /*                                                           */
+/*            Removed the unused garbage alpha match list.   */
+/*                                                           */
+/*            Added run idle functions which are called      */
+/*            when the agenda is empty so that run can       */
+/*            wait for external events to supply             */
+/*            activations.                                   */
+/*                                                           */
 /*************************************************************/
 
 #ifndef _H_engine
@@ -119,6 +126,7 @@ struct engineData
    bool alreadyEntered;
    RuleFiredFunctionItem *ListOfAfterRuleFiresFunctions;
    RuleFiredFunctionItem *ListOfBeforeRuleFiresFunctions;
+   BoolCallFunctionItem *ListOfRunIdleFunctions;
    FocalModule *CurrentFocus;
    bool FocusChanged;
 #if DEBUGGING_FUNCTIONS
@@ -131,7 +139,6 @@ struct engineData
    struct partialMatch *GlobalRHSBinds;
    struct joinNode *GlobalJoin;
    struct partialMatch *GarbagePartialMatches;
-   struct alphaMatch *GarbageAlphaMatches;
    bool AlreadyRunning;
 #if DEVELOPER
    long leftToRightComparisons;
@@ -158,6 +165,9 @@ struct engineData
    bool                    AddBeforeRuleFiresFunction(Environment *,const char *,
                                                       RuleFiredFunction *,int,void *);
    bool                    RemoveBeforeRuleFiresFunction(Environment *,const char *);
+   bool                    AddRunIdleFunction(Environment *,const char *,
+                                              BoolCallFunction *,int,void *);
+   bool                    RemoveRunIdleFunction(Environment *,const char *);
    RuleFiredFunctionItem  *AddRuleFiredFunctionToCallList(Environment *,const char *,int,RuleFiredFunction *,
                                                           RuleFiredFunctionItem *,void *);
    RuleFiredFunctionItem  *RemoveRuleFiredFunctionFromCallList(Environment *,const char *,
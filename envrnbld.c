@@ -245,6 +245,7 @@ bool DestroyEnvironment(
 
 #if (MEM_TABLE_SIZE > 0)
    free(theMemData->MemoryTable);
+   free(theMemData->SlabTable);
 #endif
 
    for (i = 0; i < MAXIMUM_ENVIRONMENT_POSITIONS; i++)
@@ -85,6 +85,7 @@
 #include "modulutl.h"
 #include "router.h"
 #include "prcdrfun.h"
+#include "prccode.h"
 #include "multifld.h"
 #include "prntutil.h"
 #include "exprnpsr.h"
@@ -157,6 +158,7 @@ bool EvaluateExpression(
    struct expr *oldArgument;
    struct functionDefinition *fptr;
    UDFContext theUDFContext;
+   UDFValue *src;
 #if PROFILING_FUNCTIONS
    struct profileFrameInfo profileFrame;
 #endif
@@ -171,6 +173,40 @@ bool EvaluateExpression(
       return(EvaluationData(theEnv)->EvaluationError);
      }
 
+   /*===================================================*/
+   /* Parameter and bound local variable references are */
+   /* the most common leaves of deffunction and message */
+   /* handler bodies, so they are read directly rather  */
+   /* than through their primitive entity records. The  */
+   /* entity records are still used when profiling so   */
+   /* that the references are counted.                  */
+   /*===================================================*/
+
+#if PROFILING_FUNCTIONS
+   if (! ProfileFunctionData(theEnv)->ProfileUserFunctions)
+#endif
+     {
+      if (problem->type == PROC_PARAM)
+        {
+         src = &ProceduralPrimitiveData(theEnv)->ProcParamArray[*((int *) problem->bitMapValue->contents) - 1];
+         returnValue->value = src->value;
+         returnValue->begin = src->begin;
+         returnValue->range = src->range;
+         return EvaluationData(theEnv)->EvaluationError;
+        }
+      else if (problem->type == PROC_GET_BIND)
+        {
+         src = &ProceduralPrimitiveData(theEnv)->LocalVarArray[((PACKED_PROC_VAR *) problem->bitMapValue->contents)->first - 1];
+         if (src->supplementalInfo == TrueSymbol(theEnv))
+           {
+            returnValue->value = src->value;
+            returnValue->begin = src->begin;
+            returnValue->range = src->range;
+            return EvaluationData(theEnv)->EvaluationError;
+           }
+        }
+     }
+
    switch (problem->type)
      {
       case STRING_TYPE:
@@ -191,9 +227,10 @@ bool EvaluateExpression(
          fptr = problem->functionValue;
 
 #if PROFILING_FUNCTIONS
-         StartProfile(theEnv,&profileFrame,
-                      &fptr->usrData,
-                      ProfileFunctionData(theEnv)->ProfileUserFunctions);
+         if (ProfileFunctionData(theEnv)->ProfileUserFunctions)
+           { StartProfile(theEnv,&profileFrame,&fptr->usrData,true); }
+         else
+           { profileFrame.profileOnExit = false; }
 #endif
 
          oldArgument = EvaluationData(theEnv)->CurrentExpression;
@@ -211,7 +248,8 @@ bool EvaluateExpression(
            { returnValue->range = returnValue->multifieldValue->length; }
 
 #if PROFILING_FUNCTIONS
-        EndProfile(theEnv,&profileFrame);
+        if (profileFrame.profileOnExit)
+          { EndProfile(theEnv,&profileFrame); }
 #endif
 
         EvaluationData(theEnv)->CurrentExpression = oldArgument;
@@ -264,15 +302,21 @@ bool EvaluateExpression(
         EvaluationData(theEnv)->CurrentExpression = problem;
 
 #if PROFILING_FUNCTIONS
-        StartProfile(theEnv,&profileFrame,
-                     &EvaluationData(theEnv)->PrimitivesArray[problem->type]->usrData,
-                     ProfileFunctionData(theEnv)->ProfileUserFunctions);
+        if (ProfileFunctionData(theEnv)->ProfileUserFunctions)
+          {
+           StartProfile(theEnv,&profileFrame,
+                        &EvaluationData(theEnv)->PrimitivesArray[problem->type]->usrData,
+                        true);
+          }
+        else
+          { profileFrame.profileOnExit = false; }
 #endif
 
         (*EvaluationData(theEnv)->PrimitivesArray[problem->type]->evaluateFunction)(theEnv,problem->value,returnValue);
 
 #if PROFILING_FUNCTIONS
-        EndProfile(theEnv,&profileFrame);
+        if (profileFrame.profileOnExit)
+          { EndProfile(theEnv,&profileFrame); }
 #endif
 
         EvaluationData(theEnv)->CurrentExpression = oldArgument;
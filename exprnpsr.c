@@ -61,6 +61,9 @@
 /*                                                           */
 /*            Eval support for run time and bload only.      */
 /*                                                           */
+/*            Calls to foldable functions with literal       */
+/*            arguments are replaced by their result.        */
+/*                                                           */
 /*************************************************************/
 
 #include "setup.h"
@@ -94,10 +97,26 @@
 
 #if DEFFUNCTION_CONSTRUCT
 #include "dffnxfun.h"
+#include "dffnxpsr.h"
+#endif
+
+#if DEFGLOBAL_CONSTRUCT
+#include "globlpsr.h"
 #endif
 
 #include "exprnpsr.h"
 
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+#if (! RUN_TIME) && (! BLOAD_ONLY)
+   static struct expr            *FoldFunctionCall(Environment *,struct expr *);
+   static bool                    FoldableLiteral(struct expr *);
+   static bool                    QueryFoldCallback(Environment *,const char *,void *);
+   static void                    WriteFoldCallback(Environment *,const char *,const char *,void *);
+#endif
+
 #if (! RUN_TIME)
 
 /***************************************************/
@@ -332,6 +351,9 @@ struct expr *Function2Parse(
          ReturnExpression(theEnv,top);
          return NULL;
         }
+#if (! BLOAD_ONLY) && (! RUN_TIME)
+      top = InlineDeffunctionCall(theEnv,top);
+#endif
      }
 #endif
 
@@ -681,7 +703,13 @@ struct expr *ArgumentParse(
        (theToken.tknType == INSTANCE_NAME_TOKEN) ||
 #endif
        (theToken.tknType == FLOAT_TOKEN) || (theToken.tknType == INTEGER_TOKEN))
-     { return(GenConstant(theEnv,TokenTypeToType(theToken.tknType),theToken.value)); }
+     {
+      top = GenConstant(theEnv,TokenTypeToType(theToken.tknType),theToken.value);
+#if DEFGLOBAL_CONSTRUCT && (! RUN_TIME) && (! BLOAD_ONLY)
+      FoldConstantGlobal(theEnv,top);
+#endif
+      return(top);
+     }
 
    /*======================*/
    /* Parse function call. */
@@ -697,9 +725,145 @@ struct expr *ArgumentParse(
 
    top = Function1Parse(theEnv,logicalName);
    if (top == NULL) *errorFlag = true;
+#if (! RUN_TIME) && (! BLOAD_ONLY)
+   else top = FoldFunctionCall(theEnv,top);
+#endif
    return(top);
   }
 
+#if (! RUN_TIME) && (! BLOAD_ONLY)
+
+/*****************************************************************/
+/* FoldFunctionCall: Replaces a call to a foldable system        */
+/*   function whose arguments are all literals with the value    */
+/*   the call returns. If evaluating the call causes an error,   */
+/*   the call is left in place so the error is reported when the */
+/*   expression is evaluated at run time.                        */
+/*****************************************************************/
+static struct expr *FoldFunctionCall(
+  Environment *theEnv,
+  struct expr *theCall)
+  {
+   struct expr *theArg, *theConstant;
+   UDFValue theResult;
+   bool ovEvaluationError, ovHaltExecution, failed;
+
+   if ((theCall->type != FCALL) || (! theCall->functionValue->foldable))
+     { return theCall; }
+
+   for (theArg = theCall->argList; theArg != NULL; theArg = theArg->nextArg)
+     { if (! FoldableLiteral(theArg)) return theCall; }
+
+   /*=====================================================*/
+   /* Evaluate the call with error output discarded and   */
+   /* the error state of any enclosing evaluation saved.  */
+   /*=====================================================*/
+
+   ovEvaluationError = EvaluationData(theEnv)->EvaluationError;
+   ovHaltExecution = EvaluationData(theEnv)->HaltExecution;
+   EvaluationData(theEnv)->EvaluationError = false;
+   EvaluationData(theEnv)->HaltExecution = false;
+
+   AddRouter(theEnv,"fold-error-discard",50,
+             QueryFoldCallback,WriteFoldCallback,
+             NULL,NULL,NULL,NULL);
+   EvaluateExpression(theEnv,theCall,&theResult);
+   DeleteRouter(theEnv,"fold-error-discard");
+
+   failed = EvaluationData(theEnv)->EvaluationError ||
+            EvaluationData(theEnv)->HaltExecution;
+   EvaluationData(theEnv)->EvaluationError = ovEvaluationError;
+   EvaluationData(theEnv)->HaltExecution = ovHaltExecution;
+
+   if (failed) return theCall;
+
+   theConstant = GenConstant(theEnv,theResult.header->type,theResult.value);
+   if (! FoldableLiteral(theConstant))
+     {
+      ReturnExpression(theEnv,theConstant);
+      return theCall;
+     }
+
+   /*=======================================================*/
+   /* A folded defconstant reference is kept as the         */
+   /* argument of its literal. Those of the call's          */
+   /* arguments move to the result so that the              */
+   /* defconstants stay referenced once the call is folded. */
+   /*=======================================================*/
+
+   for (theArg = theCall->argList; theArg != NULL; theArg = theArg->nextArg)
+     {
+      if (theArg->argList != NULL)
+        {
+         theConstant->argList = AppendExpressions(theArg->argList,theConstant->argList);
+         theArg->argList = NULL;
+        }
+     }
+
+   ReturnExpression(theEnv,theCall);
+   return theConstant;
+  }
+
+/************************************************************/
+/* FoldableLiteral: Returns true if an expression is a      */
+/*   literal which can be stored directly in an expression. */
+/************************************************************/
+static bool FoldableLiteral(
+  struct expr *theExpression)
+  {
+   switch (theExpression->type)
+     {
+      case SYMBOL_TYPE:
+      case STRING_TYPE:
+      case INSTANCE_NAME_TYPE:
+      case INTEGER_TYPE:
+      case FLOAT_TYPE:
+        return true;
+
+      default:
+        return false;
+     }
+  }
+
+/***********************************************/
+/* QueryFoldCallback: Query callback for the   */
+/*   router which discards the error output of */
+/*   a function call being folded.             */
+/***********************************************/
+static bool QueryFoldCallback(
+  Environment *theEnv,
+  const char *logicalName,
+  void *context)
+  {
+#if MAC_XCD
+#pragma unused(theEnv,context)
+#endif
+
+   if ((strcmp(logicalName,STDERR) == 0) ||
+       (strcmp(logicalName,STDWRN) == 0))
+     { return true; }
+
+   return false;
+  }
+
+/***********************************************/
+/* WriteFoldCallback: Write callback for the   */
+/*   router which discards the error output of */
+/*   a function call being folded.             */
+/***********************************************/
+static void WriteFoldCallback(
+  Environment *theEnv,
+  const char *logicalName,
+  const char *str,
+  void *context)
+  {
+#if MAC_XCD
+#pragma unused(theEnv,logicalName,str,context)
+#endif
+  }
+
+#endif /* (! RUN_TIME) && (! BLOAD_ONLY) */
+
 /************************************************************/
 /* ParseAtomOrExpression: Parses an expression which may be */
 /*   a function call, atomic value (string, symbol, etc.),  */
@@ -730,7 +894,12 @@ struct expr *ParseAtomOrExpression(
        (thisToken->tknType == MF_GBL_VARIABLE_TOKEN) ||
 #endif
        (thisToken->tknType == SF_VARIABLE_TOKEN) || (thisToken->tknType == MF_VARIABLE_TOKEN))
-     { rv = GenConstant(theEnv,TokenTypeToType(thisToken->tknType),thisToken->value); }
+     {
+      rv = GenConstant(theEnv,TokenTypeToType(thisToken->tknType),thisToken->value);
+#if DEFGLOBAL_CONSTRUCT && (! RUN_TIME) && (! BLOAD_ONLY)
+      FoldConstantGlobal(theEnv,rv);
+#endif
+     }
    else if (thisToken->tknType == LEFT_PARENTHESIS_TOKEN)
      {
       rv = Function1Parse(theEnv,logicalName);
@@ -85,7 +85,6 @@
                                                  const char *,unsigned short,unsigned short,const char *,void *);
 #endif
    static void                    PrintType(Environment *,const char *,int,int *,const char *);
-   static void                    AssignErrorValue(UDFContext *);
 
 /*********************************************************/
 /* InitializeExternalFunctionData: Allocates environment */
@@ -235,6 +234,7 @@ static AddUDFError DefineFunction(
    newFunction->sequenceuseok = true;
    newFunction->usrData = NULL;
    newFunction->context = context;
+   newFunction->foldable = false;
 
    return AUE_NO_ERROR;
   }
@@ -393,6 +393,31 @@ bool FuncSeqOvlFlags(
    return true;
   }
 
+/******************************************************************/
+/* SetFunctionFoldable: Marks a system function as foldable, i.e. */
+/*   a function without side effects whose result depends only    */
+/*   on its arguments. Calls to a foldable function with literal  */
+/*   arguments are evaluated when they are parsed.                */
+/******************************************************************/
+bool SetFunctionFoldable(
+  Environment *theEnv,
+  const char *functionName,
+  bool foldable)
+  {
+   struct functionDefinition *fdPtr;
+
+   fdPtr = FindFunction(theEnv,functionName);
+   if (fdPtr == NULL)
+     {
+      WriteString(theEnv,STDERR,"Only existing functions can be marked as foldable or not.\n");
+      return false;
+     }
+
+   fdPtr->foldable = foldable;
+
+   return true;
+  }
+
 #endif
 
 /***********************************************/
@@ -84,6 +84,7 @@ struct functionDefinition
    struct functionDefinition *next;
    struct userData *usrData;
    void *context;
+   bool foldable;
   };
 
 #define UnknownFunctionType(target) (((struct functionDefinition *) target)->unknownReturnValueType)
@@ -132,6 +133,7 @@ struct FunctionHash
                                                            struct expr *(*)( Environment *,struct expr *,const char *));
    bool                           RemoveFunctionParser(Environment *,const char *);
    bool                           FuncSeqOvlFlags(Environment *,const char *,bool,bool);
+   bool                           SetFunctionFoldable(Environment *,const char *,bool);
    struct functionDefinition     *GetFunctionList(Environment *);
    void                           InstallFunctionList(Environment *,struct functionDefinition *);
    struct functionDefinition     *FindFunction(Environment *,const char *);
@@ -147,6 +149,7 @@ struct FunctionHash
    bool                           UDFFirstArgument(UDFContext *,unsigned,UDFValue *);
    bool                           UDFNextArgument(UDFContext *,unsigned,UDFValue *);
    void                           UDFThrowError(UDFContext *);
+   void                           AssignErrorValue(UDFContext *);
    void                          *GetUDFContext(Environment *,const char *);
 
 #define UDFHasNextArgument(context) (context->lastArg != NULL)
@@ -35,6 +35,7 @@
 
 #if DEFTEMPLATE_CONSTRUCT && (BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE) && (! RUN_TIME)
 
+#include <limits.h>
 #include <stdio.h>
 
 #include "bload.h"
@@ -60,6 +61,7 @@ struct bsaveFactPatternNode
    unsigned short whichSlot;
    unsigned short whichField;
    unsigned short leaveFields;
+   unsigned long slotbmp;
    unsigned long networkTest;
    unsigned long nextLevel;
    unsigned long lastLevel;
@@ -199,6 +201,8 @@ static void BsaveDriver(
         {
          case BSAVE_FIND:
            thePattern->bsaveID = FactBinaryData(theEnv)->NumberOfPatterns++;
+           if (thePattern->slotbmp != NULL)
+             { thePattern->slotbmp->neededBitMap = true; }
            break;
 
          case BSAVE_PATTERNS:
@@ -305,6 +309,10 @@ static void BsavePatternNode(
    tempNode.whichField = thePattern->whichField;
    tempNode.leaveFields = thePattern->leaveFields;
    tempNode.whichSlot = thePattern->whichSlot;
+   if (thePattern->slotbmp != NULL)
+     { tempNode.slotbmp = thePattern->slotbmp->bucket; }
+   else
+     { tempNode.slotbmp = ULONG_MAX; }
    tempNode.networkTest = HashedExpressionIndex(theEnv,thePattern->networkTest);
    tempNode.nextLevel =  BsaveFactPatternIndex(thePattern->nextLevel);
    tempNode.lastLevel =  BsaveFactPatternIndex(thePattern->lastLevel);
@@ -407,6 +415,14 @@ static void UpdateFactPatterns(
    FactBinaryData(theEnv)->FactPatternArray[obji].leaveFields = bp->leaveFields;
    FactBinaryData(theEnv)->FactPatternArray[obji].whichSlot = bp->whichSlot;
 
+   if (bp->slotbmp != ULONG_MAX)
+     {
+      FactBinaryData(theEnv)->FactPatternArray[obji].slotbmp = BitMapPointer(bp->slotbmp);
+      IncrementBitMapCount(FactBinaryData(theEnv)->FactPatternArray[obji].slotbmp);
+     }
+   else
+     { FactBinaryData(theEnv)->FactPatternArray[obji].slotbmp = NULL; }
+
    FactBinaryData(theEnv)->FactPatternArray[obji].networkTest = HashedExpressionPointer(bp->networkTest);
    FactBinaryData(theEnv)->FactPatternArray[obji].rightNode = BloadFactPatternPointer(bp->rightNode);
    FactBinaryData(theEnv)->FactPatternArray[obji].nextLevel = BloadFactPatternPointer(bp->nextLevel);
@@ -434,8 +450,10 @@ static void ClearBload(
                                         FactBinaryData(theEnv)->FactPatternArray[i].networkTest->type,
                                         FactBinaryData(theEnv)->FactPatternArray[i].networkTest->value);
         }
-     }
 
+      if (FactBinaryData(theEnv)->FactPatternArray[i].slotbmp != NULL)
+        { DecrementBitMapReferenceCount(theEnv,FactBinaryData(theEnv)->FactPatternArray[i].slotbmp); }
+     }
 
    space = FactBinaryData(theEnv)->NumberOfPatterns * sizeof(struct factPatternNode);
    if (space != 0) genfree(theEnv,FactBinaryData(theEnv)->FactPatternArray,space);
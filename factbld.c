@@ -35,6 +35,9 @@
 /*                                                           */
 /*            Removed initial-fact support.                  */
 /*                                                           */
+/*            Stop nodes are only shared by patterns which   */
+/*            reference the same slots.                      */
+/*                                                           */
 /*************************************************************/
 
 #include "setup.h"
@@ -72,6 +75,9 @@
    static void                       DetachFactPattern(Environment *,struct patternNodeHeader *);
    static struct patternNodeHeader  *PlaceFactPattern(Environment *,struct lhsParseNode *);
    static struct lhsParseNode       *RemoveUnneededSlots(Environment *,struct lhsParseNode *);
+   static CLIPSBitMap               *FormSlotBitMap(Environment *,struct lhsParseNode *);
+   static bool                       SharableTerminal(struct factPatternNode *,struct lhsParseNode *,bool,CLIPSBitMap *);
+   static void                       SetSlotBitMap(Environment *,struct factPatternNode *,CLIPSBitMap *);
    static void                       FindAndSetDeftemplatePatternNetwork(Environment *,struct factPatternNode *,struct factPatternNode *);
 #endif
 
@@ -157,9 +163,10 @@ static struct patternNodeHeader *PlaceFactPattern(
    struct lhsParseNode *tempPattern;
    struct factPatternNode *currentLevel, *lastLevel;
    struct factPatternNode *nodeBeforeMatch, *newNode = NULL;
-   bool endSlot;
+   bool endSlot, lastField;
    unsigned int count;
    const char *deftemplateName;
+   CLIPSBitMap *slotBitMap;
 
    /*======================================================================*/
    /* Get the name of the deftemplate associated with the pattern being    */
@@ -168,6 +175,14 @@ static struct patternNodeHeader *PlaceFactPattern(
 
    deftemplateName = thePattern->right->bottom->lexemeValue->contents;
 
+   /*=========================================================*/
+   /* Record which slots the pattern references before slots  */
+   /* which only bind variables are removed. The first node   */
+   /* is the relation name and does not correspond to a slot. */
+   /*=========================================================*/
+
+   slotBitMap = FormSlotBitMap(theEnv,thePattern->right->right);
+
    /*=====================================================*/
    /* Remove any slot tests that test only for existance. */
    /*=====================================================*/
@@ -272,6 +287,17 @@ static struct patternNodeHeader *PlaceFactPattern(
       else
         { endSlot = false; }
 
+      /*==================================================*/
+      /* Determine if the last field of the whole pattern */
+      /* (which will become the stop node) is processed.  */
+      /*==================================================*/
+
+      if ((thePattern->right == NULL) &&
+          ((tempPattern == NULL) || (tempPattern->right == NULL)))
+        { lastField = true; }
+      else
+        { lastField = false; }
+
       /*========================================*/
       /* Is there a node in the pattern network */
       /* that can be reused (shared)?           */
@@ -279,6 +305,24 @@ static struct patternNodeHeader *PlaceFactPattern(
 
       newNode = FindPatternNode(currentLevel,thePattern,&nodeBeforeMatch,endSlot,false);
 
+      /*======================================================*/
+      /* A stop node can only be shared by patterns which     */
+      /* reference the same slots, otherwise a slot specific  */
+      /* modify would retrigger patterns based on which other */
+      /* patterns happen to share the node. Skip any stop     */
+      /* node whose slot bitmap differs and if none is found, */
+      /* add a new node at the head of the current level.     */
+      /*======================================================*/
+
+      if (lastField)
+        {
+         while ((newNode != NULL) &&
+                (! SharableTerminal(newNode,thePattern,endSlot,slotBitMap)))
+           { newNode = FindPatternNode(newNode->rightNode,thePattern,&nodeBeforeMatch,endSlot,false); }
+
+         nodeBeforeMatch = currentLevel;
+        }
+
       /*================================================*/
       /* If the pattern node cannot be shared, then add */
       /* a new pattern node to the pattern network.     */
@@ -328,6 +372,13 @@ static struct patternNodeHeader *PlaceFactPattern(
       currentLevel = newNode->nextLevel;
      }
 
+   /*==================================================*/
+   /* Attach the referenced slots to the leaf node. A  */
+   /* shared leaf node already has the same bitmap.    */
+   /*==================================================*/
+
+   SetSlotBitMap(theEnv,newNode,slotBitMap);
+
    /*==================================================*/
    /* Return the leaf node of the newly added pattern. */
    /*==================================================*/
@@ -335,6 +386,97 @@ static struct patternNodeHeader *PlaceFactPattern(
    return((struct patternNodeHeader *) newNode);
   }
 
+/*****************************************************************/
+/* FormSlotBitMap: Creates a bitmap with a bit set for each slot */
+/*   referenced by a deftemplate pattern (including slots which  */
+/*   only bind a variable). Returns NULL if no slots are used.   */
+/*****************************************************************/
+static CLIPSBitMap *FormSlotBitMap(
+  Environment *theEnv,
+  struct lhsParseNode *theSlots)
+  {
+   struct lhsParseNode *slotPtr;
+   unsigned short maxSlot = 0;
+   unsigned short size;
+   char *theMap;
+   CLIPSBitMap *hashedMap;
+
+   for (slotPtr = theSlots; slotPtr != NULL; slotPtr = slotPtr->right)
+     {
+      if ((slotPtr->slotNumber != UNSPECIFIED_SLOT) &&
+          (slotPtr->slotNumber > maxSlot))
+        { maxSlot = slotPtr->slotNumber; }
+     }
+
+   if (maxSlot == 0)
+     { return NULL; }
+
+   size = (unsigned short) CountToBitMapSize(maxSlot);
+   theMap = (char *) gm2(theEnv,size);
+   ClearBitString(theMap,size);
+
+   for (slotPtr = theSlots; slotPtr != NULL; slotPtr = slotPtr->right)
+     {
+      if ((slotPtr->slotNumber != UNSPECIFIED_SLOT) &&
+          (slotPtr->slotNumber > 0))
+        { SetBitMap(theMap,slotPtr->slotNumber - 1); }
+     }
+
+   hashedMap = (CLIPSBitMap *) AddBitMap(theEnv,theMap,size);
+   rm(theEnv,theMap,size);
+
+   return hashedMap;
+  }
+
+/*************************************************************/
+/* SharableTerminal: Determines if a pattern node found for  */
+/*   the last field of a pattern can become its stop node.   */
+/*   For a constant selector node, the child node for the    */
+/*   constant is the one checked. The child nodes of a       */
+/*   selector are hashed by value, so a conflicting child    */
+/*   can't be given a sibling and the selector is skipped.   */
+/*************************************************************/
+static bool SharableTerminal(
+  struct factPatternNode *theNode,
+  struct lhsParseNode *thePattern,
+  bool endSlot,
+  CLIPSBitMap *slotBitMap)
+  {
+   struct factPatternNode *nodeBeforeMatch;
+
+   if (thePattern->constantSelector != NULL)
+     {
+      theNode = FindPatternNode(theNode->nextLevel,thePattern,&nodeBeforeMatch,endSlot,true);
+      if (theNode == NULL) return true;
+     }
+
+   if (! theNode->header.stopNode) return true;
+
+   return(theNode->slotbmp == slotBitMap);
+  }
+
+/************************************************************/
+/* SetSlotBitMap: Attaches the slots referenced by a new    */
+/*   pattern to its leaf node, replacing the bitmap of a    */
+/*   node which was previously not a stop node.             */
+/************************************************************/
+static void SetSlotBitMap(
+  Environment *theEnv,
+  struct factPatternNode *theNode,
+  CLIPSBitMap *slotBitMap)
+  {
+   if (theNode->slotbmp == slotBitMap)
+     { return; }
+
+   if (theNode->slotbmp != NULL)
+     { DecrementBitMapReferenceCount(theEnv,theNode->slotbmp); }
+
+   theNode->slotbmp = slotBitMap;
+
+   if (slotBitMap != NULL)
+     { IncrementBitMapCount(slotBitMap); }
+  }
+
 /*************************************************************/
 /* FindPatternNode: Looks for a pattern node at a specified  */
 /*  level in the pattern network that can be reused (shared) */
@@ -612,6 +754,7 @@ static struct factPatternNode *CreateNewPatternNode(
    newNode->rightNode = NULL;
    newNode->leftNode = NULL;
    newNode->leaveFields = thePattern->singleFieldsAfter;
+   newNode->slotbmp = NULL;
    InitializePatternHeader(theEnv,(struct patternNodeHeader *) &newNode->header);
 
    if (thePattern->index > 0)
@@ -752,7 +895,16 @@ static void DetachFactPattern(
    /* not be removed since other patterns make use of it.   */
    /*=======================================================*/
 
-   if (patternPtr->header.entryJoin == NULL) patternPtr->header.stopNode = false;
+   if (patternPtr->header.entryJoin == NULL)
+     {
+      patternPtr->header.stopNode = false;
+      if (patternPtr->nextLevel != NULL)
+        {
+         if (patternPtr->slotbmp != NULL)
+           { DecrementBitMapReferenceCount(theEnv,patternPtr->slotbmp); }
+         patternPtr->slotbmp = NULL;
+        }
+     }
    if (patternPtr->nextLevel != NULL) return;
 
    /*==============================================================*/
@@ -788,6 +940,8 @@ static void DetachFactPattern(
 
          RemoveHashedExpression(theEnv,patternPtr->networkTest);
          RemoveHashedExpression(theEnv,patternPtr->header.rightHash);
+         if (patternPtr->slotbmp != NULL)
+           { DecrementBitMapReferenceCount(theEnv,patternPtr->slotbmp); }
          rtn_struct(theEnv,factPatternNode,patternPtr);
         }
       else if (upperLevel->leftNode != NULL)
@@ -810,6 +964,8 @@ static void DetachFactPattern(
 
          RemoveHashedExpression(theEnv,patternPtr->networkTest);
          RemoveHashedExpression(theEnv,patternPtr->header.rightHash);
+         if (patternPtr->slotbmp != NULL)
+           { DecrementBitMapReferenceCount(theEnv,patternPtr->slotbmp); }
          rtn_struct(theEnv,factPatternNode,patternPtr);
          upperLevel = NULL;
         }
@@ -836,6 +992,8 @@ static void DetachFactPattern(
 
          RemoveHashedExpression(theEnv,patternPtr->networkTest);
          RemoveHashedExpression(theEnv,patternPtr->header.rightHash);
+         if (patternPtr->slotbmp != NULL)
+           { DecrementBitMapReferenceCount(theEnv,patternPtr->slotbmp); }
          rtn_struct(theEnv,factPatternNode,patternPtr);
          upperLevel = NULL;
         }
@@ -48,6 +48,7 @@ struct factPatternNode
    unsigned short whichField; // TBD seems to be 1 based rather than 0 based
    unsigned short whichSlot;
    unsigned short leaveFields;
+   CLIPSBitMap *slotbmp;
    struct expr *networkTest;
    struct factPatternNode *nextLevel;
    struct factPatternNode *lastLevel;
@@ -300,6 +300,13 @@ static void PatternNodeToCode(
                              thePatternNode->whichSlot,
                              thePatternNode->leaveFields);
 
+   /*======================*/
+   /* Referenced Slot Bits */
+   /*======================*/
+
+   PrintBitMapReference(theEnv,theFile,thePatternNode->slotbmp);
+   fprintf(theFile,",");
+
    /*===============*/
    /* Network Tests */
    /*===============*/
@@ -71,6 +71,11 @@
 /*            Watch facts for modify command only prints     */
 /*            changed slots.                                 */
 /*                                                           */
+/*            Added assert-batch and retract-batch commands. */
+/*                                                           */
+/*            Added get-pattern-match-workers and            */
+/*            set-pattern-match-workers commands.            */
+/*                                                           */
 /*************************************************************/
 
 #include <stdio.h>
@@ -88,6 +93,7 @@
 #include "facthsh.h"
 #include "factmch.h"
 #include "factmngr.h"
+#include "factpar.h"
 #include "factrhs.h"
 #include "match.h"
 #include "memalloc.h"
@@ -118,6 +124,10 @@
 /***************************************/
 
    static struct expr            *AssertParse(Environment *,struct expr *,const char *);
+   static struct expr            *AssertBatchParse(Environment *,struct expr *,const char *);
+   static Fact                   *CreateAssertedFact(Environment *,struct expr *);
+   static bool                    AddRetractedFact(Environment *,UDFContext *,UDFValue *,
+                                                   Fact ***,size_t *,size_t *);
 #if DEBUGGING_FUNCTIONS
    static long long               GetFactsArgument(UDFContext *);
 #endif
@@ -139,23 +149,31 @@ void FactCommandDefinitions(
 
    AddUDF(theEnv,"assert","bf",0,UNBOUNDED,NULL,AssertCommand,"AssertCommand",NULL);
    AddUDF(theEnv,"retract", "v",1,UNBOUNDED,"fly",RetractCommand,"RetractCommand",NULL);
+   AddUDF(theEnv,"assert-batch","l",1,UNBOUNDED,NULL,AssertBatchCommand,"AssertBatchCommand",NULL);
+   AddUDF(theEnv,"retract-batch","v",1,UNBOUNDED,"flm",RetractBatchCommand,"RetractBatchCommand",NULL);
    AddUDF(theEnv,"assert-string","bf",1,1,"s",AssertStringFunction,"AssertStringFunction",NULL);
    AddUDF(theEnv,"str-assert","bf",1,1,"s",AssertStringFunction,"AssertStringFunction",NULL);
 
    AddUDF(theEnv,"get-fact-duplication","b",0,0,NULL,GetFactDuplicationCommand,"GetFactDuplicationCommand", NULL);
    AddUDF(theEnv,"set-fact-duplication","b",1,1,NULL,SetFactDuplicationCommand,"SetFactDuplicationCommand", NULL);
+   AddUDF(theEnv,"get-slot-specific-modify","b",0,0,NULL,GetSlotSpecificModifyCommand,"GetSlotSpecificModifyCommand", NULL);
+   AddUDF(theEnv,"set-slot-specific-modify","b",1,1,NULL,SetSlotSpecificModifyCommand,"SetSlotSpecificModifyCommand", NULL);
+   AddUDF(theEnv,"get-pattern-match-workers","l",0,0,NULL,GetPatternMatchWorkersCommand,"GetPatternMatchWorkersCommand", NULL);
+   AddUDF(theEnv,"set-pattern-match-workers","l",1,1,"l",SetPatternMatchWorkersCommand,"SetPatternMatchWorkersCommand", NULL);
 
    AddUDF(theEnv,"save-facts","b",1,UNBOUNDED,"y;sy",SaveFactsCommand,"SaveFactsCommand",NULL);
    AddUDF(theEnv,"load-facts","b",1,1,"sy",LoadFactsCommand,"LoadFactsCommand",NULL);
    AddUDF(theEnv,"fact-index","l",1,1,"f",FactIndexFunction,"FactIndexFunction",NULL);
 
    FuncSeqOvlFlags(theEnv,"assert",false,false);
+   FuncSeqOvlFlags(theEnv,"assert-batch",false,false);
 #else
 #if MAC_XCD
 #pragma unused(theEnv)
 #endif
 #endif
    AddFunctionParser(theEnv,"assert",AssertParse);
+   AddFunctionParser(theEnv,"assert-batch",AssertBatchParse);
   }
 
 /***************************************/
@@ -166,23 +184,62 @@ void AssertCommand(
   Environment *theEnv,
   UDFContext *context,
   UDFValue *returnValue)
+  {
+   Fact *newFact, *theFact;
+
+   /*====================================*/
+   /* Create the fact from the evaluated */
+   /* values of its slot expressions.    */
+   /*====================================*/
+
+   newFact = CreateAssertedFact(theEnv,GetFirstArgument());
+   if (newFact == NULL)
+     {
+      returnValue->lexemeValue = FalseSymbol(theEnv);
+      return;
+     }
+
+   /*================================*/
+   /* Add the fact to the fact-list. */
+   /*================================*/
+
+   theFact = Assert(newFact);
+
+   /*========================================*/
+   /* The asserted fact is the return value. */
+   /*========================================*/
+
+   if (theFact != NULL)
+     { returnValue->factValue = theFact; }
+   else
+     { returnValue->lexemeValue = FalseSymbol(theEnv); }
+
+   return;
+  }
+
+/*****************************************************************/
+/* CreateAssertedFact: Creates a fact from the expression for an */
+/*   assert command. The first argument of the expression is the */
+/*   deftemplate of the fact and the remaining arguments are the */
+/*   values of its slots. Returns NULL if a value is invalid.    */
+/*****************************************************************/
+static Fact *CreateAssertedFact(
+  Environment *theEnv,
+  struct expr *theExpression)
   {
    Deftemplate *theDeftemplate;
    CLIPSValue *theField;
    UDFValue theValue;
-   struct expr *theExpression;
    struct templateSlot *slotPtr;
    Fact *newFact;
    bool error = false;
    int i;
-   Fact *theFact;
 
    /*================================*/
    /* Get the deftemplate associated */
    /* with the fact being asserted.  */
    /*================================*/
 
-   theExpression = GetFirstArgument();
    theDeftemplate = (Deftemplate *) theExpression->value;
 
    /*=======================================*/
@@ -263,26 +320,57 @@ void AssertCommand(
    if (error)
      {
       ReturnFact(theEnv,newFact);
-      returnValue->lexemeValue = FalseSymbol(theEnv);
-      return;
+      return NULL;
      }
 
-   /*================================*/
-   /* Add the fact to the fact-list. */
-   /*================================*/
+   return newFact;
+  }
 
-   theFact = Assert(newFact);
+/*******************************************/
+/* AssertBatchCommand: H/L access routine  */
+/*   for the assert-batch function.        */
+/*******************************************/
+void AssertBatchCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   struct expr *theArgument;
+   Fact **theFacts;
+   size_t count = 0, i, added = 0;
+
+   for (theArgument = GetFirstArgument();
+        theArgument != NULL;
+        theArgument = GetNextArgument(theArgument))
+     { count++; }
+
+   /*=======================================================*/
+   /* Each argument is an assert call. Create its fact and  */
+   /* keep a second copy of the pointers to determine which */
+   /* facts were added rather than found to be duplicates.  */
+   /*=======================================================*/
+
+   theFacts = (Fact **) genalloc(theEnv,sizeof(Fact *) * count * 2);
+
+   for (theArgument = GetFirstArgument(), i = 0;
+        theArgument != NULL;
+        theArgument = GetNextArgument(theArgument), i++)
+     {
+      theFacts[i] = CreateAssertedFact(theEnv,theArgument->argList);
+      theFacts[count + i] = theFacts[i];
+     }
 
-   /*========================================*/
-   /* The asserted fact is the return value. */
-   /*========================================*/
+   AssertBatch(theEnv,theFacts,count);
 
-   if (theFact != NULL)
-     { returnValue->factValue = theFact; }
-   else
-     { returnValue->lexemeValue = FalseSymbol(theEnv); }
+   for (i = 0; i < count; i++)
+     {
+      if ((theFacts[i] != NULL) && (theFacts[i] == theFacts[count + i]))
+        { added++; }
+     }
 
-   return;
+   genfree(theEnv,theFacts,sizeof(Fact *) * count * 2);
+
+   returnValue->integerValue = CreateInteger(theEnv,(long long) added);
   }
 
 /****************************************/
@@ -384,6 +472,118 @@ void RetractCommand(
      }
   }
 
+/********************************************/
+/* RetractBatchCommand: H/L access routine  */
+/*   for the retract-batch command.         */
+/********************************************/
+void RetractBatchCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg, theItem;
+   Fact **theFacts = NULL;
+   size_t count = 0, size = 0, i;
+   bool ok = true;
+
+   /*======================================================*/
+   /* Collect the facts specified by each argument. A fact */
+   /* is retained until the group has been retracted.      */
+   /*======================================================*/
+
+   while (ok && UDFHasNextArgument(context))
+     {
+      if (! UDFNextArgument(context,INTEGER_BIT | FACT_ADDRESS_BIT | MULTIFIELD_BIT,&theArg))
+        {
+         ok = false;
+         break;
+        }
+
+      if (CVIsType(&theArg,MULTIFIELD_BIT))
+        {
+         for (i = theArg.begin; ok && (i < (theArg.begin + theArg.range)); i++)
+           {
+            theItem.value = theArg.multifieldValue->contents[i].value;
+            ok = AddRetractedFact(theEnv,context,&theItem,&theFacts,&count,&size);
+           }
+        }
+      else
+        { ok = AddRetractedFact(theEnv,context,&theArg,&theFacts,&count,&size); }
+     }
+
+   if (ok)
+     { RetractBatch(theEnv,theFacts,count); }
+
+   for (i = 0; i < count; i++)
+     { ReleaseFact(theFacts[i]); }
+
+   if (size != 0)
+     { genfree(theEnv,theFacts,sizeof(Fact *) * size); }
+  }
+
+/*************************************************************/
+/* AddRetractedFact: Adds the fact specified by a fact-index */
+/*   or fact-address to the facts to be retracted by the     */
+/*   retract-batch command. Returns false if the value isn't */
+/*   a fact specifier.                                       */
+/*************************************************************/
+static bool AddRetractedFact(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *theValue,
+  Fact ***theFacts,
+  size_t *count,
+  size_t *size)
+  {
+   Fact *theFact, **newFacts;
+   long long factIndex;
+
+   if (CVIsType(theValue,FACT_ADDRESS_BIT))
+     { theFact = theValue->factValue; }
+   else if (CVIsType(theValue,INTEGER_BIT))
+     {
+      factIndex = theValue->integerValue->contents;
+      if (factIndex < 0)
+        {
+         UDFInvalidArgumentMessage(context,"fact-address, fact-index, or a multifield of them");
+         SetEvaluationError(theEnv,true);
+         return false;
+        }
+
+      theFact = FindIndexedFact(theEnv,factIndex);
+      if (theFact == NULL)
+        {
+         char tempBuffer[20];
+         gensprintf(tempBuffer,"f-%lld",factIndex);
+         CantFindItemErrorMessage(theEnv,"fact",tempBuffer,false);
+         return true;
+        }
+     }
+   else
+     {
+      UDFInvalidArgumentMessage(context,"fact-address, fact-index, or a multifield of them");
+      SetEvaluationError(theEnv,true);
+      return false;
+     }
+
+   if (*count == *size)
+     {
+      newFacts = (Fact **) genalloc(theEnv,sizeof(Fact *) * (*size + 32));
+      if (*size != 0)
+        {
+         GenCopyMemory(Fact *,*count,newFacts,*theFacts);
+         genfree(theEnv,*theFacts,sizeof(Fact *) * *size);
+        }
+      *theFacts = newFacts;
+      *size += 32;
+     }
+
+   RetainFact(theFact);
+   (*theFacts)[(*count)++] = theFact;
+
+   return true;
+  }
+
 /***************************************************/
 /* SetFactDuplicationCommand: H/L access routine   */
 /*   for the set-fact-duplication command.         */
@@ -428,6 +628,77 @@ void GetFactDuplicationCommand(
    returnValue->lexemeValue = CreateBoolean(theEnv,GetFactDuplication(theEnv));
   }
 
+/******************************************************/
+/* SetSlotSpecificModifyCommand: H/L access routine   */
+/*   for the set-slot-specific-modify command.        */
+/******************************************************/
+void SetSlotSpecificModifyCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+
+   returnValue->lexemeValue = CreateBoolean(theEnv,GetSlotSpecificModify(theEnv));
+
+   if (! UDFFirstArgument(context,ANY_TYPE_BITS,&theArg))
+     { return; }
+
+   SetSlotSpecificModify(theEnv,theArg.value != FalseSymbol(theEnv));
+  }
+
+/******************************************************/
+/* GetSlotSpecificModifyCommand: H/L access routine   */
+/*   for the get-slot-specific-modify command.        */
+/******************************************************/
+void GetSlotSpecificModifyCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   returnValue->lexemeValue = CreateBoolean(theEnv,GetSlotSpecificModify(theEnv));
+  }
+
+/*******************************************************/
+/* SetPatternMatchWorkersCommand: H/L access routine   */
+/*   for the set-pattern-match-workers command.        */
+/*******************************************************/
+void SetPatternMatchWorkersCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+   long long workers;
+
+   returnValue->integerValue = CreateInteger(theEnv,GetPatternMatchWorkers(theEnv));
+
+   if (! UDFFirstArgument(context,INTEGER_BIT,&theArg))
+     { return; }
+
+   workers = theArg.integerValue->contents;
+   if ((workers < 1) || (workers > MAX_PATTERN_MATCH_WORKERS))
+     {
+      UDFInvalidArgumentMessage(context,"integer from 1 to " STR_MAX_PATTERN_MATCH_WORKERS);
+      SetEvaluationError(theEnv,true);
+      return;
+     }
+
+   SetPatternMatchWorkers(theEnv,(unsigned short) workers);
+  }
+
+/*******************************************************/
+/* GetPatternMatchWorkersCommand: H/L access routine   */
+/*   for the get-pattern-match-workers command.        */
+/*******************************************************/
+void GetPatternMatchWorkersCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   returnValue->integerValue = CreateInteger(theEnv,GetPatternMatchWorkers(theEnv));
+  }
+
 /*******************************************/
 /* FactIndexFunction: H/L access routine   */
 /*   for the fact-index function.          */
@@ -1301,6 +1572,47 @@ static struct expr *AssertParse(
    return(rv);
   }
 
+/*****************************************************************/
+/* AssertBatchParse: Driver routine for parsing the assert-batch */
+/*   function. Each fact is stored as an assert call argument.   */
+/*****************************************************************/
+static struct expr *AssertBatchParse(
+  Environment *theEnv,
+  struct expr *top,
+  const char *logicalName)
+  {
+   bool error;
+   struct expr *rv;
+   struct token theToken;
+
+   SavePPBuffer(theEnv," ");
+   IncrementIndentDepth(theEnv,14);
+   rv = BuildRHSAssert(theEnv,logicalName,&theToken,&error,true,true,"assert-batch command");
+   DecrementIndentDepth(theEnv,14);
+
+   if (rv == NULL)
+     {
+      ReturnExpression(theEnv,top);
+      return NULL;
+     }
+
+   /*===============================================*/
+   /* More than one fact is returned as the list of */
+   /* arguments of a progn call.                    */
+   /*===============================================*/
+
+   if (rv->value == (void *) FindFunction(theEnv,"progn"))
+     {
+      top->argList = rv->argList;
+      rv->argList = NULL;
+      ReturnExpression(theEnv,rv);
+     }
+   else
+     { top->argList = rv; }
+
+   return top;
+  }
+
 #endif /* DEFTEMPLATE_CONSTRUCT */
 
 
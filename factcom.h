@@ -53,6 +53,11 @@
 /*                                                           */
 /*            UDF redesign.                                  */
 /*                                                           */
+/*            Added assert-batch and retract-batch commands. */
+/*                                                           */
+/*            Added get-pattern-match-workers and            */
+/*            set-pattern-match-workers commands.            */
+/*                                                           */
 /*************************************************************/
 
 #ifndef _H_factcom
@@ -66,11 +71,17 @@
    void                           FactCommandDefinitions(Environment *);
    void                           AssertCommand(Environment *,UDFContext *,UDFValue *);
    void                           RetractCommand(Environment *,UDFContext *,UDFValue *);
+   void                           AssertBatchCommand(Environment *,UDFContext *,UDFValue *);
+   void                           RetractBatchCommand(Environment *,UDFContext *,UDFValue *);
    void                           AssertStringFunction(Environment *,UDFContext *,UDFValue *);
    void                           FactsCommand(Environment *,UDFContext *,UDFValue *);
    void                           Facts(Environment *,const char *,Defmodule *,long long,long long,long long);
    void                           SetFactDuplicationCommand(Environment *,UDFContext *,UDFValue *);
    void                           GetFactDuplicationCommand(Environment *,UDFContext *,UDFValue *);
+   void                           GetSlotSpecificModifyCommand(Environment *,UDFContext *,UDFValue *);
+   void                           SetSlotSpecificModifyCommand(Environment *,UDFContext *,UDFValue *);
+   void                           GetPatternMatchWorkersCommand(Environment *,UDFContext *,UDFValue *);
+   void                           SetPatternMatchWorkersCommand(Environment *,UDFContext *,UDFValue *);
    void                           SaveFactsCommand(Environment *,UDFContext *,UDFValue *);
    void                           LoadFactsCommand(Environment *,UDFContext *,UDFValue *);
    bool                           SaveFacts(Environment *,const char *,SaveScope);
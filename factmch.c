@@ -46,9 +46,17 @@
 /*            Watch facts for modify command only prints     */
 /*            changed slots.                                 */
 /*                                                           */
+/*            Alpha matches of facts asserted as a batch can */
+/*            be staged and sent through the join network    */
+/*            once the batch has been matched.               */
+/*                                                           */
+/*            Added StageFactPatternMatch for matches found  */
+/*            by pattern match workers.                      */
+/*                                                           */
 /*************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "setup.h"
 
@@ -77,6 +85,10 @@
    static bool                     EvaluatePatternExpression(Environment *,struct factPatternNode *,struct expr *);
    static void                     TraceErrorToJoin(Environment *,struct factPatternNode *,bool);
    static void                     ProcessFactAlphaMatch(Environment *,Fact *,struct multifieldMarker *,struct factPatternNode *);
+   static void                     AssertFactAlphaMatch(Environment *,Fact *,struct multifieldMarker *,
+                                                        struct factPatternNode *,unsigned long);
+   static void                     StageFactAlphaMatch(Environment *,Fact *,struct multifieldMarker *,
+                                                       struct factPatternNode *,unsigned long);
    static struct factPatternNode  *GetNextFactPatternNode(Environment *,bool,struct factPatternNode *);
    static bool                     SkipFactPatternNode(Environment *,struct factPatternNode *);
    static void                     ProcessMultifieldNode(Environment *,
@@ -540,7 +552,8 @@ static struct factPatternNode *GetNextFactPatternNode(
 /* ProcessFactAlphaMatch: When a fact pattern has been */
 /*   satisfied, this routine creates an alpha match to */
 /*   store in the pattern network and then sends the   */
-/*   new alpha match through the join network.         */
+/*   new alpha match through the join network, or      */
+/*   stages it if facts are being asserted as a batch. */
 /*******************************************************/
 static void ProcessFactAlphaMatch(
   Environment *theEnv,
@@ -548,42 +561,193 @@ static void ProcessFactAlphaMatch(
   struct multifieldMarker *theMarks,
   struct factPatternNode *thePattern)
   {
-   struct partialMatch *theMatch;
-   struct patternMatch *listOfMatches;
-   struct joinNode *listOfJoins;
    unsigned long hashValue;
 
+  /*====================================================*/
+  /* During a slot specific modify, the alpha matches   */
+  /* of patterns which do not reference a changed slot  */
+  /* were kept, so they must not be created again.      */
+  /*====================================================*/
+
+  if ((FactData(theEnv)->ModifyChangeMap != NULL) &&
+      (! FactPatternReferencesSlots(thePattern,FactData(theEnv)->ModifyChangeMap)))
+    { return; }
+
   /*============================================*/
   /* Create the hash value for the alpha match. */
   /*============================================*/
 
   hashValue = ComputeRightHashValue(theEnv,&thePattern->header);
 
-  /*===========================================*/
-  /* Create the partial match for the pattern. */
-  /*===========================================*/
+  /*===================================================*/
+  /* The alpha matches of facts asserted as a batch    */
+  /* are sent through the join network once the alpha  */
+  /* network has been traversed for all of the facts.  */
+  /*===================================================*/
+
+  if (FactData(theEnv)->StagingAlphaMatches)
+    {
+     StageFactAlphaMatch(theEnv,theFact,theMarks,thePattern,hashValue);
+     return;
+    }
+
+  AssertFactAlphaMatch(theEnv,theFact,theMarks,thePattern,hashValue);
+  }
+
+/*************************************************************/
+/* AssertFactAlphaMatch: Creates an alpha match to store in  */
+/*   the pattern network and sends it through the joins      */
+/*   connected to the pattern.                               */
+/*************************************************************/
+static void AssertFactAlphaMatch(
+  Environment *theEnv,
+  Fact *theFact,
+  struct multifieldMarker *theMarks,
+  struct factPatternNode *thePattern,
+  unsigned long hashValue)
+  {
+   struct partialMatch *theMatch;
+   struct patternMatch *listOfMatches;
+   struct joinNode *listOfJoins;
+
+   /*===========================================*/
+   /* Create the partial match for the pattern. */
+   /*===========================================*/
+
+   theMatch = CreateAlphaMatch(theEnv,theFact,theMarks,(struct patternNodeHeader *) &thePattern->header,hashValue);
+   theMatch->owner = &thePattern->header;
 
-  theMatch = CreateAlphaMatch(theEnv,theFact,theMarks,(struct patternNodeHeader *) &thePattern->header,hashValue);
-  theMatch->owner = &thePattern->header;
+   /*=======================================================*/
+   /* Add the pattern to the list of matches for this fact. */
+   /*=======================================================*/
 
-  /*=======================================================*/
-  /* Add the pattern to the list of matches for this fact. */
-  /*=======================================================*/
+   listOfMatches = (struct patternMatch *) theFact->list;
+   theFact->list = get_struct(theEnv,patternMatch);
+   ((struct patternMatch *) theFact->list)->next = listOfMatches;
+   ((struct patternMatch *) theFact->list)->matchingPattern = (struct patternNodeHeader *) thePattern;
+   ((struct patternMatch *) theFact->list)->theMatch = theMatch;
 
-  listOfMatches = (struct patternMatch *) theFact->list;
-  theFact->list = get_struct(theEnv,patternMatch);
-  ((struct patternMatch *) theFact->list)->next = listOfMatches;
-  ((struct patternMatch *) theFact->list)->matchingPattern = (struct patternNodeHeader *) thePattern;
-  ((struct patternMatch *) theFact->list)->theMatch = theMatch;
+   /*================================================================*/
+   /* Send the partial match to the joins connected to this pattern. */
+   /*================================================================*/
 
-  /*================================================================*/
-  /* Send the partial match to the joins connected to this pattern. */
-  /*================================================================*/
+   for (listOfJoins = thePattern->header.entryJoin;
+        listOfJoins != NULL;
+        listOfJoins = listOfJoins->rightMatchNode)
+      { NetworkAssert(theEnv,theMatch,listOfJoins); }
+  }
 
-  for (listOfJoins = thePattern->header.entryJoin;
-       listOfJoins != NULL;
-       listOfJoins = listOfJoins->rightMatchNode)
-     { NetworkAssert(theEnv,theMatch,listOfJoins); }
+/***********************************************************/
+/* StageFactAlphaMatch: Saves an alpha match for a fact    */
+/*   asserted as part of a batch. The multifield markers   */
+/*   are copied since they only exist while the pattern    */
+/*   network is being traversed.                           */
+/***********************************************************/
+static void StageFactAlphaMatch(
+  Environment *theEnv,
+  Fact *theFact,
+  struct multifieldMarker *theMarks,
+  struct factPatternNode *thePattern,
+  unsigned long hashValue)
+  {
+   struct factAlphaStage *newStage;
+   size_t newSize;
+
+   if (FactData(theEnv)->AlphaStageCount == FactData(theEnv)->AlphaStageSize)
+     {
+      newSize = (FactData(theEnv)->AlphaStageSize == 0) ? 64 : (FactData(theEnv)->AlphaStageSize * 2);
+      newStage = (struct factAlphaStage *) genalloc(theEnv,sizeof(struct factAlphaStage) * newSize);
+      if (FactData(theEnv)->AlphaStageSize != 0)
+        {
+         GenCopyMemory(struct factAlphaStage,FactData(theEnv)->AlphaStageCount,
+                       newStage,FactData(theEnv)->AlphaStage);
+         genfree(theEnv,FactData(theEnv)->AlphaStage,
+                 sizeof(struct factAlphaStage) * FactData(theEnv)->AlphaStageSize);
+        }
+      FactData(theEnv)->AlphaStage = newStage;
+      FactData(theEnv)->AlphaStageSize = newSize;
+     }
+
+   newStage = &FactData(theEnv)->AlphaStage[FactData(theEnv)->AlphaStageCount];
+   newStage->theFact = theFact;
+   newStage->markers = (theMarks == NULL) ? NULL : CopyMultifieldMarkers(theEnv,theMarks);
+   newStage->thePattern = thePattern;
+   newStage->hashValue = hashValue;
+   FactData(theEnv)->AlphaStageCount++;
+  }
+
+/**************************************************************/
+/* StageFactPatternMatch: Stages the alpha match of a fact    */
+/*   for a terminal pattern node reached without binding any  */
+/*   multifield wildcards or variables.                       */
+/**************************************************************/
+void StageFactPatternMatch(
+  Environment *theEnv,
+  Fact *theFact,
+  struct factPatternNode *thePattern)
+  {
+   FactData(theEnv)->CurrentPatternFact = theFact;
+   FactData(theEnv)->CurrentPatternMarks = NULL;
+
+   ProcessFactAlphaMatch(theEnv,theFact,NULL,thePattern);
+  }
+
+/**************************************************************/
+/* PropagateStagedFactMatches: Sends the alpha matches staged */
+/*   for a batch of facts through the join network in the     */
+/*   order they were found, so the partial matches and        */
+/*   activations are created in the same order as when the    */
+/*   facts are asserted one at a time.                        */
+/**************************************************************/
+void PropagateStagedFactMatches(
+  Environment *theEnv)
+  {
+   struct factAlphaStage *theStage = FactData(theEnv)->AlphaStage;
+   size_t i, count = FactData(theEnv)->AlphaStageCount;
+   struct multifieldMarker *theMark, *nextMark;
+
+   if (count == 0) return;
+
+   for (i = 0; i < count; i++)
+     {
+      AssertFactAlphaMatch(theEnv,theStage[i].theFact,theStage[i].markers,
+                           theStage[i].thePattern,theStage[i].hashValue);
+
+      for (theMark = theStage[i].markers; theMark != NULL; theMark = nextMark)
+        {
+         nextMark = theMark->next;
+         rtn_struct(theEnv,multifieldMarker,theMark);
+        }
+     }
+
+   genfree(theEnv,theStage,sizeof(struct factAlphaStage) * FactData(theEnv)->AlphaStageSize);
+   FactData(theEnv)->AlphaStage = NULL;
+   FactData(theEnv)->AlphaStageCount = 0;
+   FactData(theEnv)->AlphaStageSize = 0;
+  }
+
+/******************************************************************/
+/* FactPatternReferencesSlots: Determines whether the pattern     */
+/*   ending at the specified terminal node references any of the  */
+/*   slots set in a modify change map.                            */
+/******************************************************************/
+bool FactPatternReferencesSlots(
+  struct factPatternNode *thePattern,
+  const char *changeMap)
+  {
+   CLIPSBitMap *slotMap = thePattern->slotbmp;
+   unsigned short i;
+
+   if (slotMap == NULL)
+     { return false; }
+
+   for (i = 0; i < slotMap->size; i++)
+     {
+      if (slotMap->contents[i] & changeMap[i])
+        { return true; }
+     }
+
+   return false;
   }
 
 /*****************************************************************/
@@ -40,6 +40,11 @@
 /*            Removed use of void pointers for specific      */
 /*            data structures.                               */
 /*                                                           */
+/*            Added staging of alpha matches for batched     */
+/*            fact assertions.                               */
+/*                                                           */
+/*            Added StageFactPatternMatch function.          */
+/*                                                           */
 /*************************************************************/
 
 #ifndef _H_factmch
@@ -52,12 +57,28 @@
 #include "factbld.h"
 #include "factmngr.h"
 
+/*************************************************************/
+/* factAlphaStage: An alpha match found for a fact asserted  */
+/*   as part of a batch which hasn't yet been sent through   */
+/*   the join network.                                       */
+/*************************************************************/
+struct factAlphaStage
+  {
+   Fact *theFact;
+   struct multifieldMarker *markers;
+   struct factPatternNode *thePattern;
+   unsigned long hashValue;
+  };
+
    void                           FactPatternMatch(Environment *,Fact *,
                                                    struct factPatternNode *,size_t,size_t,
                                                    struct multifieldMarker *,
                                                    struct multifieldMarker *);
    void                           MarkFactPatternForIncrementalReset(Environment *,struct patternNodeHeader *,bool);
    void                           FactsIncrementalReset(Environment *);
+   bool                           FactPatternReferencesSlots(struct factPatternNode *,const char *);
+   void                           PropagateStagedFactMatches(Environment *);
+   void                           StageFactPatternMatch(Environment *,Fact *,struct factPatternNode *);
 
 #endif /* _H_factmch */
 
@@ -108,9 +108,21 @@
 /*            Assert returns duplicate fact. FALSE is now    */
 /*            returned only if an error occurs.              */
 /*                                                           */
+/*            Added AssertBatch and RetractBatch functions.  */
+/*                                                           */
+/*            The alpha tests of a batch can be evaluated by */
+/*            pattern match workers.                         */
+/*                                                           */
+/*            FindIndexedFact uses a table of asserted facts */
+/*            paged by fact index.                           */
+/*                                                           */
+/*            Asserted, retracted, and modified facts update */
+/*            the fact-set query slot indexes.               */
+/*                                                           */
 /*************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "setup.h"
 
@@ -124,6 +136,7 @@
 #include "factcom.h"
 #include "factfun.h"
 #include "factmch.h"
+#include "factpar.h"
 #include "factqury.h"
 #include "factrhs.h"
 #include "lgcldpnd.h"
@@ -143,6 +156,18 @@
 
 #include "factmngr.h"
 
+#define FACT_INDEX_PAGE_SIZE 1024
+
+/****************************************************/
+/* factIndexPage: The asserted facts for a range of */
+/*   FACT_INDEX_PAGE_SIZE consecutive fact indices. */
+/****************************************************/
+struct factIndexPage
+  {
+   size_t count;
+   Fact *facts[FACT_INDEX_PAGE_SIZE];
+  };
+
 /***************************************/
 /* LOCAL INTERNAL FUNCTION DEFINITIONS */
 /***************************************/
@@ -152,6 +177,10 @@
    static void                    RemoveGarbageFacts(Environment *,void *);
    static void                    DeallocateFactData(Environment *);
    static bool                    RetractCallback(Fact *,Environment *);
+   static void                    UnlinkRetractedFact(Environment *,Fact *,bool,char *);
+   static Fact                   *InstallAssertedFact(Environment *,Fact *,long long,Fact *,Fact *,char *);
+   static void                    AddIndexedFact(Environment *,Fact *);
+   static void                    RemoveIndexedFact(Environment *,Fact *);
 
 /**************************************************************/
 /* InitializeFacts: Initializes the fact data representation. */
@@ -190,6 +219,7 @@ void InitializeFacts(
    dummyFact.patternHeader.theInfo = &FactData(theEnv)->FactInfo;
    memcpy(&FactData(theEnv)->DummyFact,&dummyFact,sizeof(struct fact));
    FactData(theEnv)->LastModuleIndex = -1;
+   FactData(theEnv)->PatternMatchWorkers = 1;
 
    /*=========================================*/
    /* Initialize the fact hash table (used to */
@@ -317,6 +347,18 @@ static void DeallocateFactData(
       tmpFactPtr = nextFactPtr;
      }
 
+   for (i = 0; i < FactData(theEnv)->FactIndexPageCount; i++)
+     {
+      if (FactData(theEnv)->FactIndexPages[i] != NULL)
+        { rm(theEnv,FactData(theEnv)->FactIndexPages[i],sizeof(struct factIndexPage)); }
+     }
+
+   if (FactData(theEnv)->FactIndexPages != NULL)
+     {
+      rm(theEnv,FactData(theEnv)->FactIndexPages,
+         sizeof(struct factIndexPage *) * FactData(theEnv)->FactIndexPageCount);
+     }
+
    DeallocateCallListWithArg(theEnv,FactData(theEnv)->ListOfAssertFunctions);
    DeallocateCallListWithArg(theEnv,FactData(theEnv)->ListOfRetractFunctions);
    DeallocateModifyCallList(theEnv,FactData(theEnv)->ListOfModifyFunctions);
@@ -511,10 +553,13 @@ void MatchFactFunction(
    FactPatternMatch(theEnv,theFact,theFact->whichDeftemplate->patternNetwork,0,0,NULL,NULL);
   }
 
-/**********************************************/
-/* RetractDriver: Driver routine for Retract. */
-/**********************************************/
-RetractError RetractDriver(
+/**********************************************************/
+/* UnlinkRetractedFact: Removes a fact being retracted    */
+/*   from the fact-list and its template's list of facts  */
+/*   and marks it as garbage, but does not remove its     */
+/*   matches from the pattern and join networks.          */
+/**********************************************************/
+static void UnlinkRetractedFact(
   Environment *theEnv,
   Fact *theFact,
   bool modifyOperation,
@@ -523,47 +568,6 @@ RetractError RetractDriver(
    Deftemplate *theTemplate = theFact->whichDeftemplate;
    struct callFunctionItemWithArg *theRetractFunction;
 
-   FactData(theEnv)->retractError = RE_NO_ERROR;
-
-   /*===========================================*/
-   /* Retracting a retracted fact does nothing. */
-   /*===========================================*/
-
-   if (theFact->garbage)
-     { return RE_NO_ERROR; }
-
-   /*===========================================*/
-   /* A fact can not be retracted while another */
-   /* fact is being asserted or retracted.      */
-   /*===========================================*/
-
-   if (EngineData(theEnv)->JoinOperationInProgress)
-     {
-      PrintErrorID(theEnv,"FACTMNGR",1,true);
-      WriteString(theEnv,STDERR,"Facts may not be retracted during pattern-matching.\n");
-      SetEvaluationError(theEnv,true);
-      FactData(theEnv)->retractError = RE_COULD_NOT_RETRACT_ERROR;
-      return RE_COULD_NOT_RETRACT_ERROR;
-     }
-
-   /*====================================*/
-   /* A NULL fact pointer indicates that */
-   /* all facts should be retracted.     */
-   /*====================================*/
-
-   if (theFact == NULL)
-     { return RetractAllFacts(theEnv); }
-
-   /*=================================================*/
-   /* Check to see if the fact has not been asserted. */
-   /*=================================================*/
-   
-   if (theFact->factIndex == 0)
-     {
-      SystemError(theEnv,"FACTMNGR",5);
-      ExitRouter(theEnv,EXIT_FAILURE);
-     }
-   
    /*===========================================*/
    /* Execute the list of functions that are    */
    /* to be called before each fact retraction. */
@@ -612,6 +616,11 @@ RetractError RetractDriver(
    /*===========================================*/
 
    RemoveHashedFact(theEnv,theFact);
+   RemoveIndexedFact(theEnv,theFact);
+#if FACT_SET_QUERIES
+   if (theTemplate->queryIndexes != NULL)
+     { RemoveQueryIndexedFact(theEnv,theFact); }
+#endif
 
    /*=========================================*/
    /* Remove the fact from its template list. */
@@ -669,6 +678,63 @@ RetractError RetractDriver(
       theFact->nextFact = NULL;
      }
    theFact->garbage = true;
+  }
+
+/**********************************************/
+/* RetractDriver: Driver routine for Retract. */
+/**********************************************/
+RetractError RetractDriver(
+  Environment *theEnv,
+  Fact *theFact,
+  bool modifyOperation,
+  char *changeMap)
+  {
+   FactData(theEnv)->retractError = RE_NO_ERROR;
+
+   /*===========================================*/
+   /* Retracting a retracted fact does nothing. */
+   /*===========================================*/
+
+   if (theFact->garbage)
+     { return RE_NO_ERROR; }
+
+   /*===========================================*/
+   /* A fact can not be retracted while another */
+   /* fact is being asserted or retracted.      */
+   /*===========================================*/
+
+   if (EngineData(theEnv)->JoinOperationInProgress)
+     {
+      PrintErrorID(theEnv,"FACTMNGR",1,true);
+      WriteString(theEnv,STDERR,"Facts may not be retracted during pattern-matching.\n");
+      SetEvaluationError(theEnv,true);
+      FactData(theEnv)->retractError = RE_COULD_NOT_RETRACT_ERROR;
+      return RE_COULD_NOT_RETRACT_ERROR;
+     }
+
+   /*====================================*/
+   /* A NULL fact pointer indicates that */
+   /* all facts should be retracted.     */
+   /*====================================*/
+
+   if (theFact == NULL)
+     { return RetractAllFacts(theEnv); }
+
+   /*=================================================*/
+   /* Check to see if the fact has not been asserted. */
+   /*=================================================*/
+   
+   if (theFact->factIndex == 0)
+     {
+      SystemError(theEnv,"FACTMNGR",5);
+      ExitRouter(theEnv,EXIT_FAILURE);
+     }
+   
+   /*=====================================*/
+   /* Remove the fact from the fact-list. */
+   /*=====================================*/
+
+   UnlinkRetractedFact(theEnv,theFact,modifyOperation,changeMap);
 
    /*===================================================*/
    /* Reset the evaluation error flag since expressions */
@@ -766,6 +832,151 @@ RetractError Retract(
    return rv;
   }
 
+/*************************************************************/
+/* RetractBatch: C access routine for retracting a group of  */
+/*   facts. All of the facts are removed from the fact-list  */
+/*   before any of their matches are removed from the join   */
+/*   network, so partial matches which would be created as   */
+/*   one fact is retracted are never built from another fact */
+/*   of the group. Returns the first error encountered.      */
+/*************************************************************/
+RetractError RetractBatch(
+  Environment *theEnv,
+  Fact **theFacts,
+  size_t count)
+  {
+   GCBlock gcb;
+   size_t i, factCount = 0;
+   Fact *theFact, **retracted;
+   struct patternMatch *theMatch, *listOfMatches = NULL, *lastMatch = NULL;
+   RetractError rv = RE_NO_ERROR;
+
+   /*==========================================*/
+   /* Facts can not be retracted while another */
+   /* fact is being asserted or retracted.     */
+   /*==========================================*/
+
+   if (EngineData(theEnv)->JoinOperationInProgress)
+     {
+      PrintErrorID(theEnv,"FACTMNGR",1,true);
+      WriteString(theEnv,STDERR,"Facts may not be retracted during pattern-matching.\n");
+      SetEvaluationError(theEnv,true);
+      FactData(theEnv)->retractError = RE_COULD_NOT_RETRACT_ERROR;
+      return RE_COULD_NOT_RETRACT_ERROR;
+     }
+
+   if (count == 0)
+     {
+      FactData(theEnv)->retractError = RE_NO_ERROR;
+      return RE_NO_ERROR;
+     }
+
+   /*=====================================*/
+   /* If embedded, clear the error flags. */
+   /*=====================================*/
+
+   if (EvaluationData(theEnv)->CurrentExpression == NULL)
+     { ResetErrorFlags(theEnv); }
+
+   GCBlockStart(theEnv,&gcb);
+
+   /*==========================================*/
+   /* Remove each fact from the fact-list. The */
+   /* retracted facts are marked as garbage,   */
+   /* so the join network treats the partial   */
+   /* matches containing them as deleted.      */
+   /*==========================================*/
+
+   retracted = (Fact **) genalloc(theEnv,sizeof(Fact *) * count);
+
+   for (i = 0; i < count; i++)
+     {
+      theFact = theFacts[i];
+
+      if (theFact == NULL)
+        {
+         if (rv == RE_NO_ERROR) rv = RE_NULL_POINTER_ERROR;
+         continue;
+        }
+
+      if (theFact->garbage) continue;
+
+      if (theFact->factIndex == 0)
+        {
+         if (rv == RE_NO_ERROR) rv = RE_COULD_NOT_RETRACT_ERROR;
+         continue;
+        }
+
+      UnlinkRetractedFact(theEnv,theFact,false,NULL);
+      retracted[factCount++] = theFact;
+     }
+
+   /*=============================================*/
+   /* Join the alpha matches of the facts into a  */
+   /* single list in the order of the facts.      */
+   /*=============================================*/
+
+   for (i = 0; i < factCount; i++)
+     {
+      theMatch = (struct patternMatch *) retracted[i]->list;
+      retracted[i]->list = NULL;
+      if (theMatch == NULL) continue;
+
+      if (lastMatch == NULL)
+        { listOfMatches = theMatch; }
+      else
+        { lastMatch->next = theMatch; }
+
+      for (lastMatch = theMatch; lastMatch->next != NULL; lastMatch = lastMatch->next)
+        { /* Do Nothing */ }
+     }
+
+   /*===================================================*/
+   /* Remove the matches from the pattern network and   */
+   /* the join network. Expressions may be evaluated as */
+   /* part of the retraction, so reset the error flag.  */
+   /*===================================================*/
+
+   SetEvaluationError(theEnv,false);
+
+   EngineData(theEnv)->JoinOperationInProgress = true;
+   NetworkRetract(theEnv,listOfMatches);
+   EngineData(theEnv)->JoinOperationInProgress = false;
+
+   /*=========================================*/
+   /* Free partial matches that were released */
+   /* by the retraction of the facts.         */
+   /*=========================================*/
+
+   if (EngineData(theEnv)->ExecutingRule == NULL)
+     { FlushGarbagePartialMatches(theEnv); }
+
+   /*=========================================*/
+   /* Retract other facts that were logically */
+   /* dependent on the facts just retracted.  */
+   /*=========================================*/
+
+   ForceLogicalRetractions(theEnv);
+
+   /*==================================*/
+   /* Update busy counts and ephemeral */
+   /* garbage information.             */
+   /*==================================*/
+
+   for (i = 0; i < factCount; i++)
+     { FactDeinstall(theEnv,retracted[i]); }
+
+   genfree(theEnv,retracted,sizeof(Fact *) * count);
+
+   if (GetEvaluationError(theEnv) && (rv == RE_NO_ERROR))
+     { rv = RE_RULE_NETWORK_ERROR; }
+
+   GCBlockEnd(theEnv,&gcb);
+
+   FactData(theEnv)->retractError = rv;
+   return rv;
+  }
+
 /*******************************************************************/
 /* RemoveGarbageFacts: Returns facts that have been retracted to   */
 /*   the pool of available memory. It is necessary to postpone     */
@@ -805,10 +1016,15 @@ static void RemoveGarbageFacts(
      }
   }
 
-/********************************************************/
-/* AssertDriver: Driver routine for the assert command. */
-/********************************************************/
-Fact *AssertDriver(
+/***********************************************************/
+/* InstallAssertedFact: Adds a fact being asserted to the  */
+/*   fact-list and its template's list of facts, but does  */
+/*   not pattern match it. Returns the fact, the duplicate */
+/*   fact found in the fact-list, or NULL if the fact      */
+/*   could not be added.                                   */
+/***********************************************************/
+static Fact *InstallAssertedFact(
+  Environment *theEnv,
   Fact *theFact,
   long long reuseIndex,
   Fact *factListPosition,
@@ -820,39 +1036,6 @@ Fact *AssertDriver(
    CLIPSValue *theField;
    Fact *duplicate;
    struct callFunctionItemWithArg *theAssertFunction;
-   Environment *theEnv = theFact->whichDeftemplate->header.env;
-
-   FactData(theEnv)->assertError = AE_NO_ERROR;
-   
-   /*==================================================*/
-   /* Retracted and existing facts cannot be asserted. */
-   /*==================================================*/
-   
-   if (theFact->garbage)
-     {
-      FactData(theEnv)->assertError = AE_RETRACTED_ERROR;
-      return NULL;
-     }
-
-   if (reuseIndex != theFact->factIndex)
-     {
-      SystemError(theEnv,"FACTMNGR",6);
-      ExitRouter(theEnv,EXIT_FAILURE);
-     }
-
-   /*==========================================*/
-   /* A fact can not be asserted while another */
-   /* fact is being asserted or retracted.     */
-   /*==========================================*/
-
-   if (EngineData(theEnv)->JoinOperationInProgress)
-     {
-      FactData(theEnv)->assertError = AE_COULD_NOT_ASSERT_ERROR;
-      ReturnFact(theEnv,theFact);
-      PrintErrorID(theEnv,"FACTMNGR",2,true);
-      WriteString(theEnv,STDERR,"Facts may not be asserted during pattern-matching.\n");
-      return NULL;
-     }
 
    /*=============================================================*/
    /* Replace invalid data types in the fact with the symbol nil. */
@@ -896,91 +1079,589 @@ Fact *AssertDriver(
       return NULL;
      }
 
-   /*======================================*/
-   /* Add the fact to the fact hash table. */
-   /*======================================*/
+   /*======================================*/
+   /* Add the fact to the fact hash table. */
+   /*======================================*/
+
+   AddHashedFact(theEnv,theFact,hashValue);
+
+   /*================================*/
+   /* Add the fact to the fact list. */
+   /*================================*/
+
+   if (reuseIndex == 0)
+     { factListPosition = FactData(theEnv)->LastFact; }
+
+   if (factListPosition == NULL)
+     {
+      theFact->nextFact = FactData(theEnv)->FactList;
+      FactData(theEnv)->FactList = theFact;
+      theFact->previousFact = NULL;
+      if (theFact->nextFact != NULL)
+        { theFact->nextFact->previousFact = theFact; }
+     }
+   else
+     {
+      theFact->nextFact = factListPosition->nextFact;
+      theFact->previousFact = factListPosition;
+      factListPosition->nextFact = theFact;
+      if (theFact->nextFact != NULL)
+        { theFact->nextFact->previousFact = theFact; }
+     }
+
+   if ((FactData(theEnv)->LastFact == NULL) || (theFact->nextFact == NULL))
+     { FactData(theEnv)->LastFact = theFact; }
+
+   /*====================================*/
+   /* Add the fact to its template list. */
+   /*====================================*/
+
+   if (reuseIndex == 0)
+     { templatePosition = theFact->whichDeftemplate->lastFact; }
+
+   if (templatePosition == NULL)
+     {
+      theFact->nextTemplateFact = theFact->whichDeftemplate->factList;
+      theFact->whichDeftemplate->factList = theFact;
+      theFact->previousTemplateFact = NULL;
+      if (theFact->nextTemplateFact != NULL)
+        { theFact->nextTemplateFact->previousTemplateFact = theFact; }
+     }
+   else
+     {
+      theFact->nextTemplateFact = templatePosition->nextTemplateFact;
+      theFact->previousTemplateFact = templatePosition;
+      templatePosition->nextTemplateFact = theFact;
+      if (theFact->nextTemplateFact != NULL)
+        { theFact->nextTemplateFact->previousTemplateFact = theFact; }
+     }
+
+   if ((theFact->whichDeftemplate->lastFact == NULL) || (theFact->nextTemplateFact == NULL))
+     { theFact->whichDeftemplate->lastFact = theFact; }
+
+   /*==================================*/
+   /* Set the fact index and time tag. */
+   /*==================================*/
+
+   if (reuseIndex > 0)
+     { theFact->factIndex = reuseIndex; }
+   else
+     { theFact->factIndex = FactData(theEnv)->NextFactIndex++; }
+
+   AddIndexedFact(theEnv,theFact);
+#if FACT_SET_QUERIES
+   if (theFact->whichDeftemplate->queryIndexes != NULL)
+     { AddQueryIndexedFact(theEnv,theFact); }
+#endif
+
+   theFact->patternHeader.timeTag = DefruleData(theEnv)->CurrentEntityTimeTag++;
+
+   /*=====================*/
+   /* Update busy counts. */
+   /*=====================*/
+
+   FactInstall(theEnv,theFact);
+
+   if (reuseIndex == 0)
+     {
+      Multifield *theSegment = &theFact->theProposition;
+      for (i = 0 ; i < theSegment->length ; i++)
+        {
+         AtomInstall(theEnv,theSegment->contents[i].header->type,theSegment->contents[i].value);
+        }
+     }
+
+   /*==========================================*/
+   /* Execute the list of functions that are   */
+   /* to be called before each fact assertion. */
+   /*==========================================*/
+
+   for (theAssertFunction = FactData(theEnv)->ListOfAssertFunctions;
+        theAssertFunction != NULL;
+        theAssertFunction = theAssertFunction->next)
+     { (*theAssertFunction->func)(theEnv,theFact,theAssertFunction->context); }
+
+   /*==========================*/
+   /* Print assert output if   */
+   /* facts are being watched. */
+   /*==========================*/
+
+#if DEBUGGING_FUNCTIONS
+   if (theFact->whichDeftemplate->watch &&
+       (! ConstructData(theEnv)->ClearReadyInProgress) &&
+       (! ConstructData(theEnv)->ClearInProgress))
+     {
+      WriteString(theEnv,STDOUT,"==> ");
+      PrintFactWithIdentifier(theEnv,STDOUT,theFact,changeMap);
+      WriteString(theEnv,STDOUT,"\n");
+     }
+#endif
+
+   /*==================================*/
+   /* Set the change flag to indicate  */
+   /* the fact-list has been modified. */
+   /*==================================*/
+
+   FactData(theEnv)->ChangeToFactList = true;
+
+   /*==========================================*/
+   /* Check for constraint errors in the fact. */
+   /*==========================================*/
+
+   CheckTemplateFact(theEnv,theFact);
+
+   return theFact;
+  }
+
+/********************************************************/
+/* AssertDriver: Driver routine for the assert command. */
+/********************************************************/
+Fact *AssertDriver(
+  Fact *theFact,
+  long long reuseIndex,
+  Fact *factListPosition,
+  Fact *templatePosition,
+  char *changeMap)
+  {
+   Fact *result;
+   Environment *theEnv = theFact->whichDeftemplate->header.env;
+
+   FactData(theEnv)->assertError = AE_NO_ERROR;
+   
+   /*==================================================*/
+   /* Retracted and existing facts cannot be asserted. */
+   /*==================================================*/
+   
+   if (theFact->garbage)
+     {
+      FactData(theEnv)->assertError = AE_RETRACTED_ERROR;
+      return NULL;
+     }
+
+   if (reuseIndex != theFact->factIndex)
+     {
+      SystemError(theEnv,"FACTMNGR",6);
+      ExitRouter(theEnv,EXIT_FAILURE);
+     }
+
+   /*==========================================*/
+   /* A fact can not be asserted while another */
+   /* fact is being asserted or retracted.     */
+   /*==========================================*/
+
+   if (EngineData(theEnv)->JoinOperationInProgress)
+     {
+      FactData(theEnv)->assertError = AE_COULD_NOT_ASSERT_ERROR;
+      ReturnFact(theEnv,theFact);
+      PrintErrorID(theEnv,"FACTMNGR",2,true);
+      WriteString(theEnv,STDERR,"Facts may not be asserted during pattern-matching.\n");
+      return NULL;
+     }
+
+   /*====================================================*/
+   /* Add the fact to the fact-list. If a duplicate was  */
+   /* found or the fact couldn't be added, return it.    */
+   /*====================================================*/
+
+   result = InstallAssertedFact(theEnv,theFact,reuseIndex,factListPosition,templatePosition,changeMap);
+   if (result != theFact) return result;
+
+   /*===================================================*/
+   /* Reset the evaluation error flag since expressions */
+   /* will be evaluated as part of the assert .         */
+   /*===================================================*/
+
+   SetEvaluationError(theEnv,false);
+
+   /*=============================================*/
+   /* Pattern match the fact using the associated */
+   /* deftemplate's pattern network.              */
+   /*=============================================*/
+
+   EngineData(theEnv)->JoinOperationInProgress = true;
+   FactPatternMatch(theEnv,theFact,theFact->whichDeftemplate->patternNetwork,0,0,NULL,NULL);
+   EngineData(theEnv)->JoinOperationInProgress = false;
+
+   /*===================================================*/
+   /* Retract other facts that were logically dependent */
+   /* on the non-existence of the fact just asserted.   */
+   /*===================================================*/
+
+   ForceLogicalRetractions(theEnv);
+
+   /*=========================================*/
+   /* Free partial matches that were released */
+   /* by the assertion of the fact.           */
+   /*=========================================*/
+
+   if (EngineData(theEnv)->ExecutingRule == NULL) FlushGarbagePartialMatches(theEnv);
+
+   /*===============================*/
+   /* Return a pointer to the fact. */
+   /*===============================*/
+
+   if (EvaluationData(theEnv)->EvaluationError)
+     { FactData(theEnv)->assertError = AE_RULE_NETWORK_ERROR; }
+
+   return theFact;
+  }
+
+/*****************************************************/
+/* Assert: C access routine for the assert function. */
+/*****************************************************/
+Fact *Assert(
+  Fact *theFact)
+  {
+   return AssertDriver(theFact,0,NULL,NULL,NULL);
+  }
+
+/***********************************************************/
+/* AssertBatch: C access routine for asserting a group of  */
+/*   facts. All of the facts are added to the fact-list    */
+/*   before any of them are matched, and then each fact is */
+/*   matched in turn, so the partial matches and           */
+/*   activations are the same as for asserting the facts   */
+/*   one at a time. Logical retractions and the partial    */
+/*   match flush are only done once for the group. Each    */
+/*   entry of the array is replaced with the fact added,   */
+/*   the duplicate fact found, or NULL if the fact could   */
+/*   not be asserted. Returns the first error encountered. */
+/***********************************************************/
+AssertError AssertBatch(
+  Environment *theEnv,
+  Fact **theFacts,
+  size_t count)
+  {
+   size_t i, installedCount = 0;
+   Fact *theFact, *result, **installed;
+   AssertError rv = AE_NO_ERROR;
+   bool networkError = false;
+
+   /*==========================================*/
+   /* Facts can not be asserted while another  */
+   /* fact is being asserted or retracted.     */
+   /*==========================================*/
+
+   if (EngineData(theEnv)->JoinOperationInProgress)
+     {
+      for (i = 0; i < count; i++)
+        {
+         theFact = theFacts[i];
+         if ((theFact != NULL) && (! theFact->garbage) && (theFact->factIndex == 0))
+           { ReturnFact(theEnv,theFact); }
+         theFacts[i] = NULL;
+        }
+
+      FactData(theEnv)->assertError = AE_COULD_NOT_ASSERT_ERROR;
+      PrintErrorID(theEnv,"FACTMNGR",2,true);
+      WriteString(theEnv,STDERR,"Facts may not be asserted during pattern-matching.\n");
+      return AE_COULD_NOT_ASSERT_ERROR;
+     }
+
+   if (count == 0)
+     {
+      FactData(theEnv)->assertError = AE_NO_ERROR;
+      return AE_NO_ERROR;
+     }
+
+   /*==================================*/
+   /* Add each fact to the fact-list.  */
+   /*==================================*/
+
+   installed = (Fact **) genalloc(theEnv,sizeof(Fact *) * count);
+
+   for (i = 0; i < count; i++)
+     {
+      theFact = theFacts[i];
+
+      if (theFact == NULL)
+        {
+         if (rv == AE_NO_ERROR) rv = AE_NULL_POINTER_ERROR;
+         continue;
+        }
+
+      if (theFact->garbage)
+        {
+         if (rv == AE_NO_ERROR) rv = AE_RETRACTED_ERROR;
+         theFacts[i] = NULL;
+         continue;
+        }
+
+      if (theFact->factIndex != 0)
+        {
+         if (rv == AE_NO_ERROR) rv = AE_COULD_NOT_ASSERT_ERROR;
+         theFacts[i] = NULL;
+         continue;
+        }
+
+      result = InstallAssertedFact(theEnv,theFact,0,NULL,NULL,NULL);
+      theFacts[i] = result;
+
+      if (result != theFact)
+        {
+         if ((result == NULL) && (rv == AE_NO_ERROR))
+           { rv = AE_COULD_NOT_ASSERT_ERROR; }
+         continue;
+        }
+
+      installed[installedCount++] = theFact;
+     }
+
+   /*==================================================*/
+   /* Match the facts against the patterns, using the  */
+   /* pattern match workers if the batch is large      */
+   /* enough to divide among them.                     */
+   /*==================================================*/
+
+   EngineData(theEnv)->JoinOperationInProgress = true;
+
+   if (! ParallelFactPatternMatch(theEnv,installed,installedCount,&networkError))
+     {
+      for (i = 0; i < installedCount; i++)
+        {
+         theFact = installed[i];
+
+         SetEvaluationError(theEnv,false);
+         FactPatternMatch(theEnv,theFact,theFact->whichDeftemplate->patternNetwork,0,0,NULL,NULL);
+
+         if (EvaluationData(theEnv)->EvaluationError)
+           { networkError = true; }
+        }
+     }
+
+   EngineData(theEnv)->JoinOperationInProgress = false;
+
+   genfree(theEnv,installed,sizeof(Fact *) * count);
+
+   /*===================================================*/
+   /* Retract other facts that were logically dependent */
+   /* on the non-existence of the facts just asserted.  */
+   /*===================================================*/
+
+   ForceLogicalRetractions(theEnv);
+
+   /*=========================================*/
+   /* Free partial matches that were released */
+   /* by the assertion of the facts.          */
+   /*=========================================*/
+
+   if (EngineData(theEnv)->ExecutingRule == NULL) FlushGarbagePartialMatches(theEnv);
+
+   if (networkError)
+     {
+      SetEvaluationError(theEnv,true);
+      if (rv == AE_NO_ERROR) rv = AE_RULE_NETWORK_ERROR;
+     }
+
+   FactData(theEnv)->assertError = rv;
+
+   return rv;
+  }
+
+/*************************/
+/* GetAssertStringError: */
+/*************************/
+AssertStringError GetAssertStringError(
+  Environment *theEnv)
+  {
+   return FactData(theEnv)->assertStringError;
+  }
+
+/**************************************/
+/* RetractAllFacts: Loops through the */
+/*   fact-list and removes each fact. */
+/**************************************/
+RetractError RetractAllFacts(
+  Environment *theEnv)
+  {
+   RetractError rv;
+   
+   while (FactData(theEnv)->FactList != NULL)
+     {
+      if ((rv = Retract(FactData(theEnv)->FactList)) != RE_NO_ERROR)
+        { return rv; }
+     }
+     
+   return RE_NO_ERROR;
+  }
+
+/*******************************************************************/
+/* ModifyRetractDriver: First half of a slot specific modify. Only */
+/*   the alpha matches of patterns which reference one of the      */
+/*   changed slots are retracted. The matches of other patterns    */
+/*   (and the partial matches built from them) are left in place.  */
+/*   Returns false without changing anything if the modify has to  */
+/*   be performed as a full retract and assert.                    */
+/*******************************************************************/
+bool ModifyRetractDriver(
+  Environment *theEnv,
+  Fact *theFact,
+  CLIPSValue *theValueArray,
+  char *changeMap)
+  {
+   struct callFunctionItemWithArg *theRetractFunction;
+   struct patternMatch *theMatch, *nextMatch, *retractList = NULL;
+   struct patternMatch *lastRetract = NULL, *lastKeep = NULL;
+   CLIPSValue *theField = theFact->theProposition.contents;
+   void *oldValue;
+   bool unique;
+   size_t i;
+
+   /*===========================================================*/
+   /* Slot specific modify must be enabled and can only be used */
+   /* for facts which are not logically supported by, or being  */
+   /* modified from, a rule with logical conditional elements.  */
+   /*===========================================================*/
+
+   if ((! FactData(theEnv)->SlotSpecificModify) ||
+       (changeMap == NULL) ||
+       theFact->garbage ||
+       (theFact->factIndex == 0) ||
+       EngineData(theEnv)->JoinOperationInProgress ||
+       (theFact->patternHeader.dependents != NULL) ||
+       (EngineData(theEnv)->TheLogicalJoin != NULL))
+     { return false; }
+
+   /*=========================================================*/
+   /* Remove the fact from the hash table and, if duplicates  */
+   /* are not allowed, check that the new values do not match */
+   /* an existing fact. A modify producing a duplicate fact   */
+   /* removes the fact, so it is left to the full retract.    */
+   /*=========================================================*/
+
+   RemoveHashedFact(theEnv,theFact);
+
+   if (! FactData(theEnv)->FactDuplication)
+     {
+      for (i = 0; i < theFact->theProposition.length; i++)
+        {
+         if (theValueArray[i].voidValue == VoidConstant(theEnv)) continue;
+         oldValue = theField[i].value;
+         theField[i].value = theValueArray[i].value;
+         theValueArray[i].value = oldValue;
+        }
+
+      unique = FactWillBeAsserted(theEnv,theFact);
 
-   AddHashedFact(theEnv,theFact,hashValue);
+      for (i = 0; i < theFact->theProposition.length; i++)
+        {
+         if (theValueArray[i].voidValue == VoidConstant(theEnv)) continue;
+         oldValue = theField[i].value;
+         theField[i].value = theValueArray[i].value;
+         theValueArray[i].value = oldValue;
+        }
 
-   /*================================*/
-   /* Add the fact to the fact list. */
-   /*================================*/
+      if (! unique)
+        {
+         AddHashedFact(theEnv,theFact,HashFact(theFact));
+         return false;
+        }
+     }
 
-   if (reuseIndex == 0)
-     { factListPosition = FactData(theEnv)->LastFact; }
+#if FACT_SET_QUERIES
+   if (theFact->whichDeftemplate->queryIndexes != NULL)
+     { RemoveQueryIndexedFact(theEnv,theFact); }
+#endif
 
-   if (factListPosition == NULL)
+   /*===========================================*/
+   /* Execute the list of functions that are    */
+   /* to be called before each fact retraction. */
+   /*===========================================*/
+
+   for (theRetractFunction = FactData(theEnv)->ListOfRetractFunctions;
+        theRetractFunction != NULL;
+        theRetractFunction = theRetractFunction->next)
      {
-      theFact->nextFact = FactData(theEnv)->FactList;
-      FactData(theEnv)->FactList = theFact;
-      theFact->previousFact = NULL;
-      if (theFact->nextFact != NULL)
-        { theFact->nextFact->previousFact = theFact; }
+      (*theRetractFunction->func)(theEnv,theFact,theRetractFunction->context);
      }
-   else
+
+#if DEBUGGING_FUNCTIONS
+   if (theFact->whichDeftemplate->watch &&
+       (! ConstructData(theEnv)->ClearReadyInProgress) &&
+       (! ConstructData(theEnv)->ClearInProgress))
      {
-      theFact->nextFact = factListPosition->nextFact;
-      theFact->previousFact = factListPosition;
-      factListPosition->nextFact = theFact;
-      if (theFact->nextFact != NULL)
-        { theFact->nextFact->previousFact = theFact; }
+      WriteString(theEnv,STDOUT,"<== ");
+      PrintFactWithIdentifier(theEnv,STDOUT,theFact,changeMap);
+      WriteString(theEnv,STDOUT,"\n");
      }
+#endif
 
-   if ((FactData(theEnv)->LastFact == NULL) || (theFact->nextFact == NULL))
-     { FactData(theEnv)->LastFact = theFact; }
+   FactData(theEnv)->ChangeToFactList = true;
 
-   /*====================================*/
-   /* Add the fact to its template list. */
-   /*====================================*/
+   /*=====================================================*/
+   /* Split the alpha matches into those belonging to     */
+   /* patterns that reference a changed slot and the rest */
+   /* (both lists keep the order of the fact's matches).  */
+   /*=====================================================*/
 
-   if (reuseIndex == 0)
-     { templatePosition = theFact->whichDeftemplate->lastFact; }
+   theMatch = (struct patternMatch *) theFact->list;
+   theFact->list = NULL;
 
-   if (templatePosition == NULL)
+   while (theMatch != NULL)
      {
-      theFact->nextTemplateFact = theFact->whichDeftemplate->factList;
-      theFact->whichDeftemplate->factList = theFact;
-      theFact->previousTemplateFact = NULL;
-      if (theFact->nextTemplateFact != NULL)
-        { theFact->nextTemplateFact->previousTemplateFact = theFact; }
+      nextMatch = theMatch->next;
+      theMatch->next = NULL;
+
+      if (FactPatternReferencesSlots((struct factPatternNode *) theMatch->matchingPattern,changeMap))
+        {
+         if (lastRetract == NULL) retractList = theMatch;
+         else lastRetract->next = theMatch;
+         lastRetract = theMatch;
+        }
+      else
+        {
+         if (lastKeep == NULL) theFact->list = theMatch;
+         else lastKeep->next = theMatch;
+         lastKeep = theMatch;
+        }
+
+      theMatch = nextMatch;
      }
-   else
+
+   /*================================================*/
+   /* Retract the affected matches from the network. */
+   /*================================================*/
+
+   SetEvaluationError(theEnv,false);
+
+   if (retractList != NULL)
      {
-      theFact->nextTemplateFact = templatePosition->nextTemplateFact;
-      theFact->previousTemplateFact = templatePosition;
-      templatePosition->nextTemplateFact = theFact;
-      if (theFact->nextTemplateFact != NULL)
-        { theFact->nextTemplateFact->previousTemplateFact = theFact; }
+      EngineData(theEnv)->JoinOperationInProgress = true;
+      NetworkRetract(theEnv,retractList);
+      EngineData(theEnv)->JoinOperationInProgress = false;
      }
 
-   if ((theFact->whichDeftemplate->lastFact == NULL) || (theFact->nextTemplateFact == NULL))
-     { theFact->whichDeftemplate->lastFact = theFact; }
+   if (EngineData(theEnv)->ExecutingRule == NULL)
+     { FlushGarbagePartialMatches(theEnv); }
 
-   /*==================================*/
-   /* Set the fact index and time tag. */
-   /*==================================*/
+   ForceLogicalRetractions(theEnv);
 
-   if (reuseIndex > 0)
-     { theFact->factIndex = reuseIndex; }
-   else
-     { theFact->factIndex = FactData(theEnv)->NextFactIndex++; }
+   return true;
+  }
 
-   theFact->patternHeader.timeTag = DefruleData(theEnv)->CurrentEntityTimeTag++;
+/*******************************************************************/
+/* ModifyAssertDriver: Second half of a slot specific modify. Once */
+/*   the new slot values are in place, the fact is rehashed and    */
+/*   filtered through the pattern network. Alpha matches are only  */
+/*   created for patterns which reference one of the changed slots */
+/*   since the matches for the other patterns were kept.           */
+/*******************************************************************/
+Fact *ModifyAssertDriver(
+  Environment *theEnv,
+  Fact *theFact,
+  char *changeMap)
+  {
+   struct callFunctionItemWithArg *theAssertFunction;
 
-   /*=====================*/
-   /* Update busy counts. */
-   /*=====================*/
+   FactData(theEnv)->assertError = AE_NO_ERROR;
 
-   FactInstall(theEnv,theFact);
+   AddHashedFact(theEnv,theFact,HashFact(theFact));
+#if FACT_SET_QUERIES
+   if (theFact->whichDeftemplate->queryIndexes != NULL)
+     { AddQueryIndexedFact(theEnv,theFact); }
+#endif
 
-   if (reuseIndex == 0)
-     {
-      Multifield *theSegment = &theFact->theProposition;
-      for (i = 0 ; i < theSegment->length ; i++)
-        {
-         AtomInstall(theEnv,theSegment->contents[i].header->type,theSegment->contents[i].value);
-        }
-     }
+   theFact->patternHeader.timeTag = DefruleData(theEnv)->CurrentEntityTimeTag++;
 
    /*==========================================*/
    /* Execute the list of functions that are   */
@@ -992,11 +1673,6 @@ Fact *AssertDriver(
         theAssertFunction = theAssertFunction->next)
      { (*theAssertFunction->func)(theEnv,theFact,theAssertFunction->context); }
 
-   /*==========================*/
-   /* Print assert output if   */
-   /* facts are being watched. */
-   /*==========================*/
-
 #if DEBUGGING_FUNCTIONS
    if (theFact->whichDeftemplate->watch &&
        (! ConstructData(theEnv)->ClearReadyInProgress) &&
@@ -1008,95 +1684,33 @@ Fact *AssertDriver(
      }
 #endif
 
-   /*==================================*/
-   /* Set the change flag to indicate  */
-   /* the fact-list has been modified. */
-   /*==================================*/
-
    FactData(theEnv)->ChangeToFactList = true;
 
-   /*==========================================*/
-   /* Check for constraint errors in the fact. */
-   /*==========================================*/
-
    CheckTemplateFact(theEnv,theFact);
 
-   /*===================================================*/
-   /* Reset the evaluation error flag since expressions */
-   /* will be evaluated as part of the assert .         */
-   /*===================================================*/
-
    SetEvaluationError(theEnv,false);
 
-   /*=============================================*/
-   /* Pattern match the fact using the associated */
-   /* deftemplate's pattern network.              */
-   /*=============================================*/
+   /*=====================================================*/
+   /* Pattern match the fact, restricting the creation    */
+   /* of alpha matches to the patterns that were removed. */
+   /*=====================================================*/
 
    EngineData(theEnv)->JoinOperationInProgress = true;
+   FactData(theEnv)->ModifyChangeMap = changeMap;
    FactPatternMatch(theEnv,theFact,theFact->whichDeftemplate->patternNetwork,0,0,NULL,NULL);
+   FactData(theEnv)->ModifyChangeMap = NULL;
    EngineData(theEnv)->JoinOperationInProgress = false;
 
-   /*===================================================*/
-   /* Retract other facts that were logically dependent */
-   /* on the non-existence of the fact just asserted.   */
-   /*===================================================*/
-
    ForceLogicalRetractions(theEnv);
 
-   /*=========================================*/
-   /* Free partial matches that were released */
-   /* by the assertion of the fact.           */
-   /*=========================================*/
-
    if (EngineData(theEnv)->ExecutingRule == NULL) FlushGarbagePartialMatches(theEnv);
 
-   /*===============================*/
-   /* Return a pointer to the fact. */
-   /*===============================*/
-
    if (EvaluationData(theEnv)->EvaluationError)
      { FactData(theEnv)->assertError = AE_RULE_NETWORK_ERROR; }
 
    return theFact;
   }
 
-/*****************************************************/
-/* Assert: C access routine for the assert function. */
-/*****************************************************/
-Fact *Assert(
-  Fact *theFact)
-  {
-   return AssertDriver(theFact,0,NULL,NULL,NULL);
-  }
-
-/*************************/
-/* GetAssertStringError: */
-/*************************/
-AssertStringError GetAssertStringError(
-  Environment *theEnv)
-  {
-   return FactData(theEnv)->assertStringError;
-  }
-
-/**************************************/
-/* RetractAllFacts: Loops through the */
-/*   fact-list and removes each fact. */
-/**************************************/
-RetractError RetractAllFacts(
-  Environment *theEnv)
-  {
-   RetractError rv;
-   
-   while (FactData(theEnv)->FactList != NULL)
-     {
-      if ((rv = Retract(FactData(theEnv)->FactList)) != RE_NO_ERROR)
-        { return rv; }
-     }
-     
-   return RE_NO_ERROR;
-  }
-
 /*********************************************/
 /* CreateFact: Creates a fact data structure */
 /*   of the specified deftemplate.           */
@@ -1382,7 +1996,7 @@ bool DeftemplateSlotDefault(
   UDFValue *theResult,
   bool garbageMultifield)
   {
-   /*================================================*/
+   /*=================================================*/
    /* The value for the implied multifield slot of an */
    /* implied deftemplate does not have a default.    */
    /*=================================================*/
@@ -1512,7 +2126,7 @@ Fact *CreateFactBySize(
    if (size <= 0) newSize = 1;
    else newSize = size;
 
-   theFact = get_var_struct(theEnv,fact,sizeof(struct clipsValue) * (newSize - 1));
+   theFact = get_slab_var_struct(theEnv,fact,sizeof(struct clipsValue) * (newSize - 1));
 
    theFact->patternHeader.header.type = FACT_ADDRESS_TYPE;
    theFact->garbage = false;
@@ -1562,7 +2176,7 @@ void ReturnFact(
    if (theFact->theProposition.length == 0) newSize = 1;
    else newSize = theFact->theProposition.length;
 
-   rtn_var_struct(theEnv,fact,sizeof(struct clipsValue) * (newSize - 1),theFact);
+   rtn_slab_var_struct(theEnv,fact,sizeof(struct clipsValue) * (newSize - 1),theFact);
   }
 
 /*************************************************************/
@@ -1648,7 +2262,7 @@ void ReleaseFact(
   }
 
 /*********************************************************/
-/* GetNextFact: If passed a NULL pointer, returns the */
+/* GetNextFact: If passed a NULL pointer, returns the    */
 /*   first fact in the fact-list. Otherwise returns the  */
 /*   next fact following the fact passed as an argument. */
 /*********************************************************/
@@ -1828,6 +2442,59 @@ bool GetFactListChanged(
    return(FactData(theEnv)->ChangeToFactList);
   }
 
+/***********************************************/
+/* GetSlotSpecificModify: C access routine     */
+/*   for the get-slot-specific-modify command. */
+/***********************************************/
+bool GetSlotSpecificModify(
+  Environment *theEnv)
+  {
+   return FactData(theEnv)->SlotSpecificModify;
+  }
+
+/***********************************************/
+/* SetSlotSpecificModify: C access routine     */
+/*   for the set-slot-specific-modify command. */
+/***********************************************/
+bool SetSlotSpecificModify(
+  Environment *theEnv,
+  bool value)
+  {
+   bool ov;
+
+   ov = FactData(theEnv)->SlotSpecificModify;
+   FactData(theEnv)->SlotSpecificModify = value;
+   return ov;
+  }
+
+/************************************************/
+/* GetPatternMatchWorkers: C access routine for */
+/*   the get-pattern-match-workers command.     */
+/************************************************/
+unsigned short GetPatternMatchWorkers(
+  Environment *theEnv)
+  {
+   return FactData(theEnv)->PatternMatchWorkers;
+  }
+
+/************************************************/
+/* SetPatternMatchWorkers: C access routine for */
+/*   the set-pattern-match-workers command.     */
+/************************************************/
+unsigned short SetPatternMatchWorkers(
+  Environment *theEnv,
+  unsigned short value)
+  {
+   unsigned short ov;
+
+   if (value < 1) value = 1;
+   else if (value > MAX_PATTERN_MATCH_WORKERS) value = MAX_PATTERN_MATCH_WORKERS;
+
+   ov = FactData(theEnv)->PatternMatchWorkers;
+   FactData(theEnv)->PatternMatchWorkers = value;
+   return ov;
+  }
+
 /********************************************************/
 /* SetFactListChanged: Sets the flag indicating whether */
 /*   a change to the fact-list has been made.           */
@@ -1921,17 +2588,104 @@ Fact *FindIndexedFact(
   Environment *theEnv,
   long long factIndexSought)
   {
-   Fact *theFact;
+   struct factIndexPage *thePage;
+   size_t pageIndex;
+
+   if (factIndexSought < 1) return NULL;
+
+   pageIndex = (size_t) (factIndexSought / FACT_INDEX_PAGE_SIZE);
+   if (pageIndex >= FactData(theEnv)->FactIndexPageCount)
+     { return NULL; }
+
+   thePage = FactData(theEnv)->FactIndexPages[pageIndex];
+   if (thePage == NULL)
+     { return NULL; }
+
+   return thePage->facts[factIndexSought % FACT_INDEX_PAGE_SIZE];
+  }
+
+/****************************************************/
+/* AddIndexedFact: Adds an asserted fact to the     */
+/*   fact index table, allocating the page for its  */
+/*   fact index (and growing the table of pages) if */
+/*   necessary.                                     */
+/****************************************************/
+static void AddIndexedFact(
+  Environment *theEnv,
+  Fact *theFact)
+  {
+   struct factIndexPage *thePage, **newPages;
+   size_t pageIndex, newCount, offset;
+
+   pageIndex = (size_t) (theFact->factIndex / FACT_INDEX_PAGE_SIZE);
+   offset = (size_t) (theFact->factIndex % FACT_INDEX_PAGE_SIZE);
 
-   for (theFact = GetNextFact(theEnv,NULL);
-        theFact != NULL;
-        theFact = GetNextFact(theEnv,theFact))
+   if (pageIndex >= FactData(theEnv)->FactIndexPageCount)
      {
-      if (theFact->factIndex == factIndexSought)
-        { return(theFact); }
+      newCount = FactData(theEnv)->FactIndexPageCount * 2;
+      if (newCount <= pageIndex)
+        { newCount = pageIndex + 1; }
+
+      newPages = (struct factIndexPage **)
+                 genalloc(theEnv,sizeof(struct factIndexPage *) * newCount);
+      memset(newPages,0,sizeof(struct factIndexPage *) * newCount);
+
+      if (FactData(theEnv)->FactIndexPages != NULL)
+        {
+         GenCopyMemory(struct factIndexPage *,FactData(theEnv)->FactIndexPageCount,
+                       newPages,FactData(theEnv)->FactIndexPages);
+         genfree(theEnv,FactData(theEnv)->FactIndexPages,
+                 sizeof(struct factIndexPage *) * FactData(theEnv)->FactIndexPageCount);
+        }
+
+      FactData(theEnv)->FactIndexPages = newPages;
+      FactData(theEnv)->FactIndexPageCount = newCount;
      }
 
-   return NULL;
+   thePage = FactData(theEnv)->FactIndexPages[pageIndex];
+   if (thePage == NULL)
+     {
+      thePage = (struct factIndexPage *) genalloc(theEnv,sizeof(struct factIndexPage));
+      memset(thePage,0,sizeof(struct factIndexPage));
+      FactData(theEnv)->FactIndexPages[pageIndex] = thePage;
+     }
+
+   if (thePage->facts[offset] == NULL)
+     { thePage->count++; }
+
+   thePage->facts[offset] = theFact;
+  }
+
+/***************************************************/
+/* RemoveIndexedFact: Removes a fact being removed */
+/*   from the fact list from the fact index table, */
+/*   releasing its page once the page is empty.    */
+/***************************************************/
+static void RemoveIndexedFact(
+  Environment *theEnv,
+  Fact *theFact)
+  {
+   struct factIndexPage *thePage;
+   size_t pageIndex, offset;
+
+   pageIndex = (size_t) (theFact->factIndex / FACT_INDEX_PAGE_SIZE);
+   offset = (size_t) (theFact->factIndex % FACT_INDEX_PAGE_SIZE);
+
+   if (pageIndex >= FactData(theEnv)->FactIndexPageCount)
+     { return; }
+
+   thePage = FactData(theEnv)->FactIndexPages[pageIndex];
+   if ((thePage == NULL) || (thePage->facts[offset] != theFact))
+     { return; }
+
+   thePage->facts[offset] = NULL;
+   thePage->count--;
+
+   if (thePage->count == 0)
+     {
+      genfree(theEnv,thePage,sizeof(struct factIndexPage));
+      FactData(theEnv)->FactIndexPages[pageIndex] = NULL;
+     }
   }
 
 /**************************************/
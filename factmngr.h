@@ -71,6 +71,12 @@
 /*                                                           */
 /*            Modify command preserves fact id and address.  */
 /*                                                           */
+/*            Added AssertBatch and RetractBatch functions.  */
+/*                                                           */
+/*            Added pattern match workers for AssertBatch.   */
+/*                                                           */
+/*            Added fact index table for FindIndexedFact.    */
+/*                                                           */
 /*************************************************************/
 
 #ifndef _H_factmngr
@@ -81,6 +87,8 @@
 
 typedef struct factBuilder FactBuilder;
 typedef struct factModifier FactModifier;
+struct factAlphaStage;
+struct factIndexPage;
 
 #include "entities.h"
 #include "conscomp.h"
@@ -194,6 +202,8 @@ struct factsData
    Fact *LastFact;
    Fact *FactList;
    long long NextFactIndex;
+   struct factIndexPage **FactIndexPages;
+   size_t FactIndexPageCount;
    unsigned long NumberOfFacts;
    struct callFunctionItemWithArg *ListOfAssertFunctions;
    struct callFunctionItemWithArg *ListOfRetractFunctions;
@@ -208,9 +218,16 @@ struct factsData
    struct factHashEntry **FactHashTable;
    unsigned long FactHashTableSize;
    bool FactDuplication;
+   bool SlotSpecificModify;
 #if DEFRULE_CONSTRUCT
    Fact                    *CurrentPatternFact;
    struct multifieldMarker *CurrentPatternMarks;
+   const char              *ModifyChangeMap;
+   bool                     StagingAlphaMatches;
+   struct factAlphaStage   *AlphaStage;
+   size_t                   AlphaStageCount;
+   size_t                   AlphaStageSize;
+   unsigned short           PatternMatchWorkers;
 #endif
    long LastModuleIndex;
    RetractError retractError;
@@ -225,6 +242,7 @@ struct factsData
    Fact                          *Assert(Fact *);
    AssertStringError              GetAssertStringError(Environment *);
    Fact                          *AssertDriver(Fact *,long long,Fact *,Fact *,char *);
+   AssertError                    AssertBatch(Environment *,Fact **,size_t);
    Fact                          *AssertString(Environment *,const char *);
    Fact                          *CreateFact(Deftemplate *);
    void                           ReleaseFact(Fact *);
@@ -236,7 +254,14 @@ struct factsData
    void                           PrintFactIdentifierInLongForm(Environment *,const char *,Fact *);
    RetractError                   Retract(Fact *);
    RetractError                   RetractDriver(Environment *,Fact *,bool,char *);
+   RetractError                   RetractBatch(Environment *,Fact **,size_t);
    RetractError                   RetractAllFacts(Environment *);
+   bool                           ModifyRetractDriver(Environment *,Fact *,CLIPSValue *,char *);
+   Fact                          *ModifyAssertDriver(Environment *,Fact *,char *);
+   bool                           GetSlotSpecificModify(Environment *);
+   bool                           SetSlotSpecificModify(Environment *,bool);
+   unsigned short                 GetPatternMatchWorkers(Environment *);
+   unsigned short                 SetPatternMatchWorkers(Environment *,unsigned short);
    Fact                          *CreateFactBySize(Environment *,size_t);
    void                           FactInstall(Environment *,Fact *);
    void                           FactDeinstall(Environment *,Fact *);
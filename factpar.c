@@ -0,0 +1,543 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  08/25/16            */
+   /*                                                     */
+   /*          FACT PARALLEL PATTERN MATCHING MODULE      */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Evaluates the pattern network tests for a batch  */
+/*   of facts on worker threads.                             */
+/*                                                           */
+/*   The facts of a batch are divided into contiguous runs,  */
+/*   one for each worker. A worker traverses the pattern     */
+/*   network for each fact of its run and records the        */
+/*   terminal pattern nodes reached in the same depth first  */
+/*   order used by FactPatternMatch. Workers only read the   */
+/*   fact and the pattern network, so they are restricted to */
+/*   the pattern network primitives which compare the fields */
+/*   of the fact to constants or to each other, and to eq,   */
+/*   neq, and, and or calls made of them. A fact which       */
+/*   reaches any other test or a multifield node is deferred */
+/*   and matched by FactPatternMatch instead.                */
+/*                                                           */
+/*   Once all of the workers have finished, the alpha        */
+/*   matches are staged on the calling thread in the order   */
+/*   of the facts in the batch and then sent through the     */
+/*   join network, so the partial matches and activations    */
+/*   are the same as when the facts are matched one at a     */
+/*   time.                                                   */
+/*                                                           */
+/*************************************************************/
+
+#include "setup.h"
+
+#if DEFTEMPLATE_CONSTRUCT && DEFRULE_CONSTRUCT
+
+#include <stdlib.h>
+
+#if PARALLEL_PATTERN_MATCHING
+#include <pthread.h>
+#endif
+
+#include "engine.h"
+#include "envrnmnt.h"
+#include "evaluatn.h"
+#include "factgen.h"
+#include "factmch.h"
+#include "memalloc.h"
+#include "pattern.h"
+
+#include "factpar.h"
+
+#if PARALLEL_PATTERN_MATCHING
+
+/*************************************************/
+/* workerFactResult: The range of terminal nodes */
+/*   recorded by a worker for one fact.          */
+/*************************************************/
+struct workerFactResult
+  {
+   size_t start;
+   size_t end;
+   bool deferred;
+  };
+
+/**************************************************/
+/* patternMatchWorker: The run of facts traversed */
+/*   by a worker and the terminal nodes reached.  */
+/**************************************************/
+struct patternMatchWorker
+  {
+   Environment *theEnv;
+   Fact **theFacts;
+   size_t first;
+   size_t last;
+   struct workerFactResult *results;
+   struct factPatternNode **nodes;
+   size_t nodeCount;
+   size_t nodeSize;
+   pthread_t thread;
+   bool started;
+  };
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                   *PatternMatchWorker(void *);
+   static bool                    FilterFactPatterns(struct patternMatchWorker *,Fact *,struct factPatternNode *);
+   static bool                    EvaluateWorkerTest(Environment *,Fact *,struct expr *,bool *);
+   static CLIPSValue             *WorkerFieldValue(Fact *,struct expr *);
+   static struct factPatternNode *NextWorkerPatternNode(bool,struct factPatternNode *);
+   static bool                    AddWorkerMatch(struct patternMatchWorker *,struct factPatternNode *);
+
+#endif
+
+/******************************************************************/
+/* ParallelFactPatternMatch: Matches a batch of facts using the   */
+/*   number of threads set with the set-pattern-match-workers     */
+/*   command. The alpha matches are staged and then sent through  */
+/*   the joins in the order of the batch. Returns false without   */
+/*   matching any of the facts if the batch is too small to be    */
+/*   divided among the workers.                                   */
+/******************************************************************/
+bool ParallelFactPatternMatch(
+  Environment *theEnv,
+  Fact **theFacts,
+  size_t count,
+  bool *networkError)
+  {
+#if PARALLEL_PATTERN_MATCHING
+   size_t i, j, w, workerCount;
+   struct patternMatchWorker *theWorkers;
+   struct workerFactResult *theResults;
+   Fact *theFact;
+
+   /*==============================================*/
+   /* Don't start more threads than there are runs */
+   /* of MIN_FACTS_PER_WORKER facts.               */
+   /*==============================================*/
+
+   workerCount = FactData(theEnv)->PatternMatchWorkers;
+
+   if (workerCount > (count / MIN_FACTS_PER_WORKER))
+     { workerCount = count / MIN_FACTS_PER_WORKER; }
+
+   if (workerCount < 2) return false;
+
+   /*=============================================*/
+   /* Only new patterns are traversed during an   */
+   /* incremental reset, so leave those facts to  */
+   /* FactPatternMatch.                           */
+   /*=============================================*/
+
+#if (! RUN_TIME) && (! BLOAD_ONLY)
+   if (EngineData(theEnv)->IncrementalResetInProgress) return false;
+#endif
+
+   theResults = (struct workerFactResult *) genalloc(theEnv,sizeof(struct workerFactResult) * count);
+   theWorkers = (struct patternMatchWorker *) genalloc(theEnv,sizeof(struct patternMatchWorker) * workerCount);
+
+   for (w = 0; w < workerCount; w++)
+     {
+      theWorkers[w].theEnv = theEnv;
+      theWorkers[w].theFacts = theFacts;
+      theWorkers[w].first = (count * w) / workerCount;
+      theWorkers[w].last = (count * (w + 1)) / workerCount;
+      theWorkers[w].results = theResults;
+      theWorkers[w].nodes = NULL;
+      theWorkers[w].nodeCount = 0;
+      theWorkers[w].nodeSize = 0;
+      theWorkers[w].started = false;
+     }
+
+   /*==================================================*/
+   /* The calling thread handles the first run itself. */
+   /* A run whose thread can't be started is handled   */
+   /* by the calling thread once its own is finished.  */
+   /*==================================================*/
+
+   for (w = 1; w < workerCount; w++)
+     {
+      theWorkers[w].started =
+         (pthread_create(&theWorkers[w].thread,NULL,PatternMatchWorker,&theWorkers[w]) == 0);
+     }
+
+   PatternMatchWorker(&theWorkers[0]);
+
+   for (w = 1; w < workerCount; w++)
+     {
+      if (theWorkers[w].started)
+        { pthread_join(theWorkers[w].thread,NULL); }
+      else
+        { PatternMatchWorker(&theWorkers[w]); }
+     }
+
+   /*=================================================*/
+   /* Stage the alpha matches in the order the facts  */
+   /* appear in the batch.                            */
+   /*=================================================*/
+
+   FactData(theEnv)->StagingAlphaMatches = true;
+
+   for (w = 0; w < workerCount; w++)
+     {
+      for (i = theWorkers[w].first; i < theWorkers[w].last; i++)
+        {
+         theFact = theFacts[i];
+
+         SetEvaluationError(theEnv,false);
+
+         if (theResults[i].deferred)
+           { FactPatternMatch(theEnv,theFact,theFact->whichDeftemplate->patternNetwork,0,0,NULL,NULL); }
+         else
+           {
+            for (j = theResults[i].start; j < theResults[i].end; j++)
+              { StageFactPatternMatch(theEnv,theFact,theWorkers[w].nodes[j]); }
+           }
+
+         if (EvaluationData(theEnv)->EvaluationError)
+           { *networkError = true; }
+        }
+
+      if (theWorkers[w].nodes != NULL)
+        { free(theWorkers[w].nodes); }
+     }
+
+   FactData(theEnv)->StagingAlphaMatches = false;
+
+   genfree(theEnv,theWorkers,sizeof(struct patternMatchWorker) * workerCount);
+   genfree(theEnv,theResults,sizeof(struct workerFactResult) * count);
+
+   /*===================================================*/
+   /* Send the staged alpha matches through the joins.  */
+   /*===================================================*/
+
+   SetEvaluationError(theEnv,false);
+   PropagateStagedFactMatches(theEnv);
+
+   if (EvaluationData(theEnv)->EvaluationError)
+     { *networkError = true; }
+
+   return true;
+#else
+#if MAC_XCD
+#pragma unused(theEnv,theFacts,count,networkError)
+#endif
+   return false;
+#endif
+  }
+
+#if PARALLEL_PATTERN_MATCHING
+
+/*****************************************************/
+/* PatternMatchWorker: Thread routine which records  */
+/*   the terminal pattern nodes reached by each fact */
+/*   in a worker's run of facts.                     */
+/*****************************************************/
+static void *PatternMatchWorker(
+  void *theArg)
+  {
+   struct patternMatchWorker *theWorker = (struct patternMatchWorker *) theArg;
+   struct workerFactResult *theResult;
+   Fact *theFact;
+   size_t i;
+
+   for (i = theWorker->first; i < theWorker->last; i++)
+     {
+      theFact = theWorker->theFacts[i];
+      theResult = &theWorker->results[i];
+      theResult->start = theWorker->nodeCount;
+      theResult->deferred = ! FilterFactPatterns(theWorker,theFact,theFact->whichDeftemplate->patternNetwork);
+
+      if (theResult->deferred)
+        { theWorker->nodeCount = theResult->start; }
+
+      theResult->end = theWorker->nodeCount;
+     }
+
+   return NULL;
+  }
+
+/*************************************************************/
+/* FilterFactPatterns: Traverses the pattern network for a   */
+/*   fact in the same order as FactPatternMatch, recording   */
+/*   each terminal node reached. Returns false if the fact   */
+/*   reaches a node which can't be evaluated by a worker.    */
+/*************************************************************/
+static bool FilterFactPatterns(
+  struct patternMatchWorker *theWorker,
+  Fact *theFact,
+  struct factPatternNode *patternPtr)
+  {
+   Environment *theEnv = theWorker->theEnv;
+   struct factPatternNode *tempPtr;
+   CLIPSValue *theValue;
+   bool passed;
+
+   while (patternPtr != NULL)
+     {
+      if (! patternPtr->header.singlefieldNode) return false;
+
+      /*=========================================*/
+      /* A selector node finds the branch to be  */
+      /* taken by hashing the value of the slot. */
+      /*=========================================*/
+
+      if (patternPtr->header.selector)
+        {
+         if (! EvaluateWorkerTest(theEnv,theFact,patternPtr->networkTest->nextArg,&passed))
+           { return false; }
+
+         tempPtr = NULL;
+         if (passed)
+           {
+            theValue = WorkerFieldValue(theFact,patternPtr->networkTest);
+            if (theValue == NULL) return false;
+
+            tempPtr = (struct factPatternNode *)
+                      FindHashedPatternNode(theEnv,patternPtr,theValue->header->type,theValue->value);
+           }
+
+         if (tempPtr != NULL)
+           {
+            if (tempPtr->header.stopNode && (! AddWorkerMatch(theWorker,tempPtr)))
+              { return false; }
+
+            patternPtr = NextWorkerPatternNode(false,tempPtr);
+           }
+         else
+           { patternPtr = NextWorkerPatternNode(true,patternPtr); }
+        }
+
+      /*===========================================*/
+      /* Otherwise, descend if the node's test is  */
+      /* satisfied and move to the next branch if  */
+      /* it isn't.                                 */
+      /*===========================================*/
+
+      else
+        {
+         if (! EvaluateWorkerTest(theEnv,theFact,patternPtr->networkTest,&passed))
+           { return false; }
+
+         if (passed)
+           {
+            if (patternPtr->header.stopNode && (! AddWorkerMatch(theWorker,patternPtr)))
+              { return false; }
+
+            patternPtr = NextWorkerPatternNode(false,patternPtr);
+           }
+         else
+           { patternPtr = NextWorkerPatternNode(true,patternPtr); }
+        }
+     }
+
+   return true;
+  }
+
+/************************************************************/
+/* EvaluateWorkerTest: Evaluates a pattern network test     */
+/*   without using the environment's evaluation state.      */
+/*   Returns false if the test isn't one of the primitives  */
+/*   which only read the fact being matched.                */
+/************************************************************/
+static bool EvaluateWorkerTest(
+  Environment *theEnv,
+  Fact *theFact,
+  struct expr *theTest,
+  bool *passed)
+  {
+   CLIPSValue *fieldPtr, *fieldPtr2;
+   Multifield *segmentPtr;
+   struct factConstantPN1Call *hack1;
+   struct factConstantPN2Call *hack2;
+   struct factCheckLengthPNCall *hack3;
+   struct factCompVarsPN1Call *hack4;
+   bool orTest;
+
+   if (theTest == NULL)
+     {
+      *passed = true;
+      return true;
+     }
+
+   switch (theTest->type)
+     {
+      case FACT_PN_CONSTANT1:
+        hack1 = (struct factConstantPN1Call *) ((CLIPSBitMap *) theTest->value)->contents;
+        fieldPtr = &theFact->theProposition.contents[hack1->whichSlot];
+        *passed = ((theTest->argList->value == fieldPtr->value) == (bool) hack1->testForEquality);
+        return true;
+
+      case FACT_PN_CONSTANT2:
+        hack2 = (struct factConstantPN2Call *) ((CLIPSBitMap *) theTest->value)->contents;
+        fieldPtr = &theFact->theProposition.contents[hack2->whichSlot];
+        if (fieldPtr->header->type == MULTIFIELD_TYPE)
+          {
+           segmentPtr = fieldPtr->multifieldValue;
+           if (hack2->fromBeginning)
+             { fieldPtr = &segmentPtr->contents[hack2->offset]; }
+           else
+             { fieldPtr = &segmentPtr->contents[segmentPtr->length - (hack2->offset + 1)]; }
+          }
+        *passed = ((theTest->argList->value == fieldPtr->value) == (bool) hack2->testForEquality);
+        return true;
+
+      case FACT_SLOT_LENGTH:
+        hack3 = (struct factCheckLengthPNCall *) ((CLIPSBitMap *) theTest->value)->contents;
+        segmentPtr = theFact->theProposition.contents[hack3->whichSlot].multifieldValue;
+        if (segmentPtr->length < hack3->minLength)
+          { *passed = false; }
+        else if (hack3->exactly && (segmentPtr->length > hack3->minLength))
+          { *passed = false; }
+        else
+          { *passed = true; }
+        return true;
+
+      case FACT_PN_CMP1:
+        hack4 = (struct factCompVarsPN1Call *) ((CLIPSBitMap *) theTest->value)->contents;
+        fieldPtr = &theFact->theProposition.contents[hack4->field1];
+        fieldPtr2 = &theFact->theProposition.contents[hack4->field2];
+        if (fieldPtr->value != fieldPtr2->value)
+          { *passed = (bool) hack4->fail; }
+        else
+          { *passed = (bool) hack4->pass; }
+        return true;
+
+      case FCALL:
+        if ((theTest->value == ExpressionData(theEnv)->PTR_EQ) ||
+            (theTest->value == ExpressionData(theEnv)->PTR_NEQ))
+          {
+           if ((theTest->argList == NULL) ||
+               (theTest->argList->nextArg == NULL) ||
+               (theTest->argList->nextArg->nextArg != NULL))
+             { return false; }
+
+           fieldPtr = WorkerFieldValue(theFact,theTest->argList);
+           fieldPtr2 = WorkerFieldValue(theFact,theTest->argList->nextArg);
+           if ((fieldPtr == NULL) || (fieldPtr2 == NULL))
+             { return false; }
+
+           *passed = ((fieldPtr->value == fieldPtr2->value) ==
+                      (theTest->value == ExpressionData(theEnv)->PTR_EQ));
+           return true;
+          }
+
+        if ((theTest->value != ExpressionData(theEnv)->PTR_OR) &&
+            (theTest->value != ExpressionData(theEnv)->PTR_AND))
+          { return false; }
+
+        /*===============================================*/
+        /* An "or" is satisfied by the first argument    */
+        /* which is true and an "and" fails on the first */
+        /* argument which is false.                      */
+        /*===============================================*/
+
+        orTest = (theTest->value == ExpressionData(theEnv)->PTR_OR);
+        for (theTest = theTest->argList;
+             theTest != NULL;
+             theTest = theTest->nextArg)
+          {
+           if (! EvaluateWorkerTest(theEnv,theFact,theTest,passed))
+             { return false; }
+
+           if (*passed == orTest)
+             { return true; }
+          }
+
+        *passed = ! orTest;
+        return true;
+     }
+
+   return false;
+  }
+
+/***************************************************************/
+/* WorkerFieldValue: Returns the single field value retrieved  */
+/*   by a pattern network get variable primitive, or NULL if   */
+/*   it can't be retrieved without the multifield markers of   */
+/*   the pattern being matched.                                */
+/***************************************************************/
+static CLIPSValue *WorkerFieldValue(
+  Fact *theFact,
+  struct expr *theGetter)
+  {
+   struct factGetVarPN2Call *hack2;
+   struct factGetVarPN3Call *hack3;
+   Multifield *segmentPtr;
+
+   switch (theGetter->type)
+     {
+      case FACT_PN_VAR2:
+        hack2 = (struct factGetVarPN2Call *) ((CLIPSBitMap *) theGetter->value)->contents;
+        return &theFact->theProposition.contents[hack2->whichSlot];
+
+      case FACT_PN_VAR3:
+        hack3 = (struct factGetVarPN3Call *) ((CLIPSBitMap *) theGetter->value)->contents;
+        if (hack3->fromBeginning && hack3->fromEnd) return NULL;
+        segmentPtr = theFact->theProposition.contents[hack3->whichSlot].multifieldValue;
+        if (hack3->fromBeginning)
+          { return &segmentPtr->contents[hack3->beginOffset]; }
+        return &segmentPtr->contents[segmentPtr->length - (hack3->endOffset + 1)];
+     }
+
+   return NULL;
+  }
+
+/***********************************************************/
+/* NextWorkerPatternNode: Returns the next node in the     */
+/*   depth first traversal of a pattern network which has  */
+/*   no multifield nodes above the current node.           */
+/***********************************************************/
+static struct factPatternNode *NextWorkerPatternNode(
+  bool finishedMatching,
+  struct factPatternNode *thePattern)
+  {
+   if ((finishedMatching == false) && (thePattern->nextLevel != NULL))
+     { return thePattern->nextLevel; }
+
+   while ((thePattern->rightNode == NULL) ||
+          ((thePattern->lastLevel != NULL) &&
+           (thePattern->lastLevel->header.selector)))
+     {
+      thePattern = thePattern->lastLevel;
+      if (thePattern == NULL) return NULL;
+
+      if ((thePattern->lastLevel != NULL) &&
+          (thePattern->lastLevel->header.selector))
+        { thePattern = thePattern->lastLevel; }
+     }
+
+   return thePattern->rightNode;
+  }
+
+/********************************************************/
+/* AddWorkerMatch: Records a terminal node reached by a */
+/*   fact. Returns false if memory can't be allocated.  */
+/********************************************************/
+static bool AddWorkerMatch(
+  struct patternMatchWorker *theWorker,
+  struct factPatternNode *thePattern)
+  {
+   struct factPatternNode **newNodes;
+   size_t newSize;
+
+   if (theWorker->nodeCount == theWorker->nodeSize)
+     {
+      newSize = (theWorker->nodeSize == 0) ? 256 : (theWorker->nodeSize * 2);
+      newNodes = (struct factPatternNode **) realloc(theWorker->nodes,sizeof(struct factPatternNode *) * newSize);
+      if (newNodes == NULL) return false;
+      theWorker->nodes = newNodes;
+      theWorker->nodeSize = newSize;
+     }
+
+   theWorker->nodes[theWorker->nodeCount++] = thePattern;
+   return true;
+  }
+
+#endif /* PARALLEL_PATTERN_MATCHING */
+
+#endif /* DEFTEMPLATE_CONSTRUCT && DEFRULE_CONSTRUCT */
@@ -0,0 +1,29 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  08/25/16            */
+   /*                                                     */
+   /*        FACT PARALLEL PATTERN MATCHING HEADER FILE   */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Evaluates the pattern network tests for a batch  */
+/*   of facts on worker threads.                             */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_factpar
+
+#pragma once
+
+#define _H_factpar
+
+#include "factmngr.h"
+
+#define MIN_FACTS_PER_WORKER 64
+#define MAX_PATTERN_MATCH_WORKERS 64
+#define STR_MAX_PATTERN_MATCH_WORKERS "64"
+
+   bool                           ParallelFactPatternMatch(Environment *,Fact **,size_t,bool *);
+
+#endif /* _H_factpar */
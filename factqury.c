@@ -59,6 +59,9 @@
 /*                                                           */
 /*            Eval support for run time and bload only.      */
 /*                                                           */
+/*            Queries testing a slot for equality use a slot */
+/*            index rather than scanning every fact.         */
+/*                                                           */
 /*************************************************************/
 
 /* =========================================
@@ -70,11 +73,15 @@
 
 #if FACT_SET_QUERIES
 
+#include <limits.h>
+#include <string.h>
+
 #include "argacces.h"
 #include "envrnmnt.h"
 #include "memalloc.h"
 #include "exprnpsr.h"
 #include "modulutl.h"
+#include "prdctfun.h"
 #include "tmpltutl.h"
 #include "insfun.h"
 #include "factqpsr.h"
@@ -85,6 +92,28 @@
 
 #include "factqury.h"
 
+#define INITIAL_QUERY_INDEX_SIZE 16
+
+#define QueryIndexBucket(value,size) \
+   ((((size_t) (value) >> 3) ^ ((size_t) (value) >> 11)) & ((size) - 1))
+
+/***************************************************************/
+/* queryFactScan: The position of a query restriction in the   */
+/*   facts of a template. When the query tests a slot of the   */
+/*   restriction for equality with a value that doesn't depend */
+/*   on the restriction, only the facts in the slot index with */
+/*   that value are visited.                                   */
+/***************************************************************/
+typedef struct queryFactScan
+  {
+   struct factQueryIndex *index;
+   struct factQueryIndexEntry *entry;
+   unsigned long version;
+   Expression *key;
+   void *keyValue;
+   unsigned indx;
+  } QUERY_FACT_SCAN;
+
 /***************************************/
 /* LOCAL INTERNAL FUNCTION DEFINITIONS */
 /***************************************/
@@ -101,6 +130,19 @@
    static void                    TestEntireTemplate(Environment *,Deftemplate *,QUERY_TEMPLATE *,unsigned);
    static void                    AddSolution(Environment *);
    static void                    PopQuerySoln(Environment *);
+   static Fact                   *GetFirstQueryFact(Environment *,Deftemplate *,unsigned,QUERY_FACT_SCAN *);
+   static Fact                   *GetNextQueryFact(Environment *,Fact *,QUERY_FACT_SCAN *);
+   static void                    EndQueryFactScan(Environment *,QUERY_FACT_SCAN *);
+   static bool                    QueryKeyChanged(Environment *,QUERY_FACT_SCAN *);
+   static Expression             *FindIndexedQueryTest(Environment *,Deftemplate *,unsigned,unsigned short *);
+   static bool                    IsSlotReference(Expression *,unsigned);
+   static bool                    IsStableQueryKey(Expression *,unsigned);
+   static struct factQueryIndex  *FindQueryIndex(Environment *,Deftemplate *,unsigned short);
+   static struct factQueryIndexKey
+                                 *FindQueryIndexKey(struct factQueryIndex *,void *);
+   static void                    AddQueryIndexEntry(Environment *,struct factQueryIndex *,Fact *);
+   static void                    RemoveQueryIndexEntry(Environment *,struct factQueryIndex *,Fact *);
+   static void                    ResizeQueryIndex(Environment *,struct factQueryIndex *,size_t);
 
 /****************************************************
   NAME         : SetupFactQuery
@@ -667,6 +709,93 @@ void DelayedQueryDoForAllFacts(
    DeleteQueryTemplates(theEnv,qtemplates);
   }
 
+/******************************************************************
+  NAME         : AddQueryIndexedFact
+  DESCRIPTION  : Adds a fact to the slot indexes of its template
+  INPUTS       : The fact
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Index entries allocated
+  NOTES        : Called once the fact is in the fact list and has
+                   its fact index
+ ******************************************************************/
+void AddQueryIndexedFact(
+  Environment *theEnv,
+  Fact *theFact)
+  {
+   struct factQueryIndex *theIndex;
+
+   for (theIndex = theFact->whichDeftemplate->queryIndexes;
+        theIndex != NULL;
+        theIndex = theIndex->next)
+     { AddQueryIndexEntry(theEnv,theIndex,theFact); }
+  }
+
+/******************************************************************
+  NAME         : RemoveQueryIndexedFact
+  DESCRIPTION  : Removes a fact from the slot indexes of its
+                   template
+  INPUTS       : The fact
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Index entries deallocated
+  NOTES        : Called before the slot values of the fact change
+ ******************************************************************/
+void RemoveQueryIndexedFact(
+  Environment *theEnv,
+  Fact *theFact)
+  {
+   struct factQueryIndex *theIndex;
+
+   for (theIndex = theFact->whichDeftemplate->queryIndexes;
+        theIndex != NULL;
+        theIndex = theIndex->next)
+     { RemoveQueryIndexEntry(theEnv,theIndex,theFact); }
+  }
+
+/******************************************************
+  NAME         : DeleteQueryIndexes
+  DESCRIPTION  : Deletes the slot indexes of a template
+  INPUTS       : The template
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Indexes deallocated
+  NOTES        : None
+ ******************************************************/
+void DeleteQueryIndexes(
+  Environment *theEnv,
+  Deftemplate *templatePtr)
+  {
+   struct factQueryIndex *theIndex;
+   struct factQueryIndexKey *theKey;
+   struct factQueryIndexEntry *theEntry;
+   size_t i;
+
+   while (templatePtr->queryIndexes != NULL)
+     {
+      theIndex = templatePtr->queryIndexes;
+      templatePtr->queryIndexes = theIndex->next;
+
+      for (i = 0 ; i < theIndex->tableSize ; i++)
+        {
+         while (theIndex->table[i] != NULL)
+           {
+            theKey = theIndex->table[i];
+            theIndex->table[i] = theKey->next;
+
+            while (theKey->first != NULL)
+              {
+               theEntry = theKey->first;
+               theKey->first = theEntry->next;
+               rtn_struct(theEnv,factQueryIndexEntry,theEntry);
+              }
+
+            rtn_struct(theEnv,factQueryIndexKey,theKey);
+           }
+        }
+
+      rm(theEnv,theIndex->table,sizeof(struct factQueryIndexKey *) * theIndex->tableSize);
+      rtn_struct(theEnv,factQueryIndex,theIndex);
+     }
+  }
+
 /* =========================================
    *****************************************
           INTERNALLY VISIBLE FUNCTIONS
@@ -1019,10 +1148,11 @@ static bool TestForFirstFactInTemplate(
    UDFValue temp;
    GCBlock gcb;
    unsigned j;
+   QUERY_FACT_SCAN scan;
 
    GCBlockStart(theEnv,&gcb);
 
-   theFact = templatePtr->factList;
+   theFact = GetFirstQueryFact(theEnv,templatePtr,indx,&scan);
    while (theFact != NULL)
      {
       FactQueryData(theEnv)->QueryCore->solns[indx] = theFact;
@@ -1069,13 +1199,12 @@ static bool TestForFirstFactInTemplate(
       /* Get the next fact that has not been retracted. */
       /*================================================*/
       
-      theFact = theFact->nextTemplateFact;
-      while ((theFact != NULL) ? (theFact->garbage == 1) : false)
-        { theFact = theFact->nextTemplateFact; }
+      theFact = GetNextQueryFact(theEnv,theFact,&scan);
      }
      
    endTest:
    
+   EndQueryFactScan(theEnv,&scan);
    GCBlockEnd(theEnv,&gcb);
    CallPeriodicTasks(theEnv);
 
@@ -1141,10 +1270,11 @@ static void TestEntireTemplate(
    UDFValue temp;
    GCBlock gcb;
    unsigned j;
+   QUERY_FACT_SCAN scan;
 
    GCBlockStart(theEnv,&gcb);
 
-   theFact = templatePtr->factList;
+   theFact = GetFirstQueryFact(theEnv,templatePtr,indx,&scan);
    while (theFact != NULL)
      {
       FactQueryData(theEnv)->QueryCore->solns[indx] = theFact;
@@ -1194,9 +1324,7 @@ static void TestEntireTemplate(
            }
         }
 
-      theFact = theFact->nextTemplateFact;
-      while ((theFact != NULL) ? (theFact->garbage == 1) : false)
-       { theFact = theFact->nextTemplateFact; }
+      theFact = GetNextQueryFact(theEnv,theFact,&scan);
 
       CleanCurrentGarbageFrame(theEnv,NULL);
       CallPeriodicTasks(theEnv);
@@ -1204,6 +1332,7 @@ static void TestEntireTemplate(
 
    endTest:
    
+   EndQueryFactScan(theEnv,&scan);
    GCBlockEnd(theEnv,&gcb);
    CallPeriodicTasks(theEnv);
   }
@@ -1256,6 +1385,570 @@ static void PopQuerySoln(
    rm(theEnv,FactQueryData(theEnv)->QueryCore->soln_bottom,sizeof(QUERY_SOLN));
   }
 
+/*****************************************************************
+  NAME         : GetFirstQueryFact
+  DESCRIPTION  : Determines the first fact of a template to be
+                   examined for a query restriction
+  INPUTS       : 1) The template
+                 2) The index of the restriction
+                 3) Caller's buffer for the scan position
+  RETURNS      : The first fact, or NULL if there are none
+  SIDE EFFECTS : The slot index is built if necessary
+  NOTES        : If the query (or the first of a series of eq
+                   tests joined by an and) tests a single-field
+                   slot of the restriction for equality with a
+                   constant, a variable, or a slot of another
+                   restriction, only the facts in the slot index
+                   with that value are examined. Since the test
+                   fails for all of the other facts, the query
+                   results are the same as for a full scan.
+ *****************************************************************/
+static Fact *GetFirstQueryFact(
+  Environment *theEnv,
+  Deftemplate *templatePtr,
+  unsigned indx,
+  QUERY_FACT_SCAN *scan)
+  {
+   Expression *theKey;
+   unsigned short whichSlot;
+   UDFValue keyValue;
+   struct factQueryIndexKey *theIndexKey;
+
+   scan->index = NULL;
+   scan->keyValue = NULL;
+
+   if (templatePtr->factList == NULL)
+     { return NULL; }
+
+   theKey = FindIndexedQueryTest(theEnv,templatePtr,indx,&whichSlot);
+   if (theKey == NULL)
+     { return templatePtr->factList; }
+
+   /*===================================================*/
+   /* An error evaluating the key would also occur when */
+   /* the query is evaluated for the first fact.        */
+   /*===================================================*/
+
+   if (EvaluateExpression(theEnv,theKey,&keyValue))
+     { return NULL; }
+
+   if (keyValue.header->type == MULTIFIELD_TYPE)
+     { return templatePtr->factList; }
+
+   scan->index = FindQueryIndex(theEnv,templatePtr,whichSlot);
+   scan->version = scan->index->version;
+   scan->key = theKey;
+   scan->keyValue = keyValue.value;
+   scan->indx = indx;
+   Retain(theEnv,keyValue.header);
+
+   theIndexKey = FindQueryIndexKey(scan->index,keyValue.value);
+   if (theIndexKey == NULL)
+     { return NULL; }
+
+   scan->entry = theIndexKey->first;
+   return scan->entry->theFact;
+  }
+
+/*****************************************************************
+  NAME         : GetNextQueryFact
+  DESCRIPTION  : Determines the next fact of a template to be
+                   examined for a query restriction
+  INPUTS       : 1) The current fact
+                 2) The scan position
+  RETURNS      : The next fact, or NULL if there are no more
+  SIDE EFFECTS : None
+  NOTES        : If the facts of the template or the value of
+                   the key have changed since the scan began, the
+                   remaining facts of the template are examined
+                   in order from the current fact
+ *****************************************************************/
+static Fact *GetNextQueryFact(
+  Environment *theEnv,
+  Fact *theFact,
+  QUERY_FACT_SCAN *scan)
+  {
+   if (scan->index != NULL)
+     {
+      if ((scan->index->version == scan->version) &&
+          (QueryKeyChanged(theEnv,scan) == false))
+        {
+         scan->entry = scan->entry->next;
+         if (scan->entry == NULL)
+           { return NULL; }
+
+         return scan->entry->theFact;
+        }
+
+      scan->index = NULL;
+     }
+
+   theFact = theFact->nextTemplateFact;
+   while ((theFact != NULL) ? (theFact->garbage == 1) : false)
+     { theFact = theFact->nextTemplateFact; }
+
+   return theFact;
+  }
+
+/***************************************************
+  NAME         : EndQueryFactScan
+  DESCRIPTION  : Releases the key value of a scan
+  INPUTS       : The scan position
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Key value busy count decremented
+  NOTES        : None
+ ***************************************************/
+static void EndQueryFactScan(
+  Environment *theEnv,
+  QUERY_FACT_SCAN *scan)
+  {
+   if (scan->keyValue != NULL)
+     { Release(theEnv,(TypeHeader *) scan->keyValue); }
+  }
+
+/*****************************************************************
+  NAME         : QueryKeyChanged
+  DESCRIPTION  : Determines if the key of an indexed scan has a
+                   different value than when the scan began
+  INPUTS       : The scan position
+  RETURNS      : True if the key may have changed, false otherwise
+  SIDE EFFECTS : The key is reevaluated
+  NOTES        : The action of a query can rebind a variable or
+                   modify the fact referenced by the key
+ *****************************************************************/
+static bool QueryKeyChanged(
+  Environment *theEnv,
+  QUERY_FACT_SCAN *scan)
+  {
+   UDFValue keyValue;
+   QUERY_CORE *core;
+   Fact *keyFact;
+
+   if (ConstantType(scan->key->type))
+     { return false; }
+
+   if ((scan->key->type == FCALL) &&
+       ((int (*)(void)) ExpressionFunctionPointer(scan->key) != (int (*)(void)) GetLoopCount))
+     {
+      core = FindQueryCore(theEnv,scan->key->argList->integerValue->contents);
+      keyFact = core->solns[scan->key->argList->nextArg->integerValue->contents];
+      if (keyFact->garbage)
+        { return true; }
+     }
+
+   if (EvaluateExpression(theEnv,scan->key,&keyValue))
+     { return true; }
+
+   return (keyValue.value != scan->keyValue);
+  }
+
+/*****************************************************************
+  NAME         : FindIndexedQueryTest
+  DESCRIPTION  : Determines if the query tests a single-field
+                   slot of a restriction for equality with a key
+                   that doesn't depend on the restriction
+  INPUTS       : 1) The template of the restriction
+                 2) The index of the restriction
+                 3) Caller's buffer for the slot position
+  RETURNS      : The key expression, or NULL if the facts of the
+                   template must all be examined
+  SIDE EFFECTS : None
+  NOTES        : The test must be the query itself or one of the
+                   leading eq tests of an and. The eq tests which
+                   precede it may only reference constants,
+                   variables, and fact-set members so that
+                   skipping their evaluation has no side effects.
+ *****************************************************************/
+static Expression *FindIndexedQueryTest(
+  Environment *theEnv,
+  Deftemplate *templatePtr,
+  unsigned indx,
+  unsigned short *whichSlot)
+  {
+   Expression *theTest, *theSlot, *theKey;
+   struct templateSlot *slotPtr;
+   bool conjunction = false;
+
+   if (templatePtr->implied)
+     { return NULL; }
+
+   theTest = FactQueryData(theEnv)->QueryCore->query;
+   if ((theTest->type == FCALL) &&
+       ((int (*)(void)) ExpressionFunctionPointer(theTest) == (int (*)(void)) AndFunction))
+     {
+      theTest = theTest->argList;
+      conjunction = true;
+     }
+
+   while (theTest != NULL)
+     {
+      if ((theTest->type != FCALL) ||
+          ((int (*)(void)) ExpressionFunctionPointer(theTest) != (int (*)(void)) EqFunction) ||
+          (CountArguments(theTest->argList) != 2))
+        { return NULL; }
+
+      theSlot = theTest->argList;
+      theKey = theSlot->nextArg;
+      if (! (IsSlotReference(theSlot,indx) && IsStableQueryKey(theKey,indx)))
+        {
+         theKey = theTest->argList;
+         theSlot = theKey->nextArg;
+         if (! (IsSlotReference(theSlot,indx) && IsStableQueryKey(theKey,indx)))
+           { theSlot = NULL; }
+        }
+
+      if (theSlot != NULL)
+        {
+         slotPtr = FindSlot(templatePtr,theSlot->argList->nextArg->nextArg->lexemeValue,whichSlot);
+         if ((slotPtr == NULL) || slotPtr->multislot)
+           { return NULL; }
+
+         return theKey;
+        }
+
+      if ((! conjunction) ||
+          (! IsStableQueryKey(theTest->argList,UINT_MAX)) ||
+          (! IsStableQueryKey(theTest->argList->nextArg,UINT_MAX)))
+        { return NULL; }
+
+      theTest = theTest->nextArg;
+     }
+
+   return NULL;
+  }
+
+/***************************************************************
+  NAME         : IsSlotReference
+  DESCRIPTION  : Determines if an expression is a direct slot
+                   reference to a restriction of the current
+                   query, e.g. ?f:name
+  INPUTS       : 1) The expression
+                 2) The index of the restriction
+  RETURNS      : True if so, false otherwise
+  SIDE EFFECTS : None
+  NOTES        : None
+ ***************************************************************/
+static bool IsSlotReference(
+  Expression *theExp,
+  unsigned indx)
+  {
+   if ((theExp->type != FCALL) ||
+       ((int (*)(void)) ExpressionFunctionPointer(theExp) != (int (*)(void)) GetQueryFactSlot))
+     { return false; }
+
+   if ((theExp->argList->type != INTEGER_TYPE) ||
+       (theExp->argList->integerValue->contents != 0) ||
+       (theExp->argList->nextArg->type != INTEGER_TYPE) ||
+       (theExp->argList->nextArg->integerValue->contents != indx) ||
+       (theExp->argList->nextArg->nextArg->type != SYMBOL_TYPE))
+     { return false; }
+
+   return true;
+  }
+
+/***************************************************************
+  NAME         : IsStableQueryKey
+  DESCRIPTION  : Determines if an expression can be evaluated
+                   once for all of the facts of a restriction
+  INPUTS       : 1) The expression
+                 2) The index of the restriction
+  RETURNS      : True if the expression is a constant, a
+                   variable, a loop counter, or a reference to a
+                   fact-set member (or one of its slots) bound
+                   before the restriction, false otherwise
+  SIDE EFFECTS : None
+  NOTES        : None of these expressions have side effects
+ ***************************************************************/
+static bool IsStableQueryKey(
+  Expression *theExp,
+  unsigned indx)
+  {
+   int (*fptr)(void);
+
+   if (ConstantType(theExp->type))
+     { return true; }
+
+   switch (theExp->type)
+     {
+      case GBL_VARIABLE:
+      case DEFGLOBAL_PTR:
+      case PROC_PARAM:
+      case PROC_GET_BIND:
+#if DEFRULE_CONSTRUCT
+      case FACT_JN_VAR1:
+      case FACT_JN_VAR2:
+      case FACT_JN_VAR3:
+#endif
+        return true;
+
+      case FCALL:
+        fptr = (int (*)(void)) ExpressionFunctionPointer(theExp);
+        if (fptr == (int (*)(void)) GetLoopCount)
+          { return (theExp->argList->type == INTEGER_TYPE); }
+
+        if ((fptr != (int (*)(void)) GetQueryFactSlot) &&
+            (fptr != (int (*)(void)) GetQueryFact))
+          { return false; }
+
+        if ((theExp->argList->type != INTEGER_TYPE) ||
+            (theExp->argList->nextArg->type != INTEGER_TYPE))
+          { return false; }
+
+        if (theExp->argList->integerValue->contents != 0)
+          { return true; }
+
+        return (theExp->argList->nextArg->integerValue->contents < (long long) indx);
+     }
+
+   return false;
+  }
+
+/***************************************************************
+  NAME         : FindQueryIndex
+  DESCRIPTION  : Finds the index of a template slot, building
+                   it from the facts of the template if it
+                   doesn't exist yet
+  INPUTS       : 1) The template
+                 2) The slot position
+  RETURNS      : The slot index
+  SIDE EFFECTS : Index allocated if necessary
+  NOTES        : None
+ ***************************************************************/
+static struct factQueryIndex *FindQueryIndex(
+  Environment *theEnv,
+  Deftemplate *templatePtr,
+  unsigned short whichSlot)
+  {
+   struct factQueryIndex *theIndex;
+   Fact *theFact;
+
+   for (theIndex = templatePtr->queryIndexes;
+        theIndex != NULL;
+        theIndex = theIndex->next)
+     {
+      if (theIndex->whichSlot == whichSlot)
+        { return theIndex; }
+     }
+
+   theIndex = get_struct(theEnv,factQueryIndex);
+   theIndex->whichSlot = whichSlot;
+   theIndex->version = 0;
+   theIndex->keyCount = 0;
+   theIndex->tableSize = INITIAL_QUERY_INDEX_SIZE;
+   theIndex->table = (struct factQueryIndexKey **)
+                     gm2(theEnv,sizeof(struct factQueryIndexKey *) * theIndex->tableSize);
+   memset(theIndex->table,0,sizeof(struct factQueryIndexKey *) * theIndex->tableSize);
+   theIndex->next = templatePtr->queryIndexes;
+   templatePtr->queryIndexes = theIndex;
+
+   for (theFact = templatePtr->factList;
+        theFact != NULL;
+        theFact = theFact->nextTemplateFact)
+     { AddQueryIndexEntry(theEnv,theIndex,theFact); }
+
+   return theIndex;
+  }
+
+/***************************************************
+  NAME         : FindQueryIndexKey
+  DESCRIPTION  : Finds the facts in a slot index
+                   with the specified slot value
+  INPUTS       : 1) The slot index
+                 2) The slot value
+  RETURNS      : The index key, or NULL if no facts
+                   have the value
+  SIDE EFFECTS : None
+  NOTES        : None
+ ***************************************************/
+static struct factQueryIndexKey *FindQueryIndexKey(
+  struct factQueryIndex *theIndex,
+  void *theValue)
+  {
+   struct factQueryIndexKey *theKey;
+
+   for (theKey = theIndex->table[QueryIndexBucket(theValue,theIndex->tableSize)];
+        theKey != NULL;
+        theKey = theKey->next)
+     {
+      if (theKey->value == theValue)
+        { return theKey; }
+     }
+
+   return NULL;
+  }
+
+/*****************************************************************
+  NAME         : AddQueryIndexEntry
+  DESCRIPTION  : Adds a fact to a slot index
+  INPUTS       : 1) The slot index
+                 2) The fact
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Index entry (and key) allocated
+  NOTES        : Newly asserted facts have the largest fact
+                   index and are appended. A modified fact keeps
+                   its fact index and is inserted in order.
+ *****************************************************************/
+static void AddQueryIndexEntry(
+  Environment *theEnv,
+  struct factQueryIndex *theIndex,
+  Fact *theFact)
+  {
+   void *theValue = theFact->theProposition.contents[theIndex->whichSlot].value;
+   struct factQueryIndexKey *theKey;
+   struct factQueryIndexEntry *theEntry, *prev;
+   size_t bucket;
+
+   theKey = FindQueryIndexKey(theIndex,theValue);
+   if (theKey == NULL)
+     {
+      if (theIndex->keyCount >= theIndex->tableSize)
+        { ResizeQueryIndex(theEnv,theIndex,theIndex->tableSize * 2); }
+
+      theKey = get_struct(theEnv,factQueryIndexKey);
+      theKey->value = theValue;
+      theKey->first = NULL;
+      theKey->last = NULL;
+      bucket = QueryIndexBucket(theValue,theIndex->tableSize);
+      theKey->next = theIndex->table[bucket];
+      theIndex->table[bucket] = theKey;
+      theIndex->keyCount++;
+     }
+
+   theEntry = get_struct(theEnv,factQueryIndexEntry);
+   theEntry->theFact = theFact;
+
+   if (theKey->last == NULL)
+     {
+      theEntry->next = NULL;
+      theKey->first = theEntry;
+      theKey->last = theEntry;
+     }
+   else if (theKey->last->theFact->factIndex < theFact->factIndex)
+     {
+      theEntry->next = NULL;
+      theKey->last->next = theEntry;
+      theKey->last = theEntry;
+     }
+   else if (theFact->factIndex < theKey->first->theFact->factIndex)
+     {
+      theEntry->next = theKey->first;
+      theKey->first = theEntry;
+     }
+   else
+     {
+      for (prev = theKey->first;
+           prev->next->theFact->factIndex < theFact->factIndex;
+           prev = prev->next)
+        { /* Do Nothing */ }
+
+      theEntry->next = prev->next;
+      prev->next = theEntry;
+     }
+
+   theIndex->version++;
+  }
+
+/*****************************************************
+  NAME         : RemoveQueryIndexEntry
+  DESCRIPTION  : Removes a fact from a slot index
+  INPUTS       : 1) The slot index
+                 2) The fact
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Index entry (and key) deallocated
+  NOTES        : None
+ *****************************************************/
+static void RemoveQueryIndexEntry(
+  Environment *theEnv,
+  struct factQueryIndex *theIndex,
+  Fact *theFact)
+  {
+   void *theValue = theFact->theProposition.contents[theIndex->whichSlot].value;
+   struct factQueryIndexKey *theKey, *prevKey;
+   struct factQueryIndexEntry *theEntry, *prev = NULL;
+   size_t bucket;
+
+   theKey = FindQueryIndexKey(theIndex,theValue);
+   if (theKey == NULL)
+     { return; }
+
+   for (theEntry = theKey->first;
+        (theEntry != NULL) && (theEntry->theFact != theFact);
+        theEntry = theEntry->next)
+     { prev = theEntry; }
+
+   if (theEntry == NULL)
+     { return; }
+
+   if (prev == NULL)
+     { theKey->first = theEntry->next; }
+   else
+     { prev->next = theEntry->next; }
+
+   if (theKey->last == theEntry)
+     { theKey->last = prev; }
+
+   rtn_struct(theEnv,factQueryIndexEntry,theEntry);
+   theIndex->version++;
+
+   if (theKey->first != NULL)
+     { return; }
+
+   bucket = QueryIndexBucket(theValue,theIndex->tableSize);
+   if (theIndex->table[bucket] == theKey)
+     { theIndex->table[bucket] = theKey->next; }
+   else
+     {
+      for (prevKey = theIndex->table[bucket];
+           prevKey->next != theKey;
+           prevKey = prevKey->next)
+        { /* Do Nothing */ }
+
+      prevKey->next = theKey->next;
+     }
+
+   rtn_struct(theEnv,factQueryIndexKey,theKey);
+   theIndex->keyCount--;
+  }
+
+/***************************************************
+  NAME         : ResizeQueryIndex
+  DESCRIPTION  : Rehashes the keys of a slot index
+                   into a table of a new size
+  INPUTS       : 1) The slot index
+                 2) The new table size (a power of 2)
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Table reallocated
+  NOTES        : None
+ ***************************************************/
+static void ResizeQueryIndex(
+  Environment *theEnv,
+  struct factQueryIndex *theIndex,
+  size_t newSize)
+  {
+   struct factQueryIndexKey **newTable, *theKey;
+   size_t i, bucket;
+
+   newTable = (struct factQueryIndexKey **)
+              gm2(theEnv,sizeof(struct factQueryIndexKey *) * newSize);
+   memset(newTable,0,sizeof(struct factQueryIndexKey *) * newSize);
+
+   for (i = 0 ; i < theIndex->tableSize ; i++)
+     {
+      while (theIndex->table[i] != NULL)
+        {
+         theKey = theIndex->table[i];
+         theIndex->table[i] = theKey->next;
+         bucket = QueryIndexBucket(theKey->value,newSize);
+         theKey->next = newTable[bucket];
+         newTable[bucket] = theKey;
+        }
+     }
+
+   rm(theEnv,theIndex->table,sizeof(struct factQueryIndexKey *) * theIndex->tableSize);
+   theIndex->table = newTable;
+   theIndex->tableSize = newSize;
+  }
+
 #endif
 
 
@@ -41,6 +41,8 @@
 /*                                                           */
 /*            UDF redesign.                                  */
 /*                                                           */
+/*            Added slot indexes for fact-set queries.       */
+/*                                                           */
 /*************************************************************/
 
 #ifndef _H_factqury
@@ -80,6 +82,37 @@ typedef struct query_stack
    struct query_stack *nxt;
   } QUERY_STACK;
 
+/**************************************************************/
+/* factQueryIndex: Index of the facts of a deftemplate by the */
+/*   value of a single-field slot. Built the first time a     */
+/*   query tests the slot for equality and then maintained as */
+/*   facts are asserted, retracted, and modified. The facts   */
+/*   sharing a value are kept in fact index order.            */
+/**************************************************************/
+struct factQueryIndexEntry
+  {
+   Fact *theFact;
+   struct factQueryIndexEntry *next;
+  };
+
+struct factQueryIndexKey
+  {
+   void *value;
+   struct factQueryIndexEntry *first;
+   struct factQueryIndexEntry *last;
+   struct factQueryIndexKey *next;
+  };
+
+struct factQueryIndex
+  {
+   unsigned short whichSlot;
+   unsigned long version;
+   size_t keyCount;
+   size_t tableSize;
+   struct factQueryIndexKey **table;
+   struct factQueryIndex *next;
+  };
+
 #define FACT_QUERY_DATA 63
 
 struct factQueryData
@@ -103,6 +136,9 @@ struct factQueryData
    void                           QueryDoForFact(Environment *,UDFContext *,UDFValue *);
    void                           QueryDoForAllFacts(Environment *,UDFContext *,UDFValue *);
    void                           DelayedQueryDoForAllFacts(Environment *,UDFContext *,UDFValue *);
+   void                           AddQueryIndexedFact(Environment *,Fact *);
+   void                           RemoveQueryIndexedFact(Environment *,Fact *);
+   void                           DeleteQueryIndexes(Environment *,Deftemplate *);
 
 #endif /* FACT_SET_QUERIES */
 
@@ -44,6 +44,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "setup.h"
 
@@ -84,6 +85,8 @@
    static struct expr            *GenPNColon(Environment *,struct lhsParseNode *);
    static struct expr            *GenJNEq(Environment *,struct lhsParseNode *,bool,struct nandFrame *);
    static struct expr            *GenPNEq(Environment *,struct lhsParseNode *);
+   static struct expr            *GenJNRangeTest(Environment *,struct lhsParseNode *);
+   static const char             *RangeComparisonName(struct lhsParseNode *,bool);
    static struct expr            *GenJNVariableComparison(Environment *,struct lhsParseNode *,
                                                           struct lhsParseNode *,bool);
    static struct expr            *GenPNVariableComparison(Environment *,struct lhsParseNode *,
@@ -293,6 +296,26 @@ void FieldConversion(
         }
      }
 
+   /*===========================================================*/
+   /* If the field isn't an or'ed constraint, then any range    */
+   /* comparisons it makes against variables bound in prior     */
+   /* patterns are recorded so the join can use them to index   */
+   /* its alpha memory.                                         */
+   /*===========================================================*/
+
+   if ((theField->bottom != NULL) && (theField->bottom->bottom == NULL) &&
+       (! thePattern->negated) && (! thePattern->exists) &&
+       (thePattern->beginNandDepth == 1))
+     {
+      for (patternPtr = theField->bottom;
+           patternPtr != NULL;
+           patternPtr = patternPtr->right)
+        {
+         tempExpression = GenJNRangeTest(theEnv,patternPtr);
+         thePattern->rangeTest = AppendExpressions(thePattern->rangeTest,tempExpression);
+        }
+     }
+
    /*======================================================*/
    /* Attach the pattern network expressions to the field. */
    /*======================================================*/
@@ -709,6 +732,108 @@ static struct expr *GenPNEq(
    return(top);
   }
 
+/*************************************************************/
+/* GenJNRangeTest: Generates a range term for a predicate    */
+/*   constraint of the form :(op ?x ?y) where op is one of   */
+/*   <, <=, >, or >=, one variable is bound in the pattern   */
+/*   being joined, and the other is bound in a prior         */
+/*   pattern. The term is normalized so that the value from  */
+/*   the right side of the join is the first argument. Each  */
+/*   term is also part of the join's network test, so the    */
+/*   join only uses them to skip alpha memory entries that   */
+/*   could not satisfy that test.                            */
+/*************************************************************/
+static struct expr *GenJNRangeTest(
+  Environment *theEnv,
+  struct lhsParseNode *theField)
+  {
+   struct lhsParseNode *theCall, *firstArg, *secondArg, *keyArg, *boundArg, *theArg;
+   const char *comparisonName;
+   struct expr *top;
+
+   if ((theField->pnType != PREDICATE_CONSTRAINT_NODE) || theField->negated)
+     { return NULL; }
+
+   theCall = theField->expression;
+   if ((theCall == NULL) || (theCall->pnType != FCALL_NODE) || (theCall->right != NULL))
+     { return NULL; }
+
+   firstArg = theCall->bottom;
+   if ((firstArg == NULL) || (firstArg->right == NULL) || (firstArg->right->right != NULL))
+     { return NULL; }
+   secondArg = firstArg->right;
+
+   /*==================================================*/
+   /* Both arguments must be single field variables    */
+   /* which can be retrieved without nand unification. */
+   /*==================================================*/
+
+   for (theArg = firstArg; theArg != NULL; theArg = theArg->right)
+     {
+      if ((theArg->pnType != SF_VARIABLE_NODE) ||
+          (theArg->referringNode == NULL) ||
+          (theArg->referringNode->beginNandDepth != 1) ||
+          (theArg->beginNandDepth != theArg->referringNode->beginNandDepth) ||
+          (theArg->referringNode->patternType->genGetJNValueFunction == NULL))
+        { return NULL; }
+     }
+
+   /*===================================================*/
+   /* One variable must come from the right side of the */
+   /* join and the other from the left side.            */
+   /*===================================================*/
+
+   if ((firstArg->joinDepth == firstArg->referringNode->joinDepth) &&
+       (secondArg->joinDepth != secondArg->referringNode->joinDepth))
+     {
+      keyArg = firstArg;
+      boundArg = secondArg;
+      comparisonName = RangeComparisonName(theCall,false);
+     }
+   else if ((firstArg->joinDepth != firstArg->referringNode->joinDepth) &&
+            (secondArg->joinDepth == secondArg->referringNode->joinDepth))
+     {
+      keyArg = secondArg;
+      boundArg = firstArg;
+      comparisonName = RangeComparisonName(theCall,true);
+     }
+   else
+     { return NULL; }
+
+   if ((comparisonName == NULL) || (keyArg->referringNode->pattern != theField->pattern))
+     { return NULL; }
+
+   top = GenConstant(theEnv,FCALL,FindFunction(theEnv,comparisonName));
+   top->argList = (*keyArg->referringNode->patternType->genGetJNValueFunction)(theEnv,keyArg->referringNode,RHS);
+   top->argList->nextArg = (*boundArg->referringNode->patternType->genGetJNValueFunction)(theEnv,boundArg->referringNode,LHS);
+
+   return top;
+  }
+
+/*************************************************************/
+/* RangeComparisonName: Returns the name of the comparison   */
+/*   function called by a predicate constraint (reversing it */
+/*   if its arguments are to be swapped) or NULL if the      */
+/*   function isn't one of the numeric range comparisons.    */
+/*************************************************************/
+static const char *RangeComparisonName(
+  struct lhsParseNode *theCall,
+  bool swapped)
+  {
+   const char *name = theCall->functionValue->callFunctionName->contents;
+
+   if (strcmp(name,">=") == 0)
+     { return swapped ? "<=" : ">="; }
+   else if (strcmp(name,"<=") == 0)
+     { return swapped ? ">=" : "<="; }
+   else if (strcmp(name,">") == 0)
+     { return swapped ? "<" : ">"; }
+   else if (strcmp(name,"<") == 0)
+     { return swapped ? ">" : "<"; }
+
+   return NULL;
+  }
+
 /************************************************************************/
 /* AddNandUnification: Adds expressions to the nand joins to unify the  */
 /*   variable bindings that need to match from the left and right paths */
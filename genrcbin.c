@@ -48,6 +48,7 @@
 #include "cstrccom.h"
 #include "envrnmnt.h"
 #include "genrccom.h"
+#include "genrcexe.h"
 #include "memalloc.h"
 #include "modulbin.h"
 #if OBJECT_SYSTEM
@@ -729,6 +730,7 @@ static void BloadGenerics(
   {
    size_t space;
 
+   InvalidateGenericDispatchCache(theEnv);
    GenReadBinary(theEnv,&space,sizeof(size_t));
    if (DefgenericBinaryData(theEnv)->ModuleCount == 0L)
      return;
@@ -855,6 +857,7 @@ static void ClearBloadGenerics(
    unsigned long i;
    size_t space;
 
+   InvalidateGenericDispatchCache(theEnv);
    space = (sizeof(DEFGENERIC_MODULE) * DefgenericBinaryData(theEnv)->ModuleCount);
    if (space == 0L)
      return;
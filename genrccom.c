@@ -312,7 +312,15 @@ static void DeallocateDefgenericData(
 #if ! RUN_TIME
    struct defgenericModule *theModuleItem;
    Defmodule *theModule;
+#endif
 
+   if (DefgenericData(theEnv)->DispatchCache != NULL)
+     {
+      rm(theEnv,DefgenericData(theEnv)->DispatchCache,
+         sizeof(GENERIC_DISPATCH_ENTRY) * SIZE_GENERIC_DISPATCH_HASH);
+     }
+
+#if ! RUN_TIME
 #if BLOAD || BLOAD_AND_BSAVE
    if (Bloaded(theEnv)) return;
 #endif
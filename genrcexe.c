@@ -66,6 +66,7 @@
 #include "constrct.h"
 #include "envrnmnt.h"
 #include "genrccom.h"
+#include "memalloc.h"
 #include "prcdrfun.h"
 #include "prccode.h"
 #include "prntutil.h"
@@ -91,6 +92,8 @@
    ***************************************** */
 
    static Defmethod              *FindApplicableMethod(Environment *,Defgeneric *,Defmethod *);
+   static GENERIC_DISPATCH_ENTRY *FindDispatchEntry(Environment *,Defgeneric *,GENERIC_DISPATCH_ENTRY *);
+   static bool                    MethodHasQuery(Defmethod *);
 
 #if DEBUGGING_FUNCTIONS
    static void                    WatchGeneric(Environment *,const char *);
@@ -373,6 +376,22 @@ bool IsMethodApplicable(
    return true;
   }
 
+/***************************************************
+  NAME         : InvalidateGenericDispatchCache
+  DESCRIPTION  : Forgets all cached method choices
+  INPUTS       : None
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Dispatch epoch advanced
+  NOTES        : Must be called whenever methods are
+                 added, changed or removed and when
+                 classes are deleted
+ ***************************************************/
+void InvalidateGenericDispatchCache(
+  Environment *theEnv)
+  {
+   DefgenericData(theEnv)->DispatchEpoch++;
+  }
+
 /***************************************************
   NAME         : NextMethodP
   DESCRIPTION  : Determines if a shadowed generic
@@ -598,20 +617,142 @@ static Defmethod *FindApplicableMethod(
   Defgeneric *gfunc,
   Defmethod *meth)
   {
+   GENERIC_DISPATCH_ENTRY key, *slot = NULL;
+
    if (meth != NULL)
      meth++;
    else
-     meth = gfunc->methods;
+     {
+      slot = FindDispatchEntry(theEnv,gfunc,&key);
+      if (slot != NULL)
+        { key.method = slot->method; }
+      if ((slot != NULL) && (slot->method != NULL) &&
+          (memcmp(slot,&key,sizeof(GENERIC_DISPATCH_ENTRY)) == 0))
+        {
+         slot->method->busy++;
+         return slot->method;
+        }
+      meth = gfunc->methods;
+     }
    for ( ; meth < &gfunc->methods[gfunc->mcnt] ; meth++)
      {
+      /*===================================================*/
+      /* Once a query has been evaluated the outcome is no */
+      /* longer a function of the argument types alone.    */
+      /*===================================================*/
+
+      if ((slot != NULL) && MethodHasQuery(meth))
+        { slot = NULL; }
+
       meth->busy++;
       if (IsMethodApplicable(theEnv,meth))
-        return(meth);
+        {
+         if (slot != NULL)
+           {
+            memcpy(slot,&key,sizeof(GENERIC_DISPATCH_ENTRY));
+            slot->method = meth;
+           }
+         return(meth);
+        }
       meth->busy--;
      }
    return NULL;
   }
 
+/***********************************************************
+  NAME         : FindDispatchEntry
+  DESCRIPTION  : Builds the dispatch cache key for the
+                   current generic function arguments
+  INPUTS       : 1) The generic function
+                 2) Caller's buffer for the key
+  RETURNS      : The cache slot for the key, NULL if
+                   the call cannot be cached
+  SIDE EFFECTS : Cache allocated on first use
+  NOTES        : The key is the number of arguments along
+                   with the type (and class for instances)
+                   of each one. The key is zero filled so
+                   that a slot can be compared against it
+                   as a block of memory.
+ ***********************************************************/
+static GENERIC_DISPATCH_ENTRY *FindDispatchEntry(
+  Environment *theEnv,
+  Defgeneric *gfunc,
+  GENERIC_DISPATCH_ENTRY *key)
+  {
+   unsigned short i;
+   unsigned long hash;
+   UDFValue *arg;
+#if OBJECT_SYSTEM
+   Instance *ins;
+#endif
+
+   if (ProceduralPrimitiveData(theEnv)->ProcParamArraySize > GENERIC_DISPATCH_ARGS)
+     { return NULL; }
+
+   memset(key,0,sizeof(GENERIC_DISPATCH_ENTRY));
+   key->gfunc = gfunc;
+   key->epoch = DefgenericData(theEnv)->DispatchEpoch;
+   key->argCount = (unsigned short) ProceduralPrimitiveData(theEnv)->ProcParamArraySize;
+   hash = ((unsigned long) gfunc) >> 3;
+   hash = (hash * 31) + key->argCount;
+
+   for (i = 0 ; i < key->argCount ; i++)
+     {
+      arg = &ProceduralPrimitiveData(theEnv)->ProcParamArray[i];
+      key->types[i] = arg->header->type;
+#if OBJECT_SYSTEM
+      if (arg->header->type == INSTANCE_NAME_TYPE)
+        {
+         ins = FindInstanceBySymbol(theEnv,arg->lexemeValue);
+         if (ins == NULL)
+           { return NULL; }
+         key->classes[i] = ins->cls;
+        }
+      else if (arg->header->type == INSTANCE_ADDRESS_TYPE)
+        {
+         if (arg->instanceValue->garbage)
+           { return NULL; }
+         key->classes[i] = arg->instanceValue->cls;
+        }
+#endif
+      hash = (hash * 31) + key->types[i];
+      hash = (hash * 31) + (((unsigned long) key->classes[i]) >> 3);
+     }
+
+   if (DefgenericData(theEnv)->DispatchCache == NULL)
+     {
+      DefgenericData(theEnv)->DispatchCache = (GENERIC_DISPATCH_ENTRY *)
+         gm2(theEnv,sizeof(GENERIC_DISPATCH_ENTRY) * SIZE_GENERIC_DISPATCH_HASH);
+      memset(DefgenericData(theEnv)->DispatchCache,0,
+             sizeof(GENERIC_DISPATCH_ENTRY) * SIZE_GENERIC_DISPATCH_HASH);
+     }
+
+   return &DefgenericData(theEnv)->DispatchCache[hash % SIZE_GENERIC_DISPATCH_HASH];
+  }
+
+/***************************************************
+  NAME         : MethodHasQuery
+  DESCRIPTION  : Determines if any parameter of a
+                   method has a query restriction
+  INPUTS       : The method
+  RETURNS      : True if there is a query, false
+                   otherwise
+  SIDE EFFECTS : None
+  NOTES        : None
+ ***************************************************/
+static bool MethodHasQuery(
+  Defmethod *meth)
+  {
+   unsigned short i;
+
+   for (i = 0 ; i < meth->restrictionCount ; i++)
+     {
+      if (meth->restrictions[i].query != NULL)
+        { return true; }
+     }
+   return false;
+  }
+
 #if DEBUGGING_FUNCTIONS
 
 /**********************************************************************
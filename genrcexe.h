@@ -55,6 +55,7 @@
    void                           GenericDispatch(Environment *,Defgeneric *,Defmethod *,Defmethod *,Expression *,UDFValue *);
    void                           UnboundMethodErr(Environment *,const char *);
    bool                           IsMethodApplicable(Environment *,Defmethod *);
+   void                           InvalidateGenericDispatchCache(Environment *);
 
    bool                           NextMethodP(Environment *);
    void                           NextMethodPCommand(Environment *,UDFContext *,UDFValue *);
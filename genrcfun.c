@@ -316,6 +316,7 @@ void RemoveDefgeneric(
   {
    long i;
 
+   InvalidateGenericDispatchCache(theEnv);
    for (i = 0 ; i < theDefgeneric->mcnt ; i++)
      DeleteMethodInfo(theEnv,theDefgeneric,&theDefgeneric->methods[i]);
 
@@ -406,6 +407,7 @@ void DeleteMethodInfo(
    RESTRICTION *rptr;
 
    SaveBusyCount(gfunc);
+   InvalidateGenericDispatchCache(theEnv);
    ExpressionDeinstall(theEnv,meth->actions);
    ReturnPackedExpression(theEnv,meth->actions);
    ClearUserDataList(theEnv,meth->header.usrData);
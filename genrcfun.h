@@ -65,6 +65,7 @@ typedef struct defgenericModule DEFGENERIC_MODULE;
 typedef struct restriction RESTRICTION;
 typedef struct defmethod Defmethod;
 typedef struct defgeneric Defgeneric;
+typedef struct genericDispatchEntry GENERIC_DISPATCH_ENTRY;
 
 #include <stdio.h>
 
@@ -91,6 +92,19 @@ struct restriction
    unsigned short tcnt;
   };
 
+#define GENERIC_DISPATCH_ARGS 4
+#define SIZE_GENERIC_DISPATCH_HASH 1021
+
+struct genericDispatchEntry
+  {
+   Defgeneric *gfunc;
+   Defmethod *method;
+   unsigned long epoch;
+   unsigned short argCount;
+   unsigned short types[GENERIC_DISPATCH_ARGS];
+   void *classes[GENERIC_DISPATCH_ARGS];
+  };
+
 struct defmethod
   {
    ConstructHeader header;
@@ -130,6 +144,8 @@ struct defgenericData
    Defgeneric *CurrentGeneric;
    Defmethod *CurrentMethod;
    UDFValue *GenericCurrentArgument;
+   struct genericDispatchEntry *DispatchCache;
+   unsigned long DispatchEpoch;
 #if (! RUN_TIME) && (! BLOAD_ONLY)
    unsigned OldGenericBusySave;
 #endif
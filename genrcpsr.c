@@ -83,6 +83,7 @@
 #include "envrnmnt.h"
 #include "exprnpsr.h"
 #include "genrccom.h"
+#include "genrcexe.h"
 #include "immthpsr.h"
 #include "memalloc.h"
 #include "modulutl.h"
@@ -462,6 +463,7 @@ Defmethod *AddMethod(
    unsigned short mai;
 
    SaveBusyCount(gfunc);
+   InvalidateGenericDispatchCache(theEnv);
    if (meth == NULL)
      {
       mai = (mi != 0) ? FindMethodByIndex(gfunc,mi) : METHOD_NOT_FOUND;
@@ -257,6 +257,7 @@ static void BsaveBinaryItem(
          AssignBsaveConstructHeaderVals(&newDefglobal.header,
                                           &theDefglobal->header);
          newDefglobal.initial = HashedExpressionIndex(theEnv,theDefglobal->initial);
+         newDefglobal.constant = theDefglobal->constant;
 
          GenWrite(&newDefglobal,sizeof(struct bsaveDefglobal),fp);
         }
@@ -395,6 +396,7 @@ static void UpdateDefglobal(
 #if DEBUGGING_FUNCTIONS
    DefglobalBinaryData(theEnv)->DefglobalArray[obji].watch = DefglobalData(theEnv)->WatchGlobals;
 #endif
+   DefglobalBinaryData(theEnv)->DefglobalArray[obji].constant = bdp->constant;
    DefglobalBinaryData(theEnv)->DefglobalArray[obji].initial = HashedExpressionPointer(bdp->initial);
    DefglobalBinaryData(theEnv)->DefglobalArray[obji].current.voidValue = VoidConstant(theEnv);
   }
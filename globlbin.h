@@ -41,6 +41,7 @@ struct bsaveDefglobal
   {
    struct bsaveConstructHeader header;
    unsigned long initial;
+   bool constant;
   };
 
 struct bsaveDefglobalModule
@@ -261,11 +261,12 @@ static void DefglobalToCode(
 
    fprintf(theFile,",");
 
-   /*============================================*/
-   /* Watch Flag, In Scope Flag, and Busy Count. */
-   /*============================================*/
+   /*===========================================*/
+   /* Watch Flag, In Scope Flag, Constant Flag, */
+   /* and Busy Count.                           */
+   /*===========================================*/
 
-   fprintf(theFile,"0,0,%ld,",theDefglobal->busyCount);
+   fprintf(theFile,"0,0,%d,%ld,",theDefglobal->constant,theDefglobal->busyCount);
 
    /*================*/
    /* Current Value. */
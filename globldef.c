@@ -162,6 +162,22 @@ void InitializeDefglobals(
                    (IsConstructDeletableFunction *) DefglobalIsDeletable,
                    (DeleteConstructFunction *) Undefglobal,
                    (FreeConstructFunction *) ReturnDefglobal);
+
+   /*===================================================*/
+   /* A defconstant is a read-only defglobal. It shares */
+   /* the defglobal construct's data structures and is  */
+   /* only registered so that its parser can be found.  */
+   /*===================================================*/
+
+   AddConstruct(theEnv,"defconstant","defconstants",ParseDefconstant,
+                (FindConstructFunction *) FindDefglobal,
+                GetConstructNamePointer,GetConstructPPForm,
+                GetConstructModuleItem,
+                (GetNextConstructFunction *) GetNextDefglobal,
+                SetNextConstruct,
+                (IsConstructDeletableFunction *) DefglobalIsDeletable,
+                (DeleteConstructFunction *) Undefglobal,
+                (FreeConstructFunction *) ReturnDefglobal);
   }
 
 /****************************************************/
@@ -678,6 +694,18 @@ void DefglobalSetValue(
    if (EvaluationData(theEnv)->CurrentExpression == NULL)
      { ResetErrorFlags(theEnv); }
 
+   /*=======================================*/
+   /* The value of a defconstant is fixed   */
+   /* once it has been defined.             */
+   /*=======================================*/
+
+   if (theDefglobal->constant)
+     {
+      ConstantGlobalErrorMessage(theEnv,theDefglobal->header.name->contents);
+      SetEvaluationError(theEnv,true);
+      return;
+     }
+
    GCBlockStart(theEnv,&gcb);
    CLIPSToUDFValue(vPtr,&temp);
    QSetDefglobalValue(theEnv,theDefglobal,&temp,false);
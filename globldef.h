@@ -98,6 +98,7 @@ struct defglobal
    ConstructHeader header;
    unsigned int watch   : 1;
    unsigned int inScope : 1;
+   unsigned int constant : 1;
    long busyCount;
    CLIPSValue current;
    struct expr *initial;
@@ -45,6 +45,12 @@
 /*                                                           */
 /*            Eval support for run time and bload only.      */
 /*                                                           */
+/*            Added the defconstant construct. References to */
+/*            a defconstant are folded into literals.        */
+/*                                                           */
+/*            A defconstant folded into a construct can't be */
+/*            undefined until the construct is deleted.      */
+/*                                                           */
 /*************************************************************/
 
 #include "setup.h"
@@ -80,8 +86,11 @@
 /***************************************/
 
 #if (! RUN_TIME) && (! BLOAD_ONLY)
-   static bool                    GetVariableDefinition(Environment *,const char *,bool *,bool,struct token *);
-   static void                    AddDefglobal(Environment *,CLIPSLexeme *,UDFValue *,struct expr *);
+   static bool                    ParseGlobalConstruct(Environment *,const char *,bool);
+   static bool                    GetVariableDefinition(Environment *,const char *,bool *,bool,struct token *,bool);
+   static bool                    ConstantRedefinitionAllowed(Environment *,CLIPSLexeme *,UDFValue *,bool);
+   static void                    AddDefglobal(Environment *,CLIPSLexeme *,UDFValue *,struct expr *,bool);
+   static bool                    FoldConstantReference(Defglobal *,struct expr *);
 #endif
 
 /*********************************************************************/
@@ -92,12 +101,47 @@ bool ParseDefglobal(
   Environment *theEnv,
   const char *readSource)
   {
-   bool defglobalError = false;
+#if (! RUN_TIME) && (! BLOAD_ONLY)
+   return ParseGlobalConstruct(theEnv,readSource,false);
+#else
+   return false;
+#endif
+  }
+
+/**************************************************************/
+/* ParseDefconstant: Coordinates all actions necessary for    */
+/*   the parsing and creation of a defconstant. A defconstant */
+/*   is a defglobal whose value can't be changed, allowing    */
+/*   references to it to be replaced with its value.          */
+/**************************************************************/
+bool ParseDefconstant(
+  Environment *theEnv,
+  const char *readSource)
+  {
+#if (! RUN_TIME) && (! BLOAD_ONLY)
+   return ParseGlobalConstruct(theEnv,readSource,true);
+#else
+   return false;
+#endif
+  }
+
 #if (! RUN_TIME) && (! BLOAD_ONLY)
 
+/*****************************************************************/
+/* ParseGlobalConstruct: Parses the body of either a defglobal   */
+/*   or a defconstant construct. The two constructs differ only  */
+/*   in whether the variables they define can be assigned to.    */
+/*****************************************************************/
+static bool ParseGlobalConstruct(
+  Environment *theEnv,
+  const char *readSource,
+  bool constant)
+  {
+   bool defglobalError = false;
    struct token theToken;
    bool tokenRead = true;
    Defmodule *theModule;
+   const char *constructName = constant ? "defconstant" : "defglobal";
 
    /*=====================================*/
    /* Pretty print buffer initialization. */
@@ -106,7 +150,9 @@ bool ParseDefglobal(
    SetPPBufferStatus(theEnv,true);
    FlushPPBuffer(theEnv);
    SetIndentDepth(theEnv,3);
-   SavePPBuffer(theEnv,"(defglobal ");
+   SavePPBuffer(theEnv,"(");
+   SavePPBuffer(theEnv,constructName);
+   SavePPBuffer(theEnv," ");
 
    /*=================================================*/
    /* Individual defglobal constructs can't be parsed */
@@ -116,7 +162,7 @@ bool ParseDefglobal(
 #if BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE
    if ((Bloaded(theEnv) == true) && (! ConstructData(theEnv)->CheckSyntaxMode))
      {
-      CannotLoadWithBloadMessage(theEnv,"defglobal");
+      CannotLoadWithBloadMessage(theEnv,constructName);
       return true;
      }
 #endif
@@ -138,7 +184,7 @@ bool ParseDefglobal(
       tokenRead = false;
       if (FindModuleSeparator(theToken.lexemeValue->contents))
         {
-         SyntaxErrorMessage(theEnv,"defglobal");
+         SyntaxErrorMessage(theEnv,constructName);
          return true;
         }
 
@@ -180,18 +226,18 @@ bool ParseDefglobal(
    /* Parse the variables. */
    /*======================*/
 
-   while (GetVariableDefinition(theEnv,readSource,&defglobalError,tokenRead,&theToken))
+   while (GetVariableDefinition(theEnv,readSource,&defglobalError,tokenRead,&theToken,constant))
      {
       tokenRead = false;
 
       FlushPPBuffer(theEnv);
-      SavePPBuffer(theEnv,"(defglobal ");
+      SavePPBuffer(theEnv,"(");
+      SavePPBuffer(theEnv,constructName);
+      SavePPBuffer(theEnv," ");
       SavePPBuffer(theEnv,DefmoduleName(GetCurrentModule(theEnv)));
       SavePPBuffer(theEnv," ");
      }
 
-#endif
-
    /*==================================*/
    /* Return the parsing error status. */
    /*==================================*/
@@ -199,8 +245,6 @@ bool ParseDefglobal(
    return(defglobalError);
   }
 
-#if (! RUN_TIME) && (! BLOAD_ONLY)
-
 /***************************************************************/
 /* GetVariableDefinition: Parses and evaluates a single global */
 /*   variable in a defglobal construct. Returns true if the    */
@@ -214,11 +258,13 @@ static bool GetVariableDefinition(
   const char *readSource,
   bool *defglobalError,
   bool tokenRead,
-  struct token *theToken)
+  struct token *theToken,
+  bool constant)
   {
    CLIPSLexeme *variableName;
    struct expr *assignPtr;
    UDFValue assignValue;
+   const char *constructName = constant ? "defconstant" : "defglobal";
 
    /*========================================*/
    /* Get next token, which should either be */
@@ -230,13 +276,13 @@ static bool GetVariableDefinition(
 
    if (theToken->tknType == SF_VARIABLE_TOKEN)
      {
-      SyntaxErrorMessage(theEnv,"defglobal");
+      SyntaxErrorMessage(theEnv,constructName);
       *defglobalError = true;
       return false;
      }
    else if (theToken->tknType != GBL_VARIABLE_TOKEN)
      {
-      SyntaxErrorMessage(theEnv,"defglobal");
+      SyntaxErrorMessage(theEnv,constructName);
       *defglobalError = true;
       return false;
      }
@@ -287,7 +333,7 @@ static bool GetVariableDefinition(
    GetToken(theEnv,readSource,theToken);
    if (strcmp(theToken->printForm,"=") != 0)
      {
-      SyntaxErrorMessage(theEnv,"defglobal");
+      SyntaxErrorMessage(theEnv,constructName);
       *defglobalError = true;
       return false;
      }
@@ -318,6 +364,18 @@ static bool GetVariableDefinition(
          *defglobalError = true;
          return false;
         }
+
+      /*===================================================*/
+      /* References to a defconstant may already have been */
+      /* folded into literals, so its value can't change.  */
+      /*===================================================*/
+
+      if (! ConstantRedefinitionAllowed(theEnv,variableName,&assignValue,constant))
+        {
+         ReturnExpression(theEnv,assignPtr);
+         *defglobalError = true;
+         return false;
+        }
      }
    else
      { ReturnExpression(theEnv,assignPtr); }
@@ -329,7 +387,7 @@ static bool GetVariableDefinition(
    /*======================================*/
 
    if (! ConstructData(theEnv)->CheckSyntaxMode)
-     { AddDefglobal(theEnv,variableName,&assignValue,assignPtr); }
+     { AddDefglobal(theEnv,variableName,&assignValue,assignPtr,constant); }
 
    /*==================================================*/
    /* Return true to indicate that the global variable */
@@ -339,6 +397,50 @@ static bool GetVariableDefinition(
    return true;
   }
 
+/****************************************************************/
+/* ConstantRedefinitionAllowed: Determines whether a variable   */
+/*   can be (re)defined. An existing defconstant can only be    */
+/*   redefined by another defconstant having the same value.    */
+/****************************************************************/
+static bool ConstantRedefinitionAllowed(
+  Environment *theEnv,
+  CLIPSLexeme *name,
+  UDFValue *vPtr,
+  bool constant)
+  {
+   Defglobal *theGlobal;
+   UDFValue oldValue;
+   bool sameValue;
+
+   theGlobal = QFindDefglobal(theEnv,name);
+   if ((theGlobal == NULL) || (! theGlobal->constant))
+     { return true; }
+
+   if (theGlobal->current.header->type != vPtr->header->type)
+     { sameValue = false; }
+   else if (vPtr->header->type == MULTIFIELD_TYPE)
+     {
+      CLIPSToUDFValue(&theGlobal->current,&oldValue);
+      sameValue = MultifieldDOsEqual(&oldValue,vPtr);
+     }
+   else
+     { sameValue = (theGlobal->current.value == vPtr->value); }
+
+   if (constant && sameValue)
+     { return true; }
+
+   PrintErrorID(theEnv,"GLOBLPSR",3,true);
+   WriteString(theEnv,STDERR,"Constant ?*");
+   WriteString(theEnv,STDERR,name->contents);
+   WriteString(theEnv,STDERR,"* cannot be redefined");
+   if (constant)
+     { WriteString(theEnv,STDERR," with a different value.\n"); }
+   else
+     { WriteString(theEnv,STDERR," as a defglobal.\n"); }
+
+   return false;
+  }
+
 /*********************************************************/
 /* AddDefglobal: Adds a defglobal to the current module. */
 /*********************************************************/
@@ -346,7 +448,8 @@ static void AddDefglobal(
   Environment *theEnv,
   CLIPSLexeme *name,
   UDFValue *vPtr,
-  struct expr *ePtr)
+  struct expr *ePtr,
+  bool constant)
   {
    Defglobal *defglobalPtr;
    bool newGlobal = false;
@@ -397,6 +500,19 @@ static void AddDefglobal(
      { defglobalPtr->current.value = CopyMultifield(theEnv,vPtr->multifieldValue); }
    Retain(theEnv,defglobalPtr->current.header);
 
+   /*=====================================================*/
+   /* A defconstant's initial expression is replaced with */
+   /* its value so that a reset can't assign it a value   */
+   /* which differs from the literals it was folded into. */
+   /*=====================================================*/
+
+   defglobalPtr->constant = constant;
+   if (constant && (vPtr->header->type != MULTIFIELD_TYPE))
+     {
+      ReturnExpression(theEnv,ePtr);
+      ePtr = GenConstant(theEnv,vPtr->header->type,vPtr->value);
+     }
+
    defglobalPtr->initial = AddHashedExpression(theEnv,ePtr);
    ReturnExpression(theEnv,ePtr);
    DefglobalData(theEnv)->ChangeToGlobals = true;
@@ -492,10 +608,14 @@ bool ReplaceGlobalVariable(
       return false;
      }
 
-   /*==============================================*/
-   /* Replace the symbolic reference of the global */
-   /* variable with a direct pointer reference.    */
-   /*==============================================*/
+   /*===================================================*/
+   /* A reference to a defconstant is replaced with its */
+   /* value. Any other reference to a global variable   */
+   /* is replaced with a direct pointer reference.      */
+   /*===================================================*/
+
+   if (FoldConstantReference(theGlobal,ePtr))
+     { return true; }
 
    ePtr->type = DEFGLOBAL_PTR;
    ePtr->value = theGlobal;
@@ -503,6 +623,70 @@ bool ReplaceGlobalVariable(
    return true;
   }
 
+/***************************************************************/
+/* FoldConstantGlobal: Replaces a GBL_VARIABLE expression that */
+/*   refers to a defconstant with the constant's value. Other  */
+/*   references are left unchanged. Returns true if the        */
+/*   expression was folded.                                    */
+/***************************************************************/
+bool FoldConstantGlobal(
+  Environment *theEnv,
+  struct expr *ePtr)
+  {
+   Defglobal *theGlobal;
+   unsigned int count;
+
+   if (ePtr->type != GBL_VARIABLE) return false;
+
+   theGlobal = (Defglobal *)
+               FindImportedConstruct(theEnv,"defglobal",NULL,ePtr->lexemeValue->contents,
+                                     &count,true,NULL);
+
+   if ((theGlobal == NULL) || (count > 1)) return false;
+
+   return FoldConstantReference(theGlobal,ePtr);
+  }
+
+/*************************************************************/
+/* FoldConstantReference: Replaces a reference to a global   */
+/*   variable with its value if the global is a defconstant  */
+/*   whose value can be represented as a literal.            */
+/*************************************************************/
+static bool FoldConstantReference(
+  Defglobal *theGlobal,
+  struct expr *ePtr)
+  {
+   Environment *theEnv = theGlobal->header.env;
+
+   if (! theGlobal->constant) return false;
+
+   switch (theGlobal->current.header->type)
+     {
+      case SYMBOL_TYPE:
+      case STRING_TYPE:
+      case INSTANCE_NAME_TYPE:
+      case INTEGER_TYPE:
+      case FLOAT_TYPE:
+        ePtr->type = theGlobal->current.header->type;
+        ePtr->value = theGlobal->current.value;
+
+        /*=====================================================*/
+        /* The literal keeps a reference to the defconstant as */
+        /* its argument. Installing the expression in a        */
+        /* construct then marks the defconstant as busy, so it */
+        /* can't be undefined and redefined with a value that  */
+        /* differs from the one the construct uses. Deleting   */
+        /* the construct deinstalls the reference.             */
+        /*=====================================================*/
+
+        ePtr->argList = GenConstant(theEnv,DEFGLOBAL_PTR,theGlobal);
+        return true;
+
+      default:
+        return false;
+     }
+  }
+
 #endif /* (! RUN_TIME) && (! BLOAD_ONLY) */
 
 /*****************************************************************/
@@ -519,6 +703,20 @@ void GlobalReferenceErrorMessage(
    WriteString(theEnv,STDERR,"* was referenced, but is not defined.\n");
   }
 
+/****************************************************************/
+/* ConstantGlobalErrorMessage: Prints an error message when an  */
+/*   attempt is made to change the value of a defconstant.      */
+/****************************************************************/
+void ConstantGlobalErrorMessage(
+  Environment *theEnv,
+  const char *variableName)
+  {
+   PrintErrorID(theEnv,"GLOBLPSR",2,true);
+   WriteString(theEnv,STDERR,"The value of constant ?*");
+   WriteString(theEnv,STDERR,variableName);
+   WriteString(theEnv,STDERR,"* cannot be changed.\n");
+  }
+
 #endif /* DEFGLOBAL_CONSTRUCT */
 
 
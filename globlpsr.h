@@ -50,8 +50,11 @@
 #include "expressn.h"
 
    bool                    ParseDefglobal(Environment *,const char *);
+   bool                    ParseDefconstant(Environment *,const char *);
    bool                    ReplaceGlobalVariable(Environment *,struct expr *);
+   bool                    FoldConstantGlobal(Environment *,struct expr *);
    void                    GlobalReferenceErrorMessage(Environment *,const char *);
+   void                    ConstantGlobalErrorMessage(Environment *,const char *);
 
 #endif /* _H_globlpsr */
 
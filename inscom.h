@@ -57,6 +57,8 @@
 /*                                                           */
 /*            UDF redesign.                                  */
 /*                                                           */
+/*            Added instance change count.                   */
+/*                                                           */
 /*************************************************************/
 
 #ifndef _H_inscom
@@ -113,6 +115,7 @@ struct instanceData
    bool MaintainGarbageInstances;
    bool MkInsMsgPass;
    bool ChangesToInstances;
+   unsigned long InstanceChangeCount;
    IGARBAGE *InstanceGarbageList;
    struct patternEntityRecord InstanceInfo;
    Instance *InstanceList;
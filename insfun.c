@@ -73,6 +73,9 @@
 /*                                                           */
 /*            UDF redesign.                                  */
 /*                                                           */
+/*            Slot value changes increment the instance      */
+/*            change count.                                  */
+/*                                                           */
 /*************************************************************/
 
 /* =========================================
@@ -760,6 +763,7 @@ PutSlotError DirectPutSlotValue(
      }
 #endif
    InstanceData(theEnv)->ChangesToInstances = true;
+   InstanceData(theEnv)->InstanceChangeCount++;
 
 #if DEFRULE_CONSTRUCT
    if (ins->cls->reactive && sp->desc->reactive)
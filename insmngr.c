@@ -56,6 +56,9 @@
 /*                                                           */
 /*            UDF redesign.                                  */
 /*                                                           */
+/*            Creating and deleting instances increments     */
+/*            the instance change count.                     */
+/*                                                           */
 /*************************************************************/
 
 /* =========================================
@@ -441,6 +444,7 @@ Instance *BuildInstance(
    InstanceData(theEnv)->CurrentInstance->prvList = InstanceData(theEnv)->InstanceListBottom;
    InstanceData(theEnv)->InstanceListBottom = InstanceData(theEnv)->CurrentInstance;
    InstanceData(theEnv)->ChangesToInstances = true;
+   InstanceData(theEnv)->InstanceChangeCount++;
 
    /* ==============================================================================
       Install the instance's name and slot-value symbols (prevent them from becoming
@@ -633,6 +637,7 @@ UnmakeInstanceError QuashInstance(
      }
      
    InstanceData(theEnv)->ChangesToInstances = true;
+   InstanceData(theEnv)->InstanceChangeCount++;
 
    if (EvaluationData(theEnv)->EvaluationError)
      {
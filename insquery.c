@@ -60,6 +60,9 @@
 /*                                                           */
 /*            Eval support for run time and bload only.      */
 /*                                                           */
+/*            Queries testing a slot for equality use a slot */
+/*            index rather than scanning every instance.     */
+/*                                                           */
 /*************************************************************/
 
 /* =========================================
@@ -67,6 +70,9 @@
                EXTERNAL DEFINITIONS
    =========================================
    ***************************************** */
+#include <limits.h>
+#include <string.h>
+
 #include "setup.h"
 
 #if INSTANCE_SET_QUERIES
@@ -81,12 +87,33 @@
 #include "insqypsr.h"
 #include "memalloc.h"
 #include "prcdrfun.h"
+#include "prdctfun.h"
 #include "prntutil.h"
 #include "router.h"
 #include "utility.h"
 
 #include "insquery.h"
 
+#define INITIAL_QUERY_INDEX_SIZE 16
+
+#define QueryIndexBucket(value,size) \
+   ((((size_t) (value) >> 3) ^ ((size_t) (value) >> 11)) & ((size) - 1))
+
+/***************************************************************/
+/* queryInstanceScan: The position of a query restriction in   */
+/*   the direct instances of a class. When the query tests a   */
+/*   slot of the restriction for equality with a value that    */
+/*   doesn't depend on the restriction, only the instances in  */
+/*   the slot index with that value are visited.               */
+/***************************************************************/
+typedef struct queryInstanceScan
+  {
+   struct instanceQueryIndexEntry *entry;
+   unsigned long changeCount;
+   Expression *key;
+   void *keyValue;
+  } QUERY_INSTANCE_SCAN;
+
 /***************************************/
 /* LOCAL INTERNAL FUNCTION DEFINITIONS */
 /***************************************/
@@ -103,6 +130,21 @@
    static void                    TestEntireClass(Environment *,Defmodule *,int,Defclass *,QUERY_CLASS *,unsigned);
    static void                    AddSolution(Environment *);
    static void                    PopQuerySoln(Environment *);
+   static void                    DeallocateInstanceQueryData(Environment *);
+   static Instance               *GetFirstQueryInstance(Environment *,Defclass *,unsigned,QUERY_INSTANCE_SCAN *);
+   static Instance               *GetNextQueryInstance(Environment *,Instance *,QUERY_INSTANCE_SCAN *);
+   static void                    EndQueryInstanceScan(Environment *,QUERY_INSTANCE_SCAN *);
+   static bool                    QueryKeyChanged(Environment *,QUERY_INSTANCE_SCAN *);
+   static Expression             *FindIndexedQueryTest(Environment *,Defclass *,unsigned,CLIPSLexeme **);
+   static bool                    IsSlotReference(Expression *,unsigned);
+   static bool                    IsStableQueryKey(Expression *,unsigned);
+   static struct instanceQueryIndex
+                                 *FindQueryIndex(Environment *,Defclass *,CLIPSLexeme *);
+   static struct instanceQueryIndexKey
+                                 *FindQueryIndexKey(struct instanceQueryIndex *,void *);
+   static void                    AddQueryIndexEntry(Environment *,struct instanceQueryIndex *,Instance *,void *);
+   static void                    ResizeQueryIndex(Environment *,struct instanceQueryIndex *,size_t);
+   static void                    DeleteQueryIndexes(Environment *);
 
 /****************************************************
   NAME         : SetupQuery
@@ -116,7 +158,7 @@
 void SetupQuery(
   Environment *theEnv)
   {
-   AllocateEnvironmentData(theEnv,INSTANCE_QUERY_DATA,sizeof(struct instanceQueryData),NULL);
+   AllocateEnvironmentData(theEnv,INSTANCE_QUERY_DATA,sizeof(struct instanceQueryData),DeallocateInstanceQueryData);
 
 #if ! RUN_TIME
    InstanceQueryData(theEnv)->QUERY_DELIMITER_SYMBOL = CreateSymbol(theEnv,QUERY_DELIMITER_STRING);
@@ -147,6 +189,21 @@ void SetupQuery(
    AddFunctionParser(theEnv,"delayed-do-for-all-instances",ParseQueryAction);
   }
 
+/******************************************************
+  NAME         : DeallocateInstanceQueryData
+  DESCRIPTION  : Deallocates environment data for
+                   instance-set queries
+  INPUTS       : None
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Slot indexes deallocated
+  NOTES        : None
+ ******************************************************/
+static void DeallocateInstanceQueryData(
+  Environment *theEnv)
+  {
+   DeleteQueryIndexes(theEnv);
+  }
+
 /*************************************************************
   NAME         : GetQueryInstance
   DESCRIPTION  : Internal function for referring to instance
@@ -1005,6 +1062,7 @@ static bool TestForFirstInstanceInClass(
    UDFValue temp;
    GCBlock gcb;
    unsigned j;
+   QUERY_INSTANCE_SCAN scan;
 
    if (TestTraversalID(cls->traversalRecord,id))
      return false;
@@ -1014,7 +1072,7 @@ static bool TestForFirstInstanceInClass(
 
    GCBlockStart(theEnv,&gcb);
 
-   ins = cls->instanceList;
+   ins = GetFirstQueryInstance(theEnv,cls,indx,&scan);
    while (ins != NULL)
      {
       InstanceQueryData(theEnv)->QueryCore->solns[indx] = ins;
@@ -1053,13 +1111,12 @@ static bool TestForFirstInstanceInClass(
       CleanCurrentGarbageFrame(theEnv,NULL);
       CallPeriodicTasks(theEnv);
 
-      ins = ins->nxtClass;
-      while ((ins != NULL) ? (ins->garbage == 1) : false)
-        ins = ins->nxtClass;
+      ins = GetNextQueryInstance(theEnv,ins,&scan);
      }
      
    endTest:
 
+   EndQueryInstanceScan(theEnv,&scan);
    GCBlockEnd(theEnv,&gcb);
    CallPeriodicTasks(theEnv);
 
@@ -1139,6 +1196,7 @@ static void TestEntireClass(
    UDFValue temp;
    GCBlock gcb;
    unsigned j;
+   QUERY_INSTANCE_SCAN scan;
    
    if (TestTraversalID(cls->traversalRecord,id))
      return;
@@ -1148,7 +1206,7 @@ static void TestEntireClass(
 
    GCBlockStart(theEnv,&gcb);
 
-   ins = cls->instanceList;
+   ins = GetFirstQueryInstance(theEnv,cls,indx,&scan);
    while (ins != NULL)
      {
       InstanceQueryData(theEnv)->QueryCore->solns[indx] = ins;
@@ -1199,9 +1257,7 @@ static void TestEntireClass(
            }
         }
 
-      ins = ins->nxtClass;
-      while ((ins != NULL) ? (ins->garbage == 1) : false)
-        ins = ins->nxtClass;
+      ins = GetNextQueryInstance(theEnv,ins,&scan);
 
       CleanCurrentGarbageFrame(theEnv,NULL);
       CallPeriodicTasks(theEnv);
@@ -1209,6 +1265,7 @@ static void TestEntireClass(
      
    endTest:
    
+   EndQueryInstanceScan(theEnv,&scan);
    GCBlockEnd(theEnv,&gcb);
    CallPeriodicTasks(theEnv);
 
@@ -1270,6 +1327,546 @@ static void PopQuerySoln(
    rm(theEnv,InstanceQueryData(theEnv)->QueryCore->soln_bottom,sizeof(QUERY_SOLN));
   }
 
+/*****************************************************************
+  NAME         : GetFirstQueryInstance
+  DESCRIPTION  : Determines the first direct instance of a class
+                   to be examined for a query restriction
+  INPUTS       : 1) The class
+                 2) The index of the restriction
+                 3) Caller's buffer for the scan position
+  RETURNS      : The first instance, or NULL if there are none
+  SIDE EFFECTS : The slot index is built if necessary
+  NOTES        : If the query (or the first of a series of eq
+                   tests joined by an and) tests a single-field
+                   slot of the restriction for equality with a
+                   constant, a variable, or a slot of another
+                   restriction, only the instances in the slot
+                   index with that value are examined once the
+                   index has been built. Since the
+                   test fails for all of the other instances, the
+                   query results are the same as for a full scan.
+ *****************************************************************/
+static Instance *GetFirstQueryInstance(
+  Environment *theEnv,
+  Defclass *cls,
+  unsigned indx,
+  QUERY_INSTANCE_SCAN *scan)
+  {
+   Expression *theKey;
+   CLIPSLexeme *slotName;
+   UDFValue keyValue;
+   struct instanceQueryIndex *theIndex;
+   struct instanceQueryIndexKey *theIndexKey;
+
+   scan->entry = NULL;
+   scan->keyValue = NULL;
+
+   if (cls->instanceList == NULL)
+     { return NULL; }
+
+   theKey = FindIndexedQueryTest(theEnv,cls,indx,&slotName);
+   if (theKey == NULL)
+     { return cls->instanceList; }
+
+   /*===================================================*/
+   /* An error evaluating the key would also occur when */
+   /* the query is evaluated for the first instance.    */
+   /*===================================================*/
+
+   if (EvaluateExpression(theEnv,theKey,&keyValue))
+     { return NULL; }
+
+   if (keyValue.header->type == MULTIFIELD_TYPE)
+     { return cls->instanceList; }
+
+   theIndex = FindQueryIndex(theEnv,cls,slotName);
+   if (theIndex == NULL)
+     { return cls->instanceList; }
+
+   theIndexKey = FindQueryIndexKey(theIndex,keyValue.value);
+   if (theIndexKey == NULL)
+     { return NULL; }
+
+   scan->entry = theIndexKey->first;
+   scan->changeCount = InstanceData(theEnv)->InstanceChangeCount;
+   scan->key = theKey;
+   scan->keyValue = keyValue.value;
+   Retain(theEnv,keyValue.header);
+
+   return scan->entry->theInstance;
+  }
+
+/*****************************************************************
+  NAME         : GetNextQueryInstance
+  DESCRIPTION  : Determines the next direct instance of a class
+                   to be examined for a query restriction
+  INPUTS       : 1) The current instance
+                 2) The scan position
+  RETURNS      : The next instance, or NULL if there are no more
+  SIDE EFFECTS : None
+  NOTES        : If any instances or the value of the key have
+                   changed since the scan began, the remaining
+                   instances of the class are examined in order
+                   from the current instance
+ *****************************************************************/
+static Instance *GetNextQueryInstance(
+  Environment *theEnv,
+  Instance *ins,
+  QUERY_INSTANCE_SCAN *scan)
+  {
+   if (scan->entry != NULL)
+     {
+      if ((InstanceData(theEnv)->InstanceChangeCount == scan->changeCount) &&
+          (QueryKeyChanged(theEnv,scan) == false))
+        {
+         scan->entry = scan->entry->next;
+         if (scan->entry == NULL)
+           { return NULL; }
+
+         return scan->entry->theInstance;
+        }
+
+      scan->entry = NULL;
+     }
+
+   ins = ins->nxtClass;
+   while ((ins != NULL) ? (ins->garbage == 1) : false)
+     { ins = ins->nxtClass; }
+
+   return ins;
+  }
+
+/***************************************************
+  NAME         : EndQueryInstanceScan
+  DESCRIPTION  : Releases the key value of a scan
+  INPUTS       : The scan position
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Key value busy count decremented
+  NOTES        : None
+ ***************************************************/
+static void EndQueryInstanceScan(
+  Environment *theEnv,
+  QUERY_INSTANCE_SCAN *scan)
+  {
+   if (scan->keyValue != NULL)
+     { Release(theEnv,(TypeHeader *) scan->keyValue); }
+  }
+
+/*****************************************************************
+  NAME         : QueryKeyChanged
+  DESCRIPTION  : Determines if the key of an indexed scan has a
+                   different value than when the scan began
+  INPUTS       : The scan position
+  RETURNS      : True if the key may have changed, false otherwise
+  SIDE EFFECTS : The key is reevaluated
+  NOTES        : The action of a query can rebind a variable. A
+                   key referencing an instance-set member can only
+                   change if an instance changes, which ends the
+                   indexed scan anyway.
+ *****************************************************************/
+static bool QueryKeyChanged(
+  Environment *theEnv,
+  QUERY_INSTANCE_SCAN *scan)
+  {
+   UDFValue keyValue;
+
+   if (ConstantType(scan->key->type))
+     { return false; }
+
+   if ((scan->key->type == FCALL) &&
+       ((int (*)(void)) ExpressionFunctionPointer(scan->key) != (int (*)(void)) GetLoopCount))
+     { return false; }
+
+   if (EvaluateExpression(theEnv,scan->key,&keyValue))
+     { return true; }
+
+   return (keyValue.value != scan->keyValue);
+  }
+
+/*****************************************************************
+  NAME         : FindIndexedQueryTest
+  DESCRIPTION  : Determines if the query tests a single-field
+                   slot of a restriction for equality with a key
+                   that doesn't depend on the restriction
+  INPUTS       : 1) The class of the restriction
+                 2) The index of the restriction
+                 3) Caller's buffer for the slot name
+  RETURNS      : The key expression, or NULL if the instances of
+                   the class must all be examined
+  SIDE EFFECTS : None
+  NOTES        : The test must be the query itself or one of the
+                   leading eq tests of an and. The eq tests which
+                   precede it may only reference constants,
+                   variables, and instance-set members so that
+                   skipping their evaluation has no side effects.
+ *****************************************************************/
+static Expression *FindIndexedQueryTest(
+  Environment *theEnv,
+  Defclass *cls,
+  unsigned indx,
+  CLIPSLexeme **slotName)
+  {
+   Expression *theTest, *theSlot, *theKey;
+   int whichSlot;
+   bool conjunction = false;
+
+   theTest = InstanceQueryData(theEnv)->QueryCore->query;
+   if ((theTest->type == FCALL) &&
+       ((int (*)(void)) ExpressionFunctionPointer(theTest) == (int (*)(void)) AndFunction))
+     {
+      theTest = theTest->argList;
+      conjunction = true;
+     }
+
+   while (theTest != NULL)
+     {
+      if ((theTest->type != FCALL) ||
+          ((int (*)(void)) ExpressionFunctionPointer(theTest) != (int (*)(void)) EqFunction) ||
+          (CountArguments(theTest->argList) != 2))
+        { return NULL; }
+
+      theSlot = theTest->argList;
+      theKey = theSlot->nextArg;
+      if (! (IsSlotReference(theSlot,indx) && IsStableQueryKey(theKey,indx)))
+        {
+         theKey = theTest->argList;
+         theSlot = theKey->nextArg;
+         if (! (IsSlotReference(theSlot,indx) && IsStableQueryKey(theKey,indx)))
+           { theSlot = NULL; }
+        }
+
+      if (theSlot != NULL)
+        {
+         *slotName = theSlot->argList->nextArg->nextArg->lexemeValue;
+         whichSlot = FindInstanceTemplateSlot(theEnv,cls,*slotName);
+         if ((whichSlot == -1) || cls->instanceTemplate[whichSlot]->multiple)
+           { return NULL; }
+
+         return theKey;
+        }
+
+      if ((! conjunction) ||
+          (! IsStableQueryKey(theTest->argList,UINT_MAX)) ||
+          (! IsStableQueryKey(theTest->argList->nextArg,UINT_MAX)))
+        { return NULL; }
+
+      theTest = theTest->nextArg;
+     }
+
+   return NULL;
+  }
+
+/***************************************************************
+  NAME         : IsSlotReference
+  DESCRIPTION  : Determines if an expression is a direct slot
+                   reference to a restriction of the current
+                   query, e.g. ?ins:name
+  INPUTS       : 1) The expression
+                 2) The index of the restriction
+  RETURNS      : True if so, false otherwise
+  SIDE EFFECTS : None
+  NOTES        : None
+ ***************************************************************/
+static bool IsSlotReference(
+  Expression *theExp,
+  unsigned indx)
+  {
+   if ((theExp->type != FCALL) ||
+       ((int (*)(void)) ExpressionFunctionPointer(theExp) != (int (*)(void)) GetQueryInstanceSlot))
+     { return false; }
+
+   if ((theExp->argList->type != INTEGER_TYPE) ||
+       (theExp->argList->integerValue->contents != 0) ||
+       (theExp->argList->nextArg->type != INTEGER_TYPE) ||
+       (theExp->argList->nextArg->integerValue->contents != indx) ||
+       (theExp->argList->nextArg->nextArg->type != SYMBOL_TYPE))
+     { return false; }
+
+   return true;
+  }
+
+/***************************************************************
+  NAME         : IsStableQueryKey
+  DESCRIPTION  : Determines if an expression can be evaluated
+                   once for all of the instances of a restriction
+  INPUTS       : 1) The expression
+                 2) The index of the restriction
+  RETURNS      : True if the expression is a constant, a
+                   variable, a loop counter, or a reference to
+                   an instance-set member (or one of its slots)
+                   bound before the restriction, false otherwise
+  SIDE EFFECTS : None
+  NOTES        : None of these expressions have side effects
+ ***************************************************************/
+static bool IsStableQueryKey(
+  Expression *theExp,
+  unsigned indx)
+  {
+   int (*fptr)(void);
+
+   if (ConstantType(theExp->type))
+     { return true; }
+
+   switch (theExp->type)
+     {
+      case GBL_VARIABLE:
+      case DEFGLOBAL_PTR:
+      case PROC_PARAM:
+      case PROC_GET_BIND:
+        return true;
+
+      case FCALL:
+        fptr = (int (*)(void)) ExpressionFunctionPointer(theExp);
+        if (fptr == (int (*)(void)) GetLoopCount)
+          { return (theExp->argList->type == INTEGER_TYPE); }
+
+        if ((fptr != (int (*)(void)) GetQueryInstanceSlot) &&
+            (fptr != (int (*)(void)) GetQueryInstance))
+          { return false; }
+
+        if ((theExp->argList->type != INTEGER_TYPE) ||
+            (theExp->argList->nextArg->type != INTEGER_TYPE))
+          { return false; }
+
+        if (theExp->argList->integerValue->contents != 0)
+          { return true; }
+
+        return (theExp->argList->nextArg->integerValue->contents < (long long) indx);
+     }
+
+   return false;
+  }
+
+/***************************************************************
+  NAME         : FindQueryIndex
+  DESCRIPTION  : Finds the index of a class slot, building it
+                   from the direct instances of the class the
+                   second time it is requested
+  INPUTS       : 1) The class
+                 2) The slot name
+  RETURNS      : The slot index, or NULL if it isn't built yet
+  SIDE EFFECTS : Index allocated if necessary. All of the slot
+                   indexes are deleted if any instances have
+                   changed since they were requested.
+  NOTES        : The first request only records the slot so
+                   that a program which changes an instance
+                   before each query doesn't pay for an index
+                   that is discarded before it can be reused.
+ ***************************************************************/
+static struct instanceQueryIndex *FindQueryIndex(
+  Environment *theEnv,
+  Defclass *cls,
+  CLIPSLexeme *slotName)
+  {
+   struct instanceQueryIndex *theIndex;
+   Instance *ins;
+   int whichSlot;
+
+   if (InstanceQueryData(theEnv)->QueryIndexChangeCount != InstanceData(theEnv)->InstanceChangeCount)
+     {
+      DeleteQueryIndexes(theEnv);
+      InstanceQueryData(theEnv)->QueryIndexChangeCount = InstanceData(theEnv)->InstanceChangeCount;
+     }
+
+   for (theIndex = InstanceQueryData(theEnv)->QueryIndexes;
+        theIndex != NULL;
+        theIndex = theIndex->next)
+     {
+      if ((theIndex->cls == cls) && (theIndex->slotName == slotName))
+        { break; }
+     }
+
+   if (theIndex == NULL)
+     {
+      theIndex = get_struct(theEnv,instanceQueryIndex);
+      theIndex->cls = cls;
+      theIndex->slotName = slotName;
+      theIndex->keyCount = 0;
+      theIndex->tableSize = 0;
+      theIndex->table = NULL;
+      theIndex->next = InstanceQueryData(theEnv)->QueryIndexes;
+      InstanceQueryData(theEnv)->QueryIndexes = theIndex;
+      return NULL;
+     }
+
+   if (theIndex->table != NULL)
+     { return theIndex; }
+
+   theIndex->tableSize = INITIAL_QUERY_INDEX_SIZE;
+   theIndex->table = (struct instanceQueryIndexKey **)
+                     gm2(theEnv,sizeof(struct instanceQueryIndexKey *) * theIndex->tableSize);
+   memset(theIndex->table,0,sizeof(struct instanceQueryIndexKey *) * theIndex->tableSize);
+
+   whichSlot = FindInstanceTemplateSlot(theEnv,cls,slotName);
+   for (ins = cls->instanceList ; ins != NULL ; ins = ins->nxtClass)
+     { AddQueryIndexEntry(theEnv,theIndex,ins,ins->slotAddresses[whichSlot]->value); }
+
+   return theIndex;
+  }
+
+/***************************************************
+  NAME         : FindQueryIndexKey
+  DESCRIPTION  : Finds the instances in a slot index
+                   with the specified slot value
+  INPUTS       : 1) The slot index
+                 2) The slot value
+  RETURNS      : The index key, or NULL if no
+                   instances have the value
+  SIDE EFFECTS : None
+  NOTES        : None
+ ***************************************************/
+static struct instanceQueryIndexKey *FindQueryIndexKey(
+  struct instanceQueryIndex *theIndex,
+  void *theValue)
+  {
+   struct instanceQueryIndexKey *theKey;
+
+   for (theKey = theIndex->table[QueryIndexBucket(theValue,theIndex->tableSize)];
+        theKey != NULL;
+        theKey = theKey->next)
+     {
+      if (theKey->value == theValue)
+        { return theKey; }
+     }
+
+   return NULL;
+  }
+
+/***************************************************
+  NAME         : AddQueryIndexEntry
+  DESCRIPTION  : Adds an instance to a slot index
+  INPUTS       : 1) The slot index
+                 2) The instance
+                 3) The slot value of the instance
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Index entry (and key) allocated
+  NOTES        : Instances are added in class
+                   instance list order
+ ***************************************************/
+static void AddQueryIndexEntry(
+  Environment *theEnv,
+  struct instanceQueryIndex *theIndex,
+  Instance *ins,
+  void *theValue)
+  {
+   struct instanceQueryIndexKey *theKey;
+   struct instanceQueryIndexEntry *theEntry;
+   size_t bucket;
+
+   theKey = FindQueryIndexKey(theIndex,theValue);
+   if (theKey == NULL)
+     {
+      if (theIndex->keyCount >= theIndex->tableSize)
+        { ResizeQueryIndex(theEnv,theIndex,theIndex->tableSize * 2); }
+
+      theKey = get_struct(theEnv,instanceQueryIndexKey);
+      theKey->value = theValue;
+      theKey->first = NULL;
+      theKey->last = NULL;
+      bucket = QueryIndexBucket(theValue,theIndex->tableSize);
+      theKey->next = theIndex->table[bucket];
+      theIndex->table[bucket] = theKey;
+      theIndex->keyCount++;
+     }
+
+   theEntry = get_struct(theEnv,instanceQueryIndexEntry);
+   theEntry->theInstance = ins;
+   theEntry->next = NULL;
+
+   if (theKey->last == NULL)
+     { theKey->first = theEntry; }
+   else
+     { theKey->last->next = theEntry; }
+   theKey->last = theEntry;
+  }
+
+/***************************************************
+  NAME         : ResizeQueryIndex
+  DESCRIPTION  : Changes the number of buckets of a
+                   slot index
+  INPUTS       : 1) The slot index
+                 2) The new number of buckets (a
+                    power of two)
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Keys rehashed
+  NOTES        : None
+ ***************************************************/
+static void ResizeQueryIndex(
+  Environment *theEnv,
+  struct instanceQueryIndex *theIndex,
+  size_t newSize)
+  {
+   struct instanceQueryIndexKey **newTable, *theKey;
+   size_t i, bucket;
+
+   newTable = (struct instanceQueryIndexKey **)
+              gm2(theEnv,sizeof(struct instanceQueryIndexKey *) * newSize);
+   memset(newTable,0,sizeof(struct instanceQueryIndexKey *) * newSize);
+
+   for (i = 0 ; i < theIndex->tableSize ; i++)
+     {
+      while (theIndex->table[i] != NULL)
+        {
+         theKey = theIndex->table[i];
+         theIndex->table[i] = theKey->next;
+         bucket = QueryIndexBucket(theKey->value,newSize);
+         theKey->next = newTable[bucket];
+         newTable[bucket] = theKey;
+        }
+     }
+
+   rm(theEnv,theIndex->table,sizeof(struct instanceQueryIndexKey *) * theIndex->tableSize);
+   theIndex->table = newTable;
+   theIndex->tableSize = newSize;
+  }
+
+/***************************************************
+  NAME         : DeleteQueryIndexes
+  DESCRIPTION  : Deletes all of the slot indexes
+  INPUTS       : None
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Indexes deallocated
+  NOTES        : The instances and slot values in
+                   the indexes are not referenced
+ ***************************************************/
+static void DeleteQueryIndexes(
+  Environment *theEnv)
+  {
+   struct instanceQueryIndex *theIndex;
+   struct instanceQueryIndexKey *theKey;
+   struct instanceQueryIndexEntry *theEntry;
+   size_t i;
+
+   while (InstanceQueryData(theEnv)->QueryIndexes != NULL)
+     {
+      theIndex = InstanceQueryData(theEnv)->QueryIndexes;
+      InstanceQueryData(theEnv)->QueryIndexes = theIndex->next;
+
+      for (i = 0 ; i < theIndex->tableSize ; i++)
+        {
+         while (theIndex->table[i] != NULL)
+           {
+            theKey = theIndex->table[i];
+            theIndex->table[i] = theKey->next;
+
+            while (theKey->first != NULL)
+              {
+               theEntry = theKey->first;
+               theKey->first = theEntry->next;
+               rtn_struct(theEnv,instanceQueryIndexEntry,theEntry);
+              }
+
+            rtn_struct(theEnv,instanceQueryIndexKey,theKey);
+           }
+        }
+
+      if (theIndex->table != NULL)
+        { rm(theEnv,theIndex->table,sizeof(struct instanceQueryIndexKey *) * theIndex->tableSize); }
+      rtn_struct(theEnv,instanceQueryIndex,theIndex);
+     }
+  }
+
 #endif
 
 
+
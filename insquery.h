@@ -41,6 +41,8 @@
 /*                                                           */
 /*            UDF redesign.                                  */
 /*                                                           */
+/*            Added slot indexes for instance-set queries.   */
+/*                                                           */
 /*************************************************************/
 
 #ifndef _H_insquery
@@ -81,6 +83,38 @@ typedef struct query_stack
    struct query_stack *nxt;
   } QUERY_STACK;
 
+/****************************************************************/
+/* instanceQueryIndex: Index of the direct instances of a class */
+/*   by the value of a single-field slot. Built the second time */
+/*   a query tests the slot for equality and discarded as soon  */
+/*   as any instance is created, deleted, or has a slot value   */
+/*   changed. The instances sharing a value are kept in class   */
+/*   instance list order.                                       */
+/****************************************************************/
+struct instanceQueryIndexEntry
+  {
+   Instance *theInstance;
+   struct instanceQueryIndexEntry *next;
+  };
+
+struct instanceQueryIndexKey
+  {
+   void *value;
+   struct instanceQueryIndexEntry *first;
+   struct instanceQueryIndexEntry *last;
+   struct instanceQueryIndexKey *next;
+  };
+
+struct instanceQueryIndex
+  {
+   Defclass *cls;
+   CLIPSLexeme *slotName;
+   size_t keyCount;
+   size_t tableSize;
+   struct instanceQueryIndexKey **table;
+   struct instanceQueryIndex *next;
+  };
+
 #define INSTANCE_QUERY_DATA 31
 
 struct instanceQueryData
@@ -89,6 +123,8 @@ struct instanceQueryData
    QUERY_CORE *QueryCore;
    QUERY_STACK *QueryCoreStack;
    bool AbortQuery;
+   struct instanceQueryIndex *QueryIndexes;
+   unsigned long QueryIndexChangeCount;
   };
 
 #define InstanceQueryData(theEnv) ((struct instanceQueryData *) GetEnvironmentData(theEnv,INSTANCE_QUERY_DATA))
@@ -0,0 +1,606 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  08/25/16            */
+   /*                                                     */
+   /*               JOIN RANGE INDEX MODULE               */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Maintains sorted indices over alpha memories so  */
+/*   that joins with range comparisons such as               */
+/*   ?x&:(>= ?y ?x) against variables bound in prior         */
+/*   patterns only examine the alpha memory entries which    */
+/*   fall within the range.                                  */
+/*                                                           */
+/*   The range terms of a join are generated along with its  */
+/*   network test. The first term's right hand side value is */
+/*   the primary key: the entries of an alpha memory bucket  */
+/*   are sorted by it and a binary search selects those      */
+/*   within the bounds given by the left hand side. A term   */
+/*   on a different value (such as the end of an interval    */
+/*   whose start is the primary key) is kept in a max tree   */
+/*   over the sorted entries so whole subtrees which can't   */
+/*   satisfy it are skipped. The candidates are returned in  */
+/*   alpha memory order and the join still evaluates its     */
+/*   full network test against each of them.                 */
+/*                                                           */
+/*   An index is discarded whenever its bucket changes and   */
+/*   is only rebuilt after the bucket has been scanned       */
+/*   RANGE_INDEX_SCANS times without changing, so memories   */
+/*   which change as often as they're probed don't pay for   */
+/*   the sort.                                               */
+/*                                                           */
+/*************************************************************/
+
+#include "setup.h"
+
+#if DEFRULE_CONSTRUCT
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine.h"
+#include "envrnmnt.h"
+#include "evaluatn.h"
+#include "memalloc.h"
+#include "reteutil.h"
+
+#if OBJECT_SYSTEM
+#include "objrtfnx.h"
+#endif
+
+#include "joinrng.h"
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static struct joinRangeIndex  *FindRangeIndex(Environment *,struct alphaMemoryHash *,Expression *);
+   static void                    BuildRangeIndex(Environment *,struct joinRangeIndex *,
+                                                  struct alphaMemoryHash *,Expression *);
+   static void                    ReturnRangeIndexData(Environment *,struct joinRangeIndex *);
+   static bool                    RangeValue(Environment *,Expression *,double *);
+   static bool                    IsLowerBound(Expression *);
+   static Expression             *SecondaryRangeTerm(Expression *);
+   static void                    CollectSecondaryMatches(struct joinRangeIndex *,unsigned long,
+                                                          unsigned long,unsigned long,
+                                                          unsigned long,unsigned long,
+                                                          double,unsigned long *);
+   static int                     CompareRangeKeys(const void *,const void *);
+   static int                     ComparePositions(const void *,const void *);
+
+/**********************************************************/
+/* GetRangeCandidates: Retrieves the entries of the alpha */
+/*   memory on the right side of a join which can satisfy */
+/*   the join's range terms for a partial match entering  */
+/*   from the left. Returns false if the range index      */
+/*   can't be used, in which case the caller should scan  */
+/*   the alpha memory.                                    */
+/**********************************************************/
+bool GetRangeCandidates(
+  Environment *theEnv,
+  struct joinNode *join,
+  PartialMatch *lhsBinds,
+  struct rangeCandidates *candidates)
+  {
+   struct alphaMemoryHash *theMemory;
+   struct joinRangeIndex *theIndex;
+   Expression *theTerm, *secondaryTerm;
+   PartialMatch *oldRHSBinds;
+   double lower = -INFINITY, upper = INFINITY, bound, secondaryBound = -INFINITY;
+   unsigned long low, high, middle, i, count = 0;
+   bool rv = true;
+
+   candidates->matches = NULL;
+   candidates->count = 0;
+   candidates->current = 0;
+
+   if ((join->rangeTest == NULL) || join->joinFromTheRight ||
+       join->patternIsNegated || join->patternIsExists)
+     { return false; }
+
+   /*=================================================*/
+   /* Instance slot values are read from the instance */
+   /* itself, so the keys stored in an index could be */
+   /* stale while object pattern matching is queued.  */
+   /*=================================================*/
+
+#if OBJECT_SYSTEM
+   if (ObjectReteData(theEnv)->ObjectMatchActionQueue != NULL)
+     { return false; }
+#endif
+
+   theMemory = GetAlphaMemoryHash(theEnv,(struct patternNodeHeader *) join->rightSideEntryStructure,
+                                  lhsBinds->hashValue);
+   if (theMemory == NULL)
+     { return false; }
+
+   theIndex = FindRangeIndex(theEnv,theMemory,join->rangeTest);
+
+   if (! theIndex->valid)
+     {
+      if (theIndex->scans < RANGE_INDEX_SCANS)
+        {
+         theIndex->scans++;
+         return false;
+        }
+
+      BuildRangeIndex(theEnv,theIndex,theMemory,join->rangeTest);
+     }
+
+   if (theIndex->entryCount < RANGE_INDEX_MINIMUM)
+     { return false; }
+
+   /*==========================================*/
+   /* Evaluate the bounds from the left side.  */
+   /* Strict comparisons are treated as non    */
+   /* strict since the network test will check */
+   /* them exactly.                            */
+   /*==========================================*/
+
+   oldRHSBinds = EngineData(theEnv)->GlobalRHSBinds;
+   EngineData(theEnv)->GlobalRHSBinds = NULL;
+
+   secondaryTerm = SecondaryRangeTerm(join->rangeTest);
+
+   for (theTerm = join->rangeTest;
+        theTerm != NULL;
+        theTerm = theTerm->nextArg)
+     {
+      if ((theTerm != secondaryTerm) &&
+          (IdenticalExpression(theTerm->argList,join->rangeTest->argList) == false))
+        { continue; }
+
+      if (! RangeValue(theEnv,theTerm->argList->nextArg,&bound))
+        {
+         rv = false;
+         break;
+        }
+
+      if (theTerm == secondaryTerm)
+        { secondaryBound = IsLowerBound(theTerm) ? bound : -bound; }
+      else if (IsLowerBound(theTerm))
+        { if (bound > lower) lower = bound; }
+      else
+        { if (bound < upper) upper = bound; }
+     }
+
+   EngineData(theEnv)->GlobalRHSBinds = oldRHSBinds;
+
+   if (! rv)
+     { return false; }
+
+   /*=========================================*/
+   /* Find the sorted entries whose primary   */
+   /* keys lie in the range [lower, upper].   */
+   /*=========================================*/
+
+   low = 0;
+   high = theIndex->keyCount;
+   while (low < high)
+     {
+      middle = low + (high - low) / 2;
+      if (theIndex->keys[middle].value < lower) low = middle + 1;
+      else high = middle;
+     }
+
+   i = low;
+   high = theIndex->keyCount;
+   while (i < high)
+     {
+      middle = i + (high - i) / 2;
+      if (theIndex->keys[middle].value <= upper) i = middle + 1;
+      else high = middle;
+     }
+   high = i;
+
+   /*==================================================*/
+   /* Collect the positions of the candidates. Entries */
+   /* whose keys aren't numbers are always candidates. */
+   /*==================================================*/
+
+   if (theIndex->tree != NULL)
+     {
+      CollectSecondaryMatches(theIndex,1,0,theIndex->treeSize,low,high,
+                              secondaryBound,&count);
+     }
+   else
+     {
+      for (i = low; i < high; i++)
+        { theIndex->others[theIndex->otherCount + count++] = theIndex->keys[i].position; }
+     }
+
+   for (i = 0; i < theIndex->otherCount; i++)
+     { theIndex->others[theIndex->otherCount + count++] = theIndex->others[i]; }
+
+   if (count == 0)
+     { return true; }
+
+   qsort(&theIndex->others[theIndex->otherCount],count,sizeof(unsigned long),ComparePositions);
+
+   candidates->matches = (PartialMatch **) genalloc(theEnv,sizeof(PartialMatch *) * count);
+   for (i = 0; i < count; i++)
+     { candidates->matches[i] = theIndex->entries[theIndex->others[theIndex->otherCount + i]]; }
+   candidates->count = count;
+
+   return true;
+  }
+
+/*****************************************************/
+/* ReturnRangeCandidates: Releases the storage used  */
+/*   by a set of candidates from GetRangeCandidates. */
+/*****************************************************/
+void ReturnRangeCandidates(
+  Environment *theEnv,
+  struct rangeCandidates *candidates)
+  {
+   if (candidates->matches != NULL)
+     { genfree(theEnv,candidates->matches,sizeof(PartialMatch *) * candidates->count); }
+
+   candidates->matches = NULL;
+   candidates->count = 0;
+   candidates->current = 0;
+  }
+
+/*******************************************************/
+/* InvalidateRangeIndices: Discards the sorted entries */
+/*   of the range indices of an alpha memory bucket    */
+/*   after an entry has been added or removed.         */
+/*******************************************************/
+void InvalidateRangeIndices(
+  Environment *theEnv,
+  struct alphaMemoryHash *theMemory)
+  {
+   struct joinRangeIndex *theIndex;
+
+   for (theIndex = theMemory->rangeIndices;
+        theIndex != NULL;
+        theIndex = theIndex->next)
+     {
+      ReturnRangeIndexData(theEnv,theIndex);
+      theIndex->valid = false;
+      theIndex->scans = 0;
+     }
+  }
+
+/*******************************************************/
+/* ReturnRangeIndices: Returns all of the range        */
+/*   indices of an alpha memory bucket to the memory   */
+/*   manager.                                          */
+/*******************************************************/
+void ReturnRangeIndices(
+  Environment *theEnv,
+  struct alphaMemoryHash *theMemory)
+  {
+   struct joinRangeIndex *theIndex, *nextIndex;
+
+   for (theIndex = theMemory->rangeIndices;
+        theIndex != NULL;
+        theIndex = nextIndex)
+     {
+      nextIndex = theIndex->next;
+      ReturnRangeIndexData(theEnv,theIndex);
+      rtn_struct(theEnv,joinRangeIndex,theIndex);
+     }
+
+   theMemory->rangeIndices = NULL;
+  }
+
+/*********************************************************/
+/* FlushRangeIndices: Returns the range indices of every */
+/*   bucket of a pattern node's alpha memory. Called     */
+/*   when a join with range terms is removed since the   */
+/*   indices are identified by the join's range terms.   */
+/*********************************************************/
+void FlushRangeIndices(
+  Environment *theEnv,
+  struct patternNodeHeader *theHeader)
+  {
+   struct alphaMemoryHash *theMemory;
+
+   for (theMemory = theHeader->firstHash;
+        theMemory != NULL;
+        theMemory = theMemory->nextHash)
+     { ReturnRangeIndices(theEnv,theMemory); }
+
+   theHeader->rangeIndexed = false;
+  }
+
+/**************************************************/
+/* FindRangeIndex: Finds the range index for a    */
+/*   set of range terms in an alpha memory bucket */
+/*   creating an empty one if necessary.          */
+/**************************************************/
+static struct joinRangeIndex *FindRangeIndex(
+  Environment *theEnv,
+  struct alphaMemoryHash *theMemory,
+  Expression *rangeTest)
+  {
+   struct joinRangeIndex *theIndex;
+
+   for (theIndex = theMemory->rangeIndices;
+        theIndex != NULL;
+        theIndex = theIndex->next)
+     {
+      if (theIndex->rangeTest == rangeTest)
+        { return theIndex; }
+     }
+
+   theIndex = get_struct(theEnv,joinRangeIndex);
+   theIndex->rangeTest = rangeTest;
+   theIndex->valid = false;
+   theIndex->scans = 0;
+   theIndex->entryCount = 0;
+   theIndex->entries = NULL;
+   theIndex->keyCount = 0;
+   theIndex->keys = NULL;
+   theIndex->otherCount = 0;
+   theIndex->others = NULL;
+   theIndex->treeSize = 0;
+   theIndex->tree = NULL;
+   theIndex->next = theMemory->rangeIndices;
+   theMemory->rangeIndices = theIndex;
+   theMemory->owner->rangeIndexed = true;
+
+   return theIndex;
+  }
+
+/****************************************************/
+/* BuildRangeIndex: Sorts the entries of an alpha   */
+/*   memory bucket by the primary key of a set of   */
+/*   range terms and builds the max tree for the    */
+/*   secondary term (if there is one).              */
+/****************************************************/
+static void BuildRangeIndex(
+  Environment *theEnv,
+  struct joinRangeIndex *theIndex,
+  struct alphaMemoryHash *theMemory,
+  Expression *rangeTest)
+  {
+   PartialMatch *theMatch, *oldRHSBinds;
+   Expression *secondaryTerm;
+   unsigned long count = 0, i;
+   double value;
+
+   for (theMatch = theMemory->alphaMemory;
+        theMatch != NULL;
+        theMatch = theMatch->nextInMemory)
+     { count++; }
+
+   theIndex->valid = true;
+   theIndex->entryCount = count;
+
+   if (count < RANGE_INDEX_MINIMUM)
+     { return; }
+
+   /*==================================================*/
+   /* The others array also serves as scratch space    */
+   /* for the candidate positions of a lookup, so it's */
+   /* sized for the non-numeric entries plus all of    */
+   /* the entries.                                     */
+   /*==================================================*/
+
+   theIndex->entries = (PartialMatch **) genalloc(theEnv,sizeof(PartialMatch *) * count);
+   theIndex->keys = (struct rangeKey *) genalloc(theEnv,sizeof(struct rangeKey) * count);
+   theIndex->others = (unsigned long *) genalloc(theEnv,sizeof(unsigned long) * count * 2);
+
+   oldRHSBinds = EngineData(theEnv)->GlobalRHSBinds;
+
+   for (theMatch = theMemory->alphaMemory, i = 0;
+        theMatch != NULL;
+        theMatch = theMatch->nextInMemory, i++)
+     {
+      theIndex->entries[i] = theMatch;
+      EngineData(theEnv)->GlobalRHSBinds = theMatch;
+
+      if (RangeValue(theEnv,rangeTest->argList,&value))
+        {
+         theIndex->keys[theIndex->keyCount].value = value;
+         theIndex->keys[theIndex->keyCount].position = i;
+         theIndex->keyCount++;
+        }
+      else
+        { theIndex->others[theIndex->otherCount++] = i; }
+     }
+
+   qsort(theIndex->keys,theIndex->keyCount,sizeof(struct rangeKey),CompareRangeKeys);
+
+   /*=================================================*/
+   /* Build the max tree for the secondary term. The  */
+   /* values are negated for upper bounds so that the */
+   /* tree is always searched for values at or above  */
+   /* the bound. Non-numeric values can't be pruned.  */
+   /*=================================================*/
+
+   secondaryTerm = SecondaryRangeTerm(rangeTest);
+   if ((secondaryTerm != NULL) && (theIndex->keyCount > 0))
+     {
+      theIndex->treeSize = 1;
+      while (theIndex->treeSize < theIndex->keyCount)
+        { theIndex->treeSize *= 2; }
+
+      theIndex->tree = (double *) genalloc(theEnv,sizeof(double) * theIndex->treeSize * 2);
+
+      for (i = 0; i < theIndex->treeSize; i++)
+        {
+         if (i >= theIndex->keyCount)
+           { value = -INFINITY; }
+         else
+           {
+            EngineData(theEnv)->GlobalRHSBinds = theIndex->entries[theIndex->keys[i].position];
+            if (! RangeValue(theEnv,secondaryTerm->argList,&value))
+              { value = INFINITY; }
+            else if (! IsLowerBound(secondaryTerm))
+              { value = -value; }
+           }
+
+         theIndex->tree[theIndex->treeSize + i] = value;
+        }
+
+      for (i = theIndex->treeSize - 1; i > 0; i--)
+        {
+         theIndex->tree[i] = (theIndex->tree[2*i] > theIndex->tree[2*i+1]) ?
+                             theIndex->tree[2*i] : theIndex->tree[2*i+1];
+        }
+     }
+
+   EngineData(theEnv)->GlobalRHSBinds = oldRHSBinds;
+  }
+
+/****************************************************/
+/* ReturnRangeIndexData: Returns the sorted entries */
+/*   of a range index to the memory manager.        */
+/****************************************************/
+static void ReturnRangeIndexData(
+  Environment *theEnv,
+  struct joinRangeIndex *theIndex)
+  {
+   if (theIndex->entries != NULL)
+     {
+      genfree(theEnv,theIndex->entries,sizeof(PartialMatch *) * theIndex->entryCount);
+      genfree(theEnv,theIndex->keys,sizeof(struct rangeKey) * theIndex->entryCount);
+      genfree(theEnv,theIndex->others,sizeof(unsigned long) * theIndex->entryCount * 2);
+     }
+
+   if (theIndex->tree != NULL)
+     { genfree(theEnv,theIndex->tree,sizeof(double) * theIndex->treeSize * 2); }
+
+   theIndex->entryCount = 0;
+   theIndex->entries = NULL;
+   theIndex->keyCount = 0;
+   theIndex->keys = NULL;
+   theIndex->otherCount = 0;
+   theIndex->others = NULL;
+   theIndex->treeSize = 0;
+   theIndex->tree = NULL;
+  }
+
+/*************************************************/
+/* RangeValue: Evaluates one side of a range     */
+/*   term. Returns false if the value isn't a    */
+/*   number that can be ordered.                 */
+/*************************************************/
+static bool RangeValue(
+  Environment *theEnv,
+  Expression *theExpression,
+  double *theValue)
+  {
+   UDFValue result;
+
+   EvaluateExpression(theEnv,theExpression,&result);
+
+   if (EvaluationData(theEnv)->EvaluationError)
+     {
+      SetEvaluationError(theEnv,false);
+      return false;
+     }
+
+   if (result.header->type == INTEGER_TYPE)
+     { *theValue = (double) result.integerValue->contents; }
+   else if (result.header->type == FLOAT_TYPE)
+     { *theValue = result.floatValue->contents; }
+   else
+     { return false; }
+
+   return ! isnan(*theValue);
+  }
+
+/****************************************************/
+/* IsLowerBound: Returns true if the left hand side */
+/*   of a range term is a lower bound for the key.  */
+/****************************************************/
+static bool IsLowerBound(
+  Expression *theTerm)
+  {
+   return (theTerm->functionValue->callFunctionName->contents[0] == '>');
+  }
+
+/***************************************************/
+/* SecondaryRangeTerm: Returns the first range     */
+/*   term whose key differs from the primary key.  */
+/***************************************************/
+static Expression *SecondaryRangeTerm(
+  Expression *rangeTest)
+  {
+   Expression *theTerm;
+
+   for (theTerm = rangeTest->nextArg;
+        theTerm != NULL;
+        theTerm = theTerm->nextArg)
+     {
+      if (IdenticalExpression(theTerm->argList,rangeTest->argList) == false)
+        { return theTerm; }
+     }
+
+   return NULL;
+  }
+
+/**************************************************/
+/* CollectSecondaryMatches: Adds the positions of */
+/*   the sorted entries in [low, high) whose      */
+/*   secondary value is at or above the bound.    */
+/**************************************************/
+static void CollectSecondaryMatches(
+  struct joinRangeIndex *theIndex,
+  unsigned long node,
+  unsigned long nodeLow,
+  unsigned long nodeHigh,
+  unsigned long low,
+  unsigned long high,
+  double bound,
+  unsigned long *count)
+  {
+   unsigned long middle;
+
+   if ((nodeHigh <= low) || (nodeLow >= high) || (theIndex->tree[node] < bound))
+     { return; }
+
+   if (node >= theIndex->treeSize)
+     {
+      theIndex->others[theIndex->otherCount + (*count)++] = theIndex->keys[nodeLow].position;
+      return;
+     }
+
+   middle = nodeLow + (nodeHigh - nodeLow) / 2;
+   CollectSecondaryMatches(theIndex,node*2,nodeLow,middle,low,high,bound,count);
+   CollectSecondaryMatches(theIndex,node*2+1,middle,nodeHigh,low,high,bound,count);
+  }
+
+/********************************************/
+/* CompareRangeKeys: qsort comparison for   */
+/*   sorting entries by key then position.  */
+/********************************************/
+static int CompareRangeKeys(
+  const void *p1,
+  const void *p2)
+  {
+   const struct rangeKey *k1 = (const struct rangeKey *) p1;
+   const struct rangeKey *k2 = (const struct rangeKey *) p2;
+
+   if (k1->value < k2->value) return -1;
+   if (k1->value > k2->value) return 1;
+   if (k1->position < k2->position) return -1;
+   if (k1->position > k2->position) return 1;
+   return 0;
+  }
+
+/*******************************************/
+/* ComparePositions: qsort comparison for  */
+/*   restoring alpha memory order.         */
+/*******************************************/
+static int ComparePositions(
+  const void *p1,
+  const void *p2)
+  {
+   unsigned long v1 = *((const unsigned long *) p1);
+   unsigned long v2 = *((const unsigned long *) p2);
+
+   if (v1 < v2) return -1;
+   if (v1 > v2) return 1;
+   return 0;
+  }
+
+#endif /* DEFRULE_CONSTRUCT */
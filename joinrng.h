@@ -0,0 +1,70 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  08/25/16            */
+   /*                                                     */
+   /*            JOIN RANGE INDEX HEADER FILE             */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Maintains sorted indices over alpha memories so  */
+/*   that joins with range comparisons such as               */
+/*   ?x&:(>= ?y ?x) against variables bound in prior         */
+/*   patterns only examine the alpha memory entries which    */
+/*   fall within the range.                                  */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_joinrng
+
+#pragma once
+
+#define _H_joinrng
+
+#include "expressn.h"
+#include "match.h"
+#include "network.h"
+
+#define RANGE_INDEX_MINIMUM 8
+#define RANGE_INDEX_SCANS   2
+
+struct rangeKey
+  {
+   double value;
+   unsigned long position;
+  };
+
+struct joinRangeIndex
+  {
+   Expression *rangeTest;
+   bool valid;
+   unsigned short scans;
+   unsigned long entryCount;
+   PartialMatch **entries;
+   unsigned long keyCount;
+   struct rangeKey *keys;
+   unsigned long otherCount;
+   unsigned long *others;
+   unsigned long treeSize;
+   double *tree;
+   struct joinRangeIndex *next;
+  };
+
+struct rangeCandidates
+  {
+   PartialMatch **matches;
+   unsigned long count;
+   unsigned long current;
+  };
+
+#define NextRangeCandidate(rc) \
+   (((rc)->current < (rc)->count) ? (rc)->matches[(rc)->current++] : NULL)
+
+   bool                           GetRangeCandidates(Environment *,struct joinNode *,PartialMatch *,
+                                                     struct rangeCandidates *);
+   void                           ReturnRangeCandidates(Environment *,struct rangeCandidates *);
+   void                           InvalidateRangeIndices(Environment *,struct alphaMemoryHash *);
+   void                           ReturnRangeIndices(Environment *,struct alphaMemoryHash *);
+   void                           FlushRangeIndices(Environment *,struct patternNodeHeader *);
+
+#endif /* _H_joinrng */
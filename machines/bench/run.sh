@@ -0,0 +1,101 @@
+#!/bin/bash
+# run.sh <path-to-syn> - spin up the ALU, register file, and memory devices
+# then hammer them with one or more load generators and report throughput and
+# latency percentiles.
+#
+# Tunables (environment variables):
+#   BENCH_OPS          requests issued by each load generator (default 1000)
+#   BENCH_CONCURRENCY  number of load generators run in parallel (default 1)
+#   BENCH_MIX          alu:gpr:mem weighting of the request mix (default 40:30:30)
+#   BENCH_WORDS        words per memory write, > 1 uses "write map:" (default 1)
+#   BENCH_SEED         seed for the first generator, incremented per generator (default 0)
+
+ROOT=${1:-.}
+OPS=${BENCH_OPS:-1000}
+CONCURRENCY=${BENCH_CONCURRENCY:-1}
+MIX=${BENCH_MIX:-40:30:30}
+WORDS=${BENCH_WORDS:-1}
+SEED=${BENCH_SEED:-0}
+DIR=/tmp/machines/bench
+DEVICES="alu gpr mem"
+
+IFS=: read ALU_WEIGHT GPR_WEIGHT MEM_WEIGHT <<< "$MIX"
+
+mkdir -p $DIR
+rm -f $DIR/*
+cd $ROOT
+
+echo "Starting devices!"
+./syn -f2 machines/bench/ALU_desc.clp > $DIR/alu.out 2>&1 &
+DEVICE_PIDS="$!"
+./syn -f2 machines/bench/RegisterFile_desc.clp > $DIR/gpr.out 2>&1 &
+DEVICE_PIDS="$DEVICE_PIDS $!"
+./syn -f2 machines/bench/MemoryBlock16_desc.clp > $DIR/mem.out 2>&1 &
+DEVICE_PIDS="$DEVICE_PIDS $!"
+
+for dev in $DEVICES; do
+	for attempt in $(seq 1 100); do
+		[ -S $DIR/$dev ] && break
+		sleep 0.1
+	done
+	if [ ! -S $DIR/$dev ]; then
+		echo "Device $dev never came up, see $DIR/$dev.out"
+		kill $DEVICE_PIDS 2> /dev/null
+		exit 1
+	fi
+done
+
+echo "Running $CONCURRENCY generator(s) x $OPS requests (mix alu:gpr:mem = $MIX, $WORDS word(s) per memory write)"
+CLIENT_PIDS=""
+for i in $(seq 1 $CONCURRENCY); do
+	cat > $DIR/client$i.clp <<CLIENT
+(bind ?*bench-operations* $OPS)
+(bind ?*bench-alu-weight* $ALU_WEIGHT)
+(bind ?*bench-gpr-weight* $GPR_WEIGHT)
+(bind ?*bench-memory-weight* $MEM_WEIGHT)
+(bind ?*bench-words* $WORDS)
+(bind ?*bench-seed* $((SEED + i)))
+(bench:run $DIR/client$i $DIR/client$i.log)
+(exit)
+CLIENT
+	./syn -f2 machines/bench/LoadGenerator.clp -f2 $DIR/client$i.clp > $DIR/client$i.out 2>&1 &
+	CLIENT_PIDS="$CLIENT_PIDS $!"
+done
+wait $CLIENT_PIDS
+
+echo "Shutting down devices!"
+for dev in $DEVICES; do
+	./syn -f2 /dev/stdin > /dev/null 2>&1 <<SHUTDOWN
+(write-command $DIR/$dev "shutdown callback $DIR/shutdown")
+(exit)
+SHUTDOWN
+done
+sleep 0.5
+kill $DEVICE_PIDS 2> /dev/null
+
+cat $DIR/client*.log | awk '
+$1 == "wall" {
+	if (begin == "" || $2 < begin) begin = $2;
+	if (end == "" || $3 > end) end = $3;
+	next;
+}
+{ print $1, $2; print "all", $2; }
+END { printf "wall %.6f\n", end - begin > "/dev/stderr"; }
+' 2> $DIR/wall.txt | sort -k1,1 -k2,2n > $DIR/latencies.txt
+
+WALL=$(awk '{ print $2 }' $DIR/wall.txt)
+if [ -z "$WALL" ] || [ ! -s $DIR/latencies.txt ]; then
+	echo "No results collected, see $DIR/client*.out"
+	exit 1
+fi
+
+printf "%-6s %10s %12s %10s %10s %10s %10s %10s\n" kind count "ops/sec" "mean(us)" "p50(us)" "p90(us)" "p99(us)" "max(us)"
+for kind in all alu gpr mem; do
+	grep "^$kind " $DIR/latencies.txt | awk -v kind=$kind -v wall=$WALL '
+	{ v[NR] = $2; sum += $2; }
+	function pct(p,  i) { i = int((p / 100.0) * NR + 0.5); if (i < 1) i = 1; if (i > NR) i = NR; return v[i]; }
+	END {
+		if (NR == 0) exit;
+		printf "%-6s %10d %12.1f %10.1f %10d %10d %10d %10d\n", kind, NR, NR / wall, sum / NR, pct(50), pct(90), pct(99), v[NR];
+	}'
+done
@@ -49,6 +49,9 @@
 /*                                                           */
 /*            ALLOW_ENVIRONMENT_GLOBALS no longer supported. */
 /*                                                           */
+/*            Added slab allocation for facts and partial    */
+/*            matches.                                       */
+/*                                                           */
 /*************************************************************/
 
 #include <stdio.h>
@@ -73,6 +76,18 @@
 #define SpecialMalloc(sz) malloc((STD_SIZE) sz)
 #define SpecialFree(ptr) free(ptr)
 
+#define SLAB_HEADER_SIZE \
+   (((sizeof(struct memorySlab) + STRICT_ALIGN_SIZE - 1) / STRICT_ALIGN_SIZE) * STRICT_ALIGN_SIZE)
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+#if (MEM_TABLE_SIZE > 0)
+   static size_t                  FindSlab(struct memorySlab **,size_t,void *);
+   static int                     CompareSlabs(const void *,const void *);
+#endif
+
 /********************************************/
 /* InitializeMemory: Sets up memory tables. */
 /********************************************/
@@ -86,8 +101,11 @@ void InitializeMemory(
 #if (MEM_TABLE_SIZE > 0)
    MemoryData(theEnv)->MemoryTable = (struct memoryPtr **)
                  malloc((STD_SIZE) (sizeof(struct memoryPtr *) * MEM_TABLE_SIZE));
+   MemoryData(theEnv)->SlabTable = (struct memoryPtr **)
+                 malloc((STD_SIZE) (sizeof(struct memoryPtr *) * MEM_TABLE_SIZE));
 
-   if (MemoryData(theEnv)->MemoryTable == NULL)
+   if ((MemoryData(theEnv)->MemoryTable == NULL) ||
+       (MemoryData(theEnv)->SlabTable == NULL))
      {
       PrintErrorID(theEnv,"MEMORY",1,true);
       WriteString(theEnv,STDERR,"Out of memory.\n");
@@ -97,10 +115,15 @@ void InitializeMemory(
      {
       int i;
 
-      for (i = 0; i < MEM_TABLE_SIZE; i++) MemoryData(theEnv)->MemoryTable[i] = NULL;
+      for (i = 0; i < MEM_TABLE_SIZE; i++)
+        {
+         MemoryData(theEnv)->MemoryTable[i] = NULL;
+         MemoryData(theEnv)->SlabTable[i] = NULL;
+        }
      }
 #else // MEM_TABLE_SIZE == 0
       MemoryData(theEnv)->MemoryTable = NULL;
+      MemoryData(theEnv)->SlabTable = NULL;
 #endif
   }
 
@@ -268,7 +291,11 @@ long long ReleaseMem(
    struct memoryPtr *tmpPtr, *memPtr;
    unsigned int i;
    long long returns = 0;
-   long long amount = 0;
+   long long amount;
+
+   amount = ReleaseSlabs(theEnv);
+   if ((amount > maximum) && (maximum > 0))
+     { return amount; }
 
    for (i = (MEM_TABLE_SIZE - 1) ; i >= sizeof(char *) ; i--)
      {
@@ -400,6 +427,210 @@ void rm(
 #endif
   }
 
+/***********************************************************/
+/* GetSlabMemory: Allocates a structure of the given size  */
+/*   for the get_slab_struct macros when the free list for */
+/*   that size is empty. A new slab is carved into chunks  */
+/*   of the size, which are placed on the free list in     */
+/*   address order, and the first chunk is returned.       */
+/***********************************************************/
+void *GetSlabMemory(
+  Environment *theEnv,
+  size_t size)
+  {
+#if (MEM_TABLE_SIZE > 0)
+   struct memorySlab *theSlab;
+   struct memoryPtr *memPtr;
+   size_t stride, count, i;
+   char *chunks;
+
+   if ((size < sizeof(char *)) || (size >= MEM_TABLE_SIZE))
+     { return genalloc(theEnv,size); }
+
+   if (MemoryData(theEnv)->SlabTable[size] == NULL)
+     {
+      stride = ((size + STRICT_ALIGN_SIZE - 1) / STRICT_ALIGN_SIZE) * STRICT_ALIGN_SIZE;
+      count = (MEM_SLAB_SIZE - SLAB_HEADER_SIZE) / stride;
+      if (count == 0) count = 1;
+
+      theSlab = (struct memorySlab *) genalloc(theEnv,SLAB_HEADER_SIZE + (stride * count));
+      theSlab->size = size;
+      theSlab->count = count;
+      theSlab->blockSize = SLAB_HEADER_SIZE + (stride * count);
+      theSlab->next = MemoryData(theEnv)->SlabList;
+      MemoryData(theEnv)->SlabList = theSlab;
+
+      chunks = ((char *) theSlab) + SLAB_HEADER_SIZE;
+      for (i = count ; i > 0 ; i--)
+        {
+         memPtr = (struct memoryPtr *) (chunks + (stride * (i - 1)));
+         memPtr->next = MemoryData(theEnv)->SlabTable[size];
+         MemoryData(theEnv)->SlabTable[size] = memPtr;
+        }
+     }
+
+   memPtr = MemoryData(theEnv)->SlabTable[size];
+   MemoryData(theEnv)->SlabTable[size] = memPtr->next;
+
+   return ((void *) memPtr);
+#else
+   return genalloc(theEnv,size);
+#endif
+  }
+
+/**************************************************************/
+/* ReleaseSlabs: Returns to the operating system the slabs    */
+/*   with no chunks in use. The free chunks are attributed to */
+/*   their slabs by searching the slabs sorted by address,    */
+/*   and the free lists are rebuilt without the chunks of the */
+/*   released slabs. Returns the number of bytes released.    */
+/**************************************************************/
+long long ReleaseSlabs(
+  Environment *theEnv)
+  {
+#if (MEM_TABLE_SIZE > 0)
+   struct memorySlab *theSlab, **slabs;
+   struct memoryPtr *memPtr, *nextPtr, *lastPtr;
+   size_t *available;
+   size_t slabCount = 0, i, position;
+   long long amount = 0;
+
+   for (theSlab = MemoryData(theEnv)->SlabList; theSlab != NULL; theSlab = theSlab->next)
+     { slabCount++; }
+
+   if (slabCount == 0) return 0;
+
+   /*=======================================================*/
+   /* The work space is taken directly from malloc since    */
+   /* this function is called when genalloc runs out of     */
+   /* memory. If none is available, nothing is released.    */
+   /*=======================================================*/
+
+   slabs = (struct memorySlab **) malloc(sizeof(struct memorySlab *) * slabCount);
+   available = (size_t *) malloc(sizeof(size_t) * slabCount);
+   if ((slabs == NULL) || (available == NULL))
+     {
+      free(slabs);
+      free(available);
+      return 0;
+     }
+
+   for (theSlab = MemoryData(theEnv)->SlabList, i = 0; theSlab != NULL; theSlab = theSlab->next, i++)
+     {
+      slabs[i] = theSlab;
+      available[i] = 0;
+     }
+
+   qsort(slabs,slabCount,sizeof(struct memorySlab *),CompareSlabs);
+
+   /*=========================================*/
+   /* Count the free chunks within each slab. */
+   /*=========================================*/
+
+   for (i = sizeof(char *) ; i < MEM_TABLE_SIZE ; i++)
+     {
+      for (memPtr = MemoryData(theEnv)->SlabTable[i]; memPtr != NULL; memPtr = memPtr->next)
+        { available[FindSlab(slabs,slabCount,memPtr)]++; }
+     }
+
+   /*===============================================*/
+   /* Remove the chunks of the unused slabs from    */
+   /* the free lists, preserving the order of the   */
+   /* remaining chunks.                             */
+   /*===============================================*/
+
+   for (i = sizeof(char *) ; i < MEM_TABLE_SIZE ; i++)
+     {
+      lastPtr = NULL;
+      for (memPtr = MemoryData(theEnv)->SlabTable[i]; memPtr != NULL; memPtr = nextPtr)
+        {
+         nextPtr = memPtr->next;
+         position = FindSlab(slabs,slabCount,memPtr);
+         if (available[position] != slabs[position]->count)
+           {
+            lastPtr = memPtr;
+            continue;
+           }
+
+         if (lastPtr == NULL) MemoryData(theEnv)->SlabTable[i] = nextPtr;
+         else lastPtr->next = nextPtr;
+        }
+     }
+
+   /*=====================================*/
+   /* Release the unused slabs and relink */
+   /* the remaining ones.                 */
+   /*=====================================*/
+
+   MemoryData(theEnv)->SlabList = NULL;
+   for (i = slabCount ; i > 0 ; i--)
+     {
+      theSlab = slabs[i - 1];
+      if (available[i - 1] == theSlab->count)
+        {
+         amount += (long long) theSlab->blockSize;
+         genfree(theEnv,theSlab,theSlab->blockSize);
+        }
+      else
+        {
+         theSlab->next = MemoryData(theEnv)->SlabList;
+         MemoryData(theEnv)->SlabList = theSlab;
+        }
+     }
+
+   free(slabs);
+   free(available);
+
+   return amount;
+#else
+   return 0;
+#endif
+  }
+
+#if (MEM_TABLE_SIZE > 0)
+
+/*************************************************/
+/* FindSlab: Returns the position of the slab    */
+/*   containing a chunk in an array of slabs     */
+/*   sorted by address.                          */
+/*************************************************/
+static size_t FindSlab(
+  struct memorySlab **slabs,
+  size_t slabCount,
+  void *theChunk)
+  {
+   size_t low = 0, high = slabCount - 1, middle;
+
+   while (low < high)
+     {
+      middle = low + ((high - low + 1) / 2);
+      if ((char *) slabs[middle] <= (char *) theChunk)
+        { low = middle; }
+      else
+        { high = middle - 1; }
+     }
+
+   return low;
+  }
+
+/***********************************************/
+/* CompareSlabs: qsort comparison for ordering */
+/*   slabs by address.                         */
+/***********************************************/
+static int CompareSlabs(
+  const void *first,
+  const void *second)
+  {
+   char *firstSlab = (char *) *((struct memorySlab * const *) first);
+   char *secondSlab = (char *) *((struct memorySlab * const *) second);
+
+   if (firstSlab < secondSlab) return -1;
+   if (firstSlab > secondSlab) return 1;
+   return 0;
+  }
+
+#endif
+
 /***************************************************/
 /* PoolSize: Returns number of bytes in free pool. */
 /***************************************************/
@@ -420,6 +651,13 @@ unsigned long PoolSize(
          cnt += (unsigned long) i;
          memPtr = memPtr->next;
         }
+
+      memPtr = MemoryData(theEnv)->SlabTable[i];
+      while (memPtr != NULL)
+        {
+         cnt += (unsigned long) i;
+         memPtr = memPtr->next;
+        }
      }
 #endif
 
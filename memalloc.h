@@ -52,6 +52,9 @@
 /*                                                           */
 /*            ALLOW_ENVIRONMENT_GLOBALS no longer supported. */
 /*                                                           */
+/*            Added slab allocation for facts and partial    */
+/*            matches.                                       */
+/*                                                           */
 /*************************************************************/
 
 #ifndef _H_memalloc
@@ -75,6 +78,27 @@ struct memoryPtr
    struct memoryPtr *next;
   };
 
+/**************************************************************/
+/* memorySlab: A block of memory which is carved into chunks  */
+/*   of a single size. Structures allocated with the slab     */
+/*   macros are kept on their own free lists so that they     */
+/*   are packed together rather than interleaved with other   */
+/*   allocations, and a size class can be given back to the   */
+/*   operating system all at once when none of it is in use.  */
+/**************************************************************/
+
+#ifndef MEM_SLAB_SIZE
+#define MEM_SLAB_SIZE 16384
+#endif
+
+struct memorySlab
+  {
+   struct memorySlab *next;
+   size_t size;
+   size_t count;
+   size_t blockSize;
+  };
+
 #if (MEM_TABLE_SIZE > 0)
 /*
  * Normal memory management case
@@ -113,6 +137,26 @@ struct memoryPtr
      MemoryData(theEnv)->MemoryTable[MemoryData(theEnv)->TempSize] =  MemoryData(theEnv)->TempMemoryPtr) : \
     (genfree(theEnv,struct_ptr,MemoryData(theEnv)->TempSize),(struct memoryPtr *) struct_ptr)))
 
+#define get_slab_var_struct(theEnv,type,vsize) \
+  ((((sizeof(struct type) + vsize) <  MEM_TABLE_SIZE) ? \
+    (MemoryData(theEnv)->SlabTable[sizeof(struct type) + vsize] == NULL) : 1) ? \
+   ((struct type *) GetSlabMemory(theEnv,(sizeof(struct type) + vsize))) :\
+   ((MemoryData(theEnv)->TempMemoryPtr = MemoryData(theEnv)->SlabTable[sizeof(struct type) + vsize]),\
+    MemoryData(theEnv)->SlabTable[sizeof(struct type) + vsize] = MemoryData(theEnv)->TempMemoryPtr->next,\
+    ((struct type *) MemoryData(theEnv)->TempMemoryPtr)))
+
+#define rtn_slab_var_struct(theEnv,type,vsize,struct_ptr) \
+  (MemoryData(theEnv)->TempSize = sizeof(struct type) + vsize, \
+   ((MemoryData(theEnv)->TempSize < MEM_TABLE_SIZE) ? \
+    (MemoryData(theEnv)->TempMemoryPtr = (struct memoryPtr *) struct_ptr,\
+     MemoryData(theEnv)->TempMemoryPtr->next = MemoryData(theEnv)->SlabTable[MemoryData(theEnv)->TempSize], \
+     MemoryData(theEnv)->SlabTable[MemoryData(theEnv)->TempSize] =  MemoryData(theEnv)->TempMemoryPtr) : \
+    (genfree(theEnv,struct_ptr,MemoryData(theEnv)->TempSize),(struct memoryPtr *) struct_ptr)))
+
+#define get_slab_struct(theEnv,type) get_slab_var_struct(theEnv,type,0)
+
+#define rtn_slab_struct(theEnv,type,struct_ptr) rtn_slab_var_struct(theEnv,type,0,struct_ptr)
+
 #define get_mem(theEnv,size) \
   (((size <  MEM_TABLE_SIZE) ? \
     (MemoryData(theEnv)->MemoryTable[size] == NULL) : 1) ? \
@@ -144,6 +188,10 @@ struct memoryPtr
 
 #define rtn_var_struct(theEnv,type,vsize,struct_ptr) (genfree(theEnv,struct_ptr,sizeof(struct type)+vsize))
 
+#define get_slab_var_struct(theEnv,type,vsize) ((struct type *) genalloc(theEnv,(sizeof(struct type) + vsize)))
+#define rtn_slab_var_struct(theEnv,type,vsize,struct_ptr) (genfree(theEnv,struct_ptr,sizeof(struct type)+vsize))
+#define get_slab_struct(theEnv,type) ((struct type *) genalloc(theEnv,sizeof(struct type)))
+#define rtn_slab_struct(theEnv,type,struct_ptr) (genfree(theEnv,struct_ptr,sizeof(struct type)))
 #define get_mem(theEnv,size) ((struct type *) genalloc(theEnv,(size_t) (size)))
 
 #define rtn_mem(theEnv,size,ptr) (genfree(theEnv,ptr,size))
@@ -163,6 +211,8 @@ struct memoryData
    OutOfMemoryFunction *OutOfMemoryCallback;
    struct memoryPtr *TempMemoryPtr;
    struct memoryPtr **MemoryTable;
+   struct memoryPtr **SlabTable;
+   struct memorySlab *SlabList;
    size_t TempSize;
   };
 
@@ -182,6 +232,8 @@ struct memoryData
    void                          *gm1(Environment *,size_t);
    void                          *gm2(Environment *,size_t);
    void                           rm(Environment *,void *,size_t);
+   void                          *GetSlabMemory(Environment *,size_t);
+   long long                      ReleaseSlabs(Environment *);
    unsigned long                  PoolSize(Environment *);
    unsigned long                  ActualPoolSize(Environment *);
    bool                           SetConserveMemory(Environment *,bool);
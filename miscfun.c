@@ -100,6 +100,10 @@
 /*            Added get-error, set-error, and clear-error    */
 /*            functions.                                     */
 /*                                                           */
+/*            Sequence expansion shares the unexpanded       */
+/*            argument expressions rather than copying the   */
+/*            entire argument list for each call.            */
+/*                                                           */
 /*************************************************************/
 
 #include <stdio.h>
@@ -131,6 +135,21 @@
 
 #define MISCFUN_DATA 9
 
+#define EXPAND_SHARED_MAX 32
+
+/*************************************************/
+/* expandedArguments: Records the argument nodes */
+/*   of an expanded function call which share    */
+/*   their argument list with the original call  */
+/*   so that the shared expressions are not      */
+/*   returned along with the expanded call.      */
+/*************************************************/
+struct expandedArguments
+  {
+   Expression *shared[EXPAND_SHARED_MAX];
+   unsigned short count;
+  };
+
 struct miscFunctionData
   {
    long long GensymNumber;
@@ -143,8 +162,10 @@ struct miscFunctionData
 /* LOCAL INTERNAL FUNCTION DEFINITIONS */
 /***************************************/
 
-   static void                    ExpandFuncMultifield(Environment *,UDFValue *,Expression *,
-                                                       Expression **,void *);
+   static Expression             *ExpandFuncMultifield(Environment *,UDFValue *,Expression *,
+                                                       void *,struct expandedArguments *);
+   static bool                    ContainsExpansion(Expression *,void *);
+   static void                    ReturnExpandedCall(Environment *,Expression *,struct expandedArguments *);
    static int                     FindLanguageType(Environment *,const char *);
    static void                    ConvertTime(Environment *,UDFValue *,struct tm *);
 
@@ -897,15 +918,17 @@ void OperatingSystemFunction(
   DESCRIPTION  : This function is a wrap-around for a normal
                    function call.  It preexamines the argument
                    expression list and expands any references to the
-                   sequence operator.  It builds a copy of the
-                   function call expression with these new arguments
+                   sequence operator.  It builds a new argument list
+                   for the function call with these expansions
                    inserted and evaluates the function call.
   INPUTS       : A data object buffer
   RETURNS      : Nothing useful
   SIDE EFFECTS : Expressions alloctaed/deallocated
                  Function called and arguments evaluated
                  EvaluationError set on errors
-  NOTES        : None
+  NOTES        : Arguments which do not contain a sequence
+                   expansion share their argument expressions
+                   with the original function call
  *******************************************************************/
 void ExpandFuncCall(
   Environment *theEnv,
@@ -914,16 +937,18 @@ void ExpandFuncCall(
   {
    Expression *newargexp,*fcallexp;
    struct functionDefinition *func;
+   struct expandedArguments shared;
 
    /* ======================================================================
-      Copy the original function call's argument expression list.
-      Look for expand$ function callsexpressions and replace those
-        with the equivalent expressions of the expansions of evaluations
-        of the arguments.
+      Build a new argument list from the original function call's argument
+        expression list. expand$ function calls are replaced with the
+        equivalent expressions of the expansions of evaluations of the
+        arguments. Arguments which don't contain an expand$ call are not
+        copied.
       ====================================================================== */
-   newargexp = CopyExpression(theEnv,GetFirstArgument()->argList);
-   ExpandFuncMultifield(theEnv,returnValue,newargexp,&newargexp,
-                        FindFunction(theEnv,"expand$"));
+   shared.count = 0;
+   newargexp = ExpandFuncMultifield(theEnv,returnValue,GetFirstArgument()->argList,
+                                    FindFunction(theEnv,"expand$"),&shared);
 
    /* ===================================================================
       Build the new function call expression with the expanded arguments.
@@ -940,7 +965,7 @@ void ExpandFuncCall(
       if (CheckFunctionArgCount(theEnv,func,CountArguments(newargexp)) == false)
         {
          returnValue->lexemeValue = FalseSymbol(theEnv);
-         ReturnExpression(theEnv,fcallexp);
+         ReturnExpandedCall(theEnv,fcallexp,&shared);
          return;
         }
      }
@@ -951,7 +976,7 @@ void ExpandFuncCall(
               CountArguments(fcallexp->argList)) == false)
         {
          returnValue->lexemeValue = FalseSymbol(theEnv);
-         ReturnExpression(theEnv,fcallexp);
+         ReturnExpandedCall(theEnv,fcallexp,&shared);
          SetEvaluationError(theEnv,true);
          return;
         }
@@ -959,7 +984,7 @@ void ExpandFuncCall(
 #endif
 
    EvaluateExpression(theEnv,fcallexp,returnValue);
-   ReturnExpression(theEnv,fcallexp);
+   ReturnExpandedCall(theEnv,fcallexp,&shared);
   }
 
 /***********************************************************************
@@ -988,52 +1013,60 @@ void DummyExpandFuncMultifield(
 
 /***********************************************************************
   NAME         : ExpandFuncMultifield
-  DESCRIPTION  : Recursively examines an expression and replaces
-                   PROC_EXPAND_MULTIFIELD expressions with the expanded
+  DESCRIPTION  : Recursively examines an expression and builds a
+                   new expression in which PROC_EXPAND_MULTIFIELD
+                   expressions are replaced with the expanded
                    evaluation expression of its argument
   INPUTS       : 1) A data object result buffer
-                 2) The expression to modify
-                 3) The address of the expression, in case it is
-                    deleted entirely
-                 4) The address of the H/L function expand$
-  RETURNS      : Nothing useful
-  SIDE EFFECTS : Expressions allocated/deallocated as necessary
+                 2) The expression to expand
+                 3) The address of the H/L function expand$
+                 4) The record of argument lists shared with the
+                    original expression
+  RETURNS      : The expanded expression
+  SIDE EFFECTS : Expressions allocated as necessary
                  Evaluations performed
-                 On errors, argument expression set to call a function
-                   which causes an evaluation error when evaluated
-                   a second time by actual caller.
-  NOTES        : THIS ROUTINE MODIFIES EXPRESSIONS AT RUNTIME!!  MAKE
-                 SURE THAT THE Expression PASSED IS SAFE TO CHANGE!!
+                 On errors, the expansion is replaced with a call
+                   to a function which causes an evaluation error
+                   when evaluated a second time by actual caller.
+  NOTES        : The original expression is not modified. Nodes
+                   whose argument list contains no expansions
+                   share that list with the original expression
+                   and are recorded so that ReturnExpandedCall
+                   does not deallocate it.
  **********************************************************************/
-static void ExpandFuncMultifield(
+static Expression *ExpandFuncMultifield(
   Environment *theEnv,
   UDFValue *returnValue,
   Expression *theExp,
-  Expression **sto,
-  void *expmult)
+  void *expmult,
+  struct expandedArguments *shared)
   {
-   Expression *newexp,*top,*bot;
+   Expression *newexp,*top = NULL,*bot = NULL;
    size_t i; /* 6.04 Bug Fix */
+   bool expanding = true;
 
-   while (theExp != NULL)
+   for (;
+        theExp != NULL;
+        theExp = theExp->nextArg)
      {
-      if (theExp->value == expmult)
+      if (expanding && (theExp->value == expmult))
         {
          EvaluateExpression(theEnv,theExp->argList,returnValue);
-         ReturnExpression(theEnv,theExp->argList);
          if ((EvaluationData(theEnv)->EvaluationError) ||
              (returnValue->header->type != MULTIFIELD_TYPE))
            {
-            theExp->argList = NULL;
             if ((EvaluationData(theEnv)->EvaluationError == false) &&
                 (returnValue->header->type != MULTIFIELD_TYPE))
               ExpectedTypeError2(theEnv,"expand$",1);
-            theExp->value = FindFunction(theEnv,"(set-evaluation-error)");
+            newexp = GenConstant(theEnv,theExp->type,FindFunction(theEnv,"(set-evaluation-error)"));
             EvaluationData(theEnv)->EvaluationError = false;
             EvaluationData(theEnv)->HaltExecution = false;
-            return;
+            expanding = false;
+            if (top == NULL) top = newexp;
+            else bot->nextArg = newexp;
+            bot = newexp;
+            continue;
            }
-         top = bot = NULL;
          for (i = returnValue->begin ; i < (returnValue->begin + returnValue->range) ; i++)
            {
             newexp = get_struct(theEnv,expr);
@@ -1041,35 +1074,73 @@ static void ExpandFuncMultifield(
             newexp->value = returnValue->multifieldValue->contents[i].value;
             newexp->argList = NULL;
             newexp->nextArg = NULL;
-            if (top == NULL)
-              top = newexp;
-            else
-              bot->nextArg = newexp;
+            if (top == NULL) top = newexp;
+            else bot->nextArg = newexp;
             bot = newexp;
            }
-         if (top == NULL)
-           {
-            *sto = theExp->nextArg;
-            rtn_struct(theEnv,expr,theExp);
-            theExp = *sto;
-           }
-         else
-           {
-            bot->nextArg = theExp->nextArg;
-            *sto = top;
-            rtn_struct(theEnv,expr,theExp);
-            sto = &bot->nextArg;
-            theExp = bot->nextArg;
-           }
+         continue;
         }
-      else
+
+      newexp = GenConstant(theEnv,theExp->type,theExp->value);
+      if (theExp->argList == NULL)
+        { /* Do Nothing */ }
+      else if (expanding && ContainsExpansion(theExp->argList,expmult))
+        { newexp->argList = ExpandFuncMultifield(theEnv,returnValue,theExp->argList,expmult,shared); }
+      else if (shared->count < EXPAND_SHARED_MAX)
         {
-         if (theExp->argList != NULL)
-           ExpandFuncMultifield(theEnv,returnValue,theExp->argList,&theExp->argList,expmult);
-         sto = &theExp->nextArg;
-         theExp = theExp->nextArg;
+         newexp->argList = theExp->argList;
+         shared->shared[shared->count++] = newexp;
         }
+      else
+        { newexp->argList = CopyExpression(theEnv,theExp->argList); }
+
+      if (top == NULL) top = newexp;
+      else bot->nextArg = newexp;
+      bot = newexp;
      }
+
+   return top;
+  }
+
+/***************************************************/
+/* ContainsExpansion: Determines if an expression  */
+/*   contains a call to the expand$ function.      */
+/***************************************************/
+static bool ContainsExpansion(
+  Expression *theExp,
+  void *expmult)
+  {
+   for (;
+        theExp != NULL;
+        theExp = theExp->nextArg)
+     {
+      if (theExp->value == expmult)
+        { return true; }
+
+      if ((theExp->argList != NULL) &&
+          ContainsExpansion(theExp->argList,expmult))
+        { return true; }
+     }
+
+   return false;
+  }
+
+/***********************************************************/
+/* ReturnExpandedCall: Returns the expression built for an */
+/*   expanded function call without returning the argument */
+/*   lists it shares with the original function call.      */
+/***********************************************************/
+static void ReturnExpandedCall(
+  Environment *theEnv,
+  Expression *fcallexp,
+  struct expandedArguments *shared)
+  {
+   unsigned short i;
+
+   for (i = 0 ; i < shared->count ; i++)
+     { shared->shared[i]->argList = NULL; }
+
+   ReturnExpression(theEnv,fcallexp);
   }
 
 /****************************************************************
@@ -230,6 +230,23 @@ static void DeallocateMessageHandlerData(
   {
    HANDLER_LINK *tmp, *mhead, *chead;
 
+   /*====================================================*/
+   /* Chains which are executing are on the core stack   */
+   /* below and are only detached from the cache here.   */
+   /*====================================================*/
+
+   FlushHandlerChainCache(theEnv);
+   if (MessageHandlerData(theEnv)->ChainCache != NULL)
+     {
+      rm(theEnv,MessageHandlerData(theEnv)->ChainCache,
+         sizeof(HANDLER_CHAIN_CACHE *) * SIZE_HANDLER_CHAIN_HASH);
+     }
+   if (MessageHandlerData(theEnv)->SlotAccessCache != NULL)
+     {
+      rm(theEnv,MessageHandlerData(theEnv)->SlotAccessCache,
+         sizeof(SLOT_ACCESS_CACHE) * SIZE_SLOT_ACCESS_CACHE);
+     }
+
    mhead = MessageHandlerData(theEnv)->TopOfCore;
    while (mhead != NULL)
      {
@@ -84,6 +84,9 @@ struct messageHandlerData
    HANDLER_LINK *TopOfCore;
    HANDLER_LINK *NextInCore;
    HANDLER_LINK *OldCore;
+   HANDLER_CHAIN_CACHE **ChainCache;
+   SLOT_ACCESS_CACHE *SlotAccessCache;
+   unsigned long SlotAccessEpoch;
   };
 
 #define MessageHandlerData(theEnv) ((struct messageHandlerData *) GetEnvironmentData(theEnv,MESSAGE_HANDLER_DATA))
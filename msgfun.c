@@ -55,6 +55,7 @@
 
 #if OBJECT_SYSTEM
 
+#include "bytecode.h"
 #include "classcom.h"
 #include "classfun.h"
 #include "envrnmnt.h"
@@ -274,6 +275,7 @@ void NewSystemHandler(
    hnd->minParams = hnd->maxParams = extraargs + 1;
    hnd->localVarCount = 0;
    hnd->actions = get_struct(theEnv,expr);
+   hnd->bytecode = NULL;
    hnd->actions->argList = NULL;
    hnd->actions->type = FCALL;
    hnd->actions->value = FindFunction(theEnv,fname);
@@ -305,6 +307,7 @@ DefmessageHandler *InsertHandlerHeader(
    long i;
    long j,ni = -1;
 
+   FlushHandlerChainCache(theEnv);
    hnd = cls->handlers;
    arr = cls->handlerOrderMap;
    nhnd = (DefmessageHandler *) gm2(theEnv,(sizeof(DefmessageHandler) * (cls->handlerCount+1)));
@@ -341,6 +344,7 @@ DefmessageHandler *InsertHandlerHeader(
    nhnd[cls->handlerCount].maxParams = 0;
    nhnd[cls->handlerCount].localVarCount = 0;
    nhnd[cls->handlerCount].actions = NULL;
+   nhnd[cls->handlerCount].bytecode = NULL;
    nhnd[cls->handlerCount].header.ppForm = NULL;
    nhnd[cls->handlerCount].header.usrData = NULL;
    nhnd[cls->handlerCount].header.constructType = DEFMESSAGE_HANDLER;
@@ -516,6 +520,7 @@ void DeallocateMarkedHandlers(
          count++;
          ReleaseLexeme(theEnv,hnd->header.name);
          ExpressionDeinstall(theEnv,hnd->actions);
+         ReturnProcBytecode(theEnv,hnd->bytecode);
          ReturnPackedExpression(theEnv,hnd->actions);
          ClearUserDataList(theEnv,hnd->header.usrData);
          if (hnd->header.ppForm != NULL)
@@ -531,6 +536,7 @@ void DeallocateMarkedHandlers(
      }
    if (count == 0)
      return;
+   FlushHandlerChainCache(theEnv);
    if (count == cls->handlerCount)
      {
       rm(theEnv,cls->handlers,(sizeof(DefmessageHandler) * cls->handlerCount));
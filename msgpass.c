@@ -58,6 +58,9 @@
 /*            Added GCBlockStart and GCBlockEnd functions    */
 /*            for garbage collection blocks.                 */
 /*                                                           */
+/*            Cached dynamic-get and dynamic-put slot        */
+/*            lookups per call site.                         */
+/*                                                           */
 /*************************************************************/
 
 /* =========================================
@@ -71,6 +74,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "argacces.h"
 #include "classcom.h"
@@ -101,6 +105,10 @@
 
    static bool                    PerformMessage(Environment *,UDFValue *,Expression *,CLIPSLexeme *);
    static HANDLER_LINK           *FindApplicableHandlers(Environment *,Defclass *,CLIPSLexeme *);
+   static HANDLER_LINK           *AcquireHandlerChain(Environment *,Defclass *,CLIPSLexeme *,HANDLER_CHAIN_CACHE **);
+   static void                    ReleaseHandlerChain(Environment *,HANDLER_CHAIN_CACHE *);
+   static void                    ReturnCachedHandlerChain(Environment *,HANDLER_CHAIN_CACHE *);
+   static InstanceSlot           *FindCachedInstanceSlot(Environment *,Expression *,Instance *,CLIPSLexeme *);
    static void                    CallHandlers(Environment *,UDFValue *);
    static void                    EarlySlotBindError(Environment *,Instance *,Defclass *,unsigned);
 
@@ -420,10 +428,11 @@ void CallNextHandler(
                          ProfileFunctionData(theEnv)->ProfileConstructs);
 #endif
 
-            EvaluateProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
-                               MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
-                               MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
-                               returnValue,UnboundHandlerErr);
+            EvaluateCompiledProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
+                                        MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
+                                        &MessageHandlerData(theEnv)->CurrentCore->hnd->bytecode,
+                                        MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
+                                        returnValue,UnboundHandlerErr);
 #if PROFILING_FUNCTIONS
             EndProfile(theEnv,&profileFrame);
 #endif
@@ -452,10 +461,11 @@ void CallNextHandler(
                      ProfileFunctionData(theEnv)->ProfileConstructs);
 #endif
 
-        EvaluateProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
-                            returnValue,UnboundHandlerErr);
+        EvaluateCompiledProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
+                                    MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
+                                    &MessageHandlerData(theEnv)->CurrentCore->hnd->bytecode,
+                                    MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
+                                    returnValue,UnboundHandlerErr);
 #if PROFILING_FUNCTIONS
          EndProfile(theEnv,&profileFrame);
 #endif
@@ -876,7 +886,10 @@ void DynamicHandlerGetSlot(
    returnValue->value = FalseSymbol(theEnv);
    if (CheckCurrentMessage(theEnv,"dynamic-get",true) == false)
      return;
-   EvaluateExpression(theEnv,GetFirstArgument(),&temp);
+   if (GetFirstArgument()->type == SYMBOL_TYPE)
+     { temp.value = GetFirstArgument()->value; }
+   else
+     { EvaluateExpression(theEnv,GetFirstArgument(),&temp); }
    if (temp.header->type != SYMBOL_TYPE)
      {
       ExpectedTypeError1(theEnv,"dynamic-get",1,"symbol");
@@ -884,7 +897,7 @@ void DynamicHandlerGetSlot(
       return;
      }
    ins = GetActiveInstance(theEnv);
-   sp = FindInstanceSlot(theEnv,ins,temp.lexemeValue);
+   sp = FindCachedInstanceSlot(theEnv,GetFirstArgument(),ins,temp.lexemeValue);
    if (sp == NULL)
      {
       SlotExistError(theEnv,temp.lexemeValue->contents,"dynamic-get");
@@ -927,7 +940,10 @@ void DynamicHandlerPutSlot(
    returnValue->value = FalseSymbol(theEnv);
    if (CheckCurrentMessage(theEnv,"dynamic-put",true) == false)
      return;
-   EvaluateExpression(theEnv,GetFirstArgument(),&temp);
+   if (GetFirstArgument()->type == SYMBOL_TYPE)
+     { temp.value = GetFirstArgument()->value; }
+   else
+     { EvaluateExpression(theEnv,GetFirstArgument(),&temp); }
    if (temp.header->type != SYMBOL_TYPE)
      {
       ExpectedTypeError1(theEnv,"dynamic-put",1,"symbol");
@@ -935,7 +951,7 @@ void DynamicHandlerPutSlot(
       return;
      }
    ins = GetActiveInstance(theEnv);
-   sp = FindInstanceSlot(theEnv,ins,temp.lexemeValue);
+   sp = FindCachedInstanceSlot(theEnv,GetFirstArgument(),ins,temp.lexemeValue);
    if (sp == NULL)
      {
       SlotExistError(theEnv,temp.lexemeValue->contents,"dynamic-put");
@@ -1003,6 +1019,7 @@ static bool PerformMessage(
    Defclass *cls = NULL;
    Instance *ins = NULL;
    CLIPSLexeme *oldName;
+   HANDLER_CHAIN_CACHE *cachedChain = NULL;
 #if PROFILING_FUNCTIONS
    struct profileFrameInfo profileFrame;
 #endif
@@ -1094,7 +1111,7 @@ static bool PerformMessage(
      { MessageHandlerData(theEnv)->TopOfCore->nxtInStack = MessageHandlerData(theEnv)->OldCore; }
    MessageHandlerData(theEnv)->OldCore = MessageHandlerData(theEnv)->TopOfCore;
 
-   MessageHandlerData(theEnv)->TopOfCore = FindApplicableHandlers(theEnv,cls,mname);
+   MessageHandlerData(theEnv)->TopOfCore = AcquireHandlerChain(theEnv,cls,mname,&cachedChain);
 
    if (MessageHandlerData(theEnv)->TopOfCore != NULL)
      {
@@ -1122,10 +1139,11 @@ static bool PerformMessage(
 #endif
 
 
-           EvaluateProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
-                               MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
-                               MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
-                               returnValue,UnboundHandlerErr);
+           EvaluateCompiledProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
+                                       MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
+                                       &MessageHandlerData(theEnv)->CurrentCore->hnd->bytecode,
+                                       MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
+                                       returnValue,UnboundHandlerErr);
 
 
 #if PROFILING_FUNCTIONS
@@ -1155,7 +1173,10 @@ static bool PerformMessage(
 #endif
         }
 
-      DestroyHandlerLinks(theEnv,MessageHandlerData(theEnv)->TopOfCore);
+      if (cachedChain != NULL)
+        { ReleaseHandlerChain(theEnv,cachedChain); }
+      else
+        { DestroyHandlerLinks(theEnv,MessageHandlerData(theEnv)->TopOfCore); }
       MessageHandlerData(theEnv)->CurrentCore = oldCurrent;
       MessageHandlerData(theEnv)->NextInCore = oldNext;
      }
@@ -1229,6 +1250,243 @@ static HANDLER_LINK *FindApplicableHandlers(
    return(JoinHandlerLinks(theEnv,tops,bots,mname));
   }
 
+/*****************************************************************************
+  NAME         : AcquireHandlerChain
+  DESCRIPTION  : Returns the core frame for a message, reusing the chain
+                   built by an earlier send of the same message to the
+                   same class whenever possible
+  INPUTS       : 1) The class of the instance (or primitive) for the message
+                 2) The message name
+                 3) Caller's buffer for the cache entry which owns the
+                    chain (set to NULL when the chain is not cached and
+                    must be destroyed with DestroyHandlerLinks)
+  RETURNS      : NULL if no applicable handlers or errors,
+                   the list of handlers otherwise
+  SIDE EFFECTS : Busy counts of the handlers and their classes are
+                   incremented, cache entry marked in use
+  NOTES        : A cached chain is only handed to one send at a time since
+                   the links also record the core stack (nxtInStack).
+                   Recursive sends of the same message to the same class
+                   get a freshly built chain.
+ *****************************************************************************/
+static HANDLER_LINK *AcquireHandlerChain(
+  Environment *theEnv,
+  Defclass *cls,
+  CLIPSLexeme *mname,
+  HANDLER_CHAIN_CACHE **cachedChain)
+  {
+   HANDLER_CHAIN_CACHE *entry = NULL;
+   HANDLER_LINK *chain;
+   unsigned long bucket;
+
+   *cachedChain = NULL;
+   bucket = ((((unsigned long) cls) >> 3) ^ (((unsigned long) mname) >> 3)) % SIZE_HANDLER_CHAIN_HASH;
+
+   if (MessageHandlerData(theEnv)->ChainCache != NULL)
+     {
+      for (entry = MessageHandlerData(theEnv)->ChainCache[bucket] ;
+           entry != NULL ;
+           entry = entry->next)
+        {
+         if ((entry->cls == cls) && (entry->mname == mname))
+           { break; }
+        }
+     }
+
+   if (entry == NULL)
+     {
+      chain = FindApplicableHandlers(theEnv,cls,mname);
+      if (chain == NULL)
+        { return NULL; }
+
+      if (MessageHandlerData(theEnv)->ChainCache == NULL)
+        {
+         MessageHandlerData(theEnv)->ChainCache = (HANDLER_CHAIN_CACHE **)
+            gm2(theEnv,sizeof(HANDLER_CHAIN_CACHE *) * SIZE_HANDLER_CHAIN_HASH);
+         memset(MessageHandlerData(theEnv)->ChainCache,0,
+                sizeof(HANDLER_CHAIN_CACHE *) * SIZE_HANDLER_CHAIN_HASH);
+        }
+
+      entry = get_struct(theEnv,handlerChainCache);
+      entry->cls = cls;
+      entry->mname = mname;
+      entry->chain = chain;
+      entry->inUse = true;
+      entry->stale = false;
+      entry->next = MessageHandlerData(theEnv)->ChainCache[bucket];
+      MessageHandlerData(theEnv)->ChainCache[bucket] = entry;
+      *cachedChain = entry;
+      return chain;
+     }
+
+   if (entry->inUse)
+     { return FindApplicableHandlers(theEnv,cls,mname); }
+
+   entry->inUse = true;
+   for (chain = entry->chain ; chain != NULL ; chain = chain->nxt)
+     {
+      chain->hnd->busy++;
+      IncrementDefclassBusyCount(theEnv,chain->hnd->cls);
+     }
+   *cachedChain = entry;
+   return entry->chain;
+  }
+
+/*****************************************************
+  NAME         : ReleaseHandlerChain
+  DESCRIPTION  : Gives a cached core frame back to the
+                 cache once the message is finished
+  INPUTS       : The cache entry
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Busy counts decremented, entry freed
+                 if the cache was flushed meanwhile
+  NOTES        : None
+ *****************************************************/
+static void ReleaseHandlerChain(
+  Environment *theEnv,
+  HANDLER_CHAIN_CACHE *entry)
+  {
+   HANDLER_LINK *mlink;
+
+   for (mlink = entry->chain ; mlink != NULL ; mlink = mlink->nxt)
+     {
+      mlink->hnd->busy--;
+      DecrementDefclassBusyCount(theEnv,mlink->hnd->cls);
+     }
+   entry->inUse = false;
+
+   if (entry->stale)
+     { ReturnCachedHandlerChain(theEnv,entry); }
+  }
+
+/*****************************************************
+  NAME         : ReturnCachedHandlerChain
+  DESCRIPTION  : Deallocates a cache entry and its links
+  INPUTS       : The cache entry
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Entry and links deallocated
+  NOTES        : The links hold no busy counts
+ *****************************************************/
+static void ReturnCachedHandlerChain(
+  Environment *theEnv,
+  HANDLER_CHAIN_CACHE *entry)
+  {
+   HANDLER_LINK *mlink;
+
+   while (entry->chain != NULL)
+     {
+      mlink = entry->chain;
+      entry->chain = mlink->nxt;
+      rtn_struct(theEnv,messageHandlerLink,mlink);
+     }
+   rtn_struct(theEnv,handlerChainCache,entry);
+  }
+
+/*****************************************************
+  NAME         : FlushHandlerChainCache
+  DESCRIPTION  : Forgets every cached core frame
+  INPUTS       : None
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Entries deallocated
+  NOTES        : Must be called whenever handlers or
+                 classes are added or removed since the
+                 links point into the class handler
+                 arrays. Chains currently executing are
+                 detached and freed when released.
+ *****************************************************/
+void FlushHandlerChainCache(
+  Environment *theEnv)
+  {
+   HANDLER_CHAIN_CACHE *entry, *next;
+   unsigned long i;
+
+   if (MessageHandlerData(theEnv)->ChainCache == NULL)
+     { return; }
+
+   for (i = 0 ; i < SIZE_HANDLER_CHAIN_HASH ; i++)
+     {
+      for (entry = MessageHandlerData(theEnv)->ChainCache[i] ;
+           entry != NULL ;
+           entry = next)
+        {
+         next = entry->next;
+         if (entry->inUse)
+           { entry->stale = true; }
+         else
+           { ReturnCachedHandlerChain(theEnv,entry); }
+        }
+      MessageHandlerData(theEnv)->ChainCache[i] = NULL;
+     }
+  }
+
+/*****************************************************
+  NAME         : InvalidateSlotAccessCache
+  DESCRIPTION  : Forgets every cached dynamic slot
+                 lookup
+  INPUTS       : None
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Cache epoch incremented
+  NOTES        : Must be called whenever classes are
+                 removed since a new class may later be
+                 allocated at the same address
+ *****************************************************/
+void InvalidateSlotAccessCache(
+  Environment *theEnv)
+  {
+   MessageHandlerData(theEnv)->SlotAccessEpoch++;
+  }
+
+/***********************************************************************
+  NAME         : FindCachedInstanceSlot
+  DESCRIPTION  : Finds an instance slot by name for dynamic-get and
+                   dynamic-put, remembering the slot's index in the
+                   class for the call site so that a repeated access
+                   from the same site on an instance of the same class
+                   does not have to search for the slot name again
+  INPUTS       : 1) The call site (the slot name argument expression)
+                 2) The active instance
+                 3) The slot name
+  RETURNS      : The address of the slot, NULL if not found
+  SIDE EFFECTS : Cache entry for the call site (re)filled
+  NOTES        : The cache is direct-mapped on the call site. Each
+                   entry is guarded by the class and the slot name,
+                   so a collision only costs a regular lookup.
+ ***********************************************************************/
+static InstanceSlot *FindCachedInstanceSlot(
+  Environment *theEnv,
+  Expression *site,
+  Instance *ins,
+  CLIPSLexeme *sname)
+  {
+   SLOT_ACCESS_CACHE *entry;
+   int i;
+
+   if (MessageHandlerData(theEnv)->SlotAccessCache == NULL)
+     {
+      MessageHandlerData(theEnv)->SlotAccessCache = (SLOT_ACCESS_CACHE *)
+         gm2(theEnv,sizeof(SLOT_ACCESS_CACHE) * SIZE_SLOT_ACCESS_CACHE);
+      memset(MessageHandlerData(theEnv)->SlotAccessCache,0,
+             sizeof(SLOT_ACCESS_CACHE) * SIZE_SLOT_ACCESS_CACHE);
+     }
+
+   entry = &MessageHandlerData(theEnv)->SlotAccessCache[(((uintptr_t) site) >> 4) % SIZE_SLOT_ACCESS_CACHE];
+   if ((entry->site == site) && (entry->cls == ins->cls) &&
+       (entry->slotName == sname) &&
+       (entry->epoch == MessageHandlerData(theEnv)->SlotAccessEpoch))
+     { return ins->slotAddresses[entry->slotIndex]; }
+
+   i = FindInstanceTemplateSlot(theEnv,ins->cls,sname);
+   if (i == -1)
+     { return NULL; }
+
+   entry->site = site;
+   entry->cls = ins->cls;
+   entry->slotName = sname;
+   entry->epoch = MessageHandlerData(theEnv)->SlotAccessEpoch;
+   entry->slotIndex = (unsigned short) i;
+   return ins->slotAddresses[i];
+  }
+
 /***************************************************************
   NAME         : CallHandlers
   DESCRIPTION  : Moves though the current message frame
@@ -1280,10 +1538,11 @@ static void CallHandlers(
                       ProfileFunctionData(theEnv)->ProfileConstructs);
 #endif
 
-         EvaluateProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
-                            &temp,UnboundHandlerErr);
+         EvaluateCompiledProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
+                                     MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
+                                     &MessageHandlerData(theEnv)->CurrentCore->hnd->bytecode,
+                                     MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
+                                     &temp,UnboundHandlerErr);
 
 
 #if PROFILING_FUNCTIONS
@@ -1320,10 +1579,11 @@ static void CallHandlers(
 #endif
 
 
-        EvaluateProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
-                            returnValue,UnboundHandlerErr);
+        EvaluateCompiledProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
+                                    MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
+                                    &MessageHandlerData(theEnv)->CurrentCore->hnd->bytecode,
+                                    MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
+                                    returnValue,UnboundHandlerErr);
 
 #if PROFILING_FUNCTIONS
          EndProfile(theEnv,&profileFrame);
@@ -1371,10 +1631,11 @@ static void CallHandlers(
 #endif
 
 
-         EvaluateProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
-                            MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
-                            &temp,UnboundHandlerErr);
+         EvaluateCompiledProcActions(theEnv,MessageHandlerData(theEnv)->CurrentCore->hnd->cls->header.whichModule->theModule,
+                                     MessageHandlerData(theEnv)->CurrentCore->hnd->actions,
+                                     &MessageHandlerData(theEnv)->CurrentCore->hnd->bytecode,
+                                     MessageHandlerData(theEnv)->CurrentCore->hnd->localVarCount,
+                                     &temp,UnboundHandlerErr);
 
 #if PROFILING_FUNCTIONS
          EndProfile(theEnv,&profileFrame);
@@ -69,6 +69,29 @@ typedef struct messageHandlerLink
    struct messageHandlerLink *nxtInStack;
   } HANDLER_LINK;
 
+#define SIZE_HANDLER_CHAIN_HASH 1013
+
+typedef struct handlerChainCache
+  {
+   Defclass *cls;
+   CLIPSLexeme *mname;
+   HANDLER_LINK *chain;
+   bool inUse;
+   bool stale;
+   struct handlerChainCache *next;
+  } HANDLER_CHAIN_CACHE;
+
+#define SIZE_SLOT_ACCESS_CACHE 509
+
+typedef struct slotAccessCache
+  {
+   Expression *site;
+   Defclass *cls;
+   CLIPSLexeme *slotName;
+   unsigned long epoch;
+   unsigned short slotIndex;
+  } SLOT_ACCESS_CACHE;
+
    bool             DirectMessage(Environment *,CLIPSLexeme *,Instance *,
                                   UDFValue *,Expression *);
    void             Send(Environment *,CLIPSValue *,const char *,const char *,CLIPSValue *);
@@ -82,6 +105,8 @@ typedef struct messageHandlerLink
    void             FindApplicableOfName(Environment *,Defclass *,HANDLER_LINK *[],
                                          HANDLER_LINK *[],CLIPSLexeme *);
    HANDLER_LINK    *JoinHandlerLinks(Environment *,HANDLER_LINK *[],HANDLER_LINK *[],CLIPSLexeme *);
+   void             FlushHandlerChainCache(Environment *);
+   void             InvalidateSlotAccessCache(Environment *);
 
    void             PrintHandlerSlotGetFunction(Environment *,const char *,void *);
    bool             HandlerSlotGetFunction(Environment *,void *,UDFValue *);
@@ -63,6 +63,7 @@
 #include "bload.h"
 #endif
 
+#include "bytecode.h"
 #include "classcom.h"
 #include "classfun.h"
 #include "constrct.h"
@@ -283,6 +284,8 @@ bool ParseDefmessageHandler(
    if (hnd != NULL)
      {
       ExpressionDeinstall(theEnv,hnd->actions);
+      ReturnProcBytecode(theEnv,hnd->bytecode);
+      hnd->bytecode = NULL;
       ReturnPackedExpression(theEnv,hnd->actions);
       if (hnd->header.ppForm != NULL)
         rm(theEnv,(void *) hnd->header.ppForm,
@@ -325,6 +325,7 @@ Multifield *CreateMultifield(
    theSegment->next = UtilityData(theEnv)->CurrentGarbageFrame->ListOfMultifields;
    UtilityData(theEnv)->CurrentGarbageFrame->ListOfMultifields = theSegment;
    UtilityData(theEnv)->CurrentGarbageFrame->dirty = true;
+   UtilityData(theEnv)->CurrentGarbageFrame->nurseryCount++;
    if (UtilityData(theEnv)->CurrentGarbageFrame->LastMultifield == NULL)
      { UtilityData(theEnv)->CurrentGarbageFrame->LastMultifield = theSegment; }
 
@@ -361,6 +362,7 @@ void AddToMultifieldList(
    theSegment->next = UtilityData(theEnv)->CurrentGarbageFrame->ListOfMultifields;
    UtilityData(theEnv)->CurrentGarbageFrame->ListOfMultifields = theSegment;
    UtilityData(theEnv)->CurrentGarbageFrame->dirty = true;
+   UtilityData(theEnv)->CurrentGarbageFrame->nurseryCount++;
    if (UtilityData(theEnv)->CurrentGarbageFrame->LastMultifield == NULL)
      { UtilityData(theEnv)->CurrentGarbageFrame->LastMultifield = theSegment; }
   }
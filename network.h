@@ -35,6 +35,7 @@ struct alphaMemoryHash;
 struct betaMemory;
 struct joinLink;
 struct joinNode;
+struct joinRangeIndex;
 struct patternNodeHashEntry;
 typedef struct patternNodeHeader PatternNodeHeader;
 
@@ -54,6 +55,7 @@ struct patternNodeHeader
    unsigned int beginSlot : 1;
    unsigned int endSlot : 1;
    unsigned int selector : 1;
+   unsigned int rangeIndexed : 1;
   };
 
 #include "match.h"
@@ -79,6 +81,7 @@ struct alphaMemoryHash
    struct alphaMemoryHash *prevHash;
    struct alphaMemoryHash *next;
    struct alphaMemoryHash *prev;
+   struct joinRangeIndex *rangeIndices;
   };
 
 typedef struct alphaMemoryHash ALPHA_MEMORY_HASH;
@@ -128,6 +131,7 @@ struct joinNode
    Expression *secondaryNetworkTest;
    Expression *leftHash;
    Expression *rightHash;
+   Expression *rangeTest;
    void *rightSideEntryStructure;
    struct joinLink *nextLinks;
    struct joinNode *lastLevel;
@@ -51,6 +51,7 @@
 
 #include "bload.h"
 #include "bsave.h"
+#include "bytecode.h"
 #include "classcom.h"
 #include "classfun.h"
 #include "classini.h"
@@ -291,6 +292,9 @@ static void DeallocateObjectBinaryData(
 
    if (ObjectBinaryData(theEnv)->HandlerCount != 0L)
      {
+      for (i = 0L ; i < ObjectBinaryData(theEnv)->HandlerCount ; i++)
+        ReturnProcBytecode(theEnv,ObjectBinaryData(theEnv)->HandlerArray[i].bytecode);
+
       space = (sizeof(DefmessageHandler) * ObjectBinaryData(theEnv)->HandlerCount);
       if (space != 0L)
         {
@@ -1132,6 +1136,8 @@ static void BloadObjects(
    GenReadBinary(theEnv,&space,sizeof(size_t));
    if (space == 0L)
      return;
+   FlushHandlerChainCache(theEnv);
+   InvalidateSlotAccessCache(theEnv);
    if (ObjectBinaryData(theEnv)->ModuleCount != 0L)
      BloadandRefresh(theEnv,ObjectBinaryData(theEnv)->ModuleCount,sizeof(BSAVE_DEFCLASS_MODULE),UpdateDefclassModule);
    if (ObjectBinaryData(theEnv)->ClassCount != 0L)
@@ -1358,6 +1364,7 @@ static void UpdateHandler(
    hnd->cls = DefclassPointer(bhnd->cls);
    //IncrementLexemeCount(hnd->header.name);
    hnd->actions = ExpressionPointer(bhnd->actions);
+   hnd->bytecode = NULL;
    hnd->header.ppForm = NULL;
    hnd->busy = 0;
    hnd->mark = 0;
@@ -1385,6 +1392,8 @@ static void ClearBloadObjects(
    space = (sizeof(DEFCLASS_MODULE) * ObjectBinaryData(theEnv)->ModuleCount);
    if (space == 0L)
      return;
+   FlushHandlerChainCache(theEnv);
+   InvalidateSlotAccessCache(theEnv);
    genfree(theEnv,ObjectBinaryData(theEnv)->ModuleArray,space);
    ObjectBinaryData(theEnv)->ModuleArray = NULL;
    ObjectBinaryData(theEnv)->ModuleCount = 0L;
@@ -1471,7 +1480,10 @@ static void ClearBloadObjects(
    if (ObjectBinaryData(theEnv)->HandlerCount != 0L)
      {
       for (i = 0L ; i < ObjectBinaryData(theEnv)->HandlerCount ; i++)
-        ReleaseLexeme(theEnv,ObjectBinaryData(theEnv)->HandlerArray[i].header.name);
+        {
+         ReleaseLexeme(theEnv,ObjectBinaryData(theEnv)->HandlerArray[i].header.name);
+         ReturnProcBytecode(theEnv,ObjectBinaryData(theEnv)->HandlerArray[i].bytecode);
+        }
 
       space = (sizeof(DefmessageHandler) * ObjectBinaryData(theEnv)->HandlerCount);
       if (space != 0L)
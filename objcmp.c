@@ -1404,7 +1404,7 @@ static bool HandlersToCode(
       PrintClassReference(theEnv,*handlerFile,hnd->cls,imageID,maxIndices);
       fprintf(*handlerFile,",%hu,%hu,%hu,",hnd->minParams,hnd->maxParams,hnd->localVarCount);
       ExpressionToCode(theEnv,*handlerFile,hnd->actions);
-      fprintf(*handlerFile,"}");
+      fprintf(*handlerFile,",NULL}");
      }
    *handlerArrayCount += theDefclass->handlerCount;
    *handlerFile = CloseFileIfNeeded(theEnv,*handlerFile,handlerArrayCount,
@@ -212,6 +212,7 @@ struct defmessageHandler
    unsigned short maxParams;
    unsigned short localVarCount;
    Expression *actions;
+   struct procBytecode *bytecode;
   };
 
 struct instanceBuilder
@@ -57,6 +57,7 @@
 #include "pattern.h"
 #include "reteutil.h"
 #include "rulebin.h"
+#include "symblbin.h"
 
 #include "objrtbin.h"
 
@@ -90,7 +91,8 @@ typedef struct bsaveObjectAlphaNode
         slotbmp,
         patternNode,
         nxtInGroup,
-        nxtTerminal;
+        nxtTerminal,
+        instanceName;
   } BSAVE_OBJECT_ALPHA_NODE;
 
 #define BsaveObjectPatternIndex(op) ((op != NULL) ? op->bsaveID : ULONG_MAX)
@@ -208,6 +210,8 @@ static void BsaveObjectPatternsFind(
       alphaPtr->classbmp->neededBitMap = true;
       if (alphaPtr->slotbmp != NULL)
         alphaPtr->slotbmp->neededBitMap = true;
+      if (alphaPtr->instanceName != NULL)
+        alphaPtr->instanceName->neededSymbol = true;
       alphaPtr->bsaveID = ObjectReteBinaryData(theEnv)->AlphaNodeCount++;
       alphaPtr = alphaPtr->nxtTerminal;
      }
@@ -295,6 +299,10 @@ static void BsaveObjectPatterns(
       dummyAlpha.patternNode = BsaveObjectPatternIndex(alphaPtr->patternNode);
       dummyAlpha.nxtInGroup = BsaveObjectAlphaIndex(alphaPtr->nxtInGroup);
       dummyAlpha.nxtTerminal = BsaveObjectAlphaIndex(alphaPtr->nxtTerminal);
+      if (alphaPtr->instanceName != NULL)
+        dummyAlpha.instanceName = alphaPtr->instanceName->bucket;
+      else
+        dummyAlpha.instanceName = ULONG_MAX;
       GenWrite(&dummyAlpha,sizeof(BSAVE_OBJECT_ALPHA_NODE),fp);
       alphaPtr = alphaPtr->nxtTerminal;
      }
@@ -463,6 +471,14 @@ static void UpdateAlpha(
    ap->patternNode = ObjectPatternPointer(bap->patternNode);
    ap->nxtInGroup = ObjectAlphaPointer(bap->nxtInGroup);
    ap->nxtTerminal = ObjectAlphaPointer(bap->nxtTerminal);
+   if (bap->instanceName != ULONG_MAX)
+     {
+      ap->instanceName = SymbolPointer(bap->instanceName);
+      IncrementLexemeCount(ap->instanceName);
+     }
+   else
+     ap->instanceName = NULL;
+   ap->nxtInNameIndex = NULL;
    ap->bsaveID = 0L;
   }
 
@@ -545,6 +561,8 @@ static void ClearBloadObjectPatterns(
       DecrementBitMapReferenceCount(theEnv,ObjectReteBinaryData(theEnv)->AlphaArray[i].classbmp);
       if (ObjectReteBinaryData(theEnv)->AlphaArray[i].slotbmp != NULL)
         DecrementBitMapReferenceCount(theEnv,ObjectReteBinaryData(theEnv)->AlphaArray[i].slotbmp);
+      if (ObjectReteBinaryData(theEnv)->AlphaArray[i].instanceName != NULL)
+        ReleaseLexeme(theEnv,ObjectReteBinaryData(theEnv)->AlphaArray[i].instanceName);
      }
 
    if (ObjectReteBinaryData(theEnv)->AlphaNodeCount != 0L)
@@ -166,6 +166,7 @@
                                               struct lhsParseNode **,struct lhsParseNode **);
    static CLIPSBitMap            *FormSlotBitMap(Environment *,struct lhsParseNode *);
    static struct lhsParseNode    *RemoveSlotExistenceTests(Environment *,struct lhsParseNode *,CLIPSBitMap **);
+   static CLIPSLexeme            *PatternInstanceName(struct lhsParseNode *);
    static void                    MarkObjectPtnIncrementalReset(Environment *,struct patternNodeHeader *,bool);
    static void                    ObjectIncrementalReset(Environment *);
 
@@ -658,6 +659,7 @@ static struct patternNodeHeader *PlaceObjectPattern(
    OBJECT_ALPHA_NODE *newAlphaNode;
    bool endSlot;
    CLIPSBitMap *newClassBitMap,*newSlotBitMap;
+   CLIPSLexeme *instanceName;
    struct expr *rightHash;
 
    /*========================================================*/
@@ -676,6 +678,7 @@ static struct patternNodeHeader *PlaceObjectPattern(
 
    rightHash = thePattern->rightHash;
 
+   instanceName = PatternInstanceName(thePattern->right);
    newSlotBitMap = FormSlotBitMap(theEnv,thePattern->right);
    thePattern->right = RemoveSlotExistenceTests(theEnv,thePattern->right,&newClassBitMap);
    thePattern = thePattern->right;
@@ -772,6 +775,10 @@ static struct patternNodeHeader *PlaceObjectPattern(
    newAlphaNode->slotbmp = newSlotBitMap;
    if (newSlotBitMap != NULL)
      IncrementBitMapCount(newSlotBitMap);
+   newAlphaNode->instanceName = instanceName;
+   if (instanceName != NULL)
+     IncrementLexemeCount(instanceName);
+   newAlphaNode->nxtInNameIndex = NULL;
    newAlphaNode->bsaveID = 0L;
    newAlphaNode->nxtInGroup = lastLevel->alphaNode;
    lastLevel->alphaNode = newAlphaNode;
@@ -1056,6 +1063,8 @@ static void DetachObjectPattern(
    DeleteClassBitMap(theEnv,alphaPtr->classbmp);
    if (alphaPtr->slotbmp != NULL)
      { DecrementBitMapReferenceCount(theEnv,alphaPtr->slotbmp); }
+   if (alphaPtr->instanceName != NULL)
+     { ReleaseLexeme(theEnv,alphaPtr->instanceName); }
 
    /*=========================================*/
    /* Only continue deleting this pattern if  */
@@ -1073,7 +1082,10 @@ static void DetachObjectPattern(
    if (prv == NULL)
      { SetObjectNetworkTerminalPointer(theEnv,terminalPtr->nxtTerminal); }
    else
-     { prv->nxtTerminal = terminalPtr->nxtTerminal; }
+     {
+      prv->nxtTerminal = terminalPtr->nxtTerminal;
+      InvalidateObjectNameIndex(theEnv);
+     }
 
    prv = NULL;
    terminalPtr = alphaPtr->patternNode->alphaNode;
@@ -1991,6 +2003,47 @@ static struct lhsParseNode *FilterObjectPattern(
    return(unfilteredSlots);
   }
 
+/***************************************************
+  NAME         : PatternInstanceName
+  DESCRIPTION  : Determines if an object pattern
+                 can only be satisfied by the
+                 instance with a particular name
+  INPUTS       : The intermediate parsed pattern
+  RETURNS      : The instance name required by the
+                 pattern's name restriction (NULL
+                 if any instance could match)
+  SIDE EFFECTS : None
+  NOTES        : Only a restriction without |
+                 connectives and with a constant
+                 non-negated instance name in its
+                 & chain is recognized, e.g.
+                 (name [ip]) or (name ?n&[ip])
+ ***************************************************/
+static CLIPSLexeme *PatternInstanceName(
+  struct lhsParseNode *thePattern)
+  {
+   struct lhsParseNode *node, *andNode;
+
+   for (node = thePattern ; node != NULL ; node = node->right)
+     {
+      if (node->slotNumber != NAME_ID)
+        { continue; }
+
+      if ((node->bottom == NULL) || (node->bottom->bottom != NULL))
+        { return NULL; }
+
+      for (andNode = node->bottom ; andNode != NULL ; andNode = andNode->right)
+        {
+         if ((andNode->pnType == INSTANCE_NAME_NODE) && (! andNode->negated))
+           { return andNode->lexemeValue; }
+        }
+
+      return NULL;
+     }
+
+   return NULL;
+  }
+
 /***************************************************
   NAME         : FormSlotBitMap
   DESCRIPTION  : Examines an object pattern and
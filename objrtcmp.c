@@ -54,6 +54,7 @@
 #include "objrtfnx.h"
 #include "objrtmch.h"
 #include "pattern.h"
+#include "symblcmp.h"
 #include "sysdep.h"
 
 #include "objrtcmp.h"
@@ -500,7 +501,9 @@ static unsigned AlphaPatternNodesToCode(
       ObjectPatternNodeReference(theEnv,thePattern->nxtInGroup,fp,imageID,maxIndices);
       fprintf(fp,",");
       ObjectPatternNodeReference(theEnv,thePattern->nxtTerminal,fp,imageID,maxIndices);
-      fprintf(fp,",0L}");
+      fprintf(fp,",");
+      PrintSymbolReference(theEnv,fp,thePattern->instanceName);
+      fprintf(fp,",NULL,0L}");
 
       i++;
       thePattern = thePattern->nxtTerminal;
@@ -253,6 +253,8 @@ static void DeallocateObjectReteData(
   {
    OBJECT_PATTERN_NODE *theNetwork;
 
+   InvalidateObjectNameIndex(theEnv);
+
 #if BLOAD || BLOAD_AND_BSAVE
    if (Bloaded(theEnv)) return;
 #endif
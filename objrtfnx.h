@@ -198,6 +198,10 @@ struct objectReteData
    OBJECT_MATCH_ACTION *ObjectMatchActionQueue;
    OBJECT_PATTERN_NODE *ObjectPatternNetworkPointer;
    OBJECT_ALPHA_NODE *ObjectPatternNetworkTerminalPointer;
+   OBJECT_ALPHA_NODE **NamedTerminalTable;
+   unsigned long NamedTerminalTableSize;
+   OBJECT_ALPHA_NODE *UnnamedTerminals;
+   bool NameIndexValid;
    bool DelayObjectPatternMatching;
    unsigned long long CurrentObjectMatchTimeTag;
    unsigned long long UseEntityTimeTag;
@@ -96,6 +96,8 @@
    static void                    ReturnObjectMatchAction(Environment *,OBJECT_MATCH_ACTION *);
    static void                    ProcessObjectMatchQueue(Environment *);
    static void                    MarkObjectPatternNetwork(Environment *,SLOT_BITMAP *);
+   static void                    MarkObjectAlphaNode(Environment *,OBJECT_ALPHA_NODE *,SLOT_BITMAP *,unsigned);
+   static void                    BuildObjectNameIndex(Environment *);
    static bool                    CompareSlotBitMaps(SLOT_BITMAP *,SLOT_BITMAP *);
    static void                    ObjectPatternMatch(Environment *,size_t,size_t,OBJECT_PATTERN_NODE *,struct multifieldMarker *);
    static void                    ProcessPatternNode(Environment *,size_t,size_t,OBJECT_PATTERN_NODE *,struct multifieldMarker *);
@@ -251,6 +253,33 @@ void SetObjectNetworkTerminalPointer(
   OBJECT_ALPHA_NODE *value)
   {
    ObjectReteData(theEnv)->ObjectPatternNetworkTerminalPointer = value;
+   InvalidateObjectNameIndex(theEnv);
+  }
+
+/*******************************************************
+  NAME         : InvalidateObjectNameIndex
+  DESCRIPTION  : Discards the index of terminal
+                 pattern nodes by instance name
+  INPUTS       : None
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Index deallocated and marked for
+                 rebuilding on the next match
+  NOTES        : Must be called whenever a node is
+                 added to or removed from the list
+                 of terminal pattern nodes
+ *******************************************************/
+void InvalidateObjectNameIndex(
+  Environment *theEnv)
+  {
+   if (ObjectReteData(theEnv)->NamedTerminalTable != NULL)
+     {
+      genfree(theEnv,ObjectReteData(theEnv)->NamedTerminalTable,
+              sizeof(OBJECT_ALPHA_NODE *) * ObjectReteData(theEnv)->NamedTerminalTableSize);
+      ObjectReteData(theEnv)->NamedTerminalTable = NULL;
+      ObjectReteData(theEnv)->NamedTerminalTableSize = 0;
+     }
+   ObjectReteData(theEnv)->UnnamedTerminals = NULL;
+   ObjectReteData(theEnv)->NameIndexValid = false;
   }
 
 /************************************************************************
@@ -640,8 +669,9 @@ static void ProcessObjectMatchQueue(
 
 /******************************************************
   NAME         : MarkObjectPatternNetwork
-  DESCRIPTION  : Iterates through all terminal
-                 pattern nodes checking class and
+  DESCRIPTION  : Iterates through the terminal
+                 pattern nodes which could apply to
+                 the object checking class and
                  slot bitmaps.  If a pattern is
                  applicable to the object/slot change,
                  then all the nodes belonging to
@@ -652,86 +682,174 @@ static void ProcessObjectMatchQueue(
                   for the entire object)
   RETURNS      : Nothing useful
   SIDE EFFECTS : Applicable pattern nodes marked
-  NOTES        : Incremental reset status is also
-                 checked here
+  NOTES        : Terminals whose pattern requires a
+                 specific instance name are only
+                 examined for an object with that
+                 name (see BuildObjectNameIndex)
  ******************************************************/
 static void MarkObjectPatternNetwork(
   Environment *theEnv,
   SLOT_BITMAP *slotNameIDs)
   {
    OBJECT_ALPHA_NODE *alphaPtr;
-   OBJECT_PATTERN_NODE *upper;
-   CLASS_BITMAP *clsset;
+   CLIPSLexeme *theName;
    unsigned id;
 
    ResetObjectMatchTimeTags(theEnv);
    ObjectReteData(theEnv)->CurrentObjectMatchTimeTag++;
-   alphaPtr = ObjectNetworkTerminalPointer(theEnv);
    id = ObjectReteData(theEnv)->CurrentPatternObject->cls->id;
-   while (alphaPtr != NULL)
+
+   if (! ObjectReteData(theEnv)->NameIndexValid)
+     { BuildObjectNameIndex(theEnv); }
+
+   for (alphaPtr = ObjectReteData(theEnv)->UnnamedTerminals ;
+        alphaPtr != NULL ;
+        alphaPtr = alphaPtr->nxtInNameIndex)
+     { MarkObjectAlphaNode(theEnv,alphaPtr,slotNameIDs,id); }
+
+   if (ObjectReteData(theEnv)->NamedTerminalTable == NULL)
+     { return; }
+
+   theName = ObjectReteData(theEnv)->CurrentPatternObject->name;
+   for (alphaPtr = ObjectReteData(theEnv)->NamedTerminalTable
+                      [theName->bucket % ObjectReteData(theEnv)->NamedTerminalTableSize] ;
+        alphaPtr != NULL ;
+        alphaPtr = alphaPtr->nxtInNameIndex)
      {
-      /* =============================================================
-         If an incremental reset is in progress, make sure that the
-         pattern has been marked for initialization before proceeding.
-         ============================================================= */
+      if (alphaPtr->instanceName == theName)
+        { MarkObjectAlphaNode(theEnv,alphaPtr,slotNameIDs,id); }
+     }
+  }
+
+/******************************************************
+  NAME         : MarkObjectAlphaNode
+  DESCRIPTION  : Checks the class and slot bitmaps
+                 of a terminal pattern node and, if
+                 the pattern is applicable to the
+                 object/slot change, marks all the
+                 nodes belonging to the pattern
+  INPUTS       : 1) The terminal pattern node
+                 2) The bitmap of ids of the slots
+                    being changed (NULL if this is
+                    an assert for the entire object)
+                 3) The id of the object's class
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Applicable pattern nodes marked
+  NOTES        : Incremental reset status is also
+                 checked here
+ ******************************************************/
+static void MarkObjectAlphaNode(
+  Environment *theEnv,
+  OBJECT_ALPHA_NODE *alphaPtr,
+  SLOT_BITMAP *slotNameIDs,
+  unsigned id)
+  {
+   OBJECT_PATTERN_NODE *upper;
+   CLASS_BITMAP *clsset;
+
+   /* =============================================================
+      If an incremental reset is in progress, make sure that the
+      pattern has been marked for initialization before proceeding.
+      ============================================================= */
 #if (! RUN_TIME) && (! BLOAD_ONLY)
-      if (EngineData(theEnv)->IncrementalResetInProgress &&
-          (alphaPtr->header.initialize == false))
-        {
-         alphaPtr = alphaPtr->nxtTerminal;
-         continue;
-        }
+   if (EngineData(theEnv)->IncrementalResetInProgress &&
+       (alphaPtr->header.initialize == false))
+     { return; }
 #endif
 
-      /* ============================================
-         Check the class bitmap to see if the pattern
-         pattern is applicable to the object at all
-         ============================================ */
-      clsset = (CLASS_BITMAP *) alphaPtr->classbmp->contents;
+   /* ============================================
+      Check the class bitmap to see if the pattern
+      pattern is applicable to the object at all
+      ============================================ */
+   clsset = (CLASS_BITMAP *) alphaPtr->classbmp->contents;
 
-      if ((id > clsset->maxid) ? false : TestBitMap(clsset->map,id))
-        {
-         /* ===================================================
-            If we are doing an assert, then we need to
-            check all patterns which satsify the class bitmap
-            (The retraction has already been done in this case)
-            =================================================== */
-         if (slotNameIDs == NULL)
-           {
-            alphaPtr->matchTimeTag = ObjectReteData(theEnv)->CurrentObjectMatchTimeTag;
-            for (upper = alphaPtr->patternNode ; upper != NULL ; upper = upper->lastLevel)
-              {
-               if (upper->matchTimeTag == ObjectReteData(theEnv)->CurrentObjectMatchTimeTag)
-                 break;
-               else
-                 upper->matchTimeTag = ObjectReteData(theEnv)->CurrentObjectMatchTimeTag;
-              }
-           }
+   if ((id > clsset->maxid) ? true : (! TestBitMap(clsset->map,id)))
+     { return; }
 
-         /* ===================================================
-            If we are doing a slot modify, then we need to
-            check only the subset of patterns which satisfy the
-            class bitmap AND actually match on the slot in
-            question.
-            =================================================== */
-         else if (alphaPtr->slotbmp != NULL)
-           {
-           if (CompareSlotBitMaps(slotNameIDs,
-                  (SLOT_BITMAP *) alphaPtr->slotbmp->contents))
-              {
-               alphaPtr->matchTimeTag = ObjectReteData(theEnv)->CurrentObjectMatchTimeTag;
-               for (upper = alphaPtr->patternNode ; upper != NULL ; upper = upper->lastLevel)
-                 {
-                  if (upper->matchTimeTag == ObjectReteData(theEnv)->CurrentObjectMatchTimeTag)
-                    break;
-                  else
-                    upper->matchTimeTag = ObjectReteData(theEnv)->CurrentObjectMatchTimeTag;
-                 }
-              }
-           }
+   /* ===================================================
+      If we are doing an assert, then we need to
+      check all patterns which satsify the class bitmap
+      (The retraction has already been done in this case)
+
+      If we are doing a slot modify, then we need to
+      check only the subset of patterns which satisfy the
+      class bitmap AND actually match on the slot in
+      question.
+      =================================================== */
+   if (slotNameIDs != NULL)
+     {
+      if (alphaPtr->slotbmp == NULL)
+        { return; }
+      if (! CompareSlotBitMaps(slotNameIDs,(SLOT_BITMAP *) alphaPtr->slotbmp->contents))
+        { return; }
+     }
+
+   alphaPtr->matchTimeTag = ObjectReteData(theEnv)->CurrentObjectMatchTimeTag;
+   for (upper = alphaPtr->patternNode ; upper != NULL ; upper = upper->lastLevel)
+     {
+      if (upper->matchTimeTag == ObjectReteData(theEnv)->CurrentObjectMatchTimeTag)
+        break;
+      else
+        upper->matchTimeTag = ObjectReteData(theEnv)->CurrentObjectMatchTimeTag;
+     }
+  }
+
+/******************************************************
+  NAME         : BuildObjectNameIndex
+  DESCRIPTION  : Partitions the terminal pattern
+                 nodes into those which apply to any
+                 instance and those which require a
+                 specific instance name.  The latter
+                 are hashed on that name.
+  INPUTS       : None
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Name index built
+  NOTES        : The index is rebuilt lazily after
+                 any change to the terminal list
+ ******************************************************/
+static void BuildObjectNameIndex(
+  Environment *theEnv)
+  {
+   OBJECT_ALPHA_NODE *alphaPtr;
+   unsigned long namedCount = 0, i;
+
+   InvalidateObjectNameIndex(theEnv);
+
+   for (alphaPtr = ObjectNetworkTerminalPointer(theEnv) ;
+        alphaPtr != NULL ;
+        alphaPtr = alphaPtr->nxtTerminal)
+     {
+      if (alphaPtr->instanceName != NULL)
+        { namedCount++; }
+     }
+
+   if (namedCount != 0)
+     {
+      ObjectReteData(theEnv)->NamedTerminalTableSize = (namedCount * 2) + 1;
+      ObjectReteData(theEnv)->NamedTerminalTable = (OBJECT_ALPHA_NODE **)
+         genalloc(theEnv,sizeof(OBJECT_ALPHA_NODE *) * ObjectReteData(theEnv)->NamedTerminalTableSize);
+      for (i = 0 ; i < ObjectReteData(theEnv)->NamedTerminalTableSize ; i++)
+        { ObjectReteData(theEnv)->NamedTerminalTable[i] = NULL; }
+     }
+
+   for (alphaPtr = ObjectNetworkTerminalPointer(theEnv) ;
+        alphaPtr != NULL ;
+        alphaPtr = alphaPtr->nxtTerminal)
+     {
+      if (alphaPtr->instanceName == NULL)
+        {
+         alphaPtr->nxtInNameIndex = ObjectReteData(theEnv)->UnnamedTerminals;
+         ObjectReteData(theEnv)->UnnamedTerminals = alphaPtr;
+        }
+      else
+        {
+         i = alphaPtr->instanceName->bucket % ObjectReteData(theEnv)->NamedTerminalTableSize;
+         alphaPtr->nxtInNameIndex = ObjectReteData(theEnv)->NamedTerminalTable[i];
+         ObjectReteData(theEnv)->NamedTerminalTable[i] = alphaPtr;
         }
-      alphaPtr = alphaPtr->nxtTerminal;
      }
+
+   ObjectReteData(theEnv)->NameIndexValid = true;
   }
 
 /***************************************************
@@ -120,6 +120,8 @@ struct objectAlphaNode
    OBJECT_PATTERN_NODE *patternNode;
    struct objectAlphaNode *nxtInGroup,
                           *nxtTerminal;
+   CLIPSLexeme *instanceName;
+   struct objectAlphaNode *nxtInNameIndex;
    unsigned long bsaveID;
   };
 
@@ -138,6 +140,7 @@ typedef struct objectMatchAction
    OBJECT_ALPHA_NODE    *ObjectNetworkTerminalPointer(Environment *);
    void                  SetObjectNetworkPointer(Environment *,OBJECT_PATTERN_NODE *);
    void                  SetObjectNetworkTerminalPointer(Environment *,OBJECT_ALPHA_NODE *);
+   void                  InvalidateObjectNameIndex(Environment *);
    void                  ObjectNetworkAction(Environment *,int,Instance *,int);
    void                  ResetObjectMatchTimeTags(Environment *);
 
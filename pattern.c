@@ -528,7 +528,7 @@ void PatternNodeHeaderToCode(
 
    PrintHashedExpressionReference(theEnv,fp,theHeader->rightHash,imageID,maxIndices);
 
-   fprintf(fp,",%d,%d,%d,0,0,%d,%d,%d}",theHeader->singlefieldNode,
+   fprintf(fp,",%d,%d,%d,0,0,%d,%d,%d,0}",theHeader->singlefieldNode,
                                      theHeader->multifieldNode,
                                      theHeader->stopNode,
                                      theHeader->beginSlot,
@@ -123,6 +123,7 @@ struct patternData
    bool WithinNotCE;
    int GlobalSalience;
    bool GlobalAutoFocus;
+   CLIPSLexeme *GlobalPhase;
    struct expr *SalienceExpression;
    struct patternNodeHashEntry **PatternHashTable;
    unsigned long PatternHashTableSize;
@@ -58,6 +58,9 @@
 /*            an alternate variable handling function         */
 /*            generates an error.                             */
 /*                                                            */
+/*            Added optional compilation of deffunction and   */
+/*            message-handler bodies to bytecode.             */
+/*                                                            */
 /**************************************************************/
 
 /* =========================================
@@ -80,10 +83,16 @@
 #endif
 #include "exprnpsr.h"
 #include "multifld.h"
+#if DEFFUNCTION_CONSTRUCT || OBJECT_SYSTEM
+#include "bytecode.h"
+#endif
 #if OBJECT_SYSTEM
 #include "object.h"
 #endif
 #include "pprint.h"
+#if PROFILING_FUNCTIONS
+#include "proflfun.h"
+#endif
 #include "prcdrpsr.h"
 #include "prntutil.h"
 #include "router.h"
@@ -91,19 +100,6 @@
 
 #include "prccode.h"
 
-/* =========================================
-   *****************************************
-               MACROS AND TYPES
-   =========================================
-   ***************************************** */
-typedef struct
-  {
-   unsigned firstFlag  : 1;
-   unsigned first      : 15;
-   unsigned secondFlag : 1;
-   unsigned second     : 15;
-  } PACKED_PROC_VAR;
-
 /***************************************/
 /* LOCAL INTERNAL FUNCTION DEFINITIONS */
 /***************************************/
@@ -115,6 +111,8 @@ typedef struct
    static bool                    RtnProcWild(Environment *,void *,UDFValue *);
    static void                    DeallocateProceduralPrimitiveData(Environment *);
    static void                    ReleaseProcParameters(Environment *);
+   static void                    ExecuteProcActions(Environment *,Defmodule *,Expression *,struct procBytecode *,
+                                                     unsigned short,UDFValue *,void (*)(Environment *,const char *));
 
 #if (! BLOAD_ONLY) && (! RUN_TIME)
    static unsigned int            FindProcParameter(CLIPSLexeme *,Expression *,CLIPSLexeme *);
@@ -190,6 +188,10 @@ void InstallProcedurePrimitives(
 
    ProceduralPrimitiveData(theEnv)->Oldindex = UINT_MAX;
 
+#if DEFFUNCTION_CONSTRUCT || OBJECT_SYSTEM
+   BytecodeCommandDefinitions(theEnv);
+#endif
+
    /* ===============================================
       Make sure a default evaluation function is
       in place for deffunctions and generic functions
@@ -890,6 +892,97 @@ void EvaluateProcActions(
   unsigned short lvarcnt,
   UDFValue *returnValue,
   void (*crtproc)(Environment *,const char *))
+  {
+   ExecuteProcActions(theEnv,theModule,actions,NULL,lvarcnt,returnValue,crtproc);
+  }
+
+#if DEFFUNCTION_CONSTRUCT || OBJECT_SYSTEM
+
+/***********************************************************
+  NAME         : EvaluateCompiledProcActions
+  DESCRIPTION  : Executes the actions of a deffunction or
+                 message-handler, compiling them to
+                 bytecode the first time they are executed
+                 if bytecode compilation is enabled
+  INPUTS       : 1) The module where the actions should be
+                    executed
+                 2) The actions (linked by nextArg fields)
+                 3) The address of the bytecode of the
+                    actions (NULL if not compiled yet)
+                 4) The number of local variables to reserve
+                    space for.
+                 5) A buffer to hold the result of evaluating
+                    the actions.
+                 6) A function which prints out the name of
+                    the currently executing body for error
+                    messages (can be NULL).
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Bytecode allocated for the actions
+  NOTES        : The actions are interpreted while user
+                 function profiling is on
+ ***********************************************************/
+void EvaluateCompiledProcActions(
+  Environment *theEnv,
+  Defmodule *theModule,
+  Expression *actions,
+  struct procBytecode **code,
+  unsigned short lvarcnt,
+  UDFValue *returnValue,
+  void (*crtproc)(Environment *,const char *))
+  {
+   if ((! ProceduralPrimitiveData(theEnv)->BytecodeCompilation) || (actions == NULL))
+     {
+      ExecuteProcActions(theEnv,theModule,actions,NULL,lvarcnt,returnValue,crtproc);
+      return;
+     }
+
+#if PROFILING_FUNCTIONS
+   if (ProfileFunctionData(theEnv)->ProfileUserFunctions)
+     {
+      ExecuteProcActions(theEnv,theModule,actions,NULL,lvarcnt,returnValue,crtproc);
+      return;
+     }
+#endif
+
+   if (*code == NULL)
+     { *code = CompileProcBytecode(theEnv,actions); }
+
+   ExecuteProcActions(theEnv,theModule,actions,*code,lvarcnt,returnValue,crtproc);
+  }
+
+#endif
+
+/***********************************************************
+  NAME         : ExecuteProcActions
+  DESCRIPTION  : Evaluates the actions of a deffunction,
+                 generic function method or message-handler,
+                 either by walking their expressions or by
+                 executing their bytecode.
+  INPUTS       : 1) The module where the actions should be
+                    executed
+                 2) The actions (linked by nextArg fields)
+                 3) The bytecode of the actions (NULL to
+                    interpret them)
+                 4) The number of local variables to reserve
+                    space for.
+                 5) A buffer to hold the result of evaluating
+                    the actions.
+                 6) A function which prints out the name of
+                    the currently executing body for error
+                    messages (can be NULL).
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Allocates and deallocates space for
+                 local variable array.
+  NOTES        : None
+ ***********************************************************/
+static void ExecuteProcActions(
+  Environment *theEnv,
+  Defmodule *theModule,
+  Expression *actions,
+  struct procBytecode *code,
+  unsigned short lvarcnt,
+  UDFValue *returnValue,
+  void (*crtproc)(Environment *,const char *))
   {
    UDFValue *oldLocalVarArray;
    unsigned short i;
@@ -915,7 +1008,8 @@ void EvaluateProcActions(
    oldActions = ProceduralPrimitiveData(theEnv)->CurrentProcActions;
    ProceduralPrimitiveData(theEnv)->CurrentProcActions = actions;
 
-   if (EvaluateExpression(theEnv,actions,returnValue))
+   if ((code != NULL) ? ExecuteProcBytecode(theEnv,code,returnValue) :
+                        EvaluateExpression(theEnv,actions,returnValue))
      {
       returnValue->value = FalseSymbol(theEnv);
      }
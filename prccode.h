@@ -51,6 +51,9 @@
 /*                                                           */
 /*            UDF redesign.                                  */
 /*                                                           */
+/*            Added optional compilation of deffunction and  */
+/*            message-handler bodies to bytecode.            */
+/*                                                           */
 /*************************************************************/
 
 #ifndef _H_prccode
@@ -65,6 +68,8 @@
 #include "scanner.h"
 #include "symbol.h"
 
+struct procBytecode;
+
 typedef struct ProcParamStack
   {
    UDFValue *ParamArray;
@@ -79,6 +84,19 @@ typedef struct ProcParamStack
    struct ProcParamStack *nxt;
   } PROC_PARAM_STACK;
 
+/* ==============================================
+   Packed form of a PROC_GET_BIND reference: the
+   local variable index and, if it shadows one,
+   the parameter (or wildcard) index
+   ============================================== */
+typedef struct
+  {
+   unsigned firstFlag  : 1;
+   unsigned first      : 15;
+   unsigned secondFlag : 1;
+   unsigned second     : 15;
+  } PACKED_PROC_VAR;
+
 #define PROCEDURAL_PRIMITIVE_DATA 37
 
 struct proceduralPrimitiveData
@@ -105,6 +123,7 @@ struct proceduralPrimitiveData
    EntityRecord GenericEntityRecord;
 #endif
    unsigned int Oldindex;
+   bool BytecodeCompilation;
   };
 
 #define ProceduralPrimitiveData(theEnv) ((struct proceduralPrimitiveData *) GetEnvironmentData(theEnv,PROCEDURAL_PRIMITIVE_DATA))
@@ -138,6 +157,10 @@ struct proceduralPrimitiveData
 
    void                           EvaluateProcActions(Environment *,Defmodule *,Expression *,unsigned short,
                                                       UDFValue *,void (*)(Environment *,const char *));
+#if DEFFUNCTION_CONSTRUCT || OBJECT_SYSTEM
+   void                           EvaluateCompiledProcActions(Environment *,Defmodule *,Expression *,struct procBytecode **,
+                                                              unsigned short,UDFValue *,void (*)(Environment *,const char *));
+#endif
    void                           PrintProcParamArray(Environment *,const char *);
    void                           GrabProcWildargs(Environment *,UDFValue *,unsigned int);
 
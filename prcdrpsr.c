@@ -689,6 +689,13 @@ static struct expr *BindParse(
                                            &count,true,NULL)) != NULL) :
        false)
      {
+      if (theGlobal->constant)
+        {
+         ConstantGlobalErrorMessage(theEnv,variableName->contents);
+         ReturnExpression(theEnv,top);
+         return NULL;
+        }
+
       top->argList->type = DEFGLOBAL_PTR;
       top->argList->value = theGlobal;
      }
@@ -88,6 +88,21 @@ void PredicateFunctionDefinitions(
    AddUDF(theEnv,"multifieldp","b",1,1,NULL,MultifieldpFunction,"MultifieldpFunction",NULL);
    AddUDF(theEnv,"sequencep","b",1,1,NULL,MultifieldpFunction,"MultifieldpFunction",NULL); // TBD Remove?
    AddUDF(theEnv,"pointerp","b",1,1,NULL,PointerpFunction,"PointerpFunction",NULL);
+
+   SetFunctionFoldable(theEnv,"not",true);
+   SetFunctionFoldable(theEnv,"and",true);
+   SetFunctionFoldable(theEnv,"or",true);
+   SetFunctionFoldable(theEnv,"eq",true);
+   SetFunctionFoldable(theEnv,"neq",true);
+   SetFunctionFoldable(theEnv,"<=",true);
+   SetFunctionFoldable(theEnv,">=",true);
+   SetFunctionFoldable(theEnv,"<",true);
+   SetFunctionFoldable(theEnv,">",true);
+   SetFunctionFoldable(theEnv,"=",true);
+   SetFunctionFoldable(theEnv,"<>",true);
+   SetFunctionFoldable(theEnv,"!=",true);
+   SetFunctionFoldable(theEnv,"oddp",true);
+   SetFunctionFoldable(theEnv,"evenp",true);
 #else
 #if MAC_XCD
 #pragma unused(theEnv)
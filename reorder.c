@@ -55,6 +55,9 @@
 /*                                                           */
 /*            Removed initial-fact support.                  */
 /*                                                           */
+/*            Added DEFGLOBAL_PTR_NODE for the defconstant   */
+/*            references of folded literals.                 */
+/*                                                           */
 /*************************************************************/
 
 #include "setup.h"
@@ -627,6 +630,7 @@ static struct lhsParseNode *PerformReorder2(
             argPtr->right->externalLeftHash = NULL;
             argPtr->right->leftHash = NULL;
             argPtr->right->rightHash = NULL;
+            argPtr->right->rangeTest = NULL;
             argPtr->right->betaHash = NULL;
             argPtr->right->expression = NULL;
             argPtr->right->secondaryExpression = NULL;
@@ -663,6 +667,7 @@ static struct lhsParseNode *PerformReorder2(
             argPtr->constantValue = NULL;
             argPtr->leftHash = NULL;
             argPtr->rightHash = NULL;
+            argPtr->rangeTest = NULL;
             argPtr->betaHash = NULL;
             argPtr->expression = NULL;
             argPtr->secondaryExpression = NULL;
@@ -1052,6 +1057,7 @@ static struct lhsParseNode *CompressCEs(
             argPtr->constantValue = NULL;
             argPtr->leftHash = NULL;
             argPtr->rightHash = NULL;
+            argPtr->rangeTest = NULL;
             argPtr->betaHash = NULL;
             argPtr->expression = NULL;
             argPtr->secondaryExpression = NULL;
@@ -1155,6 +1161,7 @@ void CopyLHSParseNode(
       dest->leftHash = CopyExpression(theEnv,src->leftHash);
       dest->betaHash = CopyExpression(theEnv,src->betaHash);
       dest->rightHash = CopyExpression(theEnv,src->rightHash);
+      dest->rangeTest = CopyExpression(theEnv,src->rangeTest);
       if (src->userData == NULL)
         { dest->userData = NULL; }
       else if (src->patternType->copyUserDataFunction == NULL)
@@ -1179,6 +1186,7 @@ void CopyLHSParseNode(
       dest->leftHash = src->leftHash;
       dest->betaHash = src->betaHash;
       dest->rightHash = src->rightHash;
+      dest->rangeTest = src->rangeTest;
       dest->userData = src->userData;
       dest->expression = src->expression;
       dest->secondaryExpression = src->secondaryExpression;
@@ -1235,6 +1243,7 @@ struct lhsParseNode *GetLHSParseNode(
    newNode->leftHash = NULL;
    newNode->betaHash = NULL;
    newNode->rightHash = NULL;
+   newNode->rangeTest = NULL;
    newNode->expression = NULL;
    newNode->secondaryExpression = NULL;
    newNode->right = NULL;
@@ -1263,6 +1272,7 @@ void ReturnLHSParseNodes(
       ReturnExpression(theEnv,waste->leftHash);
       ReturnExpression(theEnv,waste->betaHash);
       ReturnExpression(theEnv,waste->rightHash);
+      ReturnExpression(theEnv,waste->rangeTest);
       ReturnLHSParseNodes(theEnv,waste->right);
       ReturnLHSParseNodes(theEnv,waste->bottom);
       ReturnLHSParseNodes(theEnv,waste->expression);
@@ -1410,6 +1420,8 @@ unsigned short NodeTypeToType(
         return PCALL;
       case GCALL_NODE:
         return GCALL;
+      case DEFGLOBAL_PTR_NODE:
+        return DEFGLOBAL_PTR;
         
       default:
         return VOID_TYPE;
@@ -1446,6 +1458,8 @@ ParseNodeType TypeToNodeType(
         return PCALL_NODE;
       case GCALL:
         return GCALL_NODE;
+      case DEFGLOBAL_PTR:
+        return DEFGLOBAL_PTR_NODE;
       default:
         return UNKNOWN_NODE;
      }
@@ -47,6 +47,9 @@
 /*            Removed use of void pointers for specific      */
 /*            data structures.                               */
 /*                                                           */
+/*            Added DEFGLOBAL_PTR_NODE for the defconstant   */
+/*            references of folded literals.                 */
+/*                                                           */
 /*************************************************************/
 
 #ifndef _H_reorder
@@ -86,6 +89,7 @@ typedef enum
    SYMBOL_NODE,
    STRING_NODE,
    INSTANCE_NAME_NODE,
+   DEFGLOBAL_PTR_NODE,
    UNKNOWN_NODE
   } ParseNodeType;
 
@@ -139,6 +143,7 @@ struct lhsParseNode
    struct expr *constantValue;
    struct expr *leftHash;
    struct expr *rightHash;
+   struct expr *rangeTest;
    struct expr *betaHash;
    struct lhsParseNode *expression;
    struct lhsParseNode *secondaryExpression;
@@ -71,6 +71,7 @@
 #include "engine.h"
 #include "envrnmnt.h"
 #include "incrrset.h"
+#include "joinrng.h"
 #include "match.h"
 #include "memalloc.h"
 #include "moduldef.h"
@@ -138,7 +139,7 @@ struct partialMatch *CopyPartialMatch(
    struct partialMatch *linker;
    unsigned short i;
 
-   linker = get_var_struct(theEnv,partialMatch,sizeof(struct genericMatch) *
+   linker = get_slab_var_struct(theEnv,partialMatch,sizeof(struct genericMatch) *
                                         (list->bcount - 1));
 
    InitializePMLinks(linker);
@@ -162,7 +163,7 @@ struct partialMatch *CreateEmptyPartialMatch(
   {
    struct partialMatch *linker;
 
-   linker = get_struct(theEnv,partialMatch);
+   linker = get_slab_struct(theEnv,partialMatch);
 
    InitializePMLinks(linker);
    linker->betaMemory = true;
@@ -598,7 +599,7 @@ struct partialMatch *MergePartialMatches(
    /* Allocate the new partial match. */
    /*=================================*/
 
-   linker = get_var_struct(theEnv,partialMatch,sizeof(struct genericMatch) * lhsBind->bcount);
+   linker = get_slab_var_struct(theEnv,partialMatch,sizeof(struct genericMatch) * lhsBind->bcount);
 
    /*============================================*/
    /* Set the flags to their appropriate values. */
@@ -645,6 +646,7 @@ void InitializePatternHeader(
    theHeader->singlefieldNode = false;
    theHeader->multifieldNode = false;
    theHeader->stopNode = false;
+   theHeader->rangeIndexed = false;
 #if (! RUN_TIME)
    theHeader->initialize = true;
 #else
@@ -680,7 +682,7 @@ struct partialMatch *CreateAlphaMatch(
    /* Create the alpha match and intialize its values. */
    /*==================================================*/
 
-   theMatch = get_struct(theEnv,partialMatch);
+   theMatch = get_slab_struct(theEnv,partialMatch);
    InitializePMLinks(theMatch);
    theMatch->betaMemory = false;
    theMatch->busy = false;
@@ -688,7 +690,7 @@ struct partialMatch *CreateAlphaMatch(
    theMatch->bcount = 1;
    theMatch->hashValue = hashOffset;
 
-   afbtemp = get_struct(theEnv,alphaMatch);
+   afbtemp = get_slab_struct(theEnv,alphaMatch);
    afbtemp->next = NULL;
    afbtemp->matchingItem = (struct patternEntity *) theEntity;
 
@@ -719,6 +721,7 @@ struct partialMatch *CreateAlphaMatch(
       theAlphaMemory->alphaMemory = NULL;
       theAlphaMemory->endOfQueue = NULL;
       theAlphaMemory->nextHash = NULL;
+      theAlphaMemory->rangeIndices = NULL;
 
       theAlphaMemory->next = DefruleData(theEnv)->AlphaMemoryTable[hashValue];
       if (theAlphaMemory->next != NULL)
@@ -746,6 +749,9 @@ struct partialMatch *CreateAlphaMatch(
    /* memory of the pattern node.        */
    /*====================================*/
 
+   if (theAlphaMemory->rangeIndices != NULL)
+     { InvalidateRangeIndices(theEnv,theAlphaMemory); }
+
     theMatch->prevInMemory = theAlphaMemory->endOfQueue;
     if (theAlphaMemory->endOfQueue == NULL)
      {
@@ -1218,12 +1224,16 @@ void RemoveAlphaMemoryMatches(
    struct alphaMemoryHash *theAlphaMemory = NULL;
    unsigned long hashValue;
 
-   if ((theMatch->prevInMemory == NULL) || (theMatch->nextInMemory == NULL))
+   if ((theMatch->prevInMemory == NULL) || (theMatch->nextInMemory == NULL) ||
+       theHeader->rangeIndexed)
      {
       hashValue = theAlphaMatch->bucket;
       theAlphaMemory = FindAlphaMemory(theEnv,theHeader,hashValue);
      }
 
+   if ((theAlphaMemory != NULL) && (theAlphaMemory->rangeIndices != NULL))
+     { InvalidateRangeIndices(theEnv,theAlphaMemory); }
+
    if (theMatch->prevInMemory != NULL)
      { theMatch->prevInMemory->nextInMemory = theMatch->nextInMemory; }
    else
@@ -1263,6 +1273,7 @@ void DestroyAlphaMemory(
       DestroyAlphaBetaMemory(theEnv,theAlphaMemory->alphaMemory);
       if (unlink)
         { UnlinkAlphaMemoryBucketSiblings(theEnv,theAlphaMemory); }
+      ReturnRangeIndices(theEnv,theAlphaMemory);
       rtn_struct(theEnv,alphaMemoryHash,theAlphaMemory);
       theAlphaMemory = tempMemory;
      }
@@ -1287,6 +1298,7 @@ void FlushAlphaMemory(
       tempMemory = theAlphaMemory->nextHash;
       FlushAlphaBetaMemory(theEnv,theAlphaMemory->alphaMemory);
       UnlinkAlphaMemoryBucketSiblings(theEnv,theAlphaMemory);
+      ReturnRangeIndices(theEnv,theAlphaMemory);
       rtn_struct(theEnv,alphaMemoryHash,theAlphaMemory);
       theAlphaMemory = tempMemory;
      }
@@ -1316,6 +1328,18 @@ static struct alphaMemoryHash *FindAlphaMemory(
    return theAlphaMemory;
   }
 
+/*******************************************/
+/* GetAlphaMemoryHash: Retrieves the alpha */
+/*   memory bucket for a hash value.       */
+/*******************************************/
+struct alphaMemoryHash *GetAlphaMemoryHash(
+  Environment *theEnv,
+  struct patternNodeHeader *theHeader,
+  unsigned long hashOffset)
+  {
+   return FindAlphaMemory(theEnv,theHeader,AlphaMemoryHashValue(theHeader,hashOffset));
+  }
+
 /*************************/
 /* AlphaMemoryHashValue: */
 /*************************/
@@ -1373,6 +1397,7 @@ static void UnlinkAlphaMemory(
    if (theAlphaMemory->nextHash != NULL)
      { theAlphaMemory->nextHash->prevHash = theAlphaMemory->prevHash; }
 
+   ReturnRangeIndices(theEnv,theAlphaMemory);
    rtn_struct(theEnv,alphaMemoryHash,theAlphaMemory);
   }
 
@@ -71,6 +71,7 @@
    struct partialMatch           *MergePartialMatches(Environment *,struct partialMatch *,struct partialMatch *);
    long                           IncrementPseudoFactIndex(void);
    struct partialMatch           *GetAlphaMemory(Environment *,struct patternNodeHeader *,unsigned long);
+   struct alphaMemoryHash        *GetAlphaMemoryHash(Environment *,struct patternNodeHeader *,unsigned long);
    struct partialMatch           *GetLeftBetaMemory(struct joinNode *,unsigned long);
    struct partialMatch           *GetRightBetaMemory(struct joinNode *,unsigned long);
    void                           ReturnLeftMemory(Environment *,struct joinNode *);
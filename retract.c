@@ -42,6 +42,8 @@
 /*            Removed use of void pointers for specific      */
 /*            data structures.                               */
 /*                                                           */
+/*            Removed the unused garbage alpha match list.   */
+/*                                                           */
 /*************************************************************/
 
 #include <stdio.h>
@@ -578,7 +580,7 @@ void ReturnPartialMatch(
      {
       if (waste->binds[0].gm.theMatch->markers != NULL)
         { ReturnMarkers(theEnv,waste->binds[0].gm.theMatch->markers); }
-      rm(theEnv,waste->binds[0].gm.theMatch,sizeof(struct alphaMatch));
+      rtn_slab_struct(theEnv,alphaMatch,waste->binds[0].gm.theMatch);
      }
 
    /*=================================================*/
@@ -593,7 +595,7 @@ void ReturnPartialMatch(
    /* Return the partial match to the pool of free memory. */
    /*======================================================*/
 
-   rtn_var_struct(theEnv,partialMatch,sizeof(struct genericMatch *) *
+   rtn_slab_var_struct(theEnv,partialMatch,sizeof(struct genericMatch *) *
                   (waste->bcount - 1),
                   waste);
   }
@@ -617,7 +619,7 @@ void DestroyPartialMatch(
      {
       if (waste->binds[0].gm.theMatch->markers != NULL)
         { ReturnMarkers(theEnv,waste->binds[0].gm.theMatch->markers); }
-      rm(theEnv,waste->binds[0].gm.theMatch,sizeof(struct alphaMatch));
+      rtn_slab_struct(theEnv,alphaMatch,waste->binds[0].gm.theMatch);
      }
 
    /*=================================================*/
@@ -632,7 +634,7 @@ void DestroyPartialMatch(
    /* Return the partial match to the pool of free memory. */
    /*======================================================*/
 
-   rtn_var_struct(theEnv,partialMatch,sizeof(struct genericMatch *) *
+   rtn_slab_var_struct(theEnv,partialMatch,sizeof(struct genericMatch *) *
                   (waste->bcount - 1),
                   waste);
   }
@@ -668,19 +670,6 @@ void FlushGarbagePartialMatches(
   Environment *theEnv)
   {
    struct partialMatch *pmPtr;
-   struct alphaMatch *amPtr;
-
-   /*===================================================*/
-   /* Return the garbage partial matches collected from */
-   /* the alpha memories of the pattern networks.       */
-   /*===================================================*/
-
-   while (EngineData(theEnv)->GarbageAlphaMatches != NULL)
-     {
-      amPtr = EngineData(theEnv)->GarbageAlphaMatches->next;
-      rtn_struct(theEnv,alphaMatch,EngineData(theEnv)->GarbageAlphaMatches);
-      EngineData(theEnv)->GarbageAlphaMatches = amPtr;
-     }
 
    /*==============================================*/
    /* Return the garbage partial matches collected */
@@ -58,6 +58,7 @@
 #include "reteutil.h"
 #include "retract.h"
 #include "rulebsc.h"
+#include "rulephs.h"
 
 #include "rulebin.h"
 
@@ -154,6 +155,8 @@ static void DeallocateDefruleBloadData(
 
          theGroup = tmpGroup;
         }
+
+      DestroyPhaseSequence(theEnv,theModuleItem);
      }
 
    space = DefruleBinaryData(theEnv)->NumberOfDefruleModules * sizeof(struct defruleModule);
@@ -248,7 +251,7 @@ static void BsaveFind(
          /*==========================================*/
          /* Loop through each disjunct of the rule   */
          /* counting and marking the data structures */
-         /* associated with RHS actions.             */
+         /* associated with RHS actions and phases.  */
          /*==========================================*/
 
          for (theDisjunct = theDefrule;
@@ -257,6 +260,8 @@ static void BsaveFind(
            {
             ExpressionData(theEnv)->ExpressionCount += ExpressionSize(theDisjunct->actions);
             MarkNeededItems(theEnv,theDisjunct->actions);
+            if (theDisjunct->phase != NULL)
+              { theDisjunct->phase->neededSymbol = true; }
            }
         }
      }
@@ -511,6 +516,15 @@ static void BsaveDisjuncts(
       else
         { tempDefrule.actions = ULONG_MAX; }
 
+      /*====================================*/
+      /* Set the index to the phase symbol. */
+      /*====================================*/
+
+      if (theDisjunct->phase != NULL)
+        { tempDefrule.phase = theDisjunct->phase->bucket; }
+      else
+        { tempDefrule.phase = ULONG_MAX; }
+
       /*=================================*/
       /* Set the index to the disjunct's */
       /* logical join and last join.     */
@@ -631,6 +645,7 @@ static void BsaveJoin(
    tempJoin.secondaryNetworkTest = HashedExpressionIndex(theEnv,joinPtr->secondaryNetworkTest);
    tempJoin.leftHash = HashedExpressionIndex(theEnv,joinPtr->leftHash);
    tempJoin.rightHash = HashedExpressionIndex(theEnv,joinPtr->rightHash);
+   tempJoin.rangeTest = HashedExpressionIndex(theEnv,joinPtr->rangeTest);
 
    if (joinPtr->ruleToActivate != NULL)
      {
@@ -905,6 +920,7 @@ static void UpdateDefruleModule(
                              (void *) DefruleBinaryData(theEnv)->DefruleArray);
    DefruleBinaryData(theEnv)->ModuleArray[obji].agenda = NULL;
    DefruleBinaryData(theEnv)->ModuleArray[obji].groupings = NULL;
+   DefruleBinaryData(theEnv)->ModuleArray[obji].phases = NULL;
 
   }
 
@@ -927,6 +943,13 @@ static void UpdateDefrule(
    DefruleBinaryData(theEnv)->DefruleArray[obji].dynamicSalience = ExpressionPointer(br->dynamicSalience);
 
    DefruleBinaryData(theEnv)->DefruleArray[obji].actions = ExpressionPointer(br->actions);
+   if (br->phase != ULONG_MAX)
+     {
+      DefruleBinaryData(theEnv)->DefruleArray[obji].phase = SymbolPointer(br->phase);
+      IncrementLexemeCount(DefruleBinaryData(theEnv)->DefruleArray[obji].phase);
+     }
+   else
+     { DefruleBinaryData(theEnv)->DefruleArray[obji].phase = NULL; }
    DefruleBinaryData(theEnv)->DefruleArray[obji].logicalJoin = BloadJoinPointer(br->logicalJoin);
    DefruleBinaryData(theEnv)->DefruleArray[obji].lastJoin = BloadJoinPointer(br->lastJoin);
    DefruleBinaryData(theEnv)->DefruleArray[obji].disjunct = BloadDefrulePointer(DefruleBinaryData(theEnv)->DefruleArray,br->disjunct);
@@ -965,6 +988,7 @@ static void UpdateJoin(
    DefruleBinaryData(theEnv)->JoinArray[obji].secondaryNetworkTest = HashedExpressionPointer(bj->secondaryNetworkTest);
    DefruleBinaryData(theEnv)->JoinArray[obji].leftHash = HashedExpressionPointer(bj->leftHash);
    DefruleBinaryData(theEnv)->JoinArray[obji].rightHash = HashedExpressionPointer(bj->rightHash);
+   DefruleBinaryData(theEnv)->JoinArray[obji].rangeTest = HashedExpressionPointer(bj->rangeTest);
    DefruleBinaryData(theEnv)->JoinArray[obji].nextLinks = BloadJoinLinkPointer(bj->nextLinks);
    DefruleBinaryData(theEnv)->JoinArray[obji].lastLevel = BloadJoinPointer(bj->lastLevel);
 
@@ -1018,6 +1042,7 @@ void UpdatePatternNodeHeader(
    theHeader->beginSlot = theBsaveHeader->beginSlot;
    theHeader->endSlot = theBsaveHeader->endSlot;
    theHeader->selector = theBsaveHeader->selector;
+   theHeader->rangeIndexed = 0;
    theHeader->initialize = 0;
    theHeader->marked = 0;
    theHeader->firstHash = NULL;
@@ -1089,12 +1114,24 @@ static void ClearBload(
       ReturnRightMemory(theEnv,&DefruleBinaryData(theEnv)->JoinArray[i]);
      }
 
-   /*================================================*/
-   /* Decrement the symbol count for each rule name. */
-   /*================================================*/
+   /*=================================================*/
+   /* Decrement the symbol count for each rule name   */
+   /* and phase.                                      */
+   /*=================================================*/
 
    for (i = 0; i < DefruleBinaryData(theEnv)->NumberOfDefrules; i++)
-     { UnmarkConstructHeader(theEnv,&DefruleBinaryData(theEnv)->DefruleArray[i].header); }
+     {
+      UnmarkConstructHeader(theEnv,&DefruleBinaryData(theEnv)->DefruleArray[i].header);
+      if (DefruleBinaryData(theEnv)->DefruleArray[i].phase != NULL)
+        { ReleaseLexeme(theEnv,DefruleBinaryData(theEnv)->DefruleArray[i].phase); }
+     }
+
+   /*=======================================*/
+   /* Return the phase sequence of modules. */
+   /*=======================================*/
+
+   for (i = 0; i < DefruleBinaryData(theEnv)->NumberOfDefruleModules; i++)
+     { ReturnPhaseSequence(theEnv,&DefruleBinaryData(theEnv)->ModuleArray[i]); }
 
    /*==================================================*/
    /* Return the space allocated for the bload arrays. */
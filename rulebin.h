@@ -60,6 +60,7 @@ struct bsaveDefrule
    unsigned int autoFocus       :  1;
    unsigned long dynamicSalience;
    unsigned long actions;
+   unsigned long phase;
    unsigned long logicalJoin;
    unsigned long lastJoin;
    unsigned long disjunct;
@@ -105,6 +106,7 @@ struct bsaveJoinNode
    unsigned long secondaryNetworkTest;
    unsigned long leftHash;
    unsigned long rightHash;
+   unsigned long rangeTest;
    unsigned long rightSideEntryStructure;
    unsigned long nextLinks;
    unsigned long lastLevel;
@@ -292,6 +292,8 @@ struct joinNode *ConstructJoins(
                                      lastPattern,false,theLHS->negated, isExists,
                                      leftHash,rightHash);
             lastJoin->rhsType = rhsType;
+            if ((lastPattern != NULL) && (! theLHS->negated) && (! isExists))
+              { lastJoin->rangeTest = AddHashedExpression(theEnv,theLHS->rangeTest); }
            }
          else
            {
@@ -1213,6 +1215,14 @@ static struct joinNode *CreateNewJoin(
    newJoin->leftHash = AddHashedExpression(theEnv,leftHash);
    newJoin->rightHash = AddHashedExpression(theEnv,rightHash);
 
+   /*=========================================================*/
+   /* Range terms are installed by the caller for joins which */
+   /* enter from a pattern. They're conjuncts of the network  */
+   /* test, so joins sharing a network test can share them.   */
+   /*=========================================================*/
+
+   newJoin->rangeTest = NULL;
+
    /*============================================================*/
    /* Initialize the values associated with the LHS of the join. */
    /*============================================================*/
@@ -449,6 +449,13 @@ static void DefruleToCode(
    ExpressionToCode(theEnv,theFile,theDefrule->actions);
    fprintf(theFile,",");
 
+   /*=======*/
+   /* Phase */
+   /*=======*/
+
+   PrintSymbolReference(theEnv,theFile,theDefrule->phase);
+   fprintf(theFile,",");
+
    /*=========================*/
    /* Logical Dependency Join */
    /*=========================*/
@@ -548,6 +555,9 @@ static void JoinToCode(
    PrintHashedExpressionReference(theEnv,joinFile,theJoin->rightHash,imageID,maxIndices);
    fprintf(joinFile,",");
 
+   PrintHashedExpressionReference(theEnv,joinFile,theJoin->rangeTest,imageID,maxIndices);
+   fprintf(joinFile,",");
+
    /*============================*/
    /* Right Side Entry Structure */
    /*============================*/
@@ -69,6 +69,8 @@
 /*                                                           */
 /*            UDF redesign.                                  */
 /*                                                           */
+/*            Added optimize-rules command.                  */
+/*                                                           */
 /*************************************************************/
 
 #include <stdio.h>
@@ -95,6 +97,7 @@
 #include "reteutil.h"
 #include "router.h"
 #include "ruledlt.h"
+#include "ruleopt.h"
 #include "sysdep.h"
 #include "utility.h"
 #include "watch.h"
@@ -160,6 +163,10 @@ void DefruleCommands(
    AddUDF(theEnv,"get-strategy","y",0,0,NULL,GetStrategyCommand,"GetStrategyCommand",NULL);
    AddUDF(theEnv,"set-strategy","y",1,1,"y",SetStrategyCommand,"SetStrategyCommand",NULL);
 
+#if ! BLOAD_ONLY
+   AddUDF(theEnv,"optimize-rules","l",0,1,"y",OptimizeRulesCommand,"OptimizeRulesCommand",NULL);
+#endif
+
 #if DEVELOPER && (! BLOAD_ONLY)
    AddUDF(theEnv,"rule-complexity","l",1,1,"y",RuleComplexityCommand,"RuleComplexityCommand",NULL);
    AddUDF(theEnv,"show-joins","v",1,1,"y",ShowJoinsCommand,"ShowJoinsCommand",NULL);
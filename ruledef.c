@@ -84,6 +84,7 @@
 #include "rulecom.h"
 #include "rulepsr.h"
 #include "ruledlt.h"
+#include "rulephs.h"
 
 #if BLOAD || BLOAD_AND_BSAVE || BLOAD_ONLY
 #include "bload.h"
@@ -120,6 +121,7 @@ void InitializeDefrules(
 
    InitializeEngine(theEnv);
    InitializeAgenda(theEnv);
+   InitializeRulePhases(theEnv);
    InitializePatterns(theEnv);
    InitializeDefruleModules(theEnv);
 
@@ -206,6 +208,8 @@ static void DeallocateDefruleData(
          theGroup = tmpGroup;
         }
 
+      DestroyPhaseSequence(theEnv,theModuleItem);
+
 #if ! RUN_TIME
       rtn_struct(theEnv,defruleModule,theModuleItem);
 #endif
@@ -265,6 +269,7 @@ static void *AllocateModule(
    theItem = get_struct(theEnv,defruleModule);
    theItem->agenda = NULL;
    theItem->groupings = NULL;
+   theItem->phases = NULL;
    return((void *) theItem);
   }
 
@@ -276,6 +281,7 @@ static void ReturnModule(
   void *theItem)
   {
    FreeConstructHeaderModule(theEnv,(struct defmoduleItemHeader *) theItem,DefruleData(theEnv)->DefruleConstruct);
+   ReturnPhaseSequence(theEnv,(struct defruleModule *) theItem);
    rtn_struct(theEnv,defruleModule,theItem);
   }
 
@@ -66,6 +66,9 @@
 /*                                                           */
 /*            ALLOW_ENVIRONMENT_GLOBALS no longer supported. */
 /*                                                           */
+/*            Added the join plan of a rule being re-planned */
+/*            by optimize-rules.                             */
+/*                                                           */
 /*************************************************************/
 
 #ifndef _H_ruledef
@@ -78,6 +81,8 @@
 
 typedef struct defrule Defrule;
 struct defruleModule;
+struct joinPlan;
+struct phaseSequence;
 
 #include "constrct.h"
 #include "expressn.h"
@@ -97,6 +102,7 @@ struct defrule
    unsigned int executing       :  1;
    struct expr *dynamicSalience;
    struct expr *actions;
+   CLIPSLexeme *phase;
    struct joinNode *logicalJoin;
    struct joinNode *lastJoin;
    Defrule *disjunct;
@@ -115,6 +121,7 @@ struct defruleModule
    struct defmoduleItemHeader header;
    struct salienceGroup *groupings;
    struct activation *agenda;
+   struct phaseSequence *phases;
   };
 
 #ifndef ALPHA_MEMORY_HASH_SIZE
@@ -140,6 +147,9 @@ struct defruleData
 #if DEVELOPER && (! RUN_TIME) && (! BLOAD_ONLY)
     bool WatchRuleAnalysis;
 #endif
+#if (! RUN_TIME) && (! BLOAD_ONLY)
+   struct joinPlan *JoinPlan;
+#endif
 #if CONSTRUCT_COMPILER && (! RUN_TIME)
    struct CodeGeneratorItem *DefruleCodeItem;
 #endif
@@ -55,10 +55,12 @@
 #include "drive.h"
 #include "engine.h"
 #include "envrnmnt.h"
+#include "joinrng.h"
 #include "memalloc.h"
 #include "pattern.h"
 #include "reteutil.h"
 #include "retract.h"
+#include "rulephs.h"
 
 #include "ruledlt.h"
 
@@ -108,6 +110,9 @@ void ReturnDefrule(
 
    ClearRuleFromAgenda(theEnv,theDefrule);
 
+   if (theDefrule->phase != NULL)
+     { InvalidatePhaseIndex(theDefrule); }
+
    /*======================*/
    /* Get rid of the rule. */
    /*======================*/
@@ -162,6 +167,8 @@ void ReturnDefrule(
       /*===========================================*/
 
       ReleaseLexeme(theEnv,theDefrule->header.name);
+      if (theDefrule->phase != NULL)
+        { ReleaseLexeme(theEnv,theDefrule->phase); }
 
       /*========================================*/
       /* Get rid of the the rule's RHS actions. */
@@ -360,10 +367,15 @@ static void DetachJoins(
 #if (! RUN_TIME) && (! BLOAD_ONLY)
       if (! destroy)
         {
+         if ((join->rangeTest != NULL) && (join->rightSideEntryStructure != NULL) &&
+             (! join->joinFromTheRight))
+           { FlushRangeIndices(theEnv,(struct patternNodeHeader *) join->rightSideEntryStructure); }
+
          RemoveHashedExpression(theEnv,join->networkTest);
          RemoveHashedExpression(theEnv,join->secondaryNetworkTest);
          RemoveHashedExpression(theEnv,join->leftHash);
          RemoveHashedExpression(theEnv,join->rightHash);
+         RemoveHashedExpression(theEnv,join->rangeTest);
         }
 #endif
 
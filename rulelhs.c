@@ -32,6 +32,9 @@
 /*                                                           */
 /*            UDF redesign.                                  */
 /*                                                           */
+/*            Records the conditional elements of a rule     */
+/*            being re-planned by optimize-rules.            */
+/*                                                           */
 /*************************************************************/
 
 #include "setup.h"
@@ -56,6 +59,7 @@
 #include "reorder.h"
 #include "router.h"
 #include "ruledef.h"
+#include "ruleopt.h"
 #include "scanner.h"
 #include "symbol.h"
 
@@ -77,6 +81,7 @@
    static struct lhsParseNode    *SimplePatternParse(Environment *,const char *,struct token *,bool *);
    static void                    ParseSalience(Environment *,const char *,const char *,bool *);
    static void                    ParseAutoFocus(Environment *,const char *,bool *);
+   static void                    ParsePhase(Environment *,const char *,bool *);
 
 /*******************************************************************/
 /* ParseRuleLHS: Coordinates all the actions necessary for parsing */
@@ -101,6 +106,7 @@ struct lhsParseNode *ParseRuleLHS(
 
    PatternData(theEnv)->GlobalSalience = 0;
    PatternData(theEnv)->GlobalAutoFocus = false;
+   PatternData(theEnv)->GlobalPhase = NULL;
    PatternData(theEnv)->SalienceExpression = NULL;
 
    /*============================*/
@@ -117,6 +123,13 @@ struct lhsParseNode *ParseRuleLHS(
 
    if (*error) return NULL;
 
+   /*==========================================*/
+   /* Note the CEs of a rule being re-planned. */
+   /*==========================================*/
+
+   if (DefruleData(theEnv)->JoinPlan != NULL)
+     { RecordJoinPlanCEs(theEnv,theLHS); }
+
    /*====================================================*/
    /* Reorder the raw representation so that it consists */
    /* of at most a single top level OR CE containing one */
@@ -125,6 +138,9 @@ struct lhsParseNode *ParseRuleLHS(
 
    theLHS = ReorderPatterns(theEnv,theLHS,&result);
 
+   if (DefruleData(theEnv)->JoinPlan != NULL)
+     { AnalyzeJoinPlanCEs(theEnv,theLHS); }
+
    /*================================*/
    /* Return the LHS representation. */
    /*================================*/
@@ -216,6 +232,7 @@ static struct lhsParseNode *RuleBodyParse(
 /*                                                      */
 /* <rule-property> ::= (salience <integer-expression>)  */
 /* <rule-property> ::= (auto-focus TRUE | FALSE)        */
+/* <rule-property> ::= (phase <symbol>)                 */
 /********************************************************/
 static void DeclarationParse(
   Environment *theEnv,
@@ -226,7 +243,7 @@ static void DeclarationParse(
    struct token theToken;
    struct expr *packPtr;
    bool notDone = true;
-   bool salienceParsed = false, autoFocusParsed = false;
+   bool salienceParsed = false, autoFocusParsed = false, phaseParsed = false;
 
    /*===========================*/
    /* Next token must be a '('. */
@@ -298,6 +315,26 @@ static void DeclarationParse(
            }
         }
 
+      /*============================================*/
+      /* Parse a phase declaration if encountered.  */
+      /* The phase name is stored in GlobalPhase    */
+      /* and attached to each disjunct of the rule. */
+      /*============================================*/
+
+      else if (strcmp(theToken.lexemeValue->contents,"phase") == 0)
+        {
+         if (phaseParsed)
+           {
+            AlreadyParsedErrorMessage(theEnv,"phase declaration",NULL);
+            *error = true;
+           }
+         else
+           {
+            ParsePhase(theEnv,readSource,error);
+            phaseParsed = true;
+           }
+        }
+
       /*==========================================*/
       /* Otherwise the symbol does not correspond */
       /* to a valid rule property.                */
@@ -320,10 +357,10 @@ static void DeclarationParse(
          return;
         }
 
-      /*=======================================*/
-      /* Both the salience and auto-focus rule */
-      /* properties are closed with a ')'.     */
-      /*=======================================*/
+      /*===========================================*/
+      /* The salience, auto-focus, and phase rule  */
+      /* properties are all closed with a ')'.     */
+      /*===========================================*/
 
       GetToken(theEnv,readSource,&theToken);
       if (theToken.tknType != RIGHT_PARENTHESIS_TOKEN)
@@ -484,6 +521,34 @@ static void ParseAutoFocus(
      }
   }
 
+/**********************************************************/
+/* ParsePhase: Parses the rest of a defrule phase         */
+/*   declaration once the phase keyword has been parsed.  */
+/**********************************************************/
+static void ParsePhase(
+  Environment *theEnv,
+  const char *readSource,
+  bool *error)
+  {
+   struct token theToken;
+
+   /*==================================*/
+   /* The phase name must be a symbol. */
+   /*==================================*/
+
+   SavePPBuffer(theEnv," ");
+
+   GetToken(theEnv,readSource,&theToken);
+   if (theToken.tknType != SYMBOL_TOKEN)
+     {
+      SyntaxErrorMessage(theEnv,"phase statement");
+      *error = true;
+      return;
+     }
+
+   PatternData(theEnv)->GlobalPhase = theToken.lexemeValue;
+  }
+
 /*****************************************************************/
 /* LHSPattern: Parses a single conditional element found on the  */
 /*   LHS of a rule. Conditonal element types include pattern CEs */
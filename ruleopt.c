@@ -0,0 +1,1511 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  08/25/16            */
+   /*                                                     */
+   /*             RULE JOIN OPTIMIZATION MODULE           */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Re-plans the order in which the patterns of a    */
+/*   rule are joined using the cardinality of their alpha    */
+/*   memories and the selectivity observed for their joins.  */
+/*                                                           */
+/*   A rule is re-planned by reparsing its pretty print form */
+/*   to find the conditional elements which can be moved: a  */
+/*   positive pattern CE at the top level of the rule which  */
+/*   isn't within a logical CE. Patterns are only reordered  */
+/*   among a run of consecutive movable CEs, so not, exists, */
+/*   test, and logical CEs keep their position and all of    */
+/*   the variables bound before them. Within a run, a        */
+/*   pattern referring to a variable bound by an earlier     */
+/*   pattern of the run is only placed after a pattern       */
+/*   binding that variable.                                  */
+/*                                                           */
+/*   The cost of an order is the sum of the estimated sizes  */
+/*   of its partial matches. Each pattern contributes its    */
+/*   alpha memory count and, when it shares a variable with  */
+/*   the patterns before it, the fraction of the pairs its   */
+/*   join has let through. A new order is chosen greedily    */
+/*   and used only if it's estimated to be cheaper by a      */
+/*   margin of JOIN_PLAN_GAIN. The rule is then redefined    */
+/*   with its CEs rearranged and the activations for the     */
+/*   matches which had already fired are removed from the    */
+/*   agenda so that refraction is preserved. Rules with a    */
+/*   logical CE are left alone since redefining them would   */
+/*   remove the logical support of the facts they asserted.  */
+/*                                                           */
+/*************************************************************/
+
+#include "setup.h"
+
+#if DEFRULE_CONSTRUCT && (! RUN_TIME) && (! BLOAD_ONLY)
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "agenda.h"
+#include "argacces.h"
+#include "cstrcpsr.h"
+#include "crstrtgy.h"
+#include "engine.h"
+#include "envrnmnt.h"
+#include "memalloc.h"
+#include "moduldef.h"
+#include "pprint.h"
+#include "prntutil.h"
+#include "strngrtr.h"
+#include "utility.h"
+
+#if BLOAD || BLOAD_AND_BSAVE
+#include "bload.h"
+#endif
+
+#include "ruleopt.h"
+
+#define JOIN_PLAN_ROUTER "optimize-rules"
+#define KEY_FIELDS 3
+
+/***************************************************/
+/* planKey: Identifies an activation by the values */
+/*   of its partial match in the original order of */
+/*   the rule's patterns.                          */
+/***************************************************/
+struct planKey
+  {
+   unsigned long long hash;
+   size_t row;
+   bool used;
+  };
+
+/**************************************************/
+/* planKeySet: The recorded activations of a rule */
+/*   being replaced.                              */
+/**************************************************/
+struct planKeySet
+  {
+   struct planKey *keys;
+   unsigned long long *rows;
+   size_t keyCount;
+   unsigned short width;
+  };
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static unsigned short          CountPlanCEs(struct lhsParseNode *);
+   static void                    CollectPlanBindings(Environment *,struct joinPlanCE *,struct lhsParseNode *);
+   static void                    CollectPlanReferences(Environment *,struct joinPlanCE *,struct lhsParseNode *);
+   static void                    AddPlanVariable(Environment *,CLIPSLexeme ***,unsigned short *,
+                                                  unsigned short *,CLIPSLexeme *);
+   static bool                    PlanContains(CLIPSLexeme **,unsigned short,CLIPSLexeme *);
+   static void                    ReturnJoinPlan(Environment *,struct joinPlan *);
+   static bool                    ParseRuleText(Environment *,const char *,bool);
+   static bool                    FindPlanSpans(const char *,struct joinPlan *);
+   static size_t                  SkipPlanSpace(const char *,size_t);
+   static size_t                  SkipPlanToken(const char *,size_t);
+   static size_t                  SkipPlanForm(const char *,size_t);
+   static bool                    PlanJoins(Environment *,Defrule *,struct joinPlan *,unsigned short *);
+   static bool                    PlanRun(struct joinPlan *,unsigned short,unsigned short,
+                                          double *,double *,unsigned short *,
+                                          CLIPSLexeme **,unsigned short);
+   static bool                    PlanConnected(struct joinPlanCE *,CLIPSLexeme **,unsigned short);
+   static unsigned short          PlanPlace(struct joinPlanCE *,CLIPSLexeme **,unsigned short);
+   static unsigned long           AlphaMemoryCount(struct joinNode *);
+   static char                   *BuildPlanText(Environment *,const char *,struct joinPlan *,unsigned short *);
+   static void                    PlanKeyRow(PartialMatch *,unsigned short *,unsigned short,unsigned long long *);
+   static unsigned long long      HashPlanKeyRow(unsigned long long *,unsigned short);
+   static int                     ComparePlanKeys(const void *,const void *);
+   static void                    RecordPlanKeys(Environment *,Defrule *,struct planKeySet *);
+   static void                    PreserveRefraction(Environment *,Defrule *,struct planKeySet *,
+                                                     struct joinPlan *,unsigned short *);
+   static void                    ReturnPlanKeys(Environment *,struct planKeySet *);
+   static ConstructHeader        *PreviousRule(Defrule *);
+   static void                    RestoreRulePosition(Defrule *,ConstructHeader *);
+
+/********************************************/
+/* OptimizeRulesCommand: H/L access routine */
+/*   for the optimize-rules command.        */
+/********************************************/
+void OptimizeRulesCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   const char *ruleName;
+   Defrule *rulePtr;
+
+   if (UDFArgumentCount(context) == 0)
+     {
+      returnValue->integerValue = CreateInteger(theEnv,OptimizeRules(theEnv));
+      return;
+     }
+
+   ruleName = GetConstructName(context,"optimize-rules","rule name");
+   if (ruleName == NULL)
+     {
+      returnValue->integerValue = CreateInteger(theEnv,0);
+      return;
+     }
+
+   rulePtr = FindDefrule(theEnv,ruleName);
+   if (rulePtr == NULL)
+     {
+      CantFindItemErrorMessage(theEnv,"defrule",ruleName,true);
+      returnValue->integerValue = CreateInteger(theEnv,0);
+      return;
+     }
+
+   returnValue->integerValue = CreateInteger(theEnv,OptimizeDefrule(rulePtr) ? 1 : 0);
+  }
+
+/****************************************************/
+/* OptimizeRules: Re-plans the joins of every rule  */
+/*   in every module. Returns the number of rules   */
+/*   which were redefined with a new pattern order. */
+/****************************************************/
+unsigned int OptimizeRules(
+  Environment *theEnv)
+  {
+   Defmodule *theModule;
+   Defrule *theRule, **theRules;
+   unsigned int count = 0, i, optimized = 0;
+
+   /*==================================================*/
+   /* Collect the rules before any are redefined since */
+   /* the Defrule pointer of a redefined rule is no    */
+   /* longer valid.                                    */
+   /*==================================================*/
+
+   SaveCurrentModule(theEnv);
+
+   for (theModule = GetNextDefmodule(theEnv,NULL);
+        theModule != NULL;
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      SetCurrentModule(theEnv,theModule);
+      for (theRule = GetNextDefrule(theEnv,NULL);
+           theRule != NULL;
+           theRule = GetNextDefrule(theEnv,theRule))
+        { count++; }
+     }
+
+   if (count == 0)
+     {
+      RestoreCurrentModule(theEnv);
+      return 0;
+     }
+
+   theRules = (Defrule **) genalloc(theEnv,sizeof(Defrule *) * count);
+
+   for (theModule = GetNextDefmodule(theEnv,NULL), i = 0;
+        theModule != NULL;
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      SetCurrentModule(theEnv,theModule);
+      for (theRule = GetNextDefrule(theEnv,NULL);
+           theRule != NULL;
+           theRule = GetNextDefrule(theEnv,theRule))
+        { theRules[i++] = theRule; }
+     }
+
+   RestoreCurrentModule(theEnv);
+
+   for (i = 0; i < count; i++)
+     {
+      if (OptimizeDefrule(theRules[i]))
+        { optimized++; }
+     }
+
+   genfree(theEnv,theRules,sizeof(Defrule *) * count);
+
+   return optimized;
+  }
+
+/*****************************************************************/
+/* OptimizeDefrule: Re-plans the joins of a rule. If a cheaper   */
+/*   order is found, the rule is redefined with its patterns in  */
+/*   that order and true is returned, in which case the Defrule  */
+/*   pointer passed to this function is no longer valid.         */
+/*****************************************************************/
+bool OptimizeDefrule(
+  Defrule *theRule)
+  {
+   Environment *theEnv = theRule->header.env;
+   struct joinPlan thePlan;
+   unsigned short *order;
+   char *newText;
+   bool parsed;
+   CLIPSLexeme *ruleName;
+   Defmodule *theModule;
+   Defrule *newRule = NULL;
+   struct planKeySet theKeys;
+   ConstructHeader *previous;
+   bool afterBreakpoint, watchActivation, watchFiring;
+#if DEBUGGING_FUNCTIONS
+   bool watchAll;
+#endif
+
+   /*===============================================*/
+   /* A rule can only be re-planned if it can be    */
+   /* redefined from its pretty print form. A rule  */
+   /* with a logical CE isn't re-planned since the  */
+   /* facts logically supported by its partial      */
+   /* matches would lose their support when the old */
+   /* rule is deleted.                              */
+   /*===============================================*/
+
+   if ((theRule->header.ppForm == NULL) ||
+       (theRule->disjunct != NULL) ||
+       (theRule->logicalJoin != NULL) ||
+       (DefruleData(theEnv)->JoinPlan != NULL) ||
+       EngineData(theEnv)->JoinOperationInProgress ||
+       (! DefruleIsDeletable(theRule)))
+     { return false; }
+
+#if BLOAD || BLOAD_AND_BSAVE
+   if (Bloaded(theEnv))
+     { return false; }
+#endif
+
+   /*==============================================*/
+   /* Reparse the rule to determine which of its   */
+   /* CEs can be moved and the variables they use. */
+   /*==============================================*/
+
+   thePlan.valid = false;
+   thePlan.ceCount = 0;
+   thePlan.ces = NULL;
+
+   DefruleData(theEnv)->JoinPlan = &thePlan;
+   parsed = ParseRuleText(theEnv,theRule->header.ppForm,true);
+   DefruleData(theEnv)->JoinPlan = NULL;
+
+   if ((! parsed) || (! thePlan.valid) ||
+       (! FindPlanSpans(theRule->header.ppForm,&thePlan)))
+     {
+      ReturnJoinPlan(theEnv,&thePlan);
+      return false;
+     }
+
+   /*=====================================*/
+   /* Determine the new order of the CEs. */
+   /*=====================================*/
+
+   order = (unsigned short *) genalloc(theEnv,sizeof(unsigned short) * thePlan.ceCount);
+
+   if (! PlanJoins(theEnv,theRule,&thePlan,order))
+     {
+      genfree(theEnv,order,sizeof(unsigned short) * thePlan.ceCount);
+      ReturnJoinPlan(theEnv,&thePlan);
+      return false;
+     }
+
+   /*=================================================*/
+   /* Redefine the rule with its CEs in the new order */
+   /* if the rearranged rule is syntactically valid.  */
+   /*=================================================*/
+
+   newText = BuildPlanText(theEnv,theRule->header.ppForm,&thePlan,order);
+
+   if (ParseRuleText(theEnv,newText,true))
+     {
+      ruleName = theRule->header.name;
+      RetainLexeme(theEnv,ruleName);
+      theModule = theRule->header.whichModule->theModule;
+
+      /*=================================================*/
+      /* Remember the breakpoint, the watch flags, and   */
+      /* the position of the rule in its module so they  */
+      /* can be given to the replacement rule. Watching  */
+      /* activations is turned off while the rule is     */
+      /* replaced since its activations aren't changed   */
+      /* other than by the loss of refraction.           */
+      /*=================================================*/
+
+      previous = PreviousRule(theRule);
+      afterBreakpoint = theRule->afterBreakpoint;
+      watchActivation = theRule->watchActivation;
+      watchFiring = theRule->watchFiring;
+      theRule->watchActivation = false;
+#if DEBUGGING_FUNCTIONS
+      watchAll = AgendaData(theEnv)->WatchActivations;
+      AgendaData(theEnv)->WatchActivations = false;
+#endif
+
+      RecordPlanKeys(theEnv,theRule,&theKeys);
+
+      if (ParseRuleText(theEnv,newText,false))
+        {
+         SaveCurrentModule(theEnv);
+         SetCurrentModule(theEnv,theModule);
+         newRule = FindDefruleInModule(theEnv,ruleName->contents);
+         RestoreCurrentModule(theEnv);
+        }
+
+#if DEBUGGING_FUNCTIONS
+      AgendaData(theEnv)->WatchActivations = watchAll;
+#endif
+
+      if (newRule != NULL)
+        {
+         RestoreRulePosition(newRule,previous);
+         PreserveRefraction(theEnv,newRule,&theKeys,&thePlan,order);
+         newRule->afterBreakpoint = afterBreakpoint;
+         newRule->watchActivation = watchActivation;
+         newRule->watchFiring = watchFiring;
+        }
+
+      ReturnPlanKeys(theEnv,&theKeys);
+      ReleaseLexeme(theEnv,ruleName);
+     }
+
+   genfree(theEnv,newText,strlen(newText) + 1);
+   genfree(theEnv,order,sizeof(unsigned short) * thePlan.ceCount);
+   ReturnJoinPlan(theEnv,&thePlan);
+
+   return (newRule != NULL);
+  }
+
+/*************************************************************/
+/* RecordJoinPlanCEs: Called while reparsing a rule which is */
+/*   being re-planned with the CEs of the rule before they   */
+/*   are reordered. Records which CEs can be moved and the   */
+/*   index that identifies each one after reordering.        */
+/*************************************************************/
+void RecordJoinPlanCEs(
+  Environment *theEnv,
+  struct lhsParseNode *theLHS)
+  {
+   struct joinPlan *thePlan = DefruleData(theEnv)->JoinPlan;
+   struct lhsParseNode *theCE;
+   unsigned short i, whichCE = 0;
+
+   for (theCE = theLHS; theCE != NULL; theCE = theCE->bottom)
+     { thePlan->ceCount++; }
+
+   if (thePlan->ceCount == 0)
+     { return; }
+
+   thePlan->ces = (struct joinPlanCE *) genalloc(theEnv,sizeof(struct joinPlanCE) * thePlan->ceCount);
+   memset(thePlan->ces,0,sizeof(struct joinPlanCE) * thePlan->ceCount);
+
+   for (theCE = theLHS, i = 0; theCE != NULL; theCE = theCE->bottom, i++)
+     {
+      thePlan->ces[i].whichCE = whichCE + 1;
+      thePlan->ces[i].movable = ((theCE->pnType == PATTERN_CE_NODE) &&
+                                 (! theCE->negated) && (! theCE->exists) &&
+                                 (! theCE->logical));
+      whichCE += CountPlanCEs(theCE);
+     }
+
+   /*=========================================*/
+   /* The CE index of a parse node only holds */
+   /* 7 bits, so larger rules can't be mapped */
+   /* back to their CEs.                      */
+   /*=========================================*/
+
+   thePlan->valid = (whichCE < 128);
+  }
+
+/**************************************************************/
+/* AnalyzeJoinPlanCEs: Called while reparsing a rule which is */
+/*   being re-planned with the reordered CEs of the rule.     */
+/*   Records the pattern index of each movable CE and the     */
+/*   variables it binds and refers to.                        */
+/**************************************************************/
+void AnalyzeJoinPlanCEs(
+  Environment *theEnv,
+  struct lhsParseNode *theLHS)
+  {
+   struct joinPlan *thePlan = DefruleData(theEnv)->JoinPlan;
+   struct joinPlanCE *theCE;
+   struct lhsParseNode *thePattern, *theField;
+   unsigned short i, j, k;
+
+   if (! thePlan->valid) return;
+
+   /*=========================================*/
+   /* A rule with more than one disjunct (an  */
+   /* or CE) has more than one set of joins.  */
+   /*=========================================*/
+
+   if ((theLHS == NULL) || (theLHS->pnType != AND_CE_NODE))
+     {
+      thePlan->valid = false;
+      return;
+     }
+
+   for (i = 0; i < thePlan->ceCount; i++)
+     {
+      theCE = &thePlan->ces[i];
+      if (! theCE->movable) continue;
+
+      for (thePattern = theLHS->right;
+           thePattern != NULL;
+           thePattern = thePattern->bottom)
+        {
+         if ((thePattern->pnType == PATTERN_CE_NODE) &&
+             (thePattern->whichCE == theCE->whichCE))
+           { break; }
+        }
+
+      if ((thePattern == NULL) || thePattern->negated || thePattern->exists ||
+          (thePattern->beginNandDepth != 1) || (thePattern->endNandDepth != 1) ||
+          (thePattern->pattern < 1))
+        {
+         theCE->movable = false;
+         continue;
+        }
+
+      theCE->pattern = (unsigned short) thePattern->pattern;
+
+      /*===================================================*/
+      /* A pattern binds the variable to which its address */
+      /* is assigned and any variable which is the sole    */
+      /* constraint of a field. Every other variable is a  */
+      /* reference to a variable bound elsewhere.          */
+      /*===================================================*/
+
+      if (thePattern->value != NULL)
+        {
+         AddPlanVariable(theEnv,&theCE->binds,&theCE->bindCount,
+                         &theCE->bindSize,thePattern->lexemeValue);
+        }
+
+      for (theField = thePattern->right; theField != NULL; theField = theField->right)
+        { CollectPlanBindings(theEnv,theCE,theField); }
+
+      CollectPlanReferences(theEnv,theCE,thePattern->right);
+      CollectPlanReferences(theEnv,theCE,thePattern->expression);
+
+      for (j = 0, k = 0; j < theCE->referenceCount; j++)
+        {
+         if (! PlanContains(theCE->binds,theCE->bindCount,theCE->references[j]))
+           { theCE->references[k++] = theCE->references[j]; }
+        }
+      theCE->referenceCount = k;
+     }
+  }
+
+/*******************************************************/
+/* CountPlanCEs: Counts the pattern and test CEs in a  */
+/*   CE in the same manner as the CE index is assigned */
+/*   to parse nodes.                                   */
+/*******************************************************/
+static unsigned short CountPlanCEs(
+  struct lhsParseNode *theCE)
+  {
+   struct lhsParseNode *theChild;
+   unsigned short count = 0;
+
+   if ((theCE->pnType == PATTERN_CE_NODE) || (theCE->pnType == TEST_CE_NODE))
+     { return 1; }
+
+   for (theChild = theCE->right; theChild != NULL; theChild = theChild->bottom)
+     { count += CountPlanCEs(theChild); }
+
+   return count;
+  }
+
+/**************************************************************/
+/* CollectPlanBindings: Records the variable bound by a field */
+/*   of a pattern. A multifield slot is examined field by     */
+/*   field. Otherwise the field binds a variable only if the  */
+/*   variable is the first term of its only or'ed constraint. */
+/**************************************************************/
+static void CollectPlanBindings(
+  Environment *theEnv,
+  struct joinPlanCE *theCE,
+  struct lhsParseNode *theField)
+  {
+   struct lhsParseNode *theTerm;
+
+   if (theField->multifieldSlot)
+     {
+      for (theTerm = theField->bottom; theTerm != NULL; theTerm = theTerm->right)
+        { CollectPlanBindings(theEnv,theCE,theTerm); }
+      return;
+     }
+
+   theTerm = theField->bottom;
+   if ((theTerm == NULL) || (theTerm->bottom != NULL) || theTerm->negated)
+     { return; }
+
+   if ((theTerm->pnType == SF_VARIABLE_NODE) || (theTerm->pnType == MF_VARIABLE_NODE))
+     {
+      AddPlanVariable(theEnv,&theCE->binds,&theCE->bindCount,
+                      &theCE->bindSize,theTerm->lexemeValue);
+     }
+  }
+
+/**************************************************************/
+/* CollectPlanReferences: Records every variable used within  */
+/*   a group of parse nodes, including those in the predicate */
+/*   and return value constraints.                            */
+/**************************************************************/
+static void CollectPlanReferences(
+  Environment *theEnv,
+  struct joinPlanCE *theCE,
+  struct lhsParseNode *theNode)
+  {
+   for (; theNode != NULL; theNode = theNode->right)
+     {
+      if ((theNode->pnType == SF_VARIABLE_NODE) || (theNode->pnType == MF_VARIABLE_NODE))
+        {
+         AddPlanVariable(theEnv,&theCE->references,&theCE->referenceCount,
+                         &theCE->referenceSize,theNode->lexemeValue);
+        }
+
+      CollectPlanReferences(theEnv,theCE,theNode->bottom);
+      CollectPlanReferences(theEnv,theCE,theNode->expression);
+      CollectPlanReferences(theEnv,theCE,theNode->secondaryExpression);
+     }
+  }
+
+/***********************************************************/
+/* AddPlanVariable: Adds a variable to a list of variables */
+/*   if it's not already in the list.                      */
+/***********************************************************/
+static void AddPlanVariable(
+  Environment *theEnv,
+  CLIPSLexeme ***theList,
+  unsigned short *count,
+  unsigned short *size,
+  CLIPSLexeme *theVariable)
+  {
+   CLIPSLexeme **newList;
+
+   if ((theVariable == NULL) || PlanContains(*theList,*count,theVariable))
+     { return; }
+
+   if (*count == *size)
+     {
+      newList = (CLIPSLexeme **) genalloc(theEnv,sizeof(CLIPSLexeme *) * (*size + 4U));
+      if (*size != 0)
+        {
+         memcpy(newList,*theList,sizeof(CLIPSLexeme *) * *size);
+         genfree(theEnv,*theList,sizeof(CLIPSLexeme *) * *size);
+        }
+      *theList = newList;
+      *size += 4;
+     }
+
+   (*theList)[(*count)++] = theVariable;
+  }
+
+/********************************************************/
+/* PlanContains: Determines if a variable is in a list. */
+/********************************************************/
+static bool PlanContains(
+  CLIPSLexeme **theList,
+  unsigned short count,
+  CLIPSLexeme *theVariable)
+  {
+   unsigned short i;
+
+   for (i = 0; i < count; i++)
+     {
+      if (theList[i] == theVariable)
+        { return true; }
+     }
+
+   return false;
+  }
+
+/***********************************************/
+/* ReturnJoinPlan: Returns the data structures */
+/*   associated with a join plan.              */
+/***********************************************/
+static void ReturnJoinPlan(
+  Environment *theEnv,
+  struct joinPlan *thePlan)
+  {
+   unsigned short i;
+   struct joinPlanCE *theCE;
+
+   if (thePlan->ces == NULL) return;
+
+   for (i = 0; i < thePlan->ceCount; i++)
+     {
+      theCE = &thePlan->ces[i];
+      if (theCE->bindSize != 0)
+        { genfree(theEnv,theCE->binds,sizeof(CLIPSLexeme *) * theCE->bindSize); }
+      if (theCE->referenceSize != 0)
+        { genfree(theEnv,theCE->references,sizeof(CLIPSLexeme *) * theCE->referenceSize); }
+     }
+
+   genfree(theEnv,thePlan->ces,sizeof(struct joinPlanCE) * thePlan->ceCount);
+   thePlan->ces = NULL;
+  }
+
+/************************************************************/
+/* ParseRuleText: Parses the text of a defrule. If checking */
+/*   is specified, the rule is only checked for syntax and  */
+/*   isn't added to the KB. Returns true if the rule was    */
+/*   parsed without errors.                                 */
+/************************************************************/
+static bool ParseRuleText(
+  Environment *theEnv,
+  const char *theText,
+  bool checking)
+  {
+   struct token theToken;
+   bool rv = false, oldMode;
+   GCBlock gcb;
+
+   if (OpenStringSource(theEnv,JOIN_PLAN_ROUTER,theText,0) == false)
+     { return false; }
+
+   SaveCurrentModule(theEnv);
+   GCBlockStart(theEnv,&gcb);
+
+   GetToken(theEnv,JOIN_PLAN_ROUTER,&theToken);
+   if (theToken.tknType == LEFT_PARENTHESIS_TOKEN)
+     {
+      GetToken(theEnv,JOIN_PLAN_ROUTER,&theToken);
+      if ((theToken.tknType == SYMBOL_TOKEN) &&
+          (strcmp(theToken.lexemeValue->contents,"defrule") == 0))
+        {
+         oldMode = ConstructData(theEnv)->CheckSyntaxMode;
+         ConstructData(theEnv)->CheckSyntaxMode = checking;
+         rv = (ParseConstruct(theEnv,"defrule",JOIN_PLAN_ROUTER) == BE_NO_ERROR);
+         ConstructData(theEnv)->CheckSyntaxMode = oldMode;
+        }
+     }
+
+   CloseStringSource(theEnv,JOIN_PLAN_ROUTER);
+   DestroyPPBuffer(theEnv);
+
+   GCBlockEnd(theEnv,&gcb);
+   RestoreCurrentModule(theEnv);
+
+   return rv;
+  }
+
+/*************************************************************/
+/* FindPlanSpans: Finds the text of each CE in the pretty    */
+/*   print form of a rule. Returns false if the number of    */
+/*   CEs found differs from the number in the parsed rule.   */
+/*************************************************************/
+static bool FindPlanSpans(
+  const char *ppForm,
+  struct joinPlan *thePlan)
+  {
+   size_t pos, start, end;
+   unsigned short i = 0;
+
+   /*==================================*/
+   /* Skip (defrule, the rule name and */
+   /* the optional comment.            */
+   /*==================================*/
+
+   pos = SkipPlanSpace(ppForm,0);
+   if (ppForm[pos] != '(') return false;
+   pos = SkipPlanSpace(ppForm,SkipPlanToken(ppForm,pos + 1));
+   pos = SkipPlanSpace(ppForm,SkipPlanToken(ppForm,pos));
+   if (ppForm[pos] == '"')
+     { pos = SkipPlanSpace(ppForm,SkipPlanForm(ppForm,pos)); }
+
+   /*========================================*/
+   /* Find each CE up to the => separator.   */
+   /* The declare statement is not a CE.     */
+   /*========================================*/
+
+   while (true)
+     {
+      pos = SkipPlanSpace(ppForm,pos);
+      start = pos;
+
+      if (ppForm[pos] == '\0')
+        { return false; }
+      else if ((ppForm[pos] == '=') && (ppForm[pos+1] == '>'))
+        { break; }
+      else if (ppForm[pos] == '(')
+        {
+         end = SkipPlanForm(ppForm,pos);
+         pos = SkipPlanSpace(ppForm,pos + 1);
+         if ((strncmp(&ppForm[pos],"declare",7) == 0) &&
+             (SkipPlanToken(ppForm,pos) == pos + 7))
+           {
+            pos = end;
+            continue;
+           }
+        }
+      else if (ppForm[pos] == '?')
+        {
+         pos = SkipPlanSpace(ppForm,SkipPlanToken(ppForm,pos));
+         if ((ppForm[pos] != '<') || (ppForm[pos+1] != '-')) return false;
+         pos = SkipPlanSpace(ppForm,pos + 2);
+         if (ppForm[pos] != '(') return false;
+         end = SkipPlanForm(ppForm,pos);
+        }
+      else
+        { return false; }
+
+      if ((end == 0) || (i >= thePlan->ceCount)) return false;
+
+      thePlan->ces[i].begin = start;
+      thePlan->ces[i].end = end;
+      i++;
+      pos = end;
+     }
+
+   return (i == thePlan->ceCount);
+  }
+
+/*********************************************/
+/* SkipPlanSpace: Skips over the white space */
+/*   starting at a position in a string.     */
+/*********************************************/
+static size_t SkipPlanSpace(
+  const char *theText,
+  size_t pos)
+  {
+   while ((theText[pos] == ' ') || (theText[pos] == '\t') ||
+          (theText[pos] == '\n') || (theText[pos] == '\r'))
+     { pos++; }
+
+   return pos;
+  }
+
+/*****************************************************/
+/* SkipPlanToken: Skips over the characters up to    */
+/*   the next delimiter starting at a position in a  */
+/*   string.                                         */
+/*****************************************************/
+static size_t SkipPlanToken(
+  const char *theText,
+  size_t pos)
+  {
+   while ((theText[pos] != '\0') && (theText[pos] != ' ') &&
+          (theText[pos] != '\t') && (theText[pos] != '\n') &&
+          (theText[pos] != '\r') && (theText[pos] != '(') &&
+          (theText[pos] != ')') && (theText[pos] != '"'))
+     { pos++; }
+
+   return pos;
+  }
+
+/*************************************************************/
+/* SkipPlanForm: Skips over the string or parenthesized form */
+/*   starting at a position in a string. Returns the         */
+/*   position following the form or 0 if it isn't closed.    */
+/*************************************************************/
+static size_t SkipPlanForm(
+  const char *theText,
+  size_t pos)
+  {
+   unsigned long depth = 0;
+   bool inString = false;
+
+   for (; theText[pos] != '\0'; pos++)
+     {
+      if (inString)
+        {
+         if ((theText[pos] == '\\') && (theText[pos+1] != '\0'))
+           { pos++; }
+         else if (theText[pos] == '"')
+           {
+            inString = false;
+            if (depth == 0) return pos + 1;
+           }
+        }
+      else if (theText[pos] == '"')
+        { inString = true; }
+      else if (theText[pos] == '(')
+        { depth++; }
+      else if (theText[pos] == ')')
+        {
+         if (depth == 0) return 0;
+         if (--depth == 0) return pos + 1;
+        }
+     }
+
+   return 0;
+  }
+
+/************************************************************/
+/* PlanJoins: Determines the order in which the CEs of a    */
+/*   rule should be joined. Returns true if the order found */
+/*   differs from the current order of the CEs.             */
+/************************************************************/
+static bool PlanJoins(
+  Environment *theEnv,
+  Defrule *theRule,
+  struct joinPlan *thePlan,
+  unsigned short *order)
+  {
+   struct joinNode *theJoin, **theJoins;
+   struct joinPlanCE *theCE;
+   unsigned short joinCount = 0, i, j, k, varCount = 0, varSize = 0;
+   double *cardinality, *selectivity, known;
+   CLIPSLexeme **variables;
+   bool changed = false;
+
+   for (theJoin = theRule->lastJoin; theJoin != NULL; theJoin = theJoin->lastLevel)
+     { joinCount++; }
+
+   if (joinCount < 2) return false;
+
+   theJoins = (struct joinNode **) genalloc(theEnv,sizeof(struct joinNode *) * joinCount);
+   for (theJoin = theRule->lastJoin, i = joinCount; theJoin != NULL; theJoin = theJoin->lastLevel)
+     { theJoins[--i] = theJoin; }
+
+   cardinality = (double *) genalloc(theEnv,sizeof(double) * thePlan->ceCount);
+   selectivity = (double *) genalloc(theEnv,sizeof(double) * thePlan->ceCount);
+
+   /*=========================================================*/
+   /* Under the MEA strategy the first pattern determines the */
+   /* order of activations, so it has to remain the first.    */
+   /*=========================================================*/
+
+   if (GetStrategy(theEnv) == MEA_STRATEGY)
+     { thePlan->ces[0].movable = false; }
+
+   /*================================================*/
+   /* Gather the statistics for each movable CE: the */
+   /* number of entities in its alpha memory and the */
+   /* fraction of pairs its join lets through.       */
+   /*================================================*/
+
+   for (i = 0; i < thePlan->ceCount; i++)
+     {
+      theCE = &thePlan->ces[i];
+      order[i] = i;
+      varSize = (unsigned short) (varSize + theCE->bindCount + theCE->referenceCount);
+      if (! theCE->movable) continue;
+
+      if ((theCE->pattern > joinCount) ||
+          theJoins[theCE->pattern - 1]->joinFromTheRight)
+        {
+         theCE->movable = false;
+         continue;
+        }
+
+      theJoin = theJoins[theCE->pattern - 1];
+      cardinality[i] = (double) AlphaMemoryCount(theJoin);
+      if (cardinality[i] < 1.0) cardinality[i] = 1.0;
+
+      if ((! theJoin->firstJoin) && (theCE->pattern < joinCount) &&
+          (theJoin->memoryLeftAdds > 0))
+        {
+         selectivity[i] = (double) theJoins[theCE->pattern]->memoryLeftAdds;
+         if (selectivity[i] < 1.0) selectivity[i] = 1.0;
+         selectivity[i] /= (double) theJoin->memoryLeftAdds * cardinality[i];
+         if (selectivity[i] > 1.0) selectivity[i] = 1.0;
+        }
+      else
+        { selectivity[i] = -1.0; }
+     }
+
+   /*======================================================*/
+   /* The selectivity of the first and last joins can't be */
+   /* observed. Use the lowest selectivity of the joins of */
+   /* the CEs sharing a variable with them.                */
+   /*======================================================*/
+
+   for (i = 0; i < thePlan->ceCount; i++)
+     {
+      if ((! thePlan->ces[i].movable) || (selectivity[i] >= 0.0)) continue;
+
+      known = 1.0;
+      for (j = 0; j < thePlan->ceCount; j++)
+        {
+         if ((j == i) || (! thePlan->ces[j].movable) || (selectivity[j] < 0.0))
+           { continue; }
+
+         for (k = 0; k < thePlan->ces[j].bindCount; k++)
+           {
+            if (PlanContains(thePlan->ces[i].binds,thePlan->ces[i].bindCount,thePlan->ces[j].binds[k]) ||
+                PlanContains(thePlan->ces[i].references,thePlan->ces[i].referenceCount,thePlan->ces[j].binds[k]))
+              {
+               if (selectivity[j] < known) known = selectivity[j];
+               break;
+              }
+           }
+        }
+
+      selectivity[i] = -known;
+     }
+
+   for (i = 0; i < thePlan->ceCount; i++)
+     {
+      if (thePlan->ces[i].movable && (selectivity[i] < 0.0))
+        { selectivity[i] = -selectivity[i]; }
+     }
+
+   /*=======================================*/
+   /* Plan each run of consecutive movable  */
+   /* CEs. The variables bound by the CEs   */
+   /* before a run are known to be bound.   */
+   /*=======================================*/
+
+   if (varSize == 0) varSize = 1;
+   variables = (CLIPSLexeme **) genalloc(theEnv,sizeof(CLIPSLexeme *) * varSize);
+
+   for (i = 0; i < thePlan->ceCount; )
+     {
+      if (! thePlan->ces[i].movable)
+        {
+         i++;
+         continue;
+        }
+
+      for (j = i; (j < thePlan->ceCount) && thePlan->ces[j].movable; j++)
+        { /* Do Nothing */ }
+
+      if ((j - i) > 1)
+        {
+         for (k = 0, varCount = 0; k < i; k++)
+           {
+            if (thePlan->ces[k].movable)
+              { varCount = PlanPlace(&thePlan->ces[k],variables,varCount); }
+           }
+
+         if (PlanRun(thePlan,i,j,cardinality,selectivity,order,variables,varCount))
+           { changed = true; }
+        }
+
+      i = j;
+     }
+
+   genfree(theEnv,variables,sizeof(CLIPSLexeme *) * varSize);
+   genfree(theEnv,cardinality,sizeof(double) * thePlan->ceCount);
+   genfree(theEnv,selectivity,sizeof(double) * thePlan->ceCount);
+   genfree(theEnv,theJoins,sizeof(struct joinNode *) * joinCount);
+
+   return changed;
+  }
+
+/***************************************************************/
+/* PlanRun: Orders a run of movable CEs. Starting with the     */
+/*   variables bound before the run, the CE chosen next is the */
+/*   one which can be placed and gives the smallest estimated  */
+/*   number of partial matches. Returns true if the order was  */
+/*   changed.                                                  */
+/***************************************************************/
+static bool PlanRun(
+  struct joinPlan *thePlan,
+  unsigned short first,
+  unsigned short last,
+  double *cardinality,
+  double *selectivity,
+  unsigned short *order,
+  CLIPSLexeme **variables,
+  unsigned short varCount)
+  {
+   unsigned short i, j, k, step, best, startCount = varCount;
+   double size, next, bestNext = 0.0, oldCost = 0.0, newCost = 0.0;
+   struct joinPlanCE *theCE;
+   bool ready, bound, placed[128];
+
+   /*=====================================*/
+   /* Estimate the cost of the current    */
+   /* order of the CEs.                   */
+   /*=====================================*/
+
+   for (i = first, size = 1.0; i < last; i++)
+     {
+      theCE = &thePlan->ces[i];
+      size *= cardinality[i];
+      if (PlanConnected(theCE,variables,varCount))
+        { size *= selectivity[i]; }
+      oldCost += size;
+      varCount = PlanPlace(theCE,variables,varCount);
+     }
+
+   /*===========================================*/
+   /* Greedily choose the CE to be placed next. */
+   /*===========================================*/
+
+   varCount = startCount;
+   memset(placed,0,sizeof(placed));
+
+   for (step = 0, size = 1.0; step < (last - first); step++)
+     {
+      best = last;
+
+      for (i = first; i < last; i++)
+        {
+         if (placed[i - first]) continue;
+         theCE = &thePlan->ces[i];
+
+         /*===============================================*/
+         /* A variable bound by a CE which preceded this  */
+         /* one in the run must be bound by a placed CE.  */
+         /*===============================================*/
+
+         ready = true;
+         for (j = 0; ready && (j < theCE->referenceCount); j++)
+           {
+            for (k = first, bound = false; k < i; k++)
+              {
+               if (PlanContains(thePlan->ces[k].binds,thePlan->ces[k].bindCount,theCE->references[j]))
+                 {
+                  bound = true;
+                  break;
+                 }
+              }
+
+            if (! bound) continue;
+
+            for (k = first, bound = false; k < last; k++)
+              {
+               if (placed[k - first] &&
+                   PlanContains(thePlan->ces[k].binds,thePlan->ces[k].bindCount,theCE->references[j]))
+                 {
+                  bound = true;
+                  break;
+                 }
+              }
+
+            if (! bound) ready = false;
+           }
+
+         if (! ready) continue;
+
+         next = size * cardinality[i];
+         if (PlanConnected(theCE,variables,varCount))
+           { next *= selectivity[i]; }
+
+         if ((best == last) || (next < bestNext))
+           {
+            best = i;
+            bestNext = next;
+           }
+        }
+
+      if (best == last) return false;
+
+      placed[best - first] = true;
+      order[first + step] = best;
+      size = bestNext;
+      newCost += size;
+      varCount = PlanPlace(&thePlan->ces[best],variables,varCount);
+     }
+
+   /*====================================================*/
+   /* Keep the current order unless the new order is     */
+   /* estimated to be cheaper by a significant margin.   */
+   /*====================================================*/
+
+   for (i = first; i < last; i++)
+     {
+      if (order[i] != i) break;
+     }
+
+   if ((i < last) && (newCost < (oldCost * JOIN_PLAN_GAIN)))
+     { return true; }
+
+   for (i = first; i < last; i++)
+     { order[i] = i; }
+
+   return false;
+  }
+
+/************************************************************/
+/* PlanConnected: Determines if a CE uses any of a list of  */
+/*   variables which have already been bound.               */
+/************************************************************/
+static bool PlanConnected(
+  struct joinPlanCE *theCE,
+  CLIPSLexeme **variables,
+  unsigned short varCount)
+  {
+   unsigned short i;
+
+   for (i = 0; i < theCE->bindCount; i++)
+     {
+      if (PlanContains(variables,varCount,theCE->binds[i]))
+        { return true; }
+     }
+
+   for (i = 0; i < theCE->referenceCount; i++)
+     {
+      if (PlanContains(variables,varCount,theCE->references[i]))
+        { return true; }
+     }
+
+   return false;
+  }
+
+/*********************************************************/
+/* PlanPlace: Adds the variables bound by a CE to a list */
+/*   of bound variables. Returns the new list length.    */
+/*********************************************************/
+static unsigned short PlanPlace(
+  struct joinPlanCE *theCE,
+  CLIPSLexeme **variables,
+  unsigned short varCount)
+  {
+   unsigned short i;
+
+   for (i = 0; i < theCE->bindCount; i++)
+     {
+      if (! PlanContains(variables,varCount,theCE->binds[i]))
+        { variables[varCount++] = theCE->binds[i]; }
+     }
+
+   return varCount;
+  }
+
+/*************************************************************/
+/* AlphaMemoryCount: Counts the entities in the alpha memory */
+/*   on the right side of a join.                            */
+/*************************************************************/
+static unsigned long AlphaMemoryCount(
+  struct joinNode *theJoin)
+  {
+   struct alphaMemoryHash *theMemory;
+   PartialMatch *theMatch;
+   unsigned long count = 0;
+
+   for (theMemory = ((struct patternNodeHeader *) theJoin->rightSideEntryStructure)->firstHash;
+        theMemory != NULL;
+        theMemory = theMemory->nextHash)
+     {
+      for (theMatch = theMemory->alphaMemory;
+           theMatch != NULL;
+           theMatch = theMatch->nextInMemory)
+        { count++; }
+     }
+
+   return count;
+  }
+
+/***********************************************************/
+/* BuildPlanText: Creates the text of a rule with its CEs  */
+/*   rearranged. The text of the CE placed in each         */
+/*   position replaces the text of the CE originally there */
+/*   and the text between the CEs is left unchanged.       */
+/***********************************************************/
+static char *BuildPlanText(
+  Environment *theEnv,
+  const char *ppForm,
+  struct joinPlan *thePlan,
+  unsigned short *order)
+  {
+   size_t length = strlen(ppForm), pos = 0, gapEnd;
+   struct joinPlanCE *theCE;
+   unsigned short i;
+   char *theText;
+
+   theText = (char *) genalloc(theEnv,length + 1);
+
+   memcpy(theText,ppForm,thePlan->ces[0].begin);
+   pos = thePlan->ces[0].begin;
+
+   for (i = 0; i < thePlan->ceCount; i++)
+     {
+      theCE = &thePlan->ces[order[i]];
+      memcpy(&theText[pos],&ppForm[theCE->begin],theCE->end - theCE->begin);
+      pos += theCE->end - theCE->begin;
+
+      if ((i + 1) < thePlan->ceCount)
+        { gapEnd = thePlan->ces[i+1].begin; }
+      else
+        { gapEnd = length; }
+
+      memcpy(&theText[pos],&ppForm[thePlan->ces[i].end],gapEnd - thePlan->ces[i].end);
+      pos += gapEnd - thePlan->ces[i].end;
+     }
+
+   theText[pos] = '\0';
+
+   return theText;
+  }
+
+/************************************************************/
+/* RecordPlanKeys: Records the partial match of each of the */
+/*   activations of the rule being replaced.                */
+/************************************************************/
+static void RecordPlanKeys(
+  Environment *theEnv,
+  Defrule *theRule,
+  struct planKeySet *theSet)
+  {
+   struct defruleModule *theModuleItem;
+   struct joinNode *theJoin;
+   Activation *theActivation;
+   size_t i;
+
+   theSet->keys = NULL;
+   theSet->rows = NULL;
+   theSet->keyCount = 0;
+   theSet->width = 0;
+
+   for (theJoin = theRule->lastJoin; theJoin != NULL; theJoin = theJoin->lastLevel)
+     { theSet->width++; }
+
+   theModuleItem = (struct defruleModule *) theRule->header.whichModule;
+   for (theActivation = theModuleItem->agenda;
+        theActivation != NULL;
+        theActivation = theActivation->next)
+     {
+      if (theActivation->theRule == theRule)
+        { theSet->keyCount++; }
+     }
+
+   if (theSet->keyCount == 0) return;
+
+   theSet->keys = (struct planKey *) genalloc(theEnv,sizeof(struct planKey) * theSet->keyCount);
+   theSet->rows = (unsigned long long *)
+                  genalloc(theEnv,sizeof(unsigned long long) * theSet->keyCount * theSet->width * KEY_FIELDS);
+
+   for (theActivation = theModuleItem->agenda, i = 0;
+        theActivation != NULL;
+        theActivation = theActivation->next)
+     {
+      if (theActivation->theRule != theRule) continue;
+
+      PlanKeyRow(theActivation->basis,NULL,theSet->width,&theSet->rows[i * theSet->width * KEY_FIELDS]);
+      theSet->keys[i].hash = HashPlanKeyRow(&theSet->rows[i * theSet->width * KEY_FIELDS],theSet->width);
+      theSet->keys[i].row = i;
+      theSet->keys[i].used = false;
+      i++;
+     }
+
+   qsort(theSet->keys,theSet->keyCount,sizeof(struct planKey),ComparePlanKeys);
+  }
+
+/************************************************************/
+/* PreserveRefraction: Removes the activations of the       */
+/*   replacement rule which weren't activations of the rule */
+/*   it replaced. These are for matches for which the       */
+/*   original rule had already fired.                       */
+/************************************************************/
+static void PreserveRefraction(
+  Environment *theEnv,
+  Defrule *theRule,
+  struct planKeySet *theSet,
+  struct joinPlan *thePlan,
+  unsigned short *order)
+  {
+   struct defruleModule *theModuleItem;
+   Activation *theActivation, *nextActivation;
+   unsigned short *mapping, i, width = theSet->width;
+   unsigned long long *row, hash;
+   size_t low, high, middle;
+   bool found;
+
+   /*==================================================*/
+   /* Map the position of each pattern in the new rule */
+   /* to the position of the same pattern in the old.  */
+   /*==================================================*/
+
+   mapping = (unsigned short *) genalloc(theEnv,sizeof(unsigned short) * (width + 1U));
+   for (i = 0; i < width; i++)
+     { mapping[i] = i; }
+
+   for (i = 0; i < thePlan->ceCount; i++)
+     {
+      if (thePlan->ces[i].movable && (thePlan->ces[i].pattern <= width))
+        { mapping[thePlan->ces[i].pattern - 1] = (unsigned short) (thePlan->ces[order[i]].pattern - 1); }
+     }
+
+   row = (unsigned long long *) genalloc(theEnv,sizeof(unsigned long long) * (width + 1U) * KEY_FIELDS);
+
+   theModuleItem = (struct defruleModule *) theRule->header.whichModule;
+   for (theActivation = theModuleItem->agenda;
+        theActivation != NULL;
+        theActivation = nextActivation)
+     {
+      nextActivation = theActivation->next;
+      if (theActivation->theRule != theRule) continue;
+
+      PlanKeyRow(theActivation->basis,mapping,width,row);
+      hash = HashPlanKeyRow(row,width);
+
+      /*=================================================*/
+      /* Claim an unused recorded activation with the    */
+      /* same partial match. The keys are sorted by hash */
+      /* value, so the matching keys are adjacent.       */
+      /*=================================================*/
+
+      low = 0;
+      high = theSet->keyCount;
+      while (low < high)
+        {
+         middle = low + (high - low) / 2;
+         if (theSet->keys[middle].hash < hash) low = middle + 1;
+         else high = middle;
+        }
+
+      for (found = false;
+           (low < theSet->keyCount) && (theSet->keys[low].hash == hash);
+           low++)
+        {
+         if ((! theSet->keys[low].used) &&
+             (memcmp(&theSet->rows[theSet->keys[low].row * width * KEY_FIELDS],row,
+                     sizeof(unsigned long long) * width * KEY_FIELDS) == 0))
+           {
+            theSet->keys[low].used = true;
+            found = true;
+            break;
+           }
+        }
+
+      if (! found)
+        { RemoveActivation(theEnv,theActivation,true,true); }
+     }
+
+   genfree(theEnv,row,sizeof(unsigned long long) * (width + 1U) * KEY_FIELDS);
+   genfree(theEnv,mapping,sizeof(unsigned short) * (width + 1U));
+  }
+
+/*************************************************/
+/* PreviousRule: Returns the rule preceding a    */
+/*   rule in the list of rules for its module or */
+/*   NULL if the rule is the first in the list.  */
+/*************************************************/
+static ConstructHeader *PreviousRule(
+  Defrule *theRule)
+  {
+   ConstructHeader *theConstruct, *previous = NULL;
+
+   for (theConstruct = theRule->header.whichModule->firstItem;
+        (theConstruct != NULL) && (theConstruct != &theRule->header);
+        theConstruct = theConstruct->next)
+     { previous = theConstruct; }
+
+   return previous;
+  }
+
+/****************************************************/
+/* RestoreRulePosition: Moves a redefined rule from */
+/*   the end of the list of rules for its module to */
+/*   the position of the rule it replaced.          */
+/****************************************************/
+static void RestoreRulePosition(
+  Defrule *newRule,
+  ConstructHeader *previous)
+  {
+   struct defmoduleItemHeader *theItem = newRule->header.whichModule;
+   ConstructHeader *last;
+
+   if (((previous == NULL) && (theItem->firstItem == &newRule->header)) ||
+       ((previous != NULL) && (previous->next == &newRule->header)))
+     { return; }
+
+   /*===========================================*/
+   /* Remove the rule from the end of the list. */
+   /*===========================================*/
+
+   last = PreviousRule(newRule);
+   last->next = NULL;
+   theItem->lastItem = last;
+
+   /*================================================*/
+   /* Insert it after the rule which preceded the    */
+   /* rule it replaced, or first if there was none.  */
+   /*================================================*/
+
+   if (previous == NULL)
+     {
+      newRule->header.next = theItem->firstItem;
+      theItem->firstItem = &newRule->header;
+     }
+   else
+     {
+      newRule->header.next = previous->next;
+      previous->next = &newRule->header;
+     }
+  }
+
+/**************************************************/
+/* ReturnPlanKeys: Returns the recorded partial   */
+/*   matches of the activations of a rule.        */
+/**************************************************/
+static void ReturnPlanKeys(
+  Environment *theEnv,
+  struct planKeySet *theSet)
+  {
+   if (theSet->keyCount == 0) return;
+
+   genfree(theEnv,theSet->keys,sizeof(struct planKey) * theSet->keyCount);
+   genfree(theEnv,theSet->rows,sizeof(unsigned long long) * theSet->keyCount * theSet->width * KEY_FIELDS);
+   theSet->keyCount = 0;
+  }
+
+/************************************************************/
+/* PlanKeyRow: Stores the entity, time tag, and multifield  */
+/*   markers matched by each pattern of a partial match. If */
+/*   a mapping is given, each pattern's values are stored   */
+/*   at the mapped position.                                */
+/************************************************************/
+static void PlanKeyRow(
+  PartialMatch *theMatch,
+  unsigned short *mapping,
+  unsigned short width,
+  unsigned long long *row)
+  {
+   unsigned short i, position;
+   AlphaMatch *theAlpha;
+   MultifieldMarker *theMarker;
+   unsigned long long markerHash;
+
+   memset(row,0,sizeof(unsigned long long) * width * KEY_FIELDS);
+
+   for (i = 0; (i < theMatch->bcount) && (i < width); i++)
+     {
+      theAlpha = theMatch->binds[i].gm.theMatch;
+      if ((theAlpha == NULL) || (theAlpha->matchingItem == NULL)) continue;
+
+      position = (mapping == NULL) ? i : mapping[i];
+
+      for (theMarker = theAlpha->markers, markerHash = 0;
+           theMarker != NULL;
+           theMarker = theMarker->next)
+        {
+         markerHash = (markerHash * 31) + theMarker->whichField;
+         markerHash = (markerHash * 31) + theMarker->startPosition;
+         markerHash = (markerHash * 31) + theMarker->range;
+        }
+
+      row[position * KEY_FIELDS] = (unsigned long long) (uintptr_t) theAlpha->matchingItem;
+      row[position * KEY_FIELDS + 1] = theAlpha->matchingItem->timeTag;
+      row[position * KEY_FIELDS + 2] = markerHash;
+     }
+  }
+
+/*************************************************/
+/* HashPlanKeyRow: Computes a hash value for the */
+/*   values stored for a partial match.          */
+/*************************************************/
+static unsigned long long HashPlanKeyRow(
+  unsigned long long *row,
+  unsigned short width)
+  {
+   unsigned long long hash = 14695981039346656037ULL;
+   size_t i;
+
+   for (i = 0; i < (size_t) width * KEY_FIELDS; i++)
+     {
+      hash ^= row[i];
+      hash *= 1099511628211ULL;
+     }
+
+   return hash;
+  }
+
+/************************************************/
+/* ComparePlanKeys: Orders keys by hash value.  */
+/************************************************/
+static int ComparePlanKeys(
+  const void *first,
+  const void *second)
+  {
+   const struct planKey *key1 = (const struct planKey *) first;
+   const struct planKey *key2 = (const struct planKey *) second;
+
+   if (key1->hash < key2->hash) return -1;
+   if (key1->hash > key2->hash) return 1;
+   if (key1->row < key2->row) return -1;
+   if (key1->row > key2->row) return 1;
+   return 0;
+  }
+
+#endif /* DEFRULE_CONSTRUCT && (! RUN_TIME) && (! BLOAD_ONLY) */
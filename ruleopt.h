@@ -0,0 +1,55 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  08/25/16            */
+   /*                                                     */
+   /*         RULE JOIN OPTIMIZATION HEADER FILE          */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Re-plans the order in which the patterns of a    */
+/*   rule are joined using the cardinality of their alpha    */
+/*   memories and the selectivity observed for their joins.  */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_ruleopt
+
+#pragma once
+
+#define _H_ruleopt
+
+#include "reorder.h"
+#include "ruledef.h"
+
+#define JOIN_PLAN_GAIN 0.9
+
+struct joinPlanCE
+  {
+   bool movable;
+   unsigned short whichCE;
+   unsigned short pattern;
+   size_t begin;
+   size_t end;
+   unsigned short bindCount;
+   unsigned short bindSize;
+   CLIPSLexeme **binds;
+   unsigned short referenceCount;
+   unsigned short referenceSize;
+   CLIPSLexeme **references;
+  };
+
+struct joinPlan
+  {
+   bool valid;
+   unsigned short ceCount;
+   struct joinPlanCE *ces;
+  };
+
+   void                           OptimizeRulesCommand(Environment *,UDFContext *,UDFValue *);
+   unsigned int                   OptimizeRules(Environment *);
+   bool                           OptimizeDefrule(Defrule *);
+   void                           RecordJoinPlanCEs(Environment *,struct lhsParseNode *);
+   void                           AnalyzeJoinPlanCEs(Environment *,struct lhsParseNode *);
+
+#endif /* _H_ruleopt */
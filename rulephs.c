@@ -0,0 +1,892 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  08/25/16            */
+   /*                                                     */
+   /*              DEFRULE PHASE SEQUENCER                */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Maintains an ordered list of phases for each     */
+/*   module. A rule declared with (declare (phase <name>))   */
+/*   only places activations on the agenda while <name> is   */
+/*   the current phase of its module. Provides the           */
+/*   set-phases, get-phases, get-phase, set-phase, and       */
+/*   next-phase commands.                                    */
+/*                                                           */
+/*   Gating is done in AddActivation by comparing the rule's */
+/*   phase symbol with the module's current phase, so no     */
+/*   pattern matching is involved. Changing phases removes   */
+/*   the activations of the rules in the old phase and       */
+/*   activates the matches of the rules in the new phase in  */
+/*   the order the matches were completed, which gives the   */
+/*   same activations as a control fact that every rule of   */
+/*   the phase matches on.                                   */
+/*                                                           */
+/*************************************************************/
+
+#include "setup.h"
+
+#if DEFRULE_CONSTRUCT
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "agenda.h"
+#include "argacces.h"
+#include "constrct.h"
+#include "engine.h"
+#include "envrnmnt.h"
+#include "extnfunc.h"
+#include "memalloc.h"
+#include "moduldef.h"
+#include "multifld.h"
+#include "prntutil.h"
+#include "router.h"
+#include "ruledef.h"
+#include "symbol.h"
+
+#include "rulephs.h"
+
+/******************************************************/
+/* phaseMatch: A match of a rule entering its phase.  */
+/*   The time tag is the most recent one of the facts */
+/*   and instances in the match, which is when the    */
+/*   match was completed.                             */
+/******************************************************/
+struct phaseMatch
+  {
+   Defrule *theRule;
+   PartialMatch *theMatch;
+   unsigned long long timeTag;
+   unsigned long sequence;
+  };
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                    ResetRulePhases(Environment *,void *);
+   static void                    ChangePhase(Environment *,struct defruleModule *,unsigned short);
+   static void                    ActivatePhaseRules(Environment *,struct phaseSequence *);
+   static int                     ComparePhaseMatches(const void *,const void *);
+   static void                    BuildPhaseIndex(Environment *,struct defruleModule *);
+   static void                    ReturnPhaseIndex(Environment *,struct phaseSequence *);
+   static unsigned short          FindPhaseIndex(struct phaseSequence *,CLIPSLexeme *);
+   static bool                    PhaseChangeAllowed(Environment *,const char *);
+
+/**************************************************/
+/* InitializeRulePhases: Initializes the commands */
+/*   and reset function for the phase sequencer.  */
+/**************************************************/
+void InitializeRulePhases(
+  Environment *theEnv)
+  {
+   AddResetFunction(theEnv,"phases",ResetRulePhases,65,NULL);
+
+#if ! RUN_TIME
+   AddUDF(theEnv,"set-phases","v",0,UNBOUNDED,"ym",SetPhasesCommand,"SetPhasesCommand",NULL);
+   AddUDF(theEnv,"get-phases","m",0,0,NULL,GetPhasesCommand,"GetPhasesCommand",NULL);
+   AddUDF(theEnv,"get-phase","y",0,0,NULL,GetPhaseCommand,"GetPhaseCommand",NULL);
+   AddUDF(theEnv,"set-phase","b",1,1,"y",SetPhaseCommand,"SetPhaseCommand",NULL);
+   AddUDF(theEnv,"next-phase","y",0,0,NULL,NextPhaseCommand,"NextPhaseCommand",NULL);
+#endif
+  }
+
+/*******************************************************/
+/* ResetRulePhases: Phase reset routine for use with   */
+/*   the reset command. Each module with a phase       */
+/*   sequence is returned to the first of its phases.  */
+/*******************************************************/
+static void ResetRulePhases(
+  Environment *theEnv,
+  void *context)
+  {
+   Defmodule *theModule;
+   struct defruleModule *theModuleItem;
+
+   for (theModule = GetNextDefmodule(theEnv,NULL);
+        theModule != NULL;
+        theModule = GetNextDefmodule(theEnv,theModule))
+     {
+      theModuleItem = GetDefruleModuleItem(theEnv,theModule);
+      if ((theModuleItem->phases != NULL) &&
+          (theModuleItem->phases->count != 0))
+        { ChangePhase(theEnv,theModuleItem,0); }
+     }
+  }
+
+/*****************************************************/
+/* RulePhaseIsActive: Returns true if the phase of a */
+/*   rule is the current phase of its module. Rules  */
+/*   in a module without a phase sequence (or whose  */
+/*   sequence has run past its last phase) are never */
+/*   active.                                         */
+/*****************************************************/
+bool RulePhaseIsActive(
+  Defrule *theRule)
+  {
+   struct phaseSequence *theSequence;
+
+   theSequence = ((struct defruleModule *) theRule->header.whichModule)->phases;
+
+   if ((theSequence == NULL) ||
+       (theSequence->current >= theSequence->count))
+     { return false; }
+
+   return (theSequence->names[theSequence->current] == theRule->phase);
+  }
+
+/*******************************************************/
+/* InvalidatePhaseIndex: Called when a rule with a     */
+/*   phase declaration is added or removed so that the */
+/*   rule lists for the phases of its module are       */
+/*   rebuilt the next time the phase changes.          */
+/*******************************************************/
+void InvalidatePhaseIndex(
+  Defrule *theRule)
+  {
+   struct phaseSequence *theSequence;
+
+   theSequence = ((struct defruleModule *) theRule->header.whichModule)->phases;
+
+   if (theSequence != NULL)
+     { theSequence->indexValid = false; }
+  }
+
+/*******************************************************/
+/* ReturnPhaseSequence: Deallocates the phase sequence */
+/*   of a module. Called when a module is deleted.     */
+/*******************************************************/
+void ReturnPhaseSequence(
+  Environment *theEnv,
+  struct defruleModule *theModuleItem)
+  {
+   unsigned short i;
+
+   if (theModuleItem->phases == NULL) return;
+
+   for (i = 0; i < theModuleItem->phases->count; i++)
+     { ReleaseLexeme(theEnv,theModuleItem->phases->names[i]); }
+
+   DestroyPhaseSequence(theEnv,theModuleItem);
+  }
+
+/********************************************************/
+/* DestroyPhaseSequence: Deallocates the phase sequence */
+/*   of a module as a result of DestroyEnvironment. The */
+/*   phase names are not released.                      */
+/********************************************************/
+void DestroyPhaseSequence(
+  Environment *theEnv,
+  struct defruleModule *theModuleItem)
+  {
+   struct phaseSequence *theSequence = theModuleItem->phases;
+
+   if (theSequence == NULL) return;
+
+   ReturnPhaseIndex(theEnv,theSequence);
+
+   if (theSequence->count != 0)
+     { rm(theEnv,theSequence->names,sizeof(CLIPSLexeme *) * theSequence->count); }
+
+   rtn_struct(theEnv,phaseSequence,theSequence);
+   theModuleItem->phases = NULL;
+  }
+
+/****************************************************/
+/* AdvancePhase: Moves a module to the next phase   */
+/*   in its sequence. Returns false if the module   */
+/*   has no sequence or is already past the end of  */
+/*   it. Advancing from the last phase leaves the   */
+/*   module with no current phase.                  */
+/****************************************************/
+bool AdvancePhase(
+  Environment *theEnv,
+  struct defruleModule *theModuleItem)
+  {
+   struct phaseSequence *theSequence = theModuleItem->phases;
+
+   if ((theSequence == NULL) ||
+       (theSequence->current >= theSequence->count))
+     { return false; }
+
+   ChangePhase(theEnv,theModuleItem,(unsigned short) (theSequence->current + 1));
+
+   return true;
+  }
+
+/*******************************************************/
+/* AutoAdvancePhase: Called by the inference engine    */
+/*   when the agenda of the focus is empty. Moves the  */
+/*   module to its next phase if it isn't already in   */
+/*   the last one. Returns true if the phase changed.  */
+/*******************************************************/
+bool AutoAdvancePhase(
+  Environment *theEnv,
+  struct defruleModule *theModuleItem)
+  {
+   struct phaseSequence *theSequence = theModuleItem->phases;
+
+   if ((theSequence == NULL) ||
+       ((theSequence->current + 1U) >= theSequence->count))
+     { return false; }
+
+   ChangePhase(theEnv,theModuleItem,(unsigned short) (theSequence->current + 1));
+
+   return true;
+  }
+
+/*****************************************************************/
+/* ChangePhase: Makes the specified index the current phase of   */
+/*   a module. Activations of rules in the old phase are removed */
+/*   from the agenda and rules in the new phase are refreshed so */
+/*   that each of their matches receives an activation. An index */
+/*   equal to the phase count leaves no phase current.           */
+/*****************************************************************/
+static void ChangePhase(
+  Environment *theEnv,
+  struct defruleModule *theModuleItem,
+  unsigned short newIndex)
+  {
+   struct phaseSequence *theSequence = theModuleItem->phases;
+   Defrule *theRule;
+   struct partialMatch *theMatch, *nextMatch;
+   unsigned long i, b;
+
+   if (! theSequence->indexValid)
+     { BuildPhaseIndex(theEnv,theModuleItem); }
+
+   /*=================================================*/
+   /* Remove the activations of the old phase's rules */
+   /* by walking the matches of each rule's last join */
+   /* rather than the whole agenda.                   */
+   /*=================================================*/
+
+   if (theSequence->current < theSequence->count)
+     {
+      for (i = theSequence->ruleOffsets[theSequence->current];
+           i < theSequence->ruleOffsets[theSequence->current + 1];
+           i++)
+        {
+         for (theRule = theSequence->rules[i];
+              theRule != NULL;
+              theRule = theRule->disjunct)
+           {
+            for (b = 0; b < theRule->lastJoin->leftMemory->size; b++)
+              {
+               for (theMatch = theRule->lastJoin->leftMemory->beta[b];
+                    theMatch != NULL;
+                    theMatch = nextMatch)
+                 {
+                  nextMatch = theMatch->nextInMemory;
+                  if (theMatch->marker != NULL)
+                    { RemoveActivation(theEnv,(Activation *) theMatch->marker,true,true); }
+                 }
+              }
+           }
+        }
+     }
+
+   theSequence->current = newIndex;
+
+   /*=====================================*/
+   /* Activate the new phase's rules. The */
+   /* gate in AddActivation now lets them */
+   /* through.                            */
+   /*=====================================*/
+
+   if (theSequence->current < theSequence->count)
+     { ActivatePhaseRules(theEnv,theSequence); }
+  }
+
+/*****************************************************************/
+/* ActivatePhaseRules: Adds an activation for each match of the  */
+/*   rules in the current phase of a module. The matches are     */
+/*   activated in the order in which they were completed rather  */
+/*   than the order of the beta memory, so that the strategy     */
+/*   orders the activations the same way in every phase (and the */
+/*   same way as when a rule is active as its matches form).     */
+/*****************************************************************/
+static void ActivatePhaseRules(
+  Environment *theEnv,
+  struct phaseSequence *theSequence)
+  {
+   Defrule *theRule;
+   struct partialMatch *theMatch;
+   struct phaseMatch *theMatches;
+   unsigned long i, b, matchCount = 0, maxMatches = 0;
+   unsigned short j;
+   unsigned long long timeTag;
+
+   /*===================================*/
+   /* Count the matches which will need */
+   /* an activation in the new phase.   */
+   /*===================================*/
+
+   for (i = theSequence->ruleOffsets[theSequence->current];
+        i < theSequence->ruleOffsets[theSequence->current + 1];
+        i++)
+     {
+      for (theRule = theSequence->rules[i];
+           theRule != NULL;
+           theRule = theRule->disjunct)
+        {
+         for (b = 0; b < theRule->lastJoin->leftMemory->size; b++)
+           {
+            for (theMatch = theRule->lastJoin->leftMemory->beta[b];
+                 theMatch != NULL;
+                 theMatch = theMatch->nextInMemory)
+              {
+               if ((((struct joinNode *) theMatch->owner)->ruleToActivate != NULL) &&
+                   (theMatch->marker == NULL))
+                 { maxMatches++; }
+              }
+           }
+        }
+     }
+
+   if (maxMatches == 0) return;
+
+   /*==========================================*/
+   /* Collect the matches along with the most  */
+   /* recent time tag of each one's entities.  */
+   /*==========================================*/
+
+   theMatches = (struct phaseMatch *) genalloc(theEnv,sizeof(struct phaseMatch) * maxMatches);
+
+   for (i = theSequence->ruleOffsets[theSequence->current];
+        i < theSequence->ruleOffsets[theSequence->current + 1];
+        i++)
+     {
+      for (theRule = theSequence->rules[i];
+           theRule != NULL;
+           theRule = theRule->disjunct)
+        {
+         for (b = 0; b < theRule->lastJoin->leftMemory->size; b++)
+           {
+            for (theMatch = theRule->lastJoin->leftMemory->beta[b];
+                 theMatch != NULL;
+                 theMatch = theMatch->nextInMemory)
+              {
+               if ((((struct joinNode *) theMatch->owner)->ruleToActivate == NULL) ||
+                   (theMatch->marker != NULL))
+                 { continue; }
+
+               timeTag = 0;
+               for (j = 0; j < theMatch->bcount; j++)
+                 {
+                  if ((theMatch->binds[j].gm.theMatch != NULL) &&
+                      (theMatch->binds[j].gm.theMatch->matchingItem != NULL) &&
+                      (theMatch->binds[j].gm.theMatch->matchingItem->timeTag > timeTag))
+                    { timeTag = theMatch->binds[j].gm.theMatch->matchingItem->timeTag; }
+                 }
+
+               theMatches[matchCount].theRule = theRule;
+               theMatches[matchCount].theMatch = theMatch;
+               theMatches[matchCount].timeTag = timeTag;
+               theMatches[matchCount].sequence = matchCount;
+               matchCount++;
+              }
+           }
+        }
+     }
+
+   /*==================================================*/
+   /* Activate the matches from the oldest to newest.  */
+   /*==================================================*/
+
+   qsort(theMatches,matchCount,sizeof(struct phaseMatch),ComparePhaseMatches);
+
+   for (i = 0; i < matchCount; i++)
+     { AddActivation(theEnv,theMatches[i].theRule,theMatches[i].theMatch); }
+
+   genfree(theEnv,theMatches,sizeof(struct phaseMatch) * maxMatches);
+  }
+
+/*****************************************************/
+/* ComparePhaseMatches: Orders the matches of a new  */
+/*   phase by time tag. Matches with the same time   */
+/*   tag keep the order in which they were found.    */
+/*****************************************************/
+static int ComparePhaseMatches(
+  const void *first,
+  const void *second)
+  {
+   const struct phaseMatch *match1 = (const struct phaseMatch *) first;
+   const struct phaseMatch *match2 = (const struct phaseMatch *) second;
+
+   if (match1->timeTag != match2->timeTag)
+     { return (match1->timeTag < match2->timeTag) ? -1 : 1; }
+
+   if (match1->sequence < match2->sequence) return -1;
+   if (match1->sequence > match2->sequence) return 1;
+   return 0;
+  }
+
+/*****************************************************************/
+/* BuildPhaseIndex: Groups the phased rules of a module by phase */
+/*   so that a phase change only touches the rules involved.     */
+/*   Rules naming a phase missing from the sequence are skipped. */
+/*****************************************************************/
+static void BuildPhaseIndex(
+  Environment *theEnv,
+  struct defruleModule *theModuleItem)
+  {
+   struct phaseSequence *theSequence = theModuleItem->phases;
+   Defrule *theRule;
+   unsigned long *fill;
+   unsigned short i, phaseIndex;
+
+   ReturnPhaseIndex(theEnv,theSequence);
+
+   theSequence->ruleOffsets = (unsigned long *)
+      gm2(theEnv,sizeof(unsigned long) * (theSequence->count + 1U));
+   for (i = 0; i <= theSequence->count; i++)
+     { theSequence->ruleOffsets[i] = 0; }
+
+   /*=====================================*/
+   /* Count the rules in each phase. Only */
+   /* the first disjunct is recorded.     */
+   /*=====================================*/
+
+   for (theRule = (Defrule *) theModuleItem->header.firstItem;
+        theRule != NULL;
+        theRule = (Defrule *) theRule->header.next)
+     {
+      if (theRule->phase == NULL) continue;
+
+      phaseIndex = FindPhaseIndex(theSequence,theRule->phase);
+      if (phaseIndex < theSequence->count)
+        { theSequence->ruleOffsets[phaseIndex + 1]++; }
+     }
+
+   for (i = 1; i <= theSequence->count; i++)
+     { theSequence->ruleOffsets[i] += theSequence->ruleOffsets[i - 1]; }
+
+   /*===================================*/
+   /* Fill in the rules for each phase. */
+   /*===================================*/
+
+   if (theSequence->ruleOffsets[theSequence->count] != 0)
+     {
+      theSequence->rules = (Defrule **)
+         gm2(theEnv,sizeof(Defrule *) * theSequence->ruleOffsets[theSequence->count]);
+
+      fill = (unsigned long *) gm2(theEnv,sizeof(unsigned long) * theSequence->count);
+      for (i = 0; i < theSequence->count; i++)
+        { fill[i] = theSequence->ruleOffsets[i]; }
+
+      for (theRule = (Defrule *) theModuleItem->header.firstItem;
+           theRule != NULL;
+           theRule = (Defrule *) theRule->header.next)
+        {
+         if (theRule->phase == NULL) continue;
+
+         phaseIndex = FindPhaseIndex(theSequence,theRule->phase);
+         if (phaseIndex < theSequence->count)
+           { theSequence->rules[fill[phaseIndex]++] = theRule; }
+        }
+
+      rm(theEnv,fill,sizeof(unsigned long) * theSequence->count);
+     }
+
+   theSequence->indexValid = true;
+  }
+
+/*****************************************************/
+/* ReturnPhaseIndex: Deallocates the per phase rule  */
+/*   lists built by BuildPhaseIndex.                 */
+/*****************************************************/
+static void ReturnPhaseIndex(
+  Environment *theEnv,
+  struct phaseSequence *theSequence)
+  {
+   if (theSequence->ruleOffsets != NULL)
+     {
+      if (theSequence->rules != NULL)
+        { rm(theEnv,theSequence->rules,sizeof(Defrule *) * theSequence->ruleOffsets[theSequence->count]); }
+
+      rm(theEnv,theSequence->ruleOffsets,sizeof(unsigned long) * (theSequence->count + 1U));
+     }
+
+   theSequence->rules = NULL;
+   theSequence->ruleOffsets = NULL;
+   theSequence->indexValid = false;
+  }
+
+/*******************************************************/
+/* FindPhaseIndex: Returns the position of a phase in  */
+/*   a sequence or the phase count if it isn't there.  */
+/*******************************************************/
+static unsigned short FindPhaseIndex(
+  struct phaseSequence *theSequence,
+  CLIPSLexeme *thePhase)
+  {
+   unsigned short i;
+
+   for (i = 0; i < theSequence->count; i++)
+     {
+      if (theSequence->names[i] == thePhase)
+        { return i; }
+     }
+
+   return theSequence->count;
+  }
+
+/******************************************************/
+/* PhaseChangeAllowed: Phases may not be changed from */
+/*   within the pattern matching process since doing  */
+/*   so adds and removes activations.                 */
+/******************************************************/
+static bool PhaseChangeAllowed(
+  Environment *theEnv,
+  const char *functionName)
+  {
+   if (! EngineData(theEnv)->JoinOperationInProgress)
+     { return true; }
+
+   PrintErrorID(theEnv,"RULEPHS",1,true);
+   WriteString(theEnv,STDERR,"The function ");
+   WriteString(theEnv,STDERR,functionName);
+   WriteString(theEnv,STDERR," may not be called during pattern-matching.\n");
+   SetEvaluationError(theEnv,true);
+   return false;
+  }
+
+/*****************************************************/
+/* SetPhases: C access routine for the set-phases    */
+/*   command. Replaces the phase sequence of the     */
+/*   module and makes the first phase current. An    */
+/*   empty list removes the sequence, which leaves   */
+/*   every phased rule of the module inactive.       */
+/*   Returns false if a phase is listed twice.       */
+/*****************************************************/
+bool SetPhases(
+  Defmodule *theModule,
+  CLIPSLexeme **thePhases,
+  unsigned short phaseCount)
+  {
+   Environment *theEnv = theModule->header.env;
+   struct defruleModule *theModuleItem;
+   struct phaseSequence *theSequence;
+   unsigned short i, j;
+
+   for (i = 0; i < phaseCount; i++)
+     {
+      for (j = 0; j < i; j++)
+        {
+         if (thePhases[i] == thePhases[j])
+           { return false; }
+        }
+     }
+
+   theModuleItem = GetDefruleModuleItem(theEnv,theModule);
+
+   /*==================================*/
+   /* Leave the current phase (if any) */
+   /* and discard the old sequence.    */
+   /*==================================*/
+
+   if (theModuleItem->phases != NULL)
+     {
+      ChangePhase(theEnv,theModuleItem,theModuleItem->phases->count);
+      ReturnPhaseSequence(theEnv,theModuleItem);
+     }
+
+   if (phaseCount == 0) return true;
+
+   /*============================*/
+   /* Install the new sequence   */
+   /* and enter its first phase. */
+   /*============================*/
+
+   theSequence = get_struct(theEnv,phaseSequence);
+   theSequence->names = (CLIPSLexeme **) gm2(theEnv,sizeof(CLIPSLexeme *) * phaseCount);
+   for (i = 0; i < phaseCount; i++)
+     {
+      theSequence->names[i] = thePhases[i];
+      IncrementLexemeCount(thePhases[i]);
+     }
+   theSequence->count = phaseCount;
+   theSequence->current = phaseCount;
+   theSequence->indexValid = false;
+   theSequence->rules = NULL;
+   theSequence->ruleOffsets = NULL;
+   theModuleItem->phases = theSequence;
+
+   ChangePhase(theEnv,theModuleItem,0);
+
+   return true;
+  }
+
+/**************************************************/
+/* GetPhases: C access routine for the get-phases */
+/*   command. Returns the phase sequence of the   */
+/*   module as a multifield.                      */
+/**************************************************/
+void GetPhases(
+  Defmodule *theModule,
+  CLIPSValue *returnValue)
+  {
+   Environment *theEnv = theModule->header.env;
+   struct phaseSequence *theSequence;
+   Multifield *theList;
+   unsigned short i;
+
+   theSequence = GetDefruleModuleItem(theEnv,theModule)->phases;
+
+   if (theSequence == NULL)
+     {
+      returnValue->value = CreateMultifield(theEnv,0L);
+      return;
+     }
+
+   theList = CreateMultifield(theEnv,theSequence->count);
+   for (i = 0; i < theSequence->count; i++)
+     { theList->contents[i].lexemeValue = theSequence->names[i]; }
+
+   returnValue->multifieldValue = theList;
+  }
+
+/**************************************************/
+/* GetPhase: C access routine for the get-phase   */
+/*   command. Returns NULL if the module has no   */
+/*   current phase.                               */
+/**************************************************/
+const char *GetPhase(
+  Defmodule *theModule)
+  {
+   Environment *theEnv = theModule->header.env;
+   struct phaseSequence *theSequence;
+
+   theSequence = GetDefruleModuleItem(theEnv,theModule)->phases;
+
+   if ((theSequence == NULL) ||
+       (theSequence->current >= theSequence->count))
+     { return NULL; }
+
+   return theSequence->names[theSequence->current]->contents;
+  }
+
+/***************************************************/
+/* SetPhase: C access routine for the set-phase    */
+/*   command. Makes the named phase current, which */
+/*   re-enters it if it is already current.        */
+/*   Returns false if the phase isn't part of the  */
+/*   module's sequence.                            */
+/***************************************************/
+bool SetPhase(
+  Defmodule *theModule,
+  const char *phaseName)
+  {
+   Environment *theEnv = theModule->header.env;
+   struct defruleModule *theModuleItem;
+   CLIPSLexeme *thePhase;
+   unsigned short phaseIndex;
+
+   theModuleItem = GetDefruleModuleItem(theEnv,theModule);
+   if (theModuleItem->phases == NULL) return false;
+
+   thePhase = FindSymbolHN(theEnv,phaseName,SYMBOL_BIT);
+   if (thePhase == NULL) return false;
+
+   phaseIndex = FindPhaseIndex(theModuleItem->phases,thePhase);
+   if (phaseIndex >= theModuleItem->phases->count) return false;
+
+   ChangePhase(theEnv,theModuleItem,phaseIndex);
+   return true;
+  }
+
+/***************************************************/
+/* NextPhase: C access routine for the next-phase  */
+/*   command. Returns the name of the new current  */
+/*   phase or NULL if the end of the sequence has  */
+/*   been passed.                                  */
+/***************************************************/
+const char *NextPhase(
+  Defmodule *theModule)
+  {
+   Environment *theEnv = theModule->header.env;
+
+   AdvancePhase(theEnv,GetDefruleModuleItem(theEnv,theModule));
+
+   return GetPhase(theModule);
+  }
+
+/************************************************/
+/* SetPhasesCommand: H/L access routine for the */
+/*   set-phases command. Phases may be given as */
+/*   symbols or as multifields of symbols.      */
+/************************************************/
+void SetPhasesCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue *theArgs;
+   CLIPSLexeme **thePhases = NULL;
+   unsigned int argCount, a;
+   size_t phaseCount = 0, i;
+
+   if (! PhaseChangeAllowed(theEnv,"set-phases")) return;
+
+   /*==================================*/
+   /* Evaluate the arguments and count */
+   /* the phases being listed.         */
+   /*==================================*/
+
+   argCount = UDFArgumentCount(context);
+   theArgs = NULL;
+   if (argCount != 0)
+     { theArgs = (UDFValue *) gm2(theEnv,sizeof(UDFValue) * argCount); }
+
+   for (a = 0; a < argCount; a++)
+     {
+      if (! UDFNextArgument(context,SYMBOL_BIT | MULTIFIELD_BIT,&theArgs[a]))
+        {
+         rm(theEnv,theArgs,sizeof(UDFValue) * argCount);
+         return;
+        }
+
+      if (theArgs[a].header->type != MULTIFIELD_TYPE)
+        {
+         phaseCount++;
+         continue;
+        }
+
+      for (i = theArgs[a].begin; i < (theArgs[a].begin + theArgs[a].range); i++)
+        {
+         if (theArgs[a].multifieldValue->contents[i].header->type != SYMBOL_TYPE)
+           {
+            UDFInvalidArgumentMessage(context,"symbols or multifields of symbols");
+            SetEvaluationError(theEnv,true);
+            rm(theEnv,theArgs,sizeof(UDFValue) * argCount);
+            return;
+           }
+        }
+
+      phaseCount += theArgs[a].range;
+     }
+
+   if (phaseCount > USHRT_MAX)
+     {
+      PrintErrorID(theEnv,"RULEPHS",2,true);
+      WriteString(theEnv,STDERR,"A phase sequence may not have more than 65535 phases.\n");
+      SetEvaluationError(theEnv,true);
+      if (theArgs != NULL) rm(theEnv,theArgs,sizeof(UDFValue) * argCount);
+      return;
+     }
+
+   /*=====================*/
+   /* Collect the phases. */
+   /*=====================*/
+
+   if (phaseCount != 0)
+     {
+      thePhases = (CLIPSLexeme **) gm2(theEnv,sizeof(CLIPSLexeme *) * phaseCount);
+
+      for (a = 0, phaseCount = 0; a < argCount; a++)
+        {
+         if (theArgs[a].header->type == MULTIFIELD_TYPE)
+           {
+            for (i = theArgs[a].begin; i < (theArgs[a].begin + theArgs[a].range); i++)
+              { thePhases[phaseCount++] = theArgs[a].multifieldValue->contents[i].lexemeValue; }
+           }
+         else
+           { thePhases[phaseCount++] = theArgs[a].lexemeValue; }
+        }
+     }
+
+   if (theArgs != NULL)
+     { rm(theEnv,theArgs,sizeof(UDFValue) * argCount); }
+
+   if (! SetPhases(GetCurrentModule(theEnv),thePhases,(unsigned short) phaseCount))
+     {
+      PrintErrorID(theEnv,"RULEPHS",3,true);
+      WriteString(theEnv,STDERR,"A phase may only appear once in the phase sequence of a module.\n");
+      SetEvaluationError(theEnv,true);
+     }
+
+   if (thePhases != NULL)
+     { rm(theEnv,thePhases,sizeof(CLIPSLexeme *) * phaseCount); }
+  }
+
+/************************************************/
+/* GetPhasesCommand: H/L access routine for the */
+/*   get-phases command.                        */
+/************************************************/
+void GetPhasesCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   CLIPSValue result;
+
+   GetPhases(GetCurrentModule(theEnv),&result);
+   CLIPSToUDFValue(&result,returnValue);
+  }
+
+/***********************************************/
+/* GetPhaseCommand: H/L access routine for the */
+/*   get-phase command.                        */
+/***********************************************/
+void GetPhaseCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   const char *thePhase;
+
+   thePhase = GetPhase(GetCurrentModule(theEnv));
+
+   if (thePhase == NULL)
+     { returnValue->lexemeValue = FalseSymbol(theEnv); }
+   else
+     { returnValue->lexemeValue = CreateSymbol(theEnv,thePhase); }
+  }
+
+/***********************************************/
+/* SetPhaseCommand: H/L access routine for the */
+/*   set-phase command.                        */
+/***********************************************/
+void SetPhaseCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   UDFValue theArg;
+
+   returnValue->lexemeValue = FalseSymbol(theEnv);
+
+   if (! UDFFirstArgument(context,SYMBOL_BIT,&theArg))
+     { return; }
+
+   if (! PhaseChangeAllowed(theEnv,"set-phase")) return;
+
+   returnValue->lexemeValue = CreateBoolean(theEnv,SetPhase(GetCurrentModule(theEnv),theArg.lexemeValue->contents));
+  }
+
+/************************************************/
+/* NextPhaseCommand: H/L access routine for the */
+/*   next-phase command.                        */
+/************************************************/
+void NextPhaseCommand(
+  Environment *theEnv,
+  UDFContext *context,
+  UDFValue *returnValue)
+  {
+   const char *thePhase;
+
+   returnValue->lexemeValue = FalseSymbol(theEnv);
+
+   if (! PhaseChangeAllowed(theEnv,"next-phase")) return;
+
+   thePhase = NextPhase(GetCurrentModule(theEnv));
+
+   if (thePhase != NULL)
+     { returnValue->lexemeValue = CreateSymbol(theEnv,thePhase); }
+  }
+
+#endif /* DEFRULE_CONSTRUCT */
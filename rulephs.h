@@ -0,0 +1,57 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.40  08/25/16            */
+   /*                                                     */
+   /*          DEFRULE PHASE SEQUENCER HEADER FILE        */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Maintains an ordered list of phases for each     */
+/*   module. A rule declared with (declare (phase <name>))   */
+/*   only places activations on the agenda while <name> is   */
+/*   the current phase of its module. Provides the           */
+/*   set-phases, get-phases, get-phase, set-phase, and       */
+/*   next-phase commands.                                    */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_rulephs
+
+#pragma once
+
+#define _H_rulephs
+
+#include "moduldef.h"
+#include "ruledef.h"
+#include "symbol.h"
+
+struct phaseSequence
+  {
+   CLIPSLexeme **names;
+   unsigned short count;
+   unsigned short current;
+   bool indexValid;
+   Defrule **rules;
+   unsigned long *ruleOffsets;
+  };
+
+   void                           InitializeRulePhases(Environment *);
+   bool                           RulePhaseIsActive(Defrule *);
+   void                           InvalidatePhaseIndex(Defrule *);
+   void                           ReturnPhaseSequence(Environment *,struct defruleModule *);
+   void                           DestroyPhaseSequence(Environment *,struct defruleModule *);
+   bool                           AdvancePhase(Environment *,struct defruleModule *);
+   bool                           AutoAdvancePhase(Environment *,struct defruleModule *);
+   bool                           SetPhases(Defmodule *,CLIPSLexeme **,unsigned short);
+   void                           GetPhases(Defmodule *,CLIPSValue *);
+   const char                    *GetPhase(Defmodule *);
+   bool                           SetPhase(Defmodule *,const char *);
+   const char                    *NextPhase(Defmodule *);
+   void                           SetPhasesCommand(Environment *,UDFContext *,UDFValue *);
+   void                           GetPhasesCommand(Environment *,UDFContext *,UDFValue *);
+   void                           GetPhaseCommand(Environment *,UDFContext *,UDFValue *);
+   void                           SetPhaseCommand(Environment *,UDFContext *,UDFValue *);
+   void                           NextPhaseCommand(Environment *,UDFContext *,UDFValue *);
+
+#endif /* _H_rulephs */
@@ -79,6 +79,7 @@
 #include "ruledef.h"
 #include "ruledlt.h"
 #include "rulelhs.h"
+#include "rulephs.h"
 #include "scanner.h"
 #include "symbol.h"
 #include "watch.h"
@@ -256,6 +257,9 @@ bool ParseDefrule(
 
    AddToDefruleList(topDisjunct);
 
+   if (topDisjunct->phase != NULL)
+     { InvalidatePhaseIndex(topDisjunct); }
+
    /*========================================================================*/
    /* If a rule is redefined, then we want to restore its breakpoint status. */
    /*========================================================================*/
@@ -531,6 +535,9 @@ static Defrule *CreateNewDisjunct(
    newDisjunct->executing = 0;
    newDisjunct->complexity = complexity;
    newDisjunct->autoFocus = PatternData(theEnv)->GlobalAutoFocus;
+   newDisjunct->phase = PatternData(theEnv)->GlobalPhase;
+   if (newDisjunct->phase != NULL)
+     { IncrementLexemeCount(newDisjunct->phase); }
    newDisjunct->dynamicSalience = PatternData(theEnv)->SalienceExpression;
    newDisjunct->localVarCnt = localVarCnt;
 
@@ -1050,6 +1057,13 @@ void DumpRuleAnalysis(
          WriteString(theEnv,STDOUT,"\n");
         }
 
+      if (traceNode->rangeTest != NULL)
+        {
+         WriteString(theEnv,STDOUT,"       RT: ");
+         PrintExpression(theEnv,STDOUT,traceNode->rangeTest);
+         WriteString(theEnv,STDOUT,"\n");
+        }
+
       if (traceNode->betaHash != NULL)
         {
          WriteString(theEnv,STDOUT,"       BH: ");
@@ -88,6 +88,8 @@
 /*                                                           */
 /*            UDF redesign.                                  */
 /*                                                           */
+/*            Added PARALLEL_PATTERN_MATCHING flag.          */
+/*                                                           */
 /*************************************************************/
 
 #ifndef _H_setup
@@ -433,6 +435,18 @@
 #define PROFILING_FUNCTIONS 1
 #endif
 
+/****************************************************************/
+/* PARALLEL_PATTERN_MATCHING: Allows the pattern network tests  */
+/*   for facts asserted as a batch to be evaluated on POSIX     */
+/*   threads. See the set-pattern-match-workers command. This   */
+/*   is disabled by default since starting and joining the      */
+/*   threads has not been shown to cost less than it saves.     */
+/****************************************************************/
+
+#ifndef PARALLEL_PATTERN_MATCHING
+#define PARALLEL_PATTERN_MATCHING 0
+#endif
+
 /*******************************************************************/
 /* WINDOW_INTERFACE : Set this flag if you are recompiling any of  */
 /*   the machine specific GUI interfaces. Currently, when enabled, */
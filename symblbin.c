@@ -81,74 +81,53 @@ void WriteNeededAtomicValues(
 void InitAtomicValueNeededFlags(
   Environment *theEnv)
   {
-   unsigned long i;
-   CLIPSLexeme *symbolPtr, **symbolArray;
-   CLIPSFloat *floatPtr, **floatArray;
-   CLIPSInteger *integerPtr, **integerArray;
-   CLIPSBitMap *bitMapPtr, **bitMapArray;
+   size_t i;
+   struct atomTable *theTable;
+   CLIPSInteger *integerPtr;
 
    /*===============*/
    /* Mark symbols. */
    /*===============*/
 
-   symbolArray = GetSymbolTable(theEnv);
+   theTable = GetSymbolTable(theEnv);
 
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+   for (i = 0; i < theTable->size; i++)
      {
-      symbolPtr = symbolArray[i];
-      while (symbolPtr != NULL)
-        {
-         symbolPtr->neededSymbol = false;
-         symbolPtr = symbolPtr->next;
-        }
+      if (theTable->slots[i].value != NULL)
+        { ((CLIPSLexeme *) theTable->slots[i].value)->neededSymbol = false; }
      }
 
    /*==============*/
    /* Mark floats. */
    /*==============*/
 
-   floatArray = GetFloatTable(theEnv);
+   theTable = GetFloatTable(theEnv);
 
-   for (i = 0; i < FLOAT_HASH_SIZE; i++)
+   for (i = 0; i < theTable->size; i++)
      {
-      floatPtr = floatArray[i];
-      while (floatPtr != NULL)
-        {
-         floatPtr->neededFloat = false;
-         floatPtr = floatPtr->next;
-        }
+      if (theTable->slots[i].value != NULL)
+        { ((CLIPSFloat *) theTable->slots[i].value)->neededFloat = false; }
      }
 
    /*================*/
    /* Mark integers. */
    /*================*/
 
-   integerArray = GetIntegerTable(theEnv);
+   i = 0;
 
-   for (i = 0; i < INTEGER_HASH_SIZE; i++)
-     {
-      integerPtr = integerArray[i];
-      while (integerPtr != NULL)
-        {
-         integerPtr->neededInteger = false;
-         integerPtr = integerPtr->next;
-        }
-     }
+   while ((integerPtr = GetNextInteger(theEnv,&i)) != NULL)
+     { integerPtr->neededInteger = false; }
 
    /*===============*/
    /* Mark bitmaps. */
    /*===============*/
 
-   bitMapArray = GetBitMapTable(theEnv);
+   theTable = GetBitMapTable(theEnv);
 
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+   for (i = 0; i < theTable->size; i++)
      {
-      bitMapPtr = bitMapArray[i];
-      while (bitMapPtr != NULL)
-        {
-         bitMapPtr->neededBitMap = false;
-         bitMapPtr = bitMapPtr->next;
-        }
+      if (theTable->slots[i].value != NULL)
+        { ((CLIPSBitMap *) theTable->slots[i].value)->neededBitMap = false; }
      }
   }
 
@@ -160,9 +139,9 @@ void WriteNeededSymbols(
   Environment *theEnv,
   FILE *fp)
   {
-   unsigned long i;
+   size_t i;
    size_t length;
-   CLIPSLexeme **symbolArray;
+   struct atomTable *symbolTable;
    CLIPSLexeme *symbolPtr;
    unsigned long numberOfUsedSymbols = 0;
    size_t size = 0;
@@ -171,23 +150,19 @@ void WriteNeededSymbols(
    /* Get a copy of the symbol table. */
    /*=================================*/
 
-   symbolArray = GetSymbolTable(theEnv);
+   symbolTable = GetSymbolTable(theEnv);
 
    /*======================================================*/
    /* Get the number of symbols and the total string size. */
    /*======================================================*/
 
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+   for (i = 0; i < symbolTable->size; i++)
      {
-      for (symbolPtr = symbolArray[i];
-           symbolPtr != NULL;
-           symbolPtr = symbolPtr->next)
+      symbolPtr = (CLIPSLexeme *) symbolTable->slots[i].value;
+      if ((symbolPtr != NULL) && symbolPtr->neededSymbol)
         {
-         if (symbolPtr->neededSymbol)
-           {
-            numberOfUsedSymbols++;
-            size += strlen(symbolPtr->contents) + 1;
-           }
+         numberOfUsedSymbols++;
+         size += strlen(symbolPtr->contents) + 1;
         }
      }
 
@@ -202,32 +177,24 @@ void WriteNeededSymbols(
    /* Write out the symbol types. */
    /*=============================*/
    
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+   for (i = 0; i < symbolTable->size; i++)
      {
-      for (symbolPtr = symbolArray[i];
-           symbolPtr != NULL;
-           symbolPtr = symbolPtr->next)
-        {
-         if (symbolPtr->neededSymbol)
-           { GenWrite(&symbolPtr->header.type,sizeof(unsigned short),fp); }
-        }
+      symbolPtr = (CLIPSLexeme *) symbolTable->slots[i].value;
+      if ((symbolPtr != NULL) && symbolPtr->neededSymbol)
+        { GenWrite(&symbolPtr->header.type,sizeof(unsigned short),fp); }
      }
      
    /*========================*/
    /* Write out the symbols. */
    /*========================*/
    
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+   for (i = 0; i < symbolTable->size; i++)
      {
-      for (symbolPtr = symbolArray[i];
-           symbolPtr != NULL;
-           symbolPtr = symbolPtr->next)
+      symbolPtr = (CLIPSLexeme *) symbolTable->slots[i].value;
+      if ((symbolPtr != NULL) && symbolPtr->neededSymbol)
         {
-         if (symbolPtr->neededSymbol)
-           {
-            length = strlen(symbolPtr->contents) + 1;
-            GenWrite((void *) symbolPtr->contents,length,fp);
-           }
+         length = strlen(symbolPtr->contents) + 1;
+         GenWrite((void *) symbolPtr->contents,length,fp);
         }
      }
   }
@@ -240,8 +207,8 @@ void WriteNeededFloats(
   Environment *theEnv,
   FILE *fp)
   {
-   int i;
-   CLIPSFloat **floatArray;
+   size_t i;
+   struct atomTable *floatTable;
    CLIPSFloat *floatPtr;
    unsigned long numberOfUsedFloats = 0;
 
@@ -249,18 +216,17 @@ void WriteNeededFloats(
    /* Get a copy of the float table. */
    /*================================*/
 
-   floatArray = GetFloatTable(theEnv);
+   floatTable = GetFloatTable(theEnv);
 
    /*===========================*/
    /* Get the number of floats. */
    /*===========================*/
 
-   for (i = 0; i < FLOAT_HASH_SIZE; i++)
+   for (i = 0; i < floatTable->size; i++)
      {
-      for (floatPtr = floatArray[i];
-           floatPtr != NULL;
-           floatPtr = floatPtr->next)
-        { if (floatPtr->neededFloat) numberOfUsedFloats++; }
+      floatPtr = (CLIPSFloat *) floatTable->slots[i].value;
+      if ((floatPtr != NULL) && floatPtr->neededFloat)
+        { numberOfUsedFloats++; }
      }
 
    /*======================================================*/
@@ -269,16 +235,12 @@ void WriteNeededFloats(
 
    GenWrite(&numberOfUsedFloats,sizeof(unsigned long),fp);
 
-   for (i = 0 ; i < FLOAT_HASH_SIZE; i++)
+   for (i = 0 ; i < floatTable->size; i++)
      {
-      for (floatPtr = floatArray[i];
-           floatPtr != NULL;
-           floatPtr = floatPtr->next)
-        {
-         if (floatPtr->neededFloat)
-           { GenWrite(&floatPtr->contents,
-                      sizeof(floatPtr->contents),fp); }
-        }
+      floatPtr = (CLIPSFloat *) floatTable->slots[i].value;
+      if ((floatPtr != NULL) && floatPtr->neededFloat)
+        { GenWrite(&floatPtr->contents,
+                   sizeof(floatPtr->contents),fp); }
      }
   }
 
@@ -290,29 +252,19 @@ void WriteNeededIntegers(
   Environment *theEnv,
   FILE *fp)
   {
-   int i;
-   CLIPSInteger **integerArray;
+   size_t i;
    CLIPSInteger *integerPtr;
    unsigned long numberOfUsedIntegers = 0;
 
-   /*==================================*/
-   /* Get a copy of the integer table. */
-   /*==================================*/
-
-   integerArray = GetIntegerTable(theEnv);
-
    /*=============================*/
    /* Get the number of integers. */
    /*=============================*/
 
-   for (i = 0 ; i < INTEGER_HASH_SIZE; i++)
+   i = 0;
+   while ((integerPtr = GetNextInteger(theEnv,&i)) != NULL)
      {
-      for (integerPtr = integerArray[i];
-           integerPtr != NULL;
-           integerPtr = integerPtr->next)
-        {
-         if (integerPtr->neededInteger) numberOfUsedIntegers++;
-        }
+      if (integerPtr->neededInteger)
+        { numberOfUsedIntegers++; }
      }
 
    /*==========================================================*/
@@ -321,17 +273,13 @@ void WriteNeededIntegers(
 
    GenWrite(&numberOfUsedIntegers,sizeof(unsigned long),fp);
 
-   for (i = 0 ; i < INTEGER_HASH_SIZE; i++)
+   i = 0;
+   while ((integerPtr = GetNextInteger(theEnv,&i)) != NULL)
      {
-      for (integerPtr = integerArray[i];
-           integerPtr != NULL;
-           integerPtr = integerPtr->next)
+      if (integerPtr->neededInteger)
         {
-         if (integerPtr->neededInteger)
-           {
-            GenWrite(&integerPtr->contents,
-                     sizeof(integerPtr->contents),fp);
-           }
+         GenWrite(&integerPtr->contents,
+                  sizeof(integerPtr->contents),fp);
         }
      }
   }
@@ -344,8 +292,8 @@ static void WriteNeededBitMaps(
   Environment *theEnv,
   FILE *fp)
   {
-   int i;
-   CLIPSBitMap **bitMapArray;
+   size_t i;
+   struct atomTable *bitMapTable;
    CLIPSBitMap *bitMapPtr;
    unsigned long numberOfUsedBitMaps = 0, size = 0;
    unsigned short tempSize;
@@ -354,23 +302,19 @@ static void WriteNeededBitMaps(
    /* Get a copy of the bitmap table. */
    /*=================================*/
 
-   bitMapArray = GetBitMapTable(theEnv);
+   bitMapTable = GetBitMapTable(theEnv);
 
    /*======================================================*/
    /* Get the number of bitmaps and the total bitmap size. */
    /*======================================================*/
 
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+   for (i = 0; i < bitMapTable->size; i++)
      {
-      for (bitMapPtr = bitMapArray[i];
-           bitMapPtr != NULL;
-           bitMapPtr = bitMapPtr->next)
+      bitMapPtr = (CLIPSBitMap *) bitMapTable->slots[i].value;
+      if ((bitMapPtr != NULL) && bitMapPtr->neededBitMap)
         {
-         if (bitMapPtr->neededBitMap)
-           {
-            numberOfUsedBitMaps++;
-            size += (unsigned long) (bitMapPtr->size + sizeof(unsigned short));
-           }
+         numberOfUsedBitMaps++;
+         size += (unsigned long) (bitMapPtr->size + sizeof(unsigned short));
         }
      }
 
@@ -381,18 +325,14 @@ static void WriteNeededBitMaps(
    GenWrite(&numberOfUsedBitMaps,sizeof(unsigned long),fp);
    GenWrite(&size,sizeof(unsigned long),fp);
 
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+   for (i = 0; i < bitMapTable->size; i++)
      {
-      for (bitMapPtr = bitMapArray[i];
-           bitMapPtr != NULL;
-           bitMapPtr = bitMapPtr->next)
+      bitMapPtr = (CLIPSBitMap *) bitMapTable->slots[i].value;
+      if ((bitMapPtr != NULL) && bitMapPtr->neededBitMap)
         {
-         if (bitMapPtr->neededBitMap)
-           {
-            tempSize = bitMapPtr->size;
-            GenWrite(&tempSize,sizeof(unsigned short),fp);
-            GenWrite((void *) bitMapPtr->contents,bitMapPtr->size,fp);
-           }
+         tempSize = bitMapPtr->size;
+         GenWrite(&tempSize,sizeof(unsigned short),fp);
+         GenWrite((void *) bitMapPtr->contents,bitMapPtr->size,fp);
         }
      }
   }
@@ -75,6 +75,8 @@
    static unsigned int                FloatHashNodesToCode(Environment *,const char *,const char *,char *,unsigned int);
    static unsigned int                IntegerHashNodesToCode(Environment *,const char *,const char *,char *,unsigned int);
    static int                         HashTablesToCode(Environment *,const char *,const char *,char *);
+   static GENERIC_HN                **ThreadAtomChains(Environment *,struct atomTable *,size_t);
+   static GENERIC_HN                **ThreadIntegerChains(Environment *);
    static void                        PrintCString(FILE *,const char *);
 
 /**************************************************************/
@@ -116,7 +118,7 @@ static unsigned int SymbolHashNodesToCode(
    CLIPSLexeme *hashPtr;
    unsigned int count;
    unsigned int numberOfEntries;
-   CLIPSLexeme **symbolTable;
+   struct atomTable *symbolTable;
    bool newHeader = true;
    int arrayVersion = 1;
    FILE *fp;
@@ -128,13 +130,7 @@ static unsigned int SymbolHashNodesToCode(
    symbolTable = GetSymbolTable(theEnv);
    count = numberOfEntries = 0;
 
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
-     {
-      for (hashPtr = symbolTable[i];
-           hashPtr != NULL;
-           hashPtr = hashPtr->next)
-        { numberOfEntries++; }
-     }
+   numberOfEntries = (unsigned int) symbolTable->count;
 
    if (numberOfEntries == 0) return version;
 
@@ -153,58 +149,50 @@ static unsigned int SymbolHashNodesToCode(
 
    j = 0;
 
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+   for (i = 0; i < symbolTable->size; i++)
      {
-      for (hashPtr = symbolTable[i];
-           hashPtr != NULL;
-           hashPtr = hashPtr->next)
+      hashPtr = (CLIPSLexeme *) symbolTable->slots[i].value;
+      if (hashPtr == NULL) continue;
+
+      if (newHeader)
         {
-         if (newHeader)
-           {
-            fprintf(fp,"CLIPSLexeme S%d_%d[] = {\n",ConstructCompilerData(theEnv)->ImageID,arrayVersion);
-            newHeader = false;
-           }
+         fprintf(fp,"CLIPSLexeme S%d_%d[] = {\n",ConstructCompilerData(theEnv)->ImageID,arrayVersion);
+         newHeader = false;
+        }
 
-         if (hashPtr->header.type == SYMBOL_TYPE)
-           { fprintf(fp,"{{SYMBOL_TYPE},"); }
-         else if (hashPtr->header.type == STRING_TYPE)
-           { fprintf(fp,"{{STRING_TYPE},"); }
-         else
-           { fprintf(fp,"{{INSTANCE_NAME_TYPE},"); }
-           
-         if (hashPtr->next == NULL)
-           { fprintf(fp,"NULL,"); }
-         else
-           {
-            if ((j + 1) >= (unsigned long) ConstructCompilerData(theEnv)->MaxIndices)
-              { fprintf(fp,"&S%d_%d[%d],",ConstructCompilerData(theEnv)->ImageID,arrayVersion + 1,0); }
-            else
-              { fprintf(fp,"&S%d_%d[%ld],",ConstructCompilerData(theEnv)->ImageID,arrayVersion,j + 1); }
-           }
+      if (hashPtr->header.type == SYMBOL_TYPE)
+        { fprintf(fp,"{{SYMBOL_TYPE},"); }
+      else if (hashPtr->header.type == STRING_TYPE)
+        { fprintf(fp,"{{STRING_TYPE},"); }
+      else
+        { fprintf(fp,"{{INSTANCE_NAME_TYPE},"); }
+        
+      PrintSymbolReference(theEnv,fp,hashPtr->next);
+      fprintf(fp,",");
 
-         fprintf(fp,"%ld,1,0,0,%ld,",hashPtr->count + 1,i);
-         PrintCString(fp,hashPtr->contents);
+      fprintf(fp,"%ld,1,0,0,%lu,",hashPtr->count + 1,
+                 (unsigned long) (symbolTable->slots[i].hashValue % SYMBOL_HASH_SIZE));
+      PrintCString(fp,hashPtr->contents);
 
-         count++;
-         j++;
+      count++;
+      j++;
 
-         if ((count == numberOfEntries) || (j >= ConstructCompilerData(theEnv)->MaxIndices))
+      if ((count == numberOfEntries) || (j >= ConstructCompilerData(theEnv)->MaxIndices))
+        {
+         fprintf(fp,"}};\n");
+         GenClose(theEnv,fp);
+         j = 0;
+         arrayVersion++;
+         version++;
+         if (count < numberOfEntries)
            {
-            fprintf(fp,"}};\n");
-            GenClose(theEnv,fp);
-            j = 0;
-            arrayVersion++;
-            version++;
-            if (count < numberOfEntries)
-              {
-               if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,version,false)) == NULL)
-                 { return 0; }
-               newHeader = true;
-              }
+            if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,version,false)) == NULL)
+              { return 0; }
+            newHeader = true;
            }
-         else
-           { fprintf(fp,"},\n"); }
         }
+      else
+        { fprintf(fp,"},\n"); }
      }
 
    return version;
@@ -226,7 +214,7 @@ static unsigned int BitMapHashNodesToCode(
    CLIPSBitMap *hashPtr;
    unsigned int count;
    unsigned int numberOfEntries;
-   CLIPSBitMap **bitMapTable;
+   struct atomTable *bitMapTable;
    bool newHeader = true;
    unsigned int arrayVersion = 1;
    FILE *fp;
@@ -239,13 +227,7 @@ static unsigned int BitMapHashNodesToCode(
    bitMapTable = GetBitMapTable(theEnv);
    count = numberOfEntries = 0;
 
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
-     {
-      for (hashPtr = bitMapTable[i];
-           hashPtr != NULL;
-           hashPtr = hashPtr->next)
-        { numberOfEntries++; }
-     }
+   numberOfEntries = (unsigned int) bitMapTable->count;
 
    if (numberOfEntries == 0) return version;
 
@@ -264,64 +246,55 @@ static unsigned int BitMapHashNodesToCode(
 
    j = 0;
 
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+   for (i = 0; i < bitMapTable->size; i++)
      {
-      for (hashPtr = bitMapTable[i];
-           hashPtr != NULL;
-           hashPtr = hashPtr->next)
-        {
-         if (newHeader)
-           {
-            fprintf(fp,"struct clipsBitMap B%d_%d[] = {\n",ConstructCompilerData(theEnv)->ImageID,arrayVersion);
-            newHeader = false;
-           }
-           
-         fprintf(fp,"{{BITMAP_TYPE},");
-         
-         if (hashPtr->next == NULL)
-           { fprintf(fp,"NULL,"); }
-         else
-           {
-            if ((j + 1) >= ConstructCompilerData(theEnv)->MaxIndices)
-              { fprintf(fp,"&B%d_%d[%d],",ConstructCompilerData(theEnv)->ImageID,arrayVersion + 1,0); }
-            else
-              { fprintf(fp,"&B%d_%d[%d],",ConstructCompilerData(theEnv)->ImageID,arrayVersion,j + 1); }
-           }
+      hashPtr = (CLIPSBitMap *) bitMapTable->slots[i].value;
+      if (hashPtr == NULL) continue;
 
-         fprintf(fp,"%ld,1,0,0,%d,(char *) &L%d_%d[%d],%d",
-                     hashPtr->count + 1,i,
-                     ConstructCompilerData(theEnv)->ImageID,longsReqdPartition,longsReqdPartitionCount,
-                     hashPtr->size);
-
-         longsReqdPartitionCount += (hashPtr->size / sizeof(unsigned long));
-         if ((hashPtr->size % sizeof(unsigned long)) != 0)
-           longsReqdPartitionCount++;
-         if (longsReqdPartitionCount >= ConstructCompilerData(theEnv)->MaxIndices)
-           {
-            longsReqdPartitionCount = 0;
-            longsReqdPartition++;
-           }
+      if (newHeader)
+        {
+         fprintf(fp,"struct clipsBitMap B%d_%d[] = {\n",ConstructCompilerData(theEnv)->ImageID,arrayVersion);
+         newHeader = false;
+        }
+        
+      fprintf(fp,"{{BITMAP_TYPE},");
+      
+      PrintBitMapReference(theEnv,fp,hashPtr->next);
+      fprintf(fp,",");
+
+      fprintf(fp,"%ld,1,0,0,%u,(char *) &L%d_%d[%d],%d",
+                  hashPtr->count + 1,(unsigned) (bitMapTable->slots[i].hashValue % BITMAP_HASH_SIZE),
+                  ConstructCompilerData(theEnv)->ImageID,longsReqdPartition,longsReqdPartitionCount,
+                  hashPtr->size);
+
+      longsReqdPartitionCount += (hashPtr->size / sizeof(unsigned long));
+      if ((hashPtr->size % sizeof(unsigned long)) != 0)
+        longsReqdPartitionCount++;
+      if (longsReqdPartitionCount >= ConstructCompilerData(theEnv)->MaxIndices)
+        {
+         longsReqdPartitionCount = 0;
+         longsReqdPartition++;
+        }
 
-         count++;
-         j++;
+      count++;
+      j++;
 
-         if ((count == numberOfEntries) || (j >= ConstructCompilerData(theEnv)->MaxIndices))
+      if ((count == numberOfEntries) || (j >= ConstructCompilerData(theEnv)->MaxIndices))
+        {
+         fprintf(fp,"}};\n");
+         GenClose(theEnv,fp);
+         j = 0;
+         arrayVersion++;
+         version++;
+         if (count < numberOfEntries)
            {
-            fprintf(fp,"}};\n");
-            GenClose(theEnv,fp);
-            j = 0;
-            arrayVersion++;
-            version++;
-            if (count < numberOfEntries)
-              {
-               if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,version,false)) == NULL)
-                 { return 0; }
-               newHeader = true;
-              }
+            if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,version,false)) == NULL)
+              { return 0; }
+            newHeader = true;
            }
-         else
-           { fprintf(fp,"},\n"); }
         }
+      else
+        { fprintf(fp,"},\n"); }
      }
 
    return version;
@@ -344,7 +317,7 @@ static unsigned int BitMapValuesToCode(
    CLIPSBitMap *hashPtr;
    unsigned int count;
    unsigned int numberOfEntries;
-   CLIPSBitMap **bitMapTable;
+   struct atomTable *bitMapTable;
    bool newHeader = true;
    unsigned int arrayVersion = 1;
    FILE *fp;
@@ -358,16 +331,14 @@ static unsigned int BitMapValuesToCode(
    bitMapTable = GetBitMapTable(theEnv);
    count = numberOfEntries = 0;
 
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+   for (i = 0; i < bitMapTable->size; i++)
      {
-      for (hashPtr = bitMapTable[i];
-           hashPtr != NULL;
-           hashPtr = hashPtr->next)
-        {
-         numberOfEntries += (hashPtr->size / sizeof(unsigned long));
-         if ((hashPtr->size % sizeof(unsigned long)) != 0)
-           { numberOfEntries++; }
-        }
+      hashPtr = (CLIPSBitMap *) bitMapTable->slots[i].value;
+      if (hashPtr == NULL) continue;
+
+      numberOfEntries += (hashPtr->size / sizeof(unsigned long));
+      if ((hashPtr->size % sizeof(unsigned long)) != 0)
+        { numberOfEntries++; }
      }
 
    if (numberOfEntries == 0) return version;
@@ -387,55 +358,53 @@ static unsigned int BitMapValuesToCode(
 
    j = 0;
 
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+   for (i = 0; i < bitMapTable->size; i++)
      {
-      for (hashPtr = bitMapTable[i];
-           hashPtr != NULL;
-           hashPtr = hashPtr->next)
+      hashPtr = (CLIPSBitMap *) bitMapTable->slots[i].value;
+      if (hashPtr == NULL) continue;
+
+      if (newHeader)
         {
-         if (newHeader)
-           {
-            fprintf(fp,"unsigned long L%d_%d[] = {\n",ConstructCompilerData(theEnv)->ImageID,arrayVersion);
-            newHeader = false;
-           }
+         fprintf(fp,"unsigned long L%d_%d[] = {\n",ConstructCompilerData(theEnv)->ImageID,arrayVersion);
+         newHeader = false;
+        }
 
-         longsReqd = (hashPtr->size / sizeof(unsigned long));
-         if ((hashPtr->size % sizeof(unsigned long)) != 0)
-           longsReqd++;
+      longsReqd = (hashPtr->size / sizeof(unsigned long));
+      if ((hashPtr->size % sizeof(unsigned long)) != 0)
+        longsReqd++;
 
-         for (k = 0 ; k < longsReqd ; k++)
-           {
-            if (k > 0)
-              fprintf(fp,",");
-            tmpLong = 0L;
-            for (l = 0 ;
-                 ((l < sizeof(unsigned long)) &&
-                 (((k * sizeof(unsigned long)) + l) < (size_t) hashPtr->size)) ;
-                 l++)
-              ((char *) &tmpLong)[l] = hashPtr->contents[(k * sizeof(unsigned long)) + l];
-            fprintf(fp,"0x%lxL",tmpLong);
-           }
+      for (k = 0 ; k < longsReqd ; k++)
+        {
+         if (k > 0)
+           fprintf(fp,",");
+         tmpLong = 0L;
+         for (l = 0 ;
+              ((l < sizeof(unsigned long)) &&
+              (((k * sizeof(unsigned long)) + l) < (size_t) hashPtr->size)) ;
+              l++)
+           ((char *) &tmpLong)[l] = hashPtr->contents[(k * sizeof(unsigned long)) + l];
+         fprintf(fp,"0x%lxL",tmpLong);
+        }
 
-         count += longsReqd;
-         j += longsReqd;
+      count += longsReqd;
+      j += longsReqd;
 
-         if ((count == numberOfEntries) || (j >= ConstructCompilerData(theEnv)->MaxIndices))
+      if ((count == numberOfEntries) || (j >= ConstructCompilerData(theEnv)->MaxIndices))
+        {
+         fprintf(fp,"};\n");
+         GenClose(theEnv,fp);
+         j = 0;
+         arrayVersion++;
+         version++;
+         if (count < numberOfEntries)
            {
-            fprintf(fp,"};\n");
-            GenClose(theEnv,fp);
-            j = 0;
-            arrayVersion++;
-            version++;
-            if (count < numberOfEntries)
-              {
-               if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,version,false)) == NULL)
-                 { return 0; }
-               newHeader = true;
-              }
+            if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,version,false)) == NULL)
+              { return 0; }
+            newHeader = true;
            }
-         else
-           { fprintf(fp,",\n"); }
         }
+      else
+        { fprintf(fp,",\n"); }
      }
 
    return version;
@@ -457,7 +426,7 @@ static unsigned int FloatHashNodesToCode(
    CLIPSFloat *hashPtr;
    unsigned int count;
    unsigned int numberOfEntries;
-   CLIPSFloat **floatTable;
+   struct atomTable *floatTable;
    bool newHeader = true;
    FILE *fp;
    unsigned int arrayVersion = 1;
@@ -469,13 +438,7 @@ static unsigned int FloatHashNodesToCode(
    floatTable = GetFloatTable(theEnv);
    count = numberOfEntries = 0;
 
-   for (i = 0; i < FLOAT_HASH_SIZE; i++)
-     {
-      for (hashPtr = floatTable[i];
-           hashPtr != NULL;
-           hashPtr = hashPtr->next)
-        { numberOfEntries++; }
-     }
+   numberOfEntries = (unsigned int) floatTable->count;
 
    if (numberOfEntries == 0) return version;
 
@@ -494,53 +457,50 @@ static unsigned int FloatHashNodesToCode(
 
    j = 0;
 
-   for (i = 0; i < FLOAT_HASH_SIZE; i++)
+   for (i = 0; i < floatTable->size; i++)
      {
-      for (hashPtr = floatTable[i];
-           hashPtr != NULL;
-           hashPtr = hashPtr->next)
+      hashPtr = (CLIPSFloat *) floatTable->slots[i].value;
+      if (hashPtr == NULL) continue;
+
+      if (newHeader)
         {
-         if (newHeader)
-           {
-            fprintf(fp,"CLIPSFloat F%d_%d[] = {\n",ConstructCompilerData(theEnv)->ImageID,arrayVersion);
-            newHeader = false;
-           }
-           
-         fprintf(fp,"{{FLOAT_TYPE},");
-         
-         if (hashPtr->next == NULL)
-           { fprintf(fp,"NULL,"); }
-         else
-           {
-            if ((j + 1) >= ConstructCompilerData(theEnv)->MaxIndices)
-              { fprintf(fp,"&F%d_%d[%d],",ConstructCompilerData(theEnv)->ImageID,arrayVersion + 1,0); }
-            else
-              { fprintf(fp,"&F%d_%d[%d],",ConstructCompilerData(theEnv)->ImageID,arrayVersion,j + 1); }
-           }
+         fprintf(fp,"CLIPSFloat F%d_%d[] = {\n",ConstructCompilerData(theEnv)->ImageID,arrayVersion);
+         newHeader = false;
+        }
+        
+      fprintf(fp,"{{FLOAT_TYPE},");
+      
+      if (hashPtr->next == NULL)
+        { fprintf(fp,"NULL,"); }
+      else
+        {
+         PrintFloatReference(theEnv,fp,hashPtr->next);
+         fprintf(fp,",");
+        }
 
-         fprintf(fp,"%ld,1,0,0,%d,",hashPtr->count + 1,i);
-         fprintf(fp,"%s",FloatToString(theEnv,hashPtr->contents));
+      fprintf(fp,"%ld,1,0,0,%u,",hashPtr->count + 1,
+                 (unsigned) (floatTable->slots[i].hashValue % FLOAT_HASH_SIZE));
+      fprintf(fp,"%s",FloatToString(theEnv,hashPtr->contents));
 
-         count++;
-         j++;
+      count++;
+      j++;
 
-         if ((count == numberOfEntries) || (j >= ConstructCompilerData(theEnv)->MaxIndices))
+      if ((count == numberOfEntries) || (j >= ConstructCompilerData(theEnv)->MaxIndices))
+        {
+         fprintf(fp,"}};\n");
+         GenClose(theEnv,fp);
+         j = 0;
+         version++;
+         arrayVersion++;
+         if (count < numberOfEntries)
            {
-            fprintf(fp,"}};\n");
-            GenClose(theEnv,fp);
-            j = 0;
-            version++;
-            arrayVersion++;
-            if (count < numberOfEntries)
-              {
-               if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,version,false)) == NULL)
-                 { return 0; }
-               newHeader = true;
-              }
+            if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,version,false)) == NULL)
+              { return 0; }
+            newHeader = true;
            }
-         else
-           { fprintf(fp,"},\n"); }
         }
+      else
+        { fprintf(fp,"},\n"); }
      }
 
    return version;
@@ -559,10 +519,10 @@ static unsigned int IntegerHashNodesToCode(
   unsigned int version)
   {
    unsigned int i, j;
+   size_t position;
    CLIPSInteger *hashPtr;
    unsigned int count;
    unsigned int numberOfEntries;
-   CLIPSInteger **integerTable;
    bool newHeader = true;
    FILE *fp;
    unsigned int arrayVersion = 1;
@@ -571,16 +531,11 @@ static unsigned int IntegerHashNodesToCode(
    /* Count the total number of entries. */
    /*====================================*/
 
-   integerTable = GetIntegerTable(theEnv);
    count = numberOfEntries = 0;
 
-   for (i = 0; i < INTEGER_HASH_SIZE; i++)
-     {
-      for (hashPtr = integerTable[i];
-           hashPtr != NULL;
-           hashPtr = hashPtr->next)
-        { numberOfEntries++; }
-     }
+   position = 0;
+   while (GetNextInteger(theEnv,&position) != NULL)
+     { numberOfEntries++; }
 
    if (numberOfEntries == 0) return(version);
 
@@ -599,53 +554,49 @@ static unsigned int IntegerHashNodesToCode(
 
    j = 0;
 
-   for (i = 0; i < INTEGER_HASH_SIZE; i++)
+   position = 0;
+
+   while ((hashPtr = GetNextInteger(theEnv,&position)) != NULL)
      {
-      for (hashPtr = integerTable[i];
-           hashPtr != NULL;
-           hashPtr = hashPtr->next)
+      if (newHeader)
         {
-         if (newHeader)
-           {
-            fprintf(fp,"CLIPSInteger I%d_%d[] = {\n",ConstructCompilerData(theEnv)->ImageID,arrayVersion);
-            newHeader = false;
-           }
-           
-         fprintf(fp,"{{INTEGER_TYPE},");
+         fprintf(fp,"CLIPSInteger I%d_%d[] = {\n",ConstructCompilerData(theEnv)->ImageID,arrayVersion);
+         newHeader = false;
+        }
+        
+      fprintf(fp,"{{INTEGER_TYPE},");
 
-         if (hashPtr->next == NULL)
-           { fprintf(fp,"NULL,"); }
-         else
-           {
-            if ((j + 1) >= ConstructCompilerData(theEnv)->MaxIndices)
-              { fprintf(fp,"&I%d_%d[%d],",ConstructCompilerData(theEnv)->ImageID,arrayVersion + 1,0); }
-            else
-              { fprintf(fp,"&I%d_%d[%d],",ConstructCompilerData(theEnv)->ImageID,arrayVersion,j + 1); }
-           }
+      if (hashPtr->next == NULL)
+        { fprintf(fp,"NULL,"); }
+      else
+        {
+         PrintIntegerReference(theEnv,fp,hashPtr->next);
+         fprintf(fp,",");
+        }
 
-         fprintf(fp,"%ld,1,0,0,%d,",hashPtr->count + 1,i);
-         fprintf(fp,"%lldLL",hashPtr->contents);
+      fprintf(fp,"%ld,1,0,0,%u,",hashPtr->count + 1,
+                 (unsigned) HashInteger(hashPtr->contents,INTEGER_HASH_SIZE));
+      fprintf(fp,"%lldLL",hashPtr->contents);
 
-         count++;
-         j++;
+      count++;
+      j++;
 
-         if ((count == numberOfEntries) || (j >= ConstructCompilerData(theEnv)->MaxIndices))
+      if ((count == numberOfEntries) || (j >= ConstructCompilerData(theEnv)->MaxIndices))
+        {
+         fprintf(fp,"}};\n");
+         GenClose(theEnv,fp);
+         j = 0;
+         version++;
+         arrayVersion++;
+         if (count < numberOfEntries)
            {
-            fprintf(fp,"}};\n");
-            GenClose(theEnv,fp);
-            j = 0;
-            version++;
-            arrayVersion++;
-            if (count < numberOfEntries)
-              {
-               if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,version,false)) == NULL)
-                 { return 0; }
-               newHeader = true;
-              }
+            if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,version,false)) == NULL)
+              { return 0; }
+            newHeader = true;
            }
-         else
-           { fprintf(fp,"},\n"); }
         }
+      else
+        { fprintf(fp,"},\n"); }
      }
 
    return version;
@@ -664,26 +615,26 @@ static int HashTablesToCode(
   {
    unsigned long i;
    FILE *fp;
-   CLIPSLexeme **symbolTable;
-   CLIPSFloat **floatTable;
-   CLIPSInteger **integerTable;
-   CLIPSBitMap **bitMapTable;
+   GENERIC_HN **heads;
 
    /*======================================*/
    /* Write the code for the symbol table. */
    /*======================================*/
 
-   symbolTable = GetSymbolTable(theEnv);
+   heads = ThreadAtomChains(theEnv,GetSymbolTable(theEnv),SYMBOL_HASH_SIZE);
 
    if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,1,false)) == NULL)
-     { return 0; }
+     {
+      rm(theEnv,heads,sizeof(GENERIC_HN *) * SYMBOL_HASH_SIZE);
+      return 0;
+     }
 
    fprintf(ConstructCompilerData(theEnv)->HeaderFP,"extern CLIPSLexeme *sht%d[];\n",ConstructCompilerData(theEnv)->ImageID);
    fprintf(fp,"CLIPSLexeme *sht%d[%ld] = {\n",ConstructCompilerData(theEnv)->ImageID,SYMBOL_HASH_SIZE);
 
    for (i = 0; i < SYMBOL_HASH_SIZE; i++)
       {
-       PrintSymbolReference(theEnv,fp,symbolTable[i]);
+       PrintSymbolReference(theEnv,fp,(CLIPSLexeme *) heads[i]);
 
        if (i + 1 != SYMBOL_HASH_SIZE) fprintf(fp,",\n");
       }
@@ -691,23 +642,27 @@ static int HashTablesToCode(
     fprintf(fp,"};\n");
 
     GenClose(theEnv,fp);
+    rm(theEnv,heads,sizeof(GENERIC_HN *) * SYMBOL_HASH_SIZE);
 
    /*=====================================*/
    /* Write the code for the float table. */
    /*=====================================*/
 
-   floatTable = GetFloatTable(theEnv);
+   heads = ThreadAtomChains(theEnv,GetFloatTable(theEnv),FLOAT_HASH_SIZE);
 
    if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,2,false)) == NULL)
-     { return 0; }
+     {
+      rm(theEnv,heads,sizeof(GENERIC_HN *) * FLOAT_HASH_SIZE);
+      return 0;
+     }
 
    fprintf(ConstructCompilerData(theEnv)->HeaderFP,"extern CLIPSFloat *fht%d[];\n",ConstructCompilerData(theEnv)->ImageID);
    fprintf(fp,"CLIPSFloat *fht%d[%d] = {\n",ConstructCompilerData(theEnv)->ImageID,FLOAT_HASH_SIZE);
 
    for (i = 0; i < FLOAT_HASH_SIZE; i++)
       {
-       if (floatTable[i] == NULL) { fprintf(fp,"NULL"); }
-       else PrintFloatReference(theEnv,fp,floatTable[i]);
+       if (heads[i] == NULL) { fprintf(fp,"NULL"); }
+       else PrintFloatReference(theEnv,fp,(CLIPSFloat *) heads[i]);
 
        if (i + 1 != FLOAT_HASH_SIZE) fprintf(fp,",\n");
       }
@@ -715,23 +670,27 @@ static int HashTablesToCode(
     fprintf(fp,"};\n");
 
     GenClose(theEnv,fp);
+    rm(theEnv,heads,sizeof(GENERIC_HN *) * FLOAT_HASH_SIZE);
 
    /*=======================================*/
    /* Write the code for the integer table. */
    /*=======================================*/
 
-   integerTable = GetIntegerTable(theEnv);
+   heads = ThreadIntegerChains(theEnv);
 
    if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,3,false)) == NULL)
-     { return 0; }
+     {
+      rm(theEnv,heads,sizeof(GENERIC_HN *) * INTEGER_HASH_SIZE);
+      return 0;
+     }
 
    fprintf(ConstructCompilerData(theEnv)->HeaderFP,"extern CLIPSInteger *iht%d[];\n",ConstructCompilerData(theEnv)->ImageID);
    fprintf(fp,"CLIPSInteger *iht%d[%d] = {\n",ConstructCompilerData(theEnv)->ImageID,INTEGER_HASH_SIZE);
 
    for (i = 0; i < INTEGER_HASH_SIZE; i++)
       {
-       if (integerTable[i] == NULL) { fprintf(fp,"NULL"); }
-       else PrintIntegerReference(theEnv,fp,integerTable[i]);
+       if (heads[i] == NULL) { fprintf(fp,"NULL"); }
+       else PrintIntegerReference(theEnv,fp,(CLIPSInteger *) heads[i]);
 
        if (i + 1 != INTEGER_HASH_SIZE) fprintf(fp,",\n");
       }
@@ -739,22 +698,26 @@ static int HashTablesToCode(
     fprintf(fp,"};\n");
 
     GenClose(theEnv,fp);
+    rm(theEnv,heads,sizeof(GENERIC_HN *) * INTEGER_HASH_SIZE);
 
    /*======================================*/
    /* Write the code for the bitmap table. */
    /*======================================*/
 
-   bitMapTable = GetBitMapTable(theEnv);
+   heads = ThreadAtomChains(theEnv,GetBitMapTable(theEnv),BITMAP_HASH_SIZE);
 
    if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,4,false)) == NULL)
-     { return 0; }
+     {
+      rm(theEnv,heads,sizeof(GENERIC_HN *) * BITMAP_HASH_SIZE);
+      return 0;
+     }
 
    fprintf(ConstructCompilerData(theEnv)->HeaderFP,"extern struct clipsBitMap *bmht%d[];\n",ConstructCompilerData(theEnv)->ImageID);
    fprintf(fp,"struct clipsBitMap *bmht%d[%d] = {\n",ConstructCompilerData(theEnv)->ImageID,BITMAP_HASH_SIZE);
 
    for (i = 0; i < BITMAP_HASH_SIZE; i++)
       {
-       PrintBitMapReference(theEnv,fp,bitMapTable[i]);
+       PrintBitMapReference(theEnv,fp,(CLIPSBitMap *) heads[i]);
 
        if (i + 1 != BITMAP_HASH_SIZE) fprintf(fp,",\n");
       }
@@ -762,10 +725,72 @@ static int HashTablesToCode(
     fprintf(fp,"};\n");
 
     GenClose(theEnv,fp);
+    rm(theEnv,heads,sizeof(GENERIC_HN *) * BITMAP_HASH_SIZE);
 
     return 1;
    }
 
+/*************************************************************/
+/* ThreadAtomChains: The atom tables are open addressed, but */
+/*   a run-time program receives its atomic values as bucket */
+/*   chained tables. Links the entries of an atom table into */
+/*   chains by bucket value using their next fields and      */
+/*   returns the array of chain heads. Entries are linked in */
+/*   slot order so that each chain follows the order in      */
+/*   which the entries are listed by the hash node code.     */
+/*************************************************************/
+static GENERIC_HN **ThreadAtomChains(
+  Environment *theEnv,
+  struct atomTable *theTable,
+  size_t hashSize)
+  {
+   GENERIC_HN **heads;
+   size_t i, bucket;
+
+   heads = (GENERIC_HN **) gm2(theEnv,sizeof(GENERIC_HN *) * hashSize);
+   for (i = 0; i < hashSize; i++)
+     { heads[i] = NULL; }
+
+   for (i = theTable->size; i > 0; i--)
+     {
+      if (theTable->slots[i-1].value == NULL) continue;
+
+      bucket = theTable->slots[i-1].hashValue % hashSize;
+      theTable->slots[i-1].value->next = heads[bucket];
+      heads[bucket] = theTable->slots[i-1].value;
+     }
+
+   return heads;
+  }
+
+/************************************************************/
+/* ThreadIntegerChains: Links the integers into chains by   */
+/*   bucket value. Integers from the small integer cache    */
+/*   are not stored in the integer table, so the integers   */
+/*   are visited using GetNextInteger.                      */
+/************************************************************/
+static GENERIC_HN **ThreadIntegerChains(
+  Environment *theEnv)
+  {
+   GENERIC_HN **heads;
+   CLIPSInteger *theInteger;
+   size_t i, bucket;
+
+   heads = (GENERIC_HN **) gm2(theEnv,sizeof(GENERIC_HN *) * INTEGER_HASH_SIZE);
+   for (i = 0; i < INTEGER_HASH_SIZE; i++)
+     { heads[i] = NULL; }
+
+   i = 0;
+   while ((theInteger = GetNextInteger(theEnv,&i)) != NULL)
+     {
+      bucket = HashInteger(theInteger->contents,INTEGER_HASH_SIZE);
+      theInteger->next = (CLIPSInteger *) heads[bucket];
+      heads[bucket] = (GENERIC_HN *) theInteger;
+     }
+
+   return heads;
+  }
+
 /*****************************************************/
 /* PrintSymbolReference: Prints the C code reference */
 /*   address to the specified symbol (also used for  */
@@ -68,6 +68,12 @@
 /*                                                           */
 /*            ALLOW_ENVIRONMENT_GLOBALS no longer supported. */
 /*                                                           */
+/*            Replaced the bucket chained atom tables with   */
+/*            open addressed tables. GetSymbolTable and the  */
+/*            other Get*Table functions now return the atom  */
+/*            table and the Set*Table functions were         */
+/*            removed.                                       */
+/*                                                           */
 /*************************************************************/
 
 #include <stdio.h>
@@ -101,15 +107,28 @@
 #define AVERAGE_BITMAP_SIZE sizeof(long)
 #define NUMBER_OF_LONGS_FOR_HASH 25
 
+#define NextAtomSlot(theTable,theSlot) \
+   ((((theSlot) + 1) == ((theTable)->slots + (theTable)->size)) ? (theTable)->slots : ((theSlot) + 1))
+
 /***************************************/
 /* LOCAL INTERNAL FUNCTION DEFINITIONS */
 /***************************************/
 
-   static void                    RemoveHashNode(Environment *,GENERIC_HN *,GENERIC_HN **,int,int);
+   static CLIPSInteger           *CreateSmallInteger(Environment *,long long);
+   static size_t                  HashSymbolLength(const char *,size_t *);
+   static size_t                  AtomHashValue(GENERIC_HN *,int);
+   static void                    InitializeAtomTable(Environment *,struct atomTable *,size_t);
+   static void                    ReturnAtomTable(Environment *,struct atomTable *);
+   static void                    PlaceAtomSlot(struct atomTable *,size_t,size_t,GENERIC_HN *);
+   static void                    ResizeAtomTable(Environment *,struct atomTable *,size_t);
+   static void                    AddAtomTableEntry(Environment *,struct atomTable *,size_t,size_t,GENERIC_HN *);
+   static size_t                  FindAtomTableSlot(struct atomTable *,size_t,GENERIC_HN *);
+   static void                    RemoveAtomTableEntry(Environment *,struct atomTable *,size_t,GENERIC_HN *);
+   static void                    RemoveHashNode(Environment *,GENERIC_HN *,struct atomTable *,int,int);
    static void                    AddEphemeralHashNode(Environment *,GENERIC_HN *,struct ephemeron **,
                                                        int,int,bool);
    static void                    RemoveEphemeralHashNodes(Environment *,struct ephemeron **,
-                                                           GENERIC_HN **,
+                                                           struct atomTable *,
                                                            int,int,int);
    static const char             *StringWithinString(const char *,const char *);
    static size_t                  CommonPrefixLength(const char *,const char *);
@@ -135,40 +154,39 @@ void InitializeAtomTables(
 #pragma unused(bitmapTable)
 #pragma unused(externalAddressTable)
 #endif
-   unsigned long i;
+   size_t i;
+#if RUN_TIME
+   CLIPSLexeme *symbolPtr;
+   CLIPSFloat *floatPtr;
+   CLIPSInteger *integerPtr;
+   CLIPSBitMap *bitMapPtr;
+#endif
 
    AllocateEnvironmentData(theEnv,SYMBOL_DATA,sizeof(struct symbolData),DeallocateSymbolData);
 
-#if ! RUN_TIME
    /*=========================*/
    /* Create the hash tables. */
    /*=========================*/
 
-   SymbolData(theEnv)->SymbolTable = (CLIPSLexeme **)
-                  gm2(theEnv,sizeof (CLIPSLexeme *) * SYMBOL_HASH_SIZE);
-
-   SymbolData(theEnv)->FloatTable = (CLIPSFloat **)
-                  gm2(theEnv,sizeof (CLIPSFloat *) * FLOAT_HASH_SIZE);
+   InitializeAtomTable(theEnv,&SymbolData(theEnv)->SymbolTable,SYMBOL_TABLE_INITIAL_SIZE);
+   InitializeAtomTable(theEnv,&SymbolData(theEnv)->FloatTable,ATOM_TABLE_INITIAL_SIZE);
+   InitializeAtomTable(theEnv,&SymbolData(theEnv)->IntegerTable,ATOM_TABLE_INITIAL_SIZE);
+   InitializeAtomTable(theEnv,&SymbolData(theEnv)->BitMapTable,ATOM_TABLE_INITIAL_SIZE);
+   InitializeAtomTable(theEnv,&SymbolData(theEnv)->ExternalAddressTable,ATOM_TABLE_INITIAL_SIZE);
 
-   SymbolData(theEnv)->IntegerTable = (CLIPSInteger **)
-                   gm2(theEnv,sizeof (CLIPSInteger *) * INTEGER_HASH_SIZE);
-
-   SymbolData(theEnv)->BitMapTable = (CLIPSBitMap **)
-                   gm2(theEnv,sizeof (CLIPSBitMap *) * BITMAP_HASH_SIZE);
-
-   SymbolData(theEnv)->ExternalAddressTable = (CLIPSExternalAddress **)
-                   gm2(theEnv,sizeof (CLIPSExternalAddress *) * EXTERNAL_ADDRESS_HASH_SIZE);
-
-   /*===================================================*/
-   /* Initialize all of the hash table entries to NULL. */
-   /*===================================================*/
+   /*=====================================*/
+   /* Create the cache of small integers. */
+   /*=====================================*/
 
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++) SymbolData(theEnv)->SymbolTable[i] = NULL;
-   for (i = 0; i < FLOAT_HASH_SIZE; i++) SymbolData(theEnv)->FloatTable[i] = NULL;
-   for (i = 0; i < INTEGER_HASH_SIZE; i++) SymbolData(theEnv)->IntegerTable[i] = NULL;
-   for (i = 0; i < BITMAP_HASH_SIZE; i++) SymbolData(theEnv)->BitMapTable[i] = NULL;
-   for (i = 0; i < EXTERNAL_ADDRESS_HASH_SIZE; i++) SymbolData(theEnv)->ExternalAddressTable[i] = NULL;
+   if (SMALL_INTEGER_CACHE_SIZE > 0)
+     {
+      SymbolData(theEnv)->SmallIntegers = (CLIPSInteger **)
+         genalloc(theEnv,sizeof(CLIPSInteger *) * SMALL_INTEGER_CACHE_SIZE);
+      for (i = 0; i < SMALL_INTEGER_CACHE_SIZE; i++)
+        { SymbolData(theEnv)->SmallIntegers[i] = NULL; }
+     }
 
+#if ! RUN_TIME
    /*========================*/
    /* Predefine some values. */
    /*========================*/
@@ -184,16 +202,59 @@ void InitializeAtomTables(
    SymbolData(theEnv)->Zero = CreateInteger(theEnv,0LL);
    IncrementIntegerCount(SymbolData(theEnv)->Zero);
 #else
-   SetSymbolTable(theEnv,symbolTable);
-   SetFloatTable(theEnv,floatTable);
-   SetIntegerTable(theEnv,integerTable);
-   SetBitMapTable(theEnv,bitmapTable);
+   /*=====================================================*/
+   /* The run-time image passes its values in the bucket  */
+   /* chained form produced by constructs-to-c. Load them */
+   /* into the open addressed tables.                     */
+   /*=====================================================*/
 
-   SymbolData(theEnv)->ExternalAddressTable = (CLIPSExternalAddress **)
-                gm2(theEnv,sizeof (CLIPSExternalAddress *) * EXTERNAL_ADDRESS_HASH_SIZE);
+   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+     {
+      for (symbolPtr = symbolTable[i]; symbolPtr != NULL; symbolPtr = symbolPtr->next)
+        {
+         AddAtomTableEntry(theEnv,&SymbolData(theEnv)->SymbolTable,
+                           AtomHashValue((GENERIC_HN *) symbolPtr,SYMBOL_TYPE),
+                           strlen(symbolPtr->contents),(GENERIC_HN *) symbolPtr);
+        }
+     }
+
+   for (i = 0; i < FLOAT_HASH_SIZE; i++)
+     {
+      for (floatPtr = floatTable[i]; floatPtr != NULL; floatPtr = floatPtr->next)
+        {
+         AddAtomTableEntry(theEnv,&SymbolData(theEnv)->FloatTable,
+                           AtomHashValue((GENERIC_HN *) floatPtr,FLOAT_TYPE),
+                           0,(GENERIC_HN *) floatPtr);
+        }
+     }
+
+   for (i = 0; i < INTEGER_HASH_SIZE; i++)
+     {
+      for (integerPtr = integerTable[i]; integerPtr != NULL; integerPtr = integerPtr->next)
+        {
+         if (IsSmallInteger(integerPtr->contents))
+           {
+            SymbolData(theEnv)->SmallIntegers[integerPtr->contents - SMALL_INTEGER_MINIMUM] = integerPtr;
+            IncrementIntegerCount(integerPtr);
+            continue;
+           }
+
+         AddAtomTableEntry(theEnv,&SymbolData(theEnv)->IntegerTable,
+                           AtomHashValue((GENERIC_HN *) integerPtr,INTEGER_TYPE),
+                           0,(GENERIC_HN *) integerPtr);
+        }
+     }
+
+   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+     {
+      for (bitMapPtr = bitmapTable[i]; bitMapPtr != NULL; bitMapPtr = bitMapPtr->next)
+        {
+         AddAtomTableEntry(theEnv,&SymbolData(theEnv)->BitMapTable,
+                           AtomHashValue((GENERIC_HN *) bitMapPtr,BITMAPARRAY),
+                           bitMapPtr->size,(GENERIC_HN *) bitMapPtr);
+        }
+     }
 
-   for (i = 0; i < EXTERNAL_ADDRESS_HASH_SIZE; i++) SymbolData(theEnv)->ExternalAddressTable[i] = NULL;
-   
    theEnv->TrueSymbol = FindSymbolHN(theEnv,TRUE_STRING,SYMBOL_BIT);
    theEnv->FalseSymbol = FindSymbolHN(theEnv,FALSE_STRING,SYMBOL_BIT);
 #endif
@@ -209,110 +270,94 @@ void InitializeAtomTables(
 static void DeallocateSymbolData(
   Environment *theEnv)
   {
-   int i;
-   CLIPSLexeme *shPtr, *nextSHPtr;
-   CLIPSInteger *ihPtr, *nextIHPtr;
-   CLIPSFloat *fhPtr, *nextFHPtr;
-   CLIPSBitMap *bmhPtr, *nextBMHPtr;
-   CLIPSExternalAddress *eahPtr, *nextEAHPtr;
-
-   if ((SymbolData(theEnv)->SymbolTable == NULL) ||
-       (SymbolData(theEnv)->FloatTable == NULL) ||
-       (SymbolData(theEnv)->IntegerTable == NULL) ||
-       (SymbolData(theEnv)->BitMapTable == NULL) ||
-       (SymbolData(theEnv)->ExternalAddressTable == NULL))
+   size_t i;
+   CLIPSLexeme *shPtr;
+   CLIPSInteger *ihPtr;
+   CLIPSFloat *fhPtr;
+   CLIPSBitMap *bmhPtr;
+   CLIPSExternalAddress *eahPtr;
+
+   if ((SymbolData(theEnv)->SymbolTable.slots == NULL) ||
+       (SymbolData(theEnv)->FloatTable.slots == NULL) ||
+       (SymbolData(theEnv)->IntegerTable.slots == NULL) ||
+       (SymbolData(theEnv)->BitMapTable.slots == NULL) ||
+       (SymbolData(theEnv)->ExternalAddressTable.slots == NULL))
      { return; }
      
    genfree(theEnv,theEnv->VoidConstant,sizeof(TypeHeader));
    
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+   for (i = 0; i < SymbolData(theEnv)->SymbolTable.size; i++)
      {
-      shPtr = SymbolData(theEnv)->SymbolTable[i];
+      shPtr = (CLIPSLexeme *) SymbolData(theEnv)->SymbolTable.slots[i].value;
 
-      while (shPtr != NULL)
+      if ((shPtr != NULL) && (! shPtr->permanent))
         {
-         nextSHPtr = shPtr->next;
-         if (! shPtr->permanent)
-           {
-            rm(theEnv,(void *) shPtr->contents,strlen(shPtr->contents)+1);
-            rtn_struct(theEnv,clipsLexeme,shPtr);
-           }
-         shPtr = nextSHPtr;
+         rm(theEnv,(void *) shPtr->contents,strlen(shPtr->contents)+1);
+         rtn_struct(theEnv,clipsLexeme,shPtr);
         }
      }
 
-   for (i = 0; i < FLOAT_HASH_SIZE; i++)
+   for (i = 0; i < SymbolData(theEnv)->FloatTable.size; i++)
      {
-      fhPtr = SymbolData(theEnv)->FloatTable[i];
+      fhPtr = (CLIPSFloat *) SymbolData(theEnv)->FloatTable.slots[i].value;
 
-      while (fhPtr != NULL)
-        {
-         nextFHPtr = fhPtr->next;
-         if (! fhPtr->permanent)
-           { rtn_struct(theEnv,clipsFloat,fhPtr); }
-         fhPtr = nextFHPtr;
-        }
+      if ((fhPtr != NULL) && (! fhPtr->permanent))
+        { rtn_struct(theEnv,clipsFloat,fhPtr); }
      }
 
-   for (i = 0; i < INTEGER_HASH_SIZE; i++)
+   for (i = 0; i < SymbolData(theEnv)->IntegerTable.size; i++)
      {
-      ihPtr = SymbolData(theEnv)->IntegerTable[i];
+      ihPtr = (CLIPSInteger *) SymbolData(theEnv)->IntegerTable.slots[i].value;
 
-      while (ihPtr != NULL)
-        {
-         nextIHPtr = ihPtr->next;
-         if (! ihPtr->permanent)
-           { rtn_struct(theEnv,clipsInteger,ihPtr); }
-         ihPtr = nextIHPtr;
-        }
+      if ((ihPtr != NULL) && (! ihPtr->permanent))
+        { rtn_struct(theEnv,clipsInteger,ihPtr); }
      }
 
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+   for (i = 0; i < SymbolData(theEnv)->BitMapTable.size; i++)
      {
-      bmhPtr = SymbolData(theEnv)->BitMapTable[i];
+      bmhPtr = (CLIPSBitMap *) SymbolData(theEnv)->BitMapTable.slots[i].value;
 
-      while (bmhPtr != NULL)
+      if ((bmhPtr != NULL) && (! bmhPtr->permanent))
         {
-         nextBMHPtr = bmhPtr->next;
-         if (! bmhPtr->permanent)
-           {
-            rm(theEnv,(void *) bmhPtr->contents,bmhPtr->size);
-            rtn_struct(theEnv,clipsBitMap,bmhPtr);
-           }
-         bmhPtr = nextBMHPtr;
+         rm(theEnv,(void *) bmhPtr->contents,bmhPtr->size);
+         rtn_struct(theEnv,clipsBitMap,bmhPtr);
         }
      }
 
-   for (i = 0; i < EXTERNAL_ADDRESS_HASH_SIZE; i++)
+   for (i = 0; i < SymbolData(theEnv)->ExternalAddressTable.size; i++)
      {
-      eahPtr = SymbolData(theEnv)->ExternalAddressTable[i];
+      eahPtr = (CLIPSExternalAddress *) SymbolData(theEnv)->ExternalAddressTable.slots[i].value;
 
-      while (eahPtr != NULL)
-        {
-         nextEAHPtr = eahPtr->next;
-         if (! eahPtr->permanent)
-           {
-            rtn_struct(theEnv,clipsExternalAddress,eahPtr);
-           }
-         eahPtr = nextEAHPtr;
-        }
+      if ((eahPtr != NULL) && (! eahPtr->permanent))
+        { rtn_struct(theEnv,clipsExternalAddress,eahPtr); }
      }
 
    /*================================*/
    /* Remove the symbol hash tables. */
    /*================================*/
 
- #if ! RUN_TIME
-   rm(theEnv,SymbolData(theEnv)->SymbolTable,sizeof (CLIPSLexeme *) * SYMBOL_HASH_SIZE);
+   ReturnAtomTable(theEnv,&SymbolData(theEnv)->SymbolTable);
+   ReturnAtomTable(theEnv,&SymbolData(theEnv)->FloatTable);
+   ReturnAtomTable(theEnv,&SymbolData(theEnv)->IntegerTable);
+   ReturnAtomTable(theEnv,&SymbolData(theEnv)->BitMapTable);
+   ReturnAtomTable(theEnv,&SymbolData(theEnv)->ExternalAddressTable);
 
-   genfree(theEnv,SymbolData(theEnv)->FloatTable,sizeof (CLIPSFloat *) * FLOAT_HASH_SIZE);
+   /*=====================================*/
+   /* Remove the cache of small integers. */
+   /*=====================================*/
 
-   genfree(theEnv,SymbolData(theEnv)->IntegerTable,sizeof (CLIPSInteger *) * INTEGER_HASH_SIZE);
+   if (SymbolData(theEnv)->SmallIntegers != NULL)
+     {
+      for (i = 0; i < SMALL_INTEGER_CACHE_SIZE; i++)
+        {
+         ihPtr = SymbolData(theEnv)->SmallIntegers[i];
 
-   genfree(theEnv,SymbolData(theEnv)->BitMapTable,sizeof (CLIPSBitMap *) * BITMAP_HASH_SIZE);
-#endif
+         if ((ihPtr != NULL) && (! ihPtr->permanent))
+           { rtn_struct(theEnv,clipsInteger,ihPtr); }
+        }
 
-   genfree(theEnv,SymbolData(theEnv)->ExternalAddressTable,sizeof (CLIPSExternalAddress *) * EXTERNAL_ADDRESS_HASH_SIZE);
+      genfree(theEnv,SymbolData(theEnv)->SmallIntegers,sizeof(CLIPSInteger *) * SMALL_INTEGER_CACHE_SIZE);
+     }
 
    /*==============================*/
    /* Remove binary symbol tables. */
@@ -385,9 +430,11 @@ CLIPSLexeme *AddSymbol(
   const char *str,
   unsigned short theType)
   {
-   size_t tally;
+   size_t hashValue;
    size_t length;
-   CLIPSLexeme *past = NULL, *peek;
+   CLIPSLexeme *peek;
+   struct atomTable *theTable = &SymbolData(theEnv)->SymbolTable;
+   struct atomSlot *theSlot;
    char *buffer;
 
     /*====================================*/
@@ -400,44 +447,44 @@ CLIPSLexeme *AddSymbol(
        ExitRouter(theEnv,EXIT_FAILURE);
       }
 
-    tally = HashSymbol(str,SYMBOL_HASH_SIZE);
-    peek = SymbolData(theEnv)->SymbolTable[tally];
+    hashValue = HashSymbolLength(str,&length);
 
-    /*==================================================*/
-    /* Search for the string in the list of entries for */
-    /* this symbol table location.  If the string is    */
-    /* found, then return the address of the string.    */
-    /*==================================================*/
+    /*================================================*/
+    /* Probe the table for the string. The cached     */
+    /* hash value and length are checked before the   */
+    /* string itself. If the string is found, then    */
+    /* return the address of the string.              */
+    /*================================================*/
 
-    while (peek != NULL)
+    for (theSlot = &theTable->slots[AtomTableHome(theTable,hashValue)];
+         theSlot->value != NULL;
+         theSlot = NextAtomSlot(theTable,theSlot))
       {
-       if ((peek->header.type == theType) &&
-           (strcmp(str,peek->contents) == 0))
+       peek = (CLIPSLexeme *) theSlot->value;
+       if ((theSlot->hashValue == hashValue) &&
+           (theSlot->length == length) &&
+           (peek->header.type == theType) &&
+           (memcmp(str,peek->contents,length) == 0))
          { return peek; }
-       past = peek;
-       peek = peek->next;
       }
 
-    /*==================================================*/
-    /* Add the string at the end of the list of entries */
-    /* for this symbol table location.                  */
-    /*==================================================*/
+    /*==============================*/
+    /* Add the string to the table. */
+    /*==============================*/
 
     peek = get_struct(theEnv,clipsLexeme);
 
-    if (past == NULL) SymbolData(theEnv)->SymbolTable[tally] = peek;
-    else past->next = peek;
-
-    length = strlen(str) + 1;
-    buffer = (char *) gm2(theEnv,length);
+    buffer = (char *) gm2(theEnv,length + 1);
     genstrcpy(buffer,str);
     peek->contents = buffer;
     peek->next = NULL;
-    peek->bucket = (unsigned int) tally;
+    peek->bucket = (unsigned int) (hashValue % SYMBOL_HASH_SIZE);
     peek->count = 0;
     peek->permanent = false;
     peek->header.type = theType;
 
+    AddAtomTableEntry(theEnv,theTable,hashValue,length,(GENERIC_HN *) peek);
+
     /*================================================*/
     /* Add the string to the list of ephemeral items. */
     /*================================================*/
@@ -462,17 +509,23 @@ CLIPSLexeme *FindSymbolHN(
   const char *str,
   unsigned short expectedType)
   {
-   size_t tally;
+   size_t hashValue;
+   size_t length;
    CLIPSLexeme *peek;
+   struct atomTable *theTable = &SymbolData(theEnv)->SymbolTable;
+   struct atomSlot *theSlot;
 
-    tally = HashSymbol(str,SYMBOL_HASH_SIZE);
+    hashValue = HashSymbolLength(str,&length);
 
-    for (peek = SymbolData(theEnv)->SymbolTable[tally];
-         peek != NULL;
-         peek = peek->next)
+    for (theSlot = &theTable->slots[AtomTableHome(theTable,hashValue)];
+         theSlot->value != NULL;
+         theSlot = NextAtomSlot(theTable,theSlot))
       {
-       if (((1 << peek->header.type) & expectedType) &&
-           (strcmp(str,peek->contents) == 0))
+       peek = (CLIPSLexeme *) theSlot->value;
+       if ((theSlot->hashValue == hashValue) &&
+           (theSlot->length == length) &&
+           ((1 << peek->header.type) & expectedType) &&
+           (memcmp(str,peek->contents,length) == 0))
          { return peek; }
       }
 
@@ -489,47 +542,48 @@ CLIPSFloat *CreateFloat(
   Environment *theEnv,
   double number)
   {
-   size_t tally;
-   CLIPSFloat *past = NULL, *peek;
+   size_t hashValue;
+   CLIPSFloat *peek;
+   struct atomTable *theTable = &SymbolData(theEnv)->FloatTable;
+   struct atomSlot *theSlot;
 
     /*====================================*/
     /* Get the hash value for the double. */
     /*====================================*/
 
-    tally = HashFloat(number,FLOAT_HASH_SIZE);
-    peek = SymbolData(theEnv)->FloatTable[tally];
+    hashValue = HashFloat(number,0);
 
-    /*==================================================*/
-    /* Search for the double in the list of entries for */
-    /* this hash location.  If the double is found,     */
-    /* then return the address of the double.           */
-    /*==================================================*/
+    /*===============================================*/
+    /* Probe the table for the double. If the double */
+    /* is found, then return the address of the      */
+    /* double.                                       */
+    /*===============================================*/
 
-    while (peek != NULL)
+    for (theSlot = &theTable->slots[AtomTableHome(theTable,hashValue)];
+         theSlot->value != NULL;
+         theSlot = NextAtomSlot(theTable,theSlot))
       {
-       if (number == peek->contents)
+       peek = (CLIPSFloat *) theSlot->value;
+       if ((theSlot->hashValue == hashValue) &&
+           (number == peek->contents))
          { return peek; }
-       past = peek;
-       peek = peek->next;
       }
 
-    /*=================================================*/
-    /* Add the float at the end of the list of entries */
-    /* for this hash location.                         */
-    /*=================================================*/
+    /*=============================*/
+    /* Add the float to the table. */
+    /*=============================*/
 
     peek = get_struct(theEnv,clipsFloat);
 
-    if (past == NULL) SymbolData(theEnv)->FloatTable[tally] = peek;
-    else past->next = peek;
-
     peek->contents = number;
     peek->next = NULL;
-    peek->bucket = (unsigned int) tally;
+    peek->bucket = (unsigned int) (hashValue % FLOAT_HASH_SIZE);
     peek->count = 0;
     peek->permanent = false;
     peek->header.type = FLOAT_TYPE;
 
+    AddAtomTableEntry(theEnv,theTable,hashValue,0,(GENERIC_HN *) peek);
+
     /*===============================================*/
     /* Add the float to the list of ephemeral items. */
     /*===============================================*/
@@ -555,46 +609,60 @@ CLIPSInteger *CreateInteger(
   Environment *theEnv,
   long long number)
   {
-   size_t tally;
-   CLIPSInteger *past = NULL, *peek;
+   size_t hashValue;
+   CLIPSInteger *peek;
+   struct atomTable *theTable = &SymbolData(theEnv)->IntegerTable;
+   struct atomSlot *theSlot;
+
+    /*=================================================*/
+    /* Small integers are found by indexing the cache. */
+    /*=================================================*/
+
+    if (IsSmallInteger(number))
+      {
+       peek = SymbolData(theEnv)->SmallIntegers[number - SMALL_INTEGER_MINIMUM];
+       if (peek == NULL)
+         { peek = CreateSmallInteger(theEnv,number); }
+       return peek;
+      }
 
     /*==================================*/
     /* Get the hash value for the long. */
     /*==================================*/
 
-    tally = HashInteger(number,INTEGER_HASH_SIZE);
-    peek = SymbolData(theEnv)->IntegerTable[tally];
+    hashValue = HashInteger(number,0);
 
-    /*================================================*/
-    /* Search for the long in the list of entries for */
-    /* this hash location. If the long is found, then */
-    /* return the address of the long.                */
-    /*================================================*/
+    /*=============================================*/
+    /* Probe the table for the long. If the long   */
+    /* is found, then return the address of the    */
+    /* long.                                       */
+    /*=============================================*/
 
-    while (peek != NULL)
+    for (theSlot = &theTable->slots[AtomTableHome(theTable,hashValue)];
+         theSlot->value != NULL;
+         theSlot = NextAtomSlot(theTable,theSlot))
       {
-       if (number == peek->contents)
+       peek = (CLIPSInteger *) theSlot->value;
+       if ((theSlot->hashValue == hashValue) &&
+           (number == peek->contents))
          { return peek; }
-       past = peek;
-       peek = peek->next;
       }
 
-    /*================================================*/
-    /* Add the long at the end of the list of entries */
-    /* for this hash location.                        */
-    /*================================================*/
+    /*============================*/
+    /* Add the long to the table. */
+    /*============================*/
 
     peek = get_struct(theEnv,clipsInteger);
-    if (past == NULL) SymbolData(theEnv)->IntegerTable[tally] = peek;
-    else past->next = peek;
 
     peek->contents = number;
     peek->next = NULL;
-    peek->bucket = (unsigned int) tally;
+    peek->bucket = (unsigned int) (hashValue % INTEGER_HASH_SIZE);
     peek->count = 0;
     peek->permanent = false;
     peek->header.type = INTEGER_TYPE;
 
+    AddAtomTableEntry(theEnv,theTable,hashValue,0,(GENERIC_HN *) peek);
+
     /*=================================================*/
     /* Add the integer to the list of ephemeral items. */
     /*=================================================*/
@@ -618,15 +686,25 @@ CLIPSInteger *FindLongHN(
   Environment *theEnv,
   long long theLong)
   {
-   size_t tally;
    CLIPSInteger *peek;
+   struct atomTable *theTable = &SymbolData(theEnv)->IntegerTable;
+   struct atomSlot *theSlot;
+   size_t hashValue;
 
-   tally = HashInteger(theLong,INTEGER_HASH_SIZE);
+   if (IsSmallInteger(theLong))
+     { return SymbolData(theEnv)->SmallIntegers[theLong - SMALL_INTEGER_MINIMUM]; }
 
-   for (peek = SymbolData(theEnv)->IntegerTable[tally];
-        peek != NULL;
-        peek = peek->next)
-     { if (peek->contents == theLong) return(peek); }
+   hashValue = HashInteger(theLong,0);
+
+   for (theSlot = &theTable->slots[AtomTableHome(theTable,hashValue)];
+        theSlot->value != NULL;
+        theSlot = NextAtomSlot(theTable,theSlot))
+     {
+      peek = (CLIPSInteger *) theSlot->value;
+      if ((theSlot->hashValue == hashValue) &&
+          (peek->contents == theLong))
+        { return peek; }
+     }
 
    return NULL;
   }
@@ -643,9 +721,11 @@ void *AddBitMap(
   unsigned short size)
   {
    char *theBitMap = (char *) vTheBitMap;
-   size_t tally;
+   size_t hashValue;
    unsigned short i;
-   CLIPSBitMap *past = NULL, *peek;
+   CLIPSBitMap *peek;
+   struct atomTable *theTable = &SymbolData(theEnv)->BitMapTable;
+   struct atomSlot *theSlot;
    char *buffer;
 
     /*====================================*/
@@ -658,48 +738,43 @@ void *AddBitMap(
        ExitRouter(theEnv,EXIT_FAILURE);
       }
 
-    tally = HashBitMap(theBitMap,BITMAP_HASH_SIZE,size);
-    peek = SymbolData(theEnv)->BitMapTable[tally];
+    hashValue = HashBitMap(theBitMap,0,size);
 
-    /*==================================================*/
-    /* Search for the bitmap in the list of entries for */
-    /* this hash table location.  If the bitmap is      */
-    /* found, then return the address of the bitmap.    */
-    /*==================================================*/
+    /*===============================================*/
+    /* Probe the table for the bitmap. If the bitmap */
+    /* is found, then return the address of the      */
+    /* bitmap.                                       */
+    /*===============================================*/
 
-    while (peek != NULL)
+    for (theSlot = &theTable->slots[AtomTableHome(theTable,hashValue)];
+         theSlot->value != NULL;
+         theSlot = NextAtomSlot(theTable,theSlot))
       {
-	   if (peek->size == size)
-         {
-          for (i = 0; i < size ; i++)
-            { if (peek->contents[i] != theBitMap[i]) break; }
-
-          if (i == size) return((void *) peek);
-         }
-
-       past = peek;
-       peek = peek->next;
+       peek = (CLIPSBitMap *) theSlot->value;
+       if ((theSlot->hashValue == hashValue) &&
+           (theSlot->length == size) &&
+           (memcmp(peek->contents,theBitMap,size) == 0))
+         { return((void *) peek); }
       }
 
-    /*==================================================*/
-    /* Add the bitmap at the end of the list of entries */
-    /* for this hash table location.  Return the        */
-    /*==================================================*/
+    /*==============================*/
+    /* Add the bitmap to the table. */
+    /*==============================*/
 
     peek = get_struct(theEnv,clipsBitMap);
-    if (past == NULL) SymbolData(theEnv)->BitMapTable[tally] = peek;
-    else past->next = peek;
 
     buffer = (char *) gm2(theEnv,size);
     for (i = 0; i < size ; i++) buffer[i] = theBitMap[i];
     peek->contents = buffer;
     peek->next = NULL;
-    peek->bucket = (unsigned int) tally;
+    peek->bucket = (unsigned int) (hashValue % BITMAP_HASH_SIZE);
     peek->count = 0;
     peek->permanent = false;
     peek->size = size;
     peek->header.type = BITMAP_TYPE;
 
+    AddAtomTableEntry(theEnv,theTable,hashValue,size,(GENERIC_HN *) peek);
+
     /*================================================*/
     /* Add the bitmap to the list of ephemeral items. */
     /*================================================*/
@@ -738,50 +813,50 @@ CLIPSExternalAddress *CreateExternalAddress(
   void *theExternalAddress,
   unsigned short theType)
   {
-   size_t tally;
-   CLIPSExternalAddress *past = NULL, *peek;
+   size_t hashValue;
+   CLIPSExternalAddress *peek;
+   struct atomTable *theTable = &SymbolData(theEnv)->ExternalAddressTable;
+   struct atomSlot *theSlot;
 
-    /*====================================*/
-    /* Get the hash value for the bitmap. */
-    /*====================================*/
+    /*==============================================*/
+    /* Get the hash value for the external address. */
+    /*==============================================*/
 
-    tally = HashExternalAddress(theExternalAddress,EXTERNAL_ADDRESS_HASH_SIZE);
+    hashValue = HashExternalAddress(theExternalAddress,0);
 
-    peek = SymbolData(theEnv)->ExternalAddressTable[tally];
-
-    /*=============================================================*/
-    /* Search for the external address in the list of entries for  */
-    /* this hash table location.  If the external addressis found, */
-    /* then return the address of the external address.            */
-    /*=============================================================*/
+    /*=================================================*/
+    /* Probe the table for the external address. If    */
+    /* the external address is found, then return the  */
+    /* address of the external address.                */
+    /*=================================================*/
 
-    while (peek != NULL)
+    for (theSlot = &theTable->slots[AtomTableHome(theTable,hashValue)];
+         theSlot->value != NULL;
+         theSlot = NextAtomSlot(theTable,theSlot))
       {
-       if ((peek->type == theType) &&
+       peek = (CLIPSExternalAddress *) theSlot->value;
+       if ((theSlot->hashValue == hashValue) &&
+           (peek->type == theType) &&
            (peek->contents == theExternalAddress))
          { return peek; }
-
-       past = peek;
-       peek = peek->next;
       }
 
-    /*=================================================*/
-    /* Add the external address at the end of the list */
-    /* of entries for this hash table location.        */
-    /*=================================================*/
+    /*========================================*/
+    /* Add the external address to the table. */
+    /*========================================*/
 
     peek = get_struct(theEnv,clipsExternalAddress);
-    if (past == NULL) SymbolData(theEnv)->ExternalAddressTable[tally] = peek;
-    else past->next = peek;
 
     peek->contents = theExternalAddress;
     peek->type = theType;
     peek->next = NULL;
-    peek->bucket = (unsigned int) tally;
+    peek->bucket = (unsigned int) (hashValue % EXTERNAL_ADDRESS_HASH_SIZE);
     peek->count = 0;
     peek->permanent = false;
     peek->header.type = EXTERNAL_ADDRESS_TYPE;
 
+    AddAtomTableEntry(theEnv,theTable,hashValue,0,(GENERIC_HN *) peek);
+
     /*================================================*/
     /* Add the bitmap to the list of ephemeral items. */
     /*================================================*/
@@ -850,15 +925,15 @@ size_t HashInteger(
 #if WIN_MVC
    if (number < 0)
      { number = - number; }
-   tally = (((size_t) number) % range);
+   tally = (size_t) number;
 #else
-   tally = (((size_t) llabs(number)) % range);
+   tally = (size_t) llabs(number);
 #endif
 
    if (range == 0)
      { return tally; }
 
-   return tally;
+   return tally % range;
   }
 
 /****************************************/
@@ -1155,49 +1230,334 @@ void ReleaseExternalAddress(
    return;
   }
 
-/************************************************/
-/* RemoveHashNode: Removes a hash node from the */
-/*   SymbolTable, FloatTable, IntegerTable,     */
-/*   BitMapTable, or ExternalAddressTable.      */
-/************************************************/
-static void RemoveHashNode(
+/*********************************************************/
+/* CreateSmallInteger: Creates an integer from the small */
+/*   integer range and stores it in the cache. Integers  */
+/*   in the cache are not stored in the integer table.   */
+/*   The cache holds a reference to each integer, so it  */
+/*   is never placed on the list of ephemeral values.    */
+/*********************************************************/
+static CLIPSInteger *CreateSmallInteger(
   Environment *theEnv,
+  long long number)
+  {
+   CLIPSInteger *theInteger;
+
+   theInteger = get_struct(theEnv,clipsInteger);
+
+   theInteger->contents = number;
+   theInteger->next = NULL;
+   theInteger->bucket = (unsigned int) HashInteger(number,INTEGER_HASH_SIZE);
+   theInteger->count = 1;
+   theInteger->permanent = false;
+   theInteger->markedEphemeral = false;
+   theInteger->neededInteger = false;
+   theInteger->header.type = INTEGER_TYPE;
+
+   SymbolData(theEnv)->SmallIntegers[number - SMALL_INTEGER_MINIMUM] = theInteger;
+
+   return theInteger;
+  }
+
+/*************************************************************/
+/* GetNextInteger: Iterates over the integers in the integer */
+/*   table followed by those in the small integer cache. The */
+/*   position should be zero to retrieve the first integer.  */
+/*************************************************************/
+CLIPSInteger *GetNextInteger(
+  Environment *theEnv,
+  size_t *position)
+  {
+   struct atomTable *theTable = &SymbolData(theEnv)->IntegerTable;
+   CLIPSInteger *theInteger;
+
+   while (*position < theTable->size)
+     {
+      theInteger = (CLIPSInteger *) theTable->slots[(*position)++].value;
+      if (theInteger != NULL)
+        { return theInteger; }
+     }
+
+   while ((*position - theTable->size) < SMALL_INTEGER_CACHE_SIZE)
+     {
+      theInteger = SymbolData(theEnv)->SmallIntegers[(*position)++ - theTable->size];
+      if (theInteger != NULL)
+        { return theInteger; }
+     }
+
+   return NULL;
+  }
+
+/*********************************************************/
+/* HashSymbolLength: Computes the same hash value as     */
+/*   HashSymbol with a range of zero while also finding  */
+/*   the length of the string.                           */
+/*********************************************************/
+static size_t HashSymbolLength(
+  const char *word,
+  size_t *length)
+  {
+   size_t i;
+   size_t tally = 0;
+
+   for (i = 0; word[i]; i++)
+     { tally = tally * 127 + (size_t) word[i]; }
+
+   *length = i;
+   return tally;
+  }
+
+/*************************************************************/
+/* AtomHashValue: Recomputes the hash value which was cached */
+/*   in the atom table slot for an existing atomic value.    */
+/*************************************************************/
+static size_t AtomHashValue(
   GENERIC_HN *theValue,
-  GENERIC_HN **theTable,
-  int size,
   int type)
   {
-   GENERIC_HN *previousNode, *currentNode;
-   CLIPSExternalAddress *theAddress;
+   switch (type)
+     {
+      case SYMBOL_TYPE:
+        return HashSymbol(((CLIPSLexeme *) theValue)->contents,0);
+
+      case FLOAT_TYPE:
+        return HashFloat(((CLIPSFloat *) theValue)->contents,0);
+
+      case INTEGER_TYPE:
+        return HashInteger(((CLIPSInteger *) theValue)->contents,0);
+
+      case BITMAPARRAY:
+        return HashBitMap(((CLIPSBitMap *) theValue)->contents,0,((CLIPSBitMap *) theValue)->size);
+
+      case EXTERNAL_ADDRESS_TYPE:
+        return HashExternalAddress(((CLIPSExternalAddress *) theValue)->contents,0);
+     }
+
+   return 0;
+  }
+
+/*****************************************************/
+/* AtomTableHome: Returns the slot at which probing  */
+/*   for a hash value begins. The hash value is      */
+/*   mixed first since the hash values of integers   */
+/*   and addresses often differ only in high bits.   */
+/*****************************************************/
+size_t AtomTableHome(
+  struct atomTable *theTable,
+  size_t hashValue)
+  {
+   unsigned long long mix = (unsigned long long) hashValue;
+
+   mix ^= mix >> 33;
+   mix *= 0xff51afd7ed558ccdULL;
+   mix ^= mix >> 33;
+
+   return (size_t) mix & (theTable->size - 1);
+  }
+
+/********************************************************/
+/* InitializeAtomTable: Allocates the slots for an atom */
+/*   table. The size must be a power of two.            */
+/********************************************************/
+static void InitializeAtomTable(
+  Environment *theEnv,
+  struct atomTable *theTable,
+  size_t size)
+  {
+   size_t i;
+
+   theTable->slots = (struct atomSlot *) genalloc(theEnv,sizeof(struct atomSlot) * size);
+   for (i = 0; i < size; i++)
+     {
+      theTable->slots[i].hashValue = 0;
+      theTable->slots[i].length = 0;
+      theTable->slots[i].value = NULL;
+     }
+
+   theTable->size = size;
+   theTable->count = 0;
+   theTable->initialSize = size;
+  }
+
+/*****************************************************/
+/* ReturnAtomTable: Deallocates the slots of an atom */
+/*   table. The atomic values are not deallocated.   */
+/*****************************************************/
+static void ReturnAtomTable(
+  Environment *theEnv,
+  struct atomTable *theTable)
+  {
+   genfree(theEnv,theTable->slots,sizeof(struct atomSlot) * theTable->size);
+   theTable->slots = NULL;
+   theTable->size = 0;
+   theTable->count = 0;
+  }
+
+/**************************************************/
+/* PlaceAtomSlot: Stores an entry in the first    */
+/*   empty slot of its probe sequence. The table  */
+/*   must have at least one empty slot.           */
+/**************************************************/
+static void PlaceAtomSlot(
+  struct atomTable *theTable,
+  size_t hashValue,
+  size_t length,
+  GENERIC_HN *theValue)
+  {
+   struct atomSlot *theSlot;
+
+   for (theSlot = &theTable->slots[AtomTableHome(theTable,hashValue)];
+        theSlot->value != NULL;
+        theSlot = NextAtomSlot(theTable,theSlot))
+     { /* Do Nothing */ }
+
+   theSlot->hashValue = hashValue;
+   theSlot->length = length;
+   theSlot->value = theValue;
+  }
+
+/*************************************************/
+/* ResizeAtomTable: Rehashes the entries of an   */
+/*   atom table into a table of the given size.  */
+/*************************************************/
+static void ResizeAtomTable(
+  Environment *theEnv,
+  struct atomTable *theTable,
+  size_t newSize)
+  {
+   struct atomSlot *oldSlots = theTable->slots;
+   size_t oldSize = theTable->size, i;
+
+   theTable->slots = (struct atomSlot *) genalloc(theEnv,sizeof(struct atomSlot) * newSize);
+   theTable->size = newSize;
+   for (i = 0; i < newSize; i++)
+     {
+      theTable->slots[i].hashValue = 0;
+      theTable->slots[i].length = 0;
+      theTable->slots[i].value = NULL;
+     }
+
+   for (i = 0; i < oldSize; i++)
+     {
+      if (oldSlots[i].value != NULL)
+        { PlaceAtomSlot(theTable,oldSlots[i].hashValue,oldSlots[i].length,oldSlots[i].value); }
+     }
+
+   genfree(theEnv,oldSlots,sizeof(struct atomSlot) * oldSize);
+  }
+
+/****************************************************/
+/* AddAtomTableEntry: Adds a new atomic value to an */
+/*   atom table, doubling the table first if the    */
+/*   addition would exceed the maximum load.        */
+/****************************************************/
+static void AddAtomTableEntry(
+  Environment *theEnv,
+  struct atomTable *theTable,
+  size_t hashValue,
+  size_t length,
+  GENERIC_HN *theValue)
+  {
+   if ((theTable->count + 1) > ATOM_TABLE_MAXIMUM_LOAD(theTable->size))
+     { ResizeAtomTable(theEnv,theTable,theTable->size * 2); }
+
+   PlaceAtomSlot(theTable,hashValue,length,theValue);
+   theTable->count++;
+  }
+
+/*******************************************************/
+/* FindAtomTableSlot: Returns the index of the slot    */
+/*   holding an atomic value or the size of the table  */
+/*   if the value is not in the table.                 */
+/*******************************************************/
+static size_t FindAtomTableSlot(
+  struct atomTable *theTable,
+  size_t hashValue,
+  GENERIC_HN *theValue)
+  {
+   struct atomSlot *theSlot;
 
-   /*=============================================*/
-   /* Find the entry in the specified hash table. */
-   /*=============================================*/
+   for (theSlot = &theTable->slots[AtomTableHome(theTable,hashValue)];
+        theSlot->value != NULL;
+        theSlot = NextAtomSlot(theTable,theSlot))
+     {
+      if (theSlot->value == theValue)
+        { return (size_t) (theSlot - theTable->slots); }
+     }
 
-   previousNode = NULL;
-   currentNode = theTable[theValue->bucket];
+   return theTable->size;
+  }
 
-   while (currentNode != theValue)
+/*********************************************************/
+/* RemoveAtomTableEntry: Removes an atomic value from an */
+/*   atom table. Later entries of the same probe run are */
+/*   shifted back so that no deleted markers are needed. */
+/*   The table is halved if it falls below the minimum   */
+/*   load and is larger than its initial size.           */
+/*********************************************************/
+static void RemoveAtomTableEntry(
+  Environment *theEnv,
+  struct atomTable *theTable,
+  size_t hashValue,
+  GENERIC_HN *theValue)
+  {
+   size_t mask = theTable->size - 1;
+   size_t i, j, k;
+
+   i = FindAtomTableSlot(theTable,hashValue,theValue);
+   if (i == theTable->size)
      {
-      previousNode = currentNode;
-      currentNode = currentNode->next;
+      SystemError(theEnv,"SYMBOL",11);
+      ExitRouter(theEnv,EXIT_FAILURE);
+     }
 
-      if (currentNode == NULL)
+   for (j = (i + 1) & mask;
+        theTable->slots[j].value != NULL;
+        j = (j + 1) & mask)
+     {
+      k = AtomTableHome(theTable,theTable->slots[j].hashValue);
+
+      /*====================================================*/
+      /* The entry in slot j can fill the hole at slot i if */
+      /* its home slot does not lie cyclically in (i, j].   */
+      /*====================================================*/
+
+      if ((j > i) ? ((k <= i) || (k > j)) : ((k <= i) && (k > j)))
         {
-         SystemError(theEnv,"SYMBOL",11);
-         ExitRouter(theEnv,EXIT_FAILURE);
+         theTable->slots[i] = theTable->slots[j];
+         i = j;
         }
      }
 
-   /*===========================================*/
-   /* Remove the entry from the list of entries */
-   /* stored in the hash table bucket.          */
-   /*===========================================*/
+   theTable->slots[i].hashValue = 0;
+   theTable->slots[i].length = 0;
+   theTable->slots[i].value = NULL;
+   theTable->count--;
 
-   if (previousNode == NULL)
-     { theTable[theValue->bucket] = theValue->next; }
-   else
-     { previousNode->next = currentNode->next; }
+   if ((theTable->size > theTable->initialSize) &&
+       (theTable->count < ATOM_TABLE_MINIMUM_LOAD(theTable->size)))
+     { ResizeAtomTable(theEnv,theTable,theTable->size / 2); }
+  }
+
+/************************************************/
+/* RemoveHashNode: Removes a hash node from the */
+/*   SymbolTable, FloatTable, IntegerTable,     */
+/*   BitMapTable, or ExternalAddressTable.      */
+/************************************************/
+static void RemoveHashNode(
+  Environment *theEnv,
+  GENERIC_HN *theValue,
+  struct atomTable *theTable,
+  int size,
+  int type)
+  {
+   CLIPSExternalAddress *theAddress;
+
+   /*============================================*/
+   /* Remove the entry from the specified table. */
+   /*============================================*/
+
+   RemoveAtomTableEntry(theEnv,theTable,AtomHashValue(theValue,type),theValue);
 
    /*=================================================*/
    /* Symbol and bit map nodes have additional memory */
@@ -1273,6 +1633,7 @@ static void AddEphemeralHashNode(
    temp->associatedValue = theHashNode;
    temp->next = *theEphemeralList;
    *theEphemeralList = temp;
+   UtilityData(theEnv)->CurrentGarbageFrame->nurseryCount++;
   }
 
 /***************************************************/
@@ -1289,15 +1650,15 @@ void RemoveEphemeralAtoms(
    theGarbageFrame = UtilityData(theEnv)->CurrentGarbageFrame;
    if (! theGarbageFrame->dirty) return;
 
-   RemoveEphemeralHashNodes(theEnv,&theGarbageFrame->ephemeralSymbolList,(GENERIC_HN **) SymbolData(theEnv)->SymbolTable,
+   RemoveEphemeralHashNodes(theEnv,&theGarbageFrame->ephemeralSymbolList,&SymbolData(theEnv)->SymbolTable,
                             sizeof(CLIPSLexeme),SYMBOL_TYPE,AVERAGE_STRING_SIZE);
-   RemoveEphemeralHashNodes(theEnv,&theGarbageFrame->ephemeralFloatList,(GENERIC_HN **) SymbolData(theEnv)->FloatTable,
+   RemoveEphemeralHashNodes(theEnv,&theGarbageFrame->ephemeralFloatList,&SymbolData(theEnv)->FloatTable,
                             sizeof(CLIPSFloat),FLOAT_TYPE,0);
-   RemoveEphemeralHashNodes(theEnv,&theGarbageFrame->ephemeralIntegerList,(GENERIC_HN **) SymbolData(theEnv)->IntegerTable,
+   RemoveEphemeralHashNodes(theEnv,&theGarbageFrame->ephemeralIntegerList,&SymbolData(theEnv)->IntegerTable,
                             sizeof(CLIPSInteger),INTEGER_TYPE,0);
-   RemoveEphemeralHashNodes(theEnv,&theGarbageFrame->ephemeralBitMapList,(GENERIC_HN **) SymbolData(theEnv)->BitMapTable,
+   RemoveEphemeralHashNodes(theEnv,&theGarbageFrame->ephemeralBitMapList,&SymbolData(theEnv)->BitMapTable,
                             sizeof(CLIPSBitMap),BITMAPARRAY,AVERAGE_BITMAP_SIZE);
-   RemoveEphemeralHashNodes(theEnv,&theGarbageFrame->ephemeralExternalAddressList,(GENERIC_HN **) SymbolData(theEnv)->ExternalAddressTable,
+   RemoveEphemeralHashNodes(theEnv,&theGarbageFrame->ephemeralExternalAddressList,&SymbolData(theEnv)->ExternalAddressTable,
                             sizeof(CLIPSExternalAddress),EXTERNAL_ADDRESS_TYPE,0);
   }
 
@@ -1377,7 +1738,7 @@ void EphemerateValue(
 static void RemoveEphemeralHashNodes(
   Environment *theEnv,
   struct ephemeron **theEphemeralList,
-  GENERIC_HN **theTable,
+  struct atomTable *theTable,
   int hashNodeSize,
   int hashNodeType,
   int averageContentsSize)
@@ -1439,96 +1800,46 @@ static void RemoveEphemeralHashNodes(
 /*********************************************************/
 /* GetSymbolTable: Returns a pointer to the SymbolTable. */
 /*********************************************************/
-CLIPSLexeme **GetSymbolTable(
+struct atomTable *GetSymbolTable(
   Environment *theEnv)
   {
-   return(SymbolData(theEnv)->SymbolTable);
-  }
-
-/******************************************************/
-/* SetSymbolTable: Sets the value of the SymbolTable. */
-/******************************************************/
-void SetSymbolTable(
-  Environment *theEnv,
-  CLIPSLexeme **value)
-  {
-   SymbolData(theEnv)->SymbolTable = value;
+   return(&SymbolData(theEnv)->SymbolTable);
   }
 
 /*******************************************************/
 /* GetFloatTable: Returns a pointer to the FloatTable. */
 /*******************************************************/
-CLIPSFloat **GetFloatTable(
+struct atomTable *GetFloatTable(
   Environment *theEnv)
   {
-   return(SymbolData(theEnv)->FloatTable);
-  }
-
-/****************************************************/
-/* SetFloatTable: Sets the value of the FloatTable. */
-/****************************************************/
-void SetFloatTable(
-  Environment *theEnv,
-  CLIPSFloat **value)
-  {
-   SymbolData(theEnv)->FloatTable = value;
+   return(&SymbolData(theEnv)->FloatTable);
   }
 
 /***********************************************************/
 /* GetIntegerTable: Returns a pointer to the IntegerTable. */
 /***********************************************************/
-CLIPSInteger **GetIntegerTable(
+struct atomTable *GetIntegerTable(
   Environment *theEnv)
   {
-   return(SymbolData(theEnv)->IntegerTable);
-  }
-
-/********************************************************/
-/* SetIntegerTable: Sets the value of the IntegerTable. */
-/********************************************************/
-void SetIntegerTable(
-  Environment *theEnv,
-  CLIPSInteger **value)
-  {
-   SymbolData(theEnv)->IntegerTable = value;
+   return(&SymbolData(theEnv)->IntegerTable);
   }
 
 /*********************************************************/
 /* GetBitMapTable: Returns a pointer to the BitMapTable. */
 /*********************************************************/
-CLIPSBitMap **GetBitMapTable(
+struct atomTable *GetBitMapTable(
   Environment *theEnv)
   {
-   return(SymbolData(theEnv)->BitMapTable);
-  }
-
-/******************************************************/
-/* SetBitMapTable: Sets the value of the BitMapTable. */
-/******************************************************/
-void SetBitMapTable(
-  Environment *theEnv,
-  CLIPSBitMap **value)
-  {
-   SymbolData(theEnv)->BitMapTable = value;
+   return(&SymbolData(theEnv)->BitMapTable);
   }
 
 /***************************************************************************/
 /* GetExternalAddressTable: Returns a pointer to the ExternalAddressTable. */
 /***************************************************************************/
-CLIPSExternalAddress **GetExternalAddressTable(
+struct atomTable *GetExternalAddressTable(
   Environment *theEnv)
   {
-   return(SymbolData(theEnv)->ExternalAddressTable);
-  }
-
-/************************************************************************/
-/* SetExternalAddressTable: Sets the value of the ExternalAddressTable. */
-/************************************************************************/
-void SetExternalAddressTable(
-  Environment *theEnv,
-  CLIPSExternalAddress **value)
-  {
-   SymbolData(theEnv)->ExternalAddressTable = value;
+   return(&SymbolData(theEnv)->ExternalAddressTable);
   }
 
 /******************************************************/
@@ -1637,9 +1948,9 @@ CLIPSLexeme *GetNextSymbolMatch(
   bool anywhere,
   size_t *commonPrefixLength)
   {
-   unsigned long i;
+   size_t i;
    CLIPSLexeme *hashPtr;
-   bool flag = true;
+   struct atomTable *theTable = &SymbolData(theEnv)->SymbolTable;
    size_t prefixLength;
 
    /*==========================================*/
@@ -1656,10 +1967,7 @@ CLIPSLexeme *GetNextSymbolMatch(
    /*========================================================*/
 
    if (prevSymbol == NULL)
-     {
-      i = 0;
-      hashPtr = SymbolData(theEnv)->SymbolTable[0];
-     }
+     { i = 0; }
 
    /*==========================================*/
    /* Otherwise start the search at the symbol */
@@ -1668,89 +1976,77 @@ CLIPSLexeme *GetNextSymbolMatch(
 
    else
      {
-      i = prevSymbol->bucket;
-      hashPtr = prevSymbol->next;
+      i = FindAtomTableSlot(theTable,AtomHashValue((GENERIC_HN *) prevSymbol,SYMBOL_TYPE),
+                            (GENERIC_HN *) prevSymbol) + 1;
      }
 
-   /*==============================================*/
-   /* Search through all the symbol table buckets. */
-   /*==============================================*/
+   /*==================================================*/
+   /* Search through the remaining symbol table slots. */
+   /*==================================================*/
 
-   while (flag)
+   for (; i < theTable->size; i++)
      {
-      /*===================================*/
-      /* Search through all of the entries */
-      /* in the bucket being examined.     */
-      /*===================================*/
+      hashPtr = (CLIPSLexeme *) theTable->slots[i].value;
+
+      /*==================================================*/
+      /* Skip empty slots and symbols that being with (   */
+      /* since these are typically symbols for internal   */
+      /* use. Also skip any symbols that are marked       */
+      /* ephemeral since these aren't in use.             */
+      /*==================================================*/
 
-      for (; hashPtr != NULL; hashPtr = hashPtr->next)
+      if ((hashPtr == NULL) ||
+          (hashPtr->contents[0] == '(') ||
+          (hashPtr->markedEphemeral))
+        { continue; }
+
+      /*==================================================*/
+      /* Two types of matching can be performed: the type */
+      /* comparing just to the beginning of the string    */
+      /* and the type which looks for the substring       */
+      /* anywhere within the string being examined.       */
+      /*==================================================*/
+
+      if (! anywhere)
         {
-         /*================================================*/
-         /* Skip symbols that being with ( since these are */
-         /* typically symbols for internal use. Also skip  */
-         /* any symbols that are marked ephemeral since    */
-         /* these aren't in use.                           */
-         /*================================================*/
-
-         if ((hashPtr->contents[0] == '(') ||
-             (hashPtr->markedEphemeral))
-           { continue; }
-
-         /*==================================================*/
-         /* Two types of matching can be performed: the type */
-         /* comparing just to the beginning of the string    */
-         /* and the type which looks for the substring       */
-         /* anywhere within the string being examined.       */
-         /*==================================================*/
-
-         if (! anywhere)
+         /*=============================================*/
+         /* Determine the common prefix length between  */
+         /* the previously found match (if available or */
+         /* the search string if not) and the symbol    */
+         /* table entry.                                */
+         /*=============================================*/
+
+         if (prevSymbol != NULL)
+           prefixLength = CommonPrefixLength(prevSymbol->contents,hashPtr->contents);
+         else
+           prefixLength = CommonPrefixLength(searchString,hashPtr->contents);
+
+         /*===================================================*/
+         /* If the prefix length is greater than or equal to  */
+         /* the length of the search string, then we've found */
+         /* a match. If this is the first match, the common   */
+         /* prefix length is set to the length of the first   */
+         /* match, otherwise the common prefix length is the  */
+         /* smallest prefix length found among all matches.   */
+         /*===================================================*/
+
+         if (prefixLength >= searchLength)
            {
-            /*=============================================*/
-            /* Determine the common prefix length between  */
-            /* the previously found match (if available or */
-            /* the search string if not) and the symbol    */
-            /* table entry.                                */
-            /*=============================================*/
-
-            if (prevSymbol != NULL)
-              prefixLength = CommonPrefixLength(prevSymbol->contents,hashPtr->contents);
-            else
-              prefixLength = CommonPrefixLength(searchString,hashPtr->contents);
-
-            /*===================================================*/
-            /* If the prefix length is greater than or equal to  */
-            /* the length of the search string, then we've found */
-            /* a match. If this is the first match, the common   */
-            /* prefix length is set to the length of the first   */
-            /* match, otherwise the common prefix length is the  */
-            /* smallest prefix length found among all matches.   */
-            /*===================================================*/
-
-            if (prefixLength >= searchLength)
+            if (commonPrefixLength != NULL)
               {
-               if (commonPrefixLength != NULL)
-                 {
-                  if (prevSymbol == NULL)
-                    *commonPrefixLength = strlen(hashPtr->contents);
-                  else if (prefixLength < *commonPrefixLength)
-                    *commonPrefixLength = prefixLength;
-                 }
-               return(hashPtr);
+               if (prevSymbol == NULL)
+                 *commonPrefixLength = strlen(hashPtr->contents);
+               else if (prefixLength < *commonPrefixLength)
+                 *commonPrefixLength = prefixLength;
               }
-           }
-         else
-           {
-            if (StringWithinString(hashPtr->contents,searchString) != NULL)
-              { return(hashPtr); }
+            return(hashPtr);
            }
         }
-
-      /*=================================================*/
-      /* Move on to the next bucket in the symbol table. */
-      /*=================================================*/
-
-      if (++i >= SYMBOL_HASH_SIZE) flag = false;
-      else hashPtr = SymbolData(theEnv)->SymbolTable[i];
+      else
+        {
+         if (StringWithinString(hashPtr->contents,searchString) != NULL)
+           { return(hashPtr); }
+        }
      }
 
    /*=====================================*/
@@ -1808,28 +2104,27 @@ void SetAtomicValueIndices(
   bool setAll)
   {
    unsigned int count;
-   unsigned int i;
-   CLIPSLexeme *symbolPtr, **symbolArray;
-   CLIPSFloat *floatPtr, **floatArray;
-   CLIPSInteger *integerPtr, **integerArray;
-   CLIPSBitMap *bitMapPtr, **bitMapArray;
+   size_t i;
+   struct atomTable *theTable;
+   CLIPSLexeme *symbolPtr;
+   CLIPSFloat *floatPtr;
+   CLIPSInteger *integerPtr;
+   CLIPSBitMap *bitMapPtr;
 
    /*===================================*/
    /* Set indices for the symbol table. */
    /*===================================*/
 
    count = 0;
-   symbolArray = GetSymbolTable(theEnv);
+   theTable = GetSymbolTable(theEnv);
 
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+   for (i = 0; i < theTable->size; i++)
      {
-      for (symbolPtr = symbolArray[i];
-           symbolPtr != NULL;
-           symbolPtr = symbolPtr->next)
-        {
-         if ((symbolPtr->neededSymbol == true) || setAll)
-           { symbolPtr->bucket = count++; }
-        }
+      symbolPtr = (CLIPSLexeme *) theTable->slots[i].value;
+      if (symbolPtr == NULL) continue;
+
+      if ((symbolPtr->neededSymbol == true) || setAll)
+        { symbolPtr->bucket = count++; }
      }
 
    /*==================================*/
@@ -1837,17 +2132,15 @@ void SetAtomicValueIndices(
    /*==================================*/
 
    count = 0;
-   floatArray = GetFloatTable(theEnv);
+   theTable = GetFloatTable(theEnv);
 
-   for (i = 0; i < FLOAT_HASH_SIZE; i++)
+   for (i = 0; i < theTable->size; i++)
      {
-      for (floatPtr = floatArray[i];
-           floatPtr != NULL;
-           floatPtr = floatPtr->next)
-        {
-         if ((floatPtr->neededFloat == true) || setAll)
-           { floatPtr->bucket = count++; }
-        }
+      floatPtr = (CLIPSFloat *) theTable->slots[i].value;
+      if (floatPtr == NULL) continue;
+
+      if ((floatPtr->neededFloat == true) || setAll)
+        { floatPtr->bucket = count++; }
      }
 
    /*====================================*/
@@ -1855,17 +2148,12 @@ void SetAtomicValueIndices(
    /*====================================*/
 
    count = 0;
-   integerArray = GetIntegerTable(theEnv);
+   i = 0;
 
-   for (i = 0; i < INTEGER_HASH_SIZE; i++)
+   while ((integerPtr = GetNextInteger(theEnv,&i)) != NULL)
      {
-      for (integerPtr = integerArray[i];
-           integerPtr != NULL;
-           integerPtr = integerPtr->next)
-        {
-         if ((integerPtr->neededInteger == true) || setAll)
-           { integerPtr->bucket = count++; }
-        }
+      if ((integerPtr->neededInteger == true) || setAll)
+        { integerPtr->bucket = count++; }
      }
 
    /*===================================*/
@@ -1873,17 +2161,15 @@ void SetAtomicValueIndices(
    /*===================================*/
 
    count = 0;
-   bitMapArray = GetBitMapTable(theEnv);
+   theTable = GetBitMapTable(theEnv);
 
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+   for (i = 0; i < theTable->size; i++)
      {
-      for (bitMapPtr = bitMapArray[i];
-           bitMapPtr != NULL;
-           bitMapPtr = bitMapPtr->next)
-        {
-         if ((bitMapPtr->neededBitMap == true) || setAll)
-           { bitMapPtr->bucket = count++; }
-        }
+      bitMapPtr = (CLIPSBitMap *) theTable->slots[i].value;
+      if (bitMapPtr == NULL) continue;
+
+      if ((bitMapPtr->neededBitMap == true) || setAll)
+        { bitMapPtr->bucket = count++; }
      }
   }
 
@@ -1895,66 +2181,57 @@ void SetAtomicValueIndices(
 void RestoreAtomicValueBuckets(
   Environment *theEnv)
   {
-   unsigned int i;
-   CLIPSLexeme *symbolPtr, **symbolArray;
-   CLIPSFloat *floatPtr, **floatArray;
-   CLIPSInteger *integerPtr, **integerArray;
-   CLIPSBitMap *bitMapPtr, **bitMapArray;
+   size_t i;
+   struct atomTable *theTable;
+   struct atomSlot *theSlot;
+   CLIPSInteger *integerPtr;
 
    /*================================================*/
    /* Restore the bucket values in the symbol table. */
    /*================================================*/
 
-   symbolArray = GetSymbolTable(theEnv);
+   theTable = GetSymbolTable(theEnv);
 
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+   for (i = 0; i < theTable->size; i++)
      {
-      for (symbolPtr = symbolArray[i];
-           symbolPtr != NULL;
-           symbolPtr = symbolPtr->next)
-        { symbolPtr->bucket = i; }
+      theSlot = &theTable->slots[i];
+      if (theSlot->value == NULL) continue;
+      ((CLIPSLexeme *) theSlot->value)->bucket = theSlot->hashValue % SYMBOL_HASH_SIZE;
      }
 
    /*===============================================*/
    /* Restore the bucket values in the float table. */
    /*===============================================*/
 
-   floatArray = GetFloatTable(theEnv);
+   theTable = GetFloatTable(theEnv);
 
-   for (i = 0; i < FLOAT_HASH_SIZE; i++)
+   for (i = 0; i < theTable->size; i++)
      {
-      for (floatPtr = floatArray[i];
-           floatPtr != NULL;
-           floatPtr = floatPtr->next)
-        { floatPtr->bucket = i; }
+      theSlot = &theTable->slots[i];
+      if (theSlot->value == NULL) continue;
+      ((CLIPSFloat *) theSlot->value)->bucket = theSlot->hashValue % FLOAT_HASH_SIZE;
      }
 
    /*=================================================*/
    /* Restore the bucket values in the integer table. */
    /*=================================================*/
 
-   integerArray = GetIntegerTable(theEnv);
+   i = 0;
 
-   for (i = 0; i < INTEGER_HASH_SIZE; i++)
-     {
-      for (integerPtr = integerArray[i];
-           integerPtr != NULL;
-           integerPtr = integerPtr->next)
-        { integerPtr->bucket = i; }
-     }
+   while ((integerPtr = GetNextInteger(theEnv,&i)) != NULL)
+     { integerPtr->bucket = (unsigned int) HashInteger(integerPtr->contents,INTEGER_HASH_SIZE); }
 
    /*================================================*/
    /* Restore the bucket values in the bitmap table. */
    /*================================================*/
 
-   bitMapArray = GetBitMapTable(theEnv);
+   theTable = GetBitMapTable(theEnv);
 
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+   for (i = 0; i < theTable->size; i++)
      {
-      for (bitMapPtr = bitMapArray[i];
-           bitMapPtr != NULL;
-           bitMapPtr = bitMapPtr->next)
-        { bitMapPtr->bucket = i; }
+      theSlot = &theTable->slots[i];
+      if (theSlot->value == NULL) continue;
+      ((CLIPSBitMap *) theSlot->value)->bucket = theSlot->hashValue % BITMAP_HASH_SIZE;
      }
   }
 
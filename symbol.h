@@ -74,6 +74,12 @@
 /*                                                           */
 /*            UDF redesign.                                  */
 /*                                                           */
+/*            Replaced the bucket chained atom tables with   */
+/*            open addressed tables. GetSymbolTable and the  */
+/*            other Get*Table functions now return the atom  */
+/*            table and the Set*Table functions were         */
+/*            removed.                                       */
+/*                                                           */
 /*************************************************************/
 
 #ifndef _H_symbol
@@ -88,6 +94,15 @@
 
 typedef struct genericHashNode GENERIC_HN;
 
+/*==========================================================*/
+/* The hash sizes determine the range of the bucket value   */
+/* stored with each atomic value. The bucket value is a     */
+/* stable hash used by other modules and by the bucket      */
+/* chained tables passed to run-time programs. The atom     */
+/* tables themselves are open addressed and resized to keep */
+/* their load factor between the minimum and the maximum.   */
+/*==========================================================*/
+
 #ifndef SYMBOL_HASH_SIZE
 #define SYMBOL_HASH_SIZE       63559L
 #endif
@@ -108,6 +123,39 @@ typedef struct genericHashNode GENERIC_HN;
 #define EXTERNAL_ADDRESS_HASH_SIZE        8191
 #endif
 
+#ifndef SYMBOL_TABLE_INITIAL_SIZE
+#define SYMBOL_TABLE_INITIAL_SIZE        4096
+#endif
+
+#ifndef ATOM_TABLE_INITIAL_SIZE
+#define ATOM_TABLE_INITIAL_SIZE           256
+#endif
+
+#define ATOM_TABLE_MAXIMUM_LOAD(size) (((size) / 4) * 3)
+#define ATOM_TABLE_MINIMUM_LOAD(size) ((size) / 8)
+
+/*=========================================================*/
+/* Integers within the small integer range are kept in a   */
+/* cache indexed by value rather than in the integer table */
+/* and are retained once created. Defining the maximum     */
+/* below the minimum disables the cache.                   */
+/*=========================================================*/
+
+#ifndef SMALL_INTEGER_MINIMUM
+#define SMALL_INTEGER_MINIMUM          -1024LL
+#endif
+
+#ifndef SMALL_INTEGER_MAXIMUM
+#define SMALL_INTEGER_MAXIMUM          65535LL
+#endif
+
+#define SMALL_INTEGER_CACHE_SIZE \
+   ((SMALL_INTEGER_MAXIMUM >= SMALL_INTEGER_MINIMUM) ? \
+    (size_t) (SMALL_INTEGER_MAXIMUM - SMALL_INTEGER_MINIMUM + 1) : 0)
+
+#define IsSmallInteger(number) \
+   (((number) >= SMALL_INTEGER_MINIMUM) && ((number) <= SMALL_INTEGER_MAXIMUM))
+
 /******************************/
 /* genericHashNode STRUCTURE: */
 /******************************/
@@ -122,6 +170,31 @@ struct genericHashNode
    unsigned int bucket : 29;
   };
 
+/**********************************************************/
+/* ATOMSLOT STRUCTURE: An entry in an open addressed atom */
+/*   table. The hash value and length of the atomic value */
+/*   are cached so that probing rarely needs to touch the */
+/*   atomic value itself. An empty slot has a NULL value. */
+/**********************************************************/
+struct atomSlot
+  {
+   size_t hashValue;
+   size_t length;
+   GENERIC_HN *value;
+  };
+
+/**************************************************************/
+/* ATOMTABLE STRUCTURE: A linear probing hash table of atomic */
+/*   values. The size is always a power of two.               */
+/**************************************************************/
+struct atomTable
+  {
+   struct atomSlot *slots;
+   size_t size;
+   size_t count;
+   size_t initialSize;
+  };
+
 /**********************************************************/
 /* EPHEMERON STRUCTURE: Data structure used to keep track */
 /*   of ephemeral symbols, floats, and integers.          */
@@ -165,11 +238,12 @@ struct symbolData
    CLIPSLexeme *PositiveInfinity;
    CLIPSLexeme *NegativeInfinity;
    CLIPSInteger *Zero;
-   CLIPSLexeme **SymbolTable;
-   CLIPSFloat **FloatTable;
-   CLIPSInteger **IntegerTable;
-   CLIPSBitMap **BitMapTable;
-   CLIPSExternalAddress **ExternalAddressTable;
+   struct atomTable SymbolTable;
+   struct atomTable FloatTable;
+   struct atomTable IntegerTable;
+   struct atomTable BitMapTable;
+   struct atomTable ExternalAddressTable;
+   CLIPSInteger **SmallIntegers;
 #if BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE || BLOAD_INSTANCES || BSAVE_INSTANCES
    unsigned long NumberOfSymbols;
    unsigned long NumberOfFloats;
@@ -213,16 +287,13 @@ struct symbolData
    void                           DecrementBitMapReferenceCount(Environment *,CLIPSBitMap *);
    void                           ReleaseExternalAddress(Environment *,CLIPSExternalAddress *);
    void                           RemoveEphemeralAtoms(Environment *);
-   CLIPSLexeme                  **GetSymbolTable(Environment *);
-   void                           SetSymbolTable(Environment *,CLIPSLexeme **);
-   CLIPSFloat                   **GetFloatTable(Environment *);
-   void                           SetFloatTable(Environment *,CLIPSFloat **);
-   CLIPSInteger                 **GetIntegerTable(Environment *);
-   void                           SetIntegerTable(Environment *,CLIPSInteger **);
-   CLIPSBitMap                  **GetBitMapTable(Environment *);
-   void                           SetBitMapTable(Environment *,CLIPSBitMap **);
-   CLIPSExternalAddress         **GetExternalAddressTable(Environment *);
-   void                           SetExternalAddressTable(Environment *,CLIPSExternalAddress **);
+   struct atomTable              *GetSymbolTable(Environment *);
+   struct atomTable              *GetFloatTable(Environment *);
+   struct atomTable              *GetIntegerTable(Environment *);
+   struct atomTable              *GetBitMapTable(Environment *);
+   struct atomTable              *GetExternalAddressTable(Environment *);
+   size_t                         AtomTableHome(struct atomTable *,size_t);
+   CLIPSInteger                  *GetNextInteger(Environment *,size_t *);
    void                           RefreshSpecialSymbols(Environment *);
    struct symbolMatch            *FindSymbolMatches(Environment *,const char *,unsigned *,size_t *);
    void                           ReturnSymbolMatches(Environment *,struct symbolMatch *);
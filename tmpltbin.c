@@ -48,6 +48,7 @@
 #include "envrnmnt.h"
 #include "factbin.h"
 #include "factmngr.h"
+#include "factqury.h"
 #include "memalloc.h"
 #include "tmpltdef.h"
 #include "tmpltpsr.h"
@@ -508,6 +509,7 @@ static void UpdateDeftemplate(
    theDeftemplate->numberOfSlots = bdtPtr->numberOfSlots;
    theDeftemplate->factList = NULL;
    theDeftemplate->lastFact = NULL;
+   theDeftemplate->queryIndexes = NULL;
   }
 
 /************************************************/
@@ -560,6 +562,15 @@ static void ClearBload(
    for (i = 0; i < DeftemplateBinaryData(theEnv)->NumberOfDeftemplates; i++)
      { UnmarkConstructHeader(theEnv,&DeftemplateBinaryData(theEnv)->DeftemplateArray[i].header); }
 
+#if FACT_SET_QUERIES
+   /*====================================*/
+   /* Delete the fact-set query indexes. */
+   /*====================================*/
+
+   for (i = 0; i < DeftemplateBinaryData(theEnv)->NumberOfDeftemplates; i++)
+     { DeleteQueryIndexes(theEnv,&DeftemplateBinaryData(theEnv)->DeftemplateArray[i]); }
+#endif
+
    /*=======================================*/
    /* Decrement in use counters for symbols */
    /* used as slot names.                   */
@@ -318,12 +318,12 @@ static void DeftemplateToCode(
    else
      { FactPatternNodeReference(theEnv,theTemplate->patternNetwork,theFile,imageID,maxIndices); }
 
-   /*============================================*/
-   /* Print the factList and lastFact references */
-   /* and close the structure.                   */
-   /*============================================*/
+   /*===========================================*/
+   /* Print the factList, lastFact, and query   */
+   /* index references and close the structure. */
+   /*===========================================*/
 
-   fprintf(theFile,",NULL,NULL}");
+   fprintf(theFile,",NULL,NULL,NULL}");
   }
 
 /*****************************************************/
@@ -55,6 +55,9 @@
 /*                                                           */
 /*            ALLOW_ENVIRONMENT_GLOBALS no longer supported. */
 /*                                                           */
+/*            Fact-set query slot indexes are deleted with   */
+/*            the deftemplate.                               */
+/*                                                           */
 /*************************************************************/
 
 #include "setup.h"
@@ -67,6 +70,7 @@
 #include "cstrnchk.h"
 #include "envrnmnt.h"
 #include "exprnops.h"
+#include "factqury.h"
 #include "memalloc.h"
 #include "modulpsr.h"
 #include "modulutl.h"
@@ -350,6 +354,10 @@ static void ReturnDeftemplate(
 
    ReturnSlots(theEnv,theDeftemplate->slotList);
 
+#if FACT_SET_QUERIES
+   DeleteQueryIndexes(theEnv,theDeftemplate);
+#endif
+
    /*==================================*/
    /* Free storage used by the header. */
    /*==================================*/
@@ -386,6 +394,10 @@ static void DestroyDeftemplate(
 
    DestroyFactPatternNetwork(theEnv,theDeftemplate->patternNetwork);
 
+#if FACT_SET_QUERIES
+   DeleteQueryIndexes(theEnv,theDeftemplate);
+#endif
+
    /*==================================*/
    /* Free storage used by the header. */
    /*==================================*/
@@ -55,6 +55,8 @@
 /*                                                           */
 /*            ALLOW_ENVIRONMENT_GLOBALS no longer supported. */
 /*                                                           */
+/*            Added slot indexes for fact-set queries.       */
+/*                                                           */
 /*************************************************************/
 
 #ifndef _H_tmpltdef
@@ -67,6 +69,7 @@ typedef struct deftemplate Deftemplate;
 
 struct templateSlot;
 struct deftemplateModule;
+struct factQueryIndex;
 
 #include "entities.h"
 
@@ -95,6 +98,7 @@ struct deftemplate
    struct factPatternNode *patternNetwork;
    Fact *factList;
    Fact *lastFact;
+   struct factQueryIndex *queryIndexes;
   };
 
 struct templateSlot
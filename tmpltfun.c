@@ -519,6 +519,7 @@ Fact *ReplaceFact(
    size_t i;
    Fact *theFact;
    Fact *factListPosition, *templatePosition;
+   bool slotSpecific;
    
    /*===============================================*/
    /* Call registered modify notification functions */
@@ -546,12 +547,17 @@ Fact *ReplaceFact(
    factListPosition = oldFact->previousFact;
    templatePosition = oldFact->previousTemplateFact;
    
-   /*===================*/
-   /* Retract the fact. */
-   /*===================*/
+   /*=========================================================*/
+   /* Retract the fact. A slot specific modify only retracts  */
+   /* the matches of patterns which reference a changed slot. */
+   /*=========================================================*/
 
-   RetractDriver(theEnv,oldFact,true,changeMap);
-   oldFact->garbage = false;
+   slotSpecific = ModifyRetractDriver(theEnv,oldFact,theValueArray,changeMap);
+   if (! slotSpecific)
+     {
+      RetractDriver(theEnv,oldFact,true,changeMap);
+      oldFact->garbage = false;
+     }
 
    /*======================================*/
    /* Copy the new values to the old fact. */
@@ -582,7 +588,10 @@ Fact *ReplaceFact(
    /* Assert the new fact. */
    /*======================*/
 
-   theFact = AssertDriver(oldFact,oldFact->factIndex,factListPosition,templatePosition,changeMap);
+   if (slotSpecific)
+     { theFact = ModifyAssertDriver(theEnv,oldFact,changeMap); }
+   else
+     { theFact = AssertDriver(oldFact,oldFact->factIndex,factListPosition,templatePosition,changeMap); }
 
    /*===============================================*/
    /* Call registered modify notification functions */
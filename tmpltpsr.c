@@ -182,6 +182,7 @@ bool ParseDeftemplate(
    newDeftemplate->patternNetwork = NULL;
    newDeftemplate->factList = NULL;
    newDeftemplate->lastFact = NULL;
+   newDeftemplate->queryIndexes = NULL;
    newDeftemplate->header.whichModule = (struct defmoduleItemHeader *)
                                         GetModuleItem(theEnv,NULL,DeftemplateData(theEnv)->DeftemplateModuleIndex);
 
@@ -592,6 +592,7 @@ Deftemplate *CreateImpliedDeftemplate(
    newDeftemplate->patternNetwork = NULL;
    newDeftemplate->factList = NULL;
    newDeftemplate->lastFact = NULL;
+   newDeftemplate->queryIndexes = NULL;
    newDeftemplate->busyCount = 0;
    newDeftemplate->watch = false;
    newDeftemplate->header.next = NULL;
@@ -66,6 +66,9 @@
 /*                                                           */
 /*            Added StringBuilder functions.                 */
 /*                                                           */
+/*            Added garbage frame nursery and GCBlockCollect */
+/*            for collection within join operations.         */
+/*                                                           */
 /*************************************************************/
 
 #include "setup.h"
@@ -98,6 +101,8 @@
 /***************************************/
 
    static void                    DeallocateUtilityData(Environment *);
+   static void                    RemoveGarbageFrame(Environment *,struct garbageFrame *,struct garbageFrame *,
+                                                     UDFValue *,bool);
 
 /************************************************/
 /* InitializeUtilityData: Allocates environment */
@@ -235,6 +240,7 @@ void CleanCurrentGarbageFrame(
    CallCleanupFunctions(theEnv);
    RemoveEphemeralAtoms(theEnv);
    FlushMultifields(theEnv);
+   currentGarbageFrame->nurseryCount = 0;
 
    if (returnValue != NULL)
      { ReleaseUDFV(theEnv,returnValue); }
@@ -256,11 +262,27 @@ void RestorePriorGarbageFrame(
   struct garbageFrame *newGarbageFrame,
   struct garbageFrame *oldGarbageFrame,
   UDFValue *returnValue)
+  {
+   RemoveGarbageFrame(theEnv,newGarbageFrame,oldGarbageFrame,returnValue,true);
+  }
+
+/*************************************************************/
+/* RemoveGarbageFrame: Reclaims the atoms and multifields of */
+/*   a garbage frame and makes the prior frame current. The  */
+/*   multifields still in use are moved to the prior frame.  */
+/*   The cleanup functions are only called when requested.   */
+/*************************************************************/
+static void RemoveGarbageFrame(
+  Environment *theEnv,
+  struct garbageFrame *newGarbageFrame,
+  struct garbageFrame *oldGarbageFrame,
+  UDFValue *returnValue,
+  bool callCleanupFunctions)
   {
    if (newGarbageFrame->dirty)
      {
       if (returnValue != NULL) RetainUDFV(theEnv,returnValue);
-      CallCleanupFunctions(theEnv);
+      if (callCleanupFunctions) CallCleanupFunctions(theEnv);
       RemoveEphemeralAtoms(theEnv);
       FlushMultifields(theEnv);
      }
@@ -321,6 +343,49 @@ void GCBlockEndUDF(
    RestorePriorGarbageFrame(theEnv,&theBlock->newGarbageFrame,theBlock->oldGarbageFrame,rv);
   }
 
+/*********************************************************/
+/* GCBlockCollect: Reclaims the atoms and multifields    */
+/*   created within a garbage collection block once its  */
+/*   nursery is full. The cleanup functions are not      */
+/*   called, so this may be used within join operations. */
+/*   It must only be called at points where no value     */
+/*   created within the block is still in use.           */
+/*********************************************************/
+void GCBlockCollect(
+  Environment *theEnv,
+  GCBlock *theBlock)
+  {
+   struct garbageFrame *theGarbageFrame = &theBlock->newGarbageFrame;
+
+   if ((theGarbageFrame->nurseryCount < GARBAGE_NURSERY_SIZE) ||
+       (UtilityData(theEnv)->CurrentGarbageFrame != theGarbageFrame))
+     { return; }
+
+   RemoveEphemeralAtoms(theEnv);
+   FlushMultifields(theEnv);
+   theGarbageFrame->nurseryCount = 0;
+
+   if ((theGarbageFrame->ephemeralFloatList == NULL) &&
+       (theGarbageFrame->ephemeralIntegerList == NULL) &&
+       (theGarbageFrame->ephemeralSymbolList == NULL) &&
+       (theGarbageFrame->ephemeralBitMapList == NULL) &&
+       (theGarbageFrame->ephemeralExternalAddressList == NULL) &&
+       (theGarbageFrame->LastMultifield == NULL))
+     { theGarbageFrame->dirty = false; }
+  }
+
+/***********************************************************/
+/* GCBlockEndCollect: Ends a garbage collection block that */
+/*   was collected with GCBlockCollect. Like that function */
+/*   the cleanup functions are not called.                 */
+/***********************************************************/
+void GCBlockEndCollect(
+  Environment *theEnv,
+  GCBlock *theBlock)
+  {
+   RemoveGarbageFrame(theEnv,&theBlock->newGarbageFrame,theBlock->oldGarbageFrame,NULL,false);
+  }
+
 /*************************/
 /* CallCleanupFunctions: */
 /*************************/
@@ -63,6 +63,9 @@
 /*                                                           */
 /*            Added StringBuilder functions.                 */
 /*                                                           */
+/*            Added garbage frame nursery and GCBlockCollect */
+/*            for collection within join operations.         */
+/*                                                           */
 /*************************************************************/
 
 #ifndef _H_utility
@@ -130,6 +133,7 @@ struct garbageFrame
    struct ephemeron *ephemeralExternalAddressList;
    Multifield *ListOfMultifields;
    Multifield *LastMultifield;
+   unsigned long nurseryCount;
   };
 
 struct gcBlock
@@ -148,6 +152,17 @@ struct stringBuilder
    size_t bufferMaximum;
   };
 
+/********************************************************/
+/* GARBAGE_NURSERY_SIZE: The number of atoms and        */
+/*   multifields that may be added to a garbage frame   */
+/*   since it was last cleaned before GCBlockCollect    */
+/*   reclaims them.                                     */
+/********************************************************/
+
+#ifndef GARBAGE_NURSERY_SIZE
+#define GARBAGE_NURSERY_SIZE 1024
+#endif
+
 #define UTILITY_DATA 55
 
 struct utilityData
@@ -219,6 +234,8 @@ struct utilityData
    void                           GCBlockStart(Environment *,GCBlock *);
    void                           GCBlockEnd(Environment *,GCBlock *);
    void                           GCBlockEndUDF(Environment *,GCBlock *,UDFValue *);
+   void                           GCBlockCollect(Environment *,GCBlock *);
+   void                           GCBlockEndCollect(Environment *,GCBlock *);
    StringBuilder                 *CreateStringBuilder(Environment *,size_t);
    void                           SBDispose(StringBuilder *);
    void                           SBAppend(StringBuilder *,const char *);